@@ -2,27 +2,64 @@ QT += core gui network testlib
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 CONFIG += c++11
 
+# release 빌드에서는 디버그 로그 문장을 컴파일하지 않음 (logging.h 참고)
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += main.cpp \
+           binarylog.cpp \
+           completionpredictor.cpp \
+           devicestatesync.cpp \
+           framecapture.cpp \
+           framescheduler.cpp \
+           loadgenerator.cpp \
+           logging.cpp \
+           metrics.cpp \
+           metricsserver.cpp \
            networkmanager.cpp \
+           orderdispatcher.cpp \
            ordermanager.cpp \
            ordermanagergui.cpp \
+           ordertable.cpp \
+           sharedmemoryring.cpp \
+           simulatedrobot.cpp \
+           statuspublisher.cpp \
+           tracer.cpp \
            test_networkmanager.cpp \
            test_ordermanagergui.cpp \
            test_ordermanager.cpp
 
 HEADERS += \
+    binarylog.h \
+    completionpredictor.h \
+    devicestatesync.h \
+    framecapture.h \
+    framescheduler.h \
+    loadgenerator.h \
+    logging.h \
     message.h \
+    metrics.h \
+    metricsserver.h \
     networkmanager.h \
+    orderdispatcher.h \
     ordermanager.h \
-    ordermanagergui.h
+    ordermanagergui.h \
+    ordertable.h \
+    sharedmemoryring.h \
+    simulatedrobot.h \
+    statuspublisher.h \
+    spscqueue.h \
+    tracer.h
 
 FORMS += \
     ordermanagergui.ui
 
+DISTFILES += \
+    load_profile.json
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
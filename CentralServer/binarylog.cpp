@@ -0,0 +1,715 @@
+// binarylog.cpp
+#include "binarylog.h"
+#include "metrics.h"
+#include <QDateTime>
+#include <QDir>
+#include <QThread>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+const char LogMagic[4] = { 'R', 'B', 'L', 'G' };
+
+enum ArgType : quint8 {
+    IntegerArg = 1,
+    DoubleArg = 2,
+    StringArg = 3
+};
+
+struct EventInfo {
+    LogEvent event;
+    const char* name;
+    const char* format;
+};
+
+// 문장은 예전 logMessage/appendLog 문구 그대로 (로그 창과 기존 도구가 같은 문장을 봄)
+const EventInfo EventTable[] = {
+    { LogEvent::OrderCreated, "OrderCreated", "새로운 주문이 생성되었습니다. (주문 ID: %1)" },
+    { LogEvent::OrderStatusChanged, "OrderStatusChanged", "주문 %1: %2" },
+    { LogEvent::DeviceStatusReported, "DeviceStatusReported", "%1 장치 %2: %3 - %4" },
+    { LogEvent::OrderAccepted, "OrderAccepted", "새로운 주문이 접수되었습니다. (주문 ID: %1)" },
+    { LogEvent::OrderSent, "OrderSent", "주문을 로봇 %1(으)로 전송했습니다. (주문 ID: %2)" },
+    { LogEvent::OrderStepChanged, "OrderStepChanged", "주문 %1: %2 - %3" },
+    { LogEvent::RobotOrderReceived, "RobotOrderReceived", "새 주문 수신 (ID: %1)" },
+    { LogEvent::TaskStarted, "TaskStarted", "주문 %1: %2 시작" },
+    { LogEvent::RobotOrderCompleted, "RobotOrderCompleted", "주문 %1 완료" },
+    { LogEvent::TaskFinished, "TaskFinished", "작업 완료 - 모듈: %1, 장치: %2, 주문 ID: %3" },
+    { LogEvent::OrderRejectedBacklog, "OrderRejectedBacklog", "보관 한도 초과로 주문을 거절합니다 (ID: %1, 한도: %2)" }
+};
+
+const EventInfo* findEvent(quint16 eventId)
+{
+    for (const EventInfo& info : EventTable) {
+        if (static_cast<quint16>(info.event) == eventId) {
+            return &info;
+        }
+    }
+    return nullptr;
+}
+
+int writeVarint(char* target, quint64 value)
+{
+    int length = 0;
+    while (value >= 0x80) {
+        target[length++] = static_cast<char>((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    target[length++] = static_cast<char>(value);
+    return length;
+}
+
+bool readVarint(const char* data, int size, int& position, quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (position >= size) {
+            return false;
+        }
+        const quint8 byte = static_cast<quint8>(data[position++]);
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+quint64 zigzag(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+qint64 unzigzag(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+QString argText(const QVariant& value)
+{
+    if (value.userType() == QMetaType::Double) {
+        return QString::number(value.toDouble());
+    }
+    return value.toString();
+}
+
+} // namespace
+
+LogArgWriter::LogArgWriter(char* buffer, int capacity)
+    : buffer(buffer)
+    , capacity(capacity)
+    , used(0)
+    , argCount(0)
+{
+}
+
+void LogArgWriter::addInteger(qint64 value)
+{
+    if (capacity - used < 11) return;
+    buffer[used++] = static_cast<char>(IntegerArg);
+    used += writeVarint(buffer + used, zigzag(value));
+    argCount++;
+}
+
+void LogArgWriter::add(double value)
+{
+    if (capacity - used < 9) return;
+    buffer[used++] = static_cast<char>(DoubleArg);
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian(bits, buffer + used);
+    used += 8;
+    argCount++;
+}
+
+void LogArgWriter::add(const char* value)
+{
+    addUtf8(value ? value : "", value ? static_cast<int>(std::strlen(value)) : 0);
+}
+
+void LogArgWriter::add(const QString& value)
+{
+    // toUtf8()는 할당하므로 칸에 바로 UTF-8로 옮김
+    if (capacity - used < 2) return;
+    buffer[used++] = static_cast<char>(StringArg);
+    const int lengthAt = used++;    // 길이는 최대 SlotArgBytes라 varint 한 바이트
+    const int limit = qMin(capacity, lengthAt + 1 + 0x7f);
+
+    int length = 0;
+    const QChar* data = value.constData();
+    const int count = value.size();
+    for (int i = 0; i < count; ++i) {
+        uint code = data[i].unicode();
+        if (QChar::isHighSurrogate(code) && i + 1 < count && data[i + 1].isLowSurrogate()) {
+            code = QChar::surrogateToUcs4(static_cast<ushort>(code), data[i + 1].unicode());
+        }
+
+        char encoded[4];
+        int bytes;
+        if (code < 0x80) {
+            encoded[0] = static_cast<char>(code);
+            bytes = 1;
+        } else if (code < 0x800) {
+            encoded[0] = static_cast<char>(0xc0 | (code >> 6));
+            encoded[1] = static_cast<char>(0x80 | (code & 0x3f));
+            bytes = 2;
+        } else if (code < 0x10000) {
+            encoded[0] = static_cast<char>(0xe0 | (code >> 12));
+            encoded[1] = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            encoded[2] = static_cast<char>(0x80 | (code & 0x3f));
+            bytes = 3;
+        } else {
+            encoded[0] = static_cast<char>(0xf0 | (code >> 18));
+            encoded[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            encoded[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            encoded[3] = static_cast<char>(0x80 | (code & 0x3f));
+            bytes = 4;
+            ++i;
+        }
+
+        // 글자 중간에서 자르지 않음
+        if (used + bytes > limit) break;
+        std::memcpy(buffer + used, encoded, bytes);
+        used += bytes;
+        length += bytes;
+    }
+    buffer[lengthAt] = static_cast<char>(length);
+    argCount++;
+}
+
+void LogArgWriter::addUtf8(const char* text, int length)
+{
+    if (capacity - used < 2) return;
+    length = qMin(length, qMin(capacity - used - 2, 0x7f));
+    // 잘린 곳이 글자 중간이면 글자 시작까지 물림
+    if (text[length] != '\0') {
+        while (length > 0 && (static_cast<quint8>(text[length]) & 0xc0) == 0x80) {
+            --length;
+        }
+    }
+    buffer[used++] = static_cast<char>(StringArg);
+    buffer[used++] = static_cast<char>(length);
+    std::memcpy(buffer + used, text, length);
+    used += length;
+    argCount++;
+}
+
+QString BinaryLog::eventName(quint16 eventId)
+{
+    const EventInfo* info = findEvent(eventId);
+    return info ? QString::fromLatin1(info->name) : QString();
+}
+
+QString BinaryLog::render(const LogRecord& record)
+{
+    const EventInfo* info = findEvent(record.eventId);
+    if (!info) {
+        // 이 빌드보다 새 이벤트: 번호와 인자만 보여 줌
+        QStringList parts;
+        for (const QVariant& arg : record.args) {
+            parts << argText(arg);
+        }
+        return QString("이벤트 %1: %2").arg(record.eventId).arg(parts.join(", "));
+    }
+
+    QString text = QString::fromUtf8(info->format);
+    for (const QVariant& arg : record.args) {
+        text = text.arg(argText(arg));
+    }
+    return text;
+}
+
+bool BinaryLog::decodeArgs(const char* data, int size, int argCount, QVariantList& args)
+{
+    args.clear();
+    int position = 0;
+    for (int i = 0; i < argCount; ++i) {
+        if (position >= size) {
+            return false;
+        }
+        const quint8 type = static_cast<quint8>(data[position++]);
+        quint64 value = 0;
+        switch (type) {
+        case IntegerArg:
+            if (!readVarint(data, size, position, value)) return false;
+            args.append(unzigzag(value));
+            break;
+        case DoubleArg:
+        {
+            if (size - position < 8) return false;
+            const quint64 bits = qFromLittleEndian<quint64>(data + position);
+            double number;
+            std::memcpy(&number, &bits, sizeof(number));
+            args.append(number);
+            position += 8;
+        }
+            break;
+        case StringArg:
+            if (!readVarint(data, size, position, value) || value > static_cast<quint64>(size - position)) {
+                return false;
+            }
+            args.append(QString::fromUtf8(data + position, static_cast<int>(value)));
+            position += static_cast<int>(value);
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+// 기록 스레드 (이벤트 루프 없이 주기적으로 링을 비움)
+class BinaryLogger::WriterThread : public QThread
+{
+public:
+    explicit WriterThread(BinaryLogger& logger) : logger(logger) {}
+
+protected:
+    void run() override { logger.writerLoop(); }
+
+private:
+    BinaryLogger& logger;
+};
+
+BinaryLogger& BinaryLogger::instance()
+{
+    static BinaryLogger logger;
+    return logger;
+}
+
+BinaryLogger::BinaryLogger()
+    : running(false)
+    , dropped(0)
+    , written(0)
+    , writer(nullptr)
+    , stopRequested(false)
+    , flushRequested(false)
+    , cyclesStarted(0)
+    , cyclesCompleted(0)
+    , tailEnabled(false)
+    , fileNumber(0)
+    , fileBytes(0)
+    , fileStartUs(0)
+    , fileStartMs(0)
+    , previousUs(0)
+{
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    stop();
+    qDeleteAll(rings);
+}
+
+BinaryLogger::ThreadRing* BinaryLogger::localRing()
+{
+    // 스레드가 끝나도 남은 기록을 써야 하므로 링은 기록기가 소유
+    thread_local ThreadRing* ring = nullptr;
+    if (!ring) {
+        ring = new ThreadRing;
+        ring->head.store(0, std::memory_order_relaxed);
+        ring->tail.store(0, std::memory_order_relaxed);
+        QMutexLocker locker(&mutex);
+        ring->threadIndex = rings.size();
+        rings.append(ring);
+    }
+    return ring;
+}
+
+BinaryLogger::Slot* BinaryLogger::beginRecord()
+{
+    ThreadRing* ring = localRing();
+    const quint32 head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= static_cast<quint32>(RingCapacity)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Slot* slot = &ring->slots[head & (RingCapacity - 1)];
+    slot->timestampUs = MetricsRegistry::nowUs();
+    return slot;
+}
+
+void BinaryLogger::commitRecord()
+{
+    // 칸을 다 쓴 뒤에 위치를 옮겨 기록 스레드가 완성된 칸만 보도록 함
+    ThreadRing* ring = localRing();
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+QString BinaryLogger::formatArgs(LogEvent event, const char* data, int size, int argCount)
+{
+    LogRecord record;
+    record.eventId = static_cast<quint16>(event);
+    BinaryLog::decodeArgs(data, size, argCount, record.args);
+    return BinaryLog::render(record);
+}
+
+bool BinaryLogger::start(const BinaryLogSettings& newSettings, QString& errorMessage)
+{
+    stop();
+
+    settings = newSettings;
+    settings.maxFiles = qMax(1, settings.maxFiles);
+    settings.maxFileBytes = qMax<qint64>(4096, settings.maxFileBytes);
+    settings.flushIntervalMs = qMax(1, settings.flushIntervalMs);
+    fileStartUs = MetricsRegistry::nowUs();
+    fileStartMs = QDateTime::currentMSecsSinceEpoch();
+
+    if (!settings.directory.isEmpty()) {
+        if (!QDir().mkpath(settings.directory)) {
+            errorMessage = QString("로그 폴더를 만들 수 없습니다: %1").arg(settings.directory);
+            return false;
+        }
+        // 이전 실행의 파일 다음 번호부터 이어서 씀
+        fileNumber = 0;
+        for (const QString& name : existingFiles()) {
+            fileNumber = qMax(fileNumber, name.section('.', -2, -2).toInt());
+        }
+        if (!openNextFile(errorMessage)) {
+            return false;
+        }
+    }
+
+    QMutexLocker locker(&mutex);
+    // 꺼져 있던 동안 남은 기록은 버림
+    for (ThreadRing* ring : rings) {
+        ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+    tail.clear();
+    stopRequested = false;
+    flushRequested = false;
+    writer = new WriterThread(*this);
+    writer->start(QThread::LowPriority);
+    running.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void BinaryLogger::stop()
+{
+    QThread* thread;
+    {
+        QMutexLocker locker(&mutex);
+        if (!writer) {
+            return;
+        }
+        running.store(false, std::memory_order_relaxed);
+        stopRequested = true;
+        wake.wakeAll();
+        thread = writer;
+    }
+
+    // 기록 스레드는 멈추기 전에 마지막으로 한 번 더 비움
+    thread->wait();
+    {
+        QMutexLocker locker(&mutex);
+        delete writer;
+        writer = nullptr;
+        drained.wakeAll();
+    }
+    closeFile();
+}
+
+void BinaryLogger::flush()
+{
+    QMutexLocker locker(&mutex);
+    if (!writer) {
+        return;
+    }
+    // 지금 이후에 시작한 주기가 끝나야 지금까지의 기록이 모두 반영됨
+    const quint64 target = cyclesStarted + 1;
+    flushRequested = true;
+    wake.wakeAll();
+    while (writer && cyclesCompleted < target) {
+        drained.wait(&mutex);
+    }
+}
+
+void BinaryLogger::setTailEnabled(bool enable)
+{
+    QMutexLocker locker(&mutex);
+    tailEnabled = enable;
+    if (!enable) {
+        tail.clear();
+    }
+}
+
+QVector<LogRecord> BinaryLogger::takeTail()
+{
+    QMutexLocker locker(&mutex);
+    QVector<LogRecord> records;
+    records.swap(tail);
+    return records;
+}
+
+QString BinaryLogger::currentFilePath() const
+{
+    QMutexLocker locker(&mutex);
+    return file.isOpen() ? filePath : QString();
+}
+
+void BinaryLogger::writerLoop()
+{
+    for (;;) {
+        bool last;
+        quint64 cycle;
+        {
+            QMutexLocker locker(&mutex);
+            if (!stopRequested && !flushRequested) {
+                wake.wait(&mutex, static_cast<unsigned long>(settings.flushIntervalMs));
+            }
+            last = stopRequested;
+            flushRequested = false;
+            cycle = ++cyclesStarted;
+        }
+
+        drain();
+
+        {
+            QMutexLocker locker(&mutex);
+            cyclesCompleted = cycle;
+            drained.wakeAll();
+        }
+        if (last) {
+            return;
+        }
+    }
+}
+
+void BinaryLogger::drain()
+{
+    QList<ThreadRing*> current;
+    {
+        QMutexLocker locker(&mutex);
+        current = rings;
+    }
+
+    batch.clear();
+    for (ThreadRing* ring : current) {
+        const quint32 head = ring->head.load(std::memory_order_acquire);
+        quint32 position = ring->tail.load(std::memory_order_relaxed);
+        for (; position != head; ++position) {
+            PendingRecord record;
+            record.threadIndex = ring->threadIndex;
+            record.slot = ring->slots[position & (RingCapacity - 1)];
+            batch.append(record);
+        }
+        // 다 복사한 뒤에 칸을 돌려줌
+        ring->tail.store(position, std::memory_order_release);
+    }
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    // 스레드별로 모은 기록을 시각 순으로 (파일의 시각 차가 작게 유지됨)
+    std::stable_sort(batch.begin(), batch.end(), [](const PendingRecord& a, const PendingRecord& b) {
+        return a.slot.timestampUs < b.slot.timestampUs;
+    });
+
+    for (const PendingRecord& record : batch) {
+        writeRecord(record);
+    }
+    if (file.isOpen()) {
+        file.flush();
+    }
+    written.fetch_add(static_cast<quint64>(batch.size()), std::memory_order_relaxed);
+
+    QMutexLocker locker(&mutex);
+    if (!tailEnabled) {
+        return;
+    }
+    for (const PendingRecord& pending : batch) {
+        LogRecord record;
+        record.timestampUs = pending.slot.timestampUs;
+        record.wallMs = fileStartMs + (pending.slot.timestampUs - fileStartUs) / 1000;
+        record.eventId = pending.slot.eventId;
+        record.threadIndex = pending.threadIndex;
+        BinaryLog::decodeArgs(pending.slot.args, pending.slot.argBytes, pending.slot.argCount, record.args);
+        tail.append(record);
+    }
+    if (tail.size() > TailCapacity) {
+        tail.remove(0, tail.size() - TailCapacity);
+    }
+}
+
+void BinaryLogger::writeRecord(const PendingRecord& record)
+{
+    if (!file.isOpen()) {
+        return;
+    }
+    if (fileBytes >= settings.maxFileBytes) {
+        QString error;
+        if (!openNextFile(error)) {
+            return;
+        }
+    }
+
+    // 최대 크기: 시각 10 + 이벤트 3 + 스레드 5 + 인자 수 1 + 인자 바이트 수 1
+    char header[24];
+    int length = writeVarint(header, zigzag(record.slot.timestampUs - previousUs));
+    length += writeVarint(header + length, record.slot.eventId);
+    length += writeVarint(header + length, static_cast<quint64>(record.threadIndex));
+    header[length++] = static_cast<char>(record.slot.argCount);
+    header[length++] = static_cast<char>(record.slot.argBytes);
+    file.write(header, length);
+    file.write(record.slot.args, record.slot.argBytes);
+    fileBytes += length + record.slot.argBytes;
+    previousUs = record.slot.timestampUs;
+}
+
+bool BinaryLogger::openNextFile(QString& errorMessage)
+{
+    closeFile();
+
+    const QString path = QDir(settings.directory).filePath(
+        QString("%1.%2.blog").arg(settings.baseName).arg(++fileNumber, 6, 10, QLatin1Char('0')));
+
+    QMutexLocker locker(&mutex);
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QString("로그 파일을 열 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+    filePath = path;
+
+    // 파일마다 자기 기준 시각을 가지므로 따로 떼어 읽을 수 있음
+    const qint64 nowUs = MetricsRegistry::nowUs();
+    fileStartMs = QDateTime::currentMSecsSinceEpoch();
+    fileStartUs = nowUs;
+    previousUs = nowUs;
+
+    char header[sizeof(LogMagic) + 2 + 8 + 8];
+    std::memcpy(header, LogMagic, sizeof(LogMagic));
+    qToLittleEndian<quint16>(FormatVersion, header + 4);
+    qToLittleEndian<qint64>(fileStartMs, header + 6);
+    qToLittleEndian<qint64>(fileStartUs, header + 14);
+    if (file.write(header, sizeof(header)) != static_cast<qint64>(sizeof(header))) {
+        errorMessage = QString("로그 파일에 쓸 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        file.close();
+        return false;
+    }
+    fileBytes = sizeof(header);
+    locker.unlock();
+
+    removeOldFiles();
+    return true;
+}
+
+void BinaryLogger::closeFile()
+{
+    QMutexLocker locker(&mutex);
+    if (file.isOpen()) {
+        file.close();
+    }
+}
+
+QStringList BinaryLogger::existingFiles() const
+{
+    // 번호를 0으로 채워 이름 순서가 곧 기록 순서
+    return QDir(settings.directory).entryList(QStringList() << settings.baseName + ".*.blog",
+                                              QDir::Files, QDir::Name);
+}
+
+void BinaryLogger::removeOldFiles()
+{
+    QStringList names = existingFiles();
+    const QDir directory(settings.directory);
+    while (names.size() > settings.maxFiles) {
+        QFile::remove(directory.filePath(names.takeFirst()));
+    }
+}
+
+BinaryLogReader::BinaryLogReader()
+    : startedAt(0)
+    , baseUs(0)
+    , previousUs(0)
+{
+}
+
+bool BinaryLogReader::open(const QString& path, QString& errorMessage)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("로그 파일을 열 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+
+    char header[sizeof(LogMagic) + 2 + 8 + 8];
+    if (file.read(header, sizeof(header)) != static_cast<qint64>(sizeof(header)) ||
+        std::memcmp(header, LogMagic, sizeof(LogMagic)) != 0) {
+        errorMessage = QString("이진 로그 파일 형식이 아닙니다: %1").arg(path);
+        close();
+        return false;
+    }
+    const quint16 version = qFromLittleEndian<quint16>(header + 4);
+    if (version != BinaryLogger::FormatVersion) {
+        errorMessage = QString("지원하지 않는 로그 파일 버전입니다: %1 (버전 %2)").arg(path).arg(version);
+        close();
+        return false;
+    }
+    startedAt = qFromLittleEndian<qint64>(header + 6);
+    baseUs = qFromLittleEndian<qint64>(header + 14);
+    previousUs = baseUs;
+    return true;
+}
+
+void BinaryLogReader::close()
+{
+    if (file.isOpen()) {
+        file.close();
+    }
+    error.clear();
+}
+
+bool BinaryLogReader::readVarint(quint64& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        char byte;
+        if (!file.getChar(&byte)) {
+            return false;
+        }
+        value |= static_cast<quint64>(static_cast<quint8>(byte) & 0x7f) << shift;
+        if (!(static_cast<quint8>(byte) & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BinaryLogReader::next(LogRecord& record)
+{
+    if (!file.isOpen() || file.atEnd()) {
+        return false;
+    }
+
+    quint64 delta = 0;
+    quint64 eventId = 0;
+    quint64 threadIndex = 0;
+    char argCount = 0;
+    char argBytes = 0;
+    if (!readVarint(delta) || !readVarint(eventId) || !readVarint(threadIndex) ||
+        !file.getChar(&argCount) || !file.getChar(&argBytes)) {
+        error = QString("로그 파일의 기록 머리말이 잘렸습니다 (위치 %1)").arg(file.pos());
+        return false;
+    }
+
+    const int count = static_cast<quint8>(argCount);
+    const int size = static_cast<quint8>(argBytes);
+    const QByteArray data = file.read(size);
+    QVariantList args;
+    if (data.size() != size || !BinaryLog::decodeArgs(data.constData(), size, count, args)) {
+        error = QString("로그 파일의 기록 인자가 잘렸거나 손상되었습니다 (위치 %1)").arg(file.pos());
+        return false;
+    }
+
+    previousUs += unzigzag(delta);
+    record.timestampUs = previousUs;
+    record.wallMs = startedAt + (previousUs - baseUs) / 1000;
+    record.eventId = static_cast<quint16>(eventId);
+    record.threadIndex = static_cast<int>(threadIndex);
+    record.args = args;
+    return true;
+}
@@ -0,0 +1,254 @@
+// binarylog.h
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <QList>
+#include <QFile>
+#include <QMutex>
+#include <QWaitCondition>
+#include <atomic>
+#include <type_traits>
+
+class QThread;
+
+// 이진 로그 이벤트 ID
+// 파일에는 문장 대신 ID와 인자만 기록하므로 한 번 정한 번호는 바꾸거나 재사용하지 않습니다.
+// 문장 틀은 binarylog.cpp의 이벤트 표에 있고, 사람이 읽을 문장은 읽을 때(LogDecoder, 로그 창) 만듭니다.
+enum class LogEvent : quint16 {
+    // 서버 (1xx)
+    OrderCreated = 100,         // 주문 ID
+    OrderStatusChanged = 101,   // 주문 ID, 상태 문구
+    DeviceStatusReported = 102, // 모듈, 장치 번호, 상태 문구, 작업
+    OrderAccepted = 103,        // 주문 ID
+    OrderSent = 104,            // 로봇 연결 ID, 주문 ID
+    OrderStepChanged = 105,     // 주문 ID, 단계, 상태
+
+    // 로봇 (2xx)
+    RobotOrderReceived = 200,   // 주문 ID
+    TaskStarted = 201,          // 주문 ID, 작업 내용
+    RobotOrderCompleted = 202,  // 주문 ID
+    TaskFinished = 203,         // 모듈, 장치 번호, 주문 ID
+    OrderRejectedBacklog = 204  // 주문 ID, 보관 한도
+};
+
+// 읽어 들인 기록 하나
+struct LogRecord {
+    qint64 timestampUs = 0;     // 기록 시각 (MetricsRegistry::nowUs와 같은 단조 시계)
+    qint64 wallMs = 0;          // 같은 시각의 epoch ms
+    quint16 eventId = 0;
+    int threadIndex = 0;        // 기록한 스레드 (프로세스 안에서 처음 기록한 순서)
+    QVariantList args;          // qint64, double, QString
+};
+
+// 인자를 기록 칸에 직접 부호화 (메모리 할당 없음)
+//   정수: 1 | zigzag varint, 실수: 2 | 8바이트, 문자열: 3 | varint 길이 | UTF-8 (칸이 모자라면 잘림)
+class LogArgWriter
+{
+public:
+    LogArgWriter(char* buffer, int capacity);
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value>::type add(T value) { addInteger(static_cast<qint64>(value)); }
+    void add(double value);
+    void add(const QString& value);
+    void add(const char* value);
+
+    int size() const { return used; }
+    int count() const { return argCount; }
+
+private:
+    void addInteger(qint64 value);
+    void addUtf8(const char* text, int length);
+
+    char* buffer;
+    int capacity;
+    int used;
+    int argCount;
+};
+
+namespace BinaryLog {
+
+// 이벤트 이름 (알 수 없는 ID는 빈 문자열)
+QString eventName(quint16 eventId);
+
+// 이벤트 표의 문장 틀에 인자를 채운 문장
+QString render(const LogRecord& record);
+
+// 부호화한 인자를 다시 읽음 (잘못된 형식이면 false)
+bool decodeArgs(const char* data, int size, int argCount, QVariantList& args);
+
+} // namespace BinaryLog
+
+// 이진 로그 기록기 설정
+struct BinaryLogSettings {
+    QString directory;                      // 비우면 파일 없이 화면용 기록(tail)만 유지
+    QString baseName = "sandwich";          // 파일 이름: <baseName>.<번호>.blog
+    qint64 maxFileBytes = 32 * 1024 * 1024; // 넘으면 다음 파일로 넘어감
+    int maxFiles = 16;                      // 넘으면 가장 오래된 파일부터 지움
+    int flushIntervalMs = 200;              // 기록 스레드가 스레드별 대기열을 비우는 주기
+};
+
+// 프로세스 전역 이진 로그 기록기 (기본 꺼짐)
+// 주문 경로에서는 이벤트 ID와 인자를 스레드별 단일 생산자/단일 소비자 링에 복사만 하고,
+// 전용 기록 스레드가 주기적으로 모아 시각 순으로 정렬해 순환 파일에 씁니다.
+// 문장 포맷은 읽는 쪽(LogDecoder, 로그 창)에서만 하므로 기록 비용은 문장 길이와 무관합니다.
+//
+// 파일 형식 (리틀엔디언)
+//   머리말: "RBLG" | quint16 버전 | qint64 파일 시작 시각 (epoch ms) | qint64 같은 시각의 단조 시계 (us)
+//   기록: varint zigzag(이전 기록과의 시각 차 us) | varint 이벤트 ID | varint 스레드 | quint8 인자 수 | quint8 인자 바이트 수 | 인자
+class BinaryLogger
+{
+public:
+    static const quint16 FormatVersion = 1;
+    static const int RingCapacity = 4096;   // 스레드당 기록 수 (2의 거듭제곱), 넘치면 버림
+    static const int SlotArgBytes = 116;    // 기록 한 칸의 인자 영역 (칸 전체 128바이트)
+    static const int TailCapacity = 2000;   // 화면용 기록 보관 수
+
+    static BinaryLogger& instance();
+
+    bool start(const BinaryLogSettings& settings, QString& errorMessage);
+    // 남은 기록을 모두 쓰고 기록 스레드를 멈춤
+    void stop();
+    bool isRunning() const { return running.load(std::memory_order_relaxed); }
+
+    // 꺼져 있으면 원자 변수 하나만 읽고 돌아옴
+    static bool enabled() { return instance().running.load(std::memory_order_relaxed); }
+
+    template <typename... Args>
+    void log(LogEvent event, const Args&... args)
+    {
+        if (!enabled()) return;
+
+        Slot* slot = beginRecord();
+        if (!slot) return;      // 이 스레드의 링이 가득 참
+
+        LogArgWriter writer(slot->args, SlotArgBytes);
+        int expand[] = { 0, (writer.add(args), 0)... };
+        Q_UNUSED(expand);
+        slot->eventId = static_cast<quint16>(event);
+        slot->argCount = static_cast<quint8>(writer.count());
+        slot->argBytes = static_cast<quint8>(writer.size());
+        commitRecord();
+    }
+
+    // 기록 없이 문장만 만듦 (logMessage 시그널을 받는 쪽이 있을 때만 호출)
+    template <typename... Args>
+    static QString format(LogEvent event, const Args&... args)
+    {
+        char buffer[SlotArgBytes];
+        LogArgWriter writer(buffer, SlotArgBytes);
+        int expand[] = { 0, (writer.add(args), 0)... };
+        Q_UNUSED(expand);
+        return formatArgs(event, buffer, writer.size(), writer.count());
+    }
+
+    // 지금까지 기록한 것이 파일과 화면용 기록에 반영될 때까지 기다림
+    void flush();
+
+    // 화면용 기록: 켜 두면 기록 스레드가 읽어 들인 기록을 모아 두고 takeTail()로 가져감
+    void setTailEnabled(bool enable);
+    QVector<LogRecord> takeTail();
+
+    quint64 droppedRecords() const { return dropped.load(std::memory_order_relaxed); }
+    quint64 writtenRecords() const { return written.load(std::memory_order_relaxed); }
+    QString currentFilePath() const;
+
+private:
+    struct Slot {
+        qint64 timestampUs;
+        quint16 eventId;
+        quint8 argCount;
+        quint8 argBytes;
+        char args[SlotArgBytes];
+    };
+
+    // 작성자는 그 스레드 하나, 읽는 쪽은 기록 스레드 하나
+    struct ThreadRing {
+        int threadIndex;
+        std::atomic<quint32> head;      // 다음에 쓸 위치 (작성 스레드만 증가)
+        std::atomic<quint32> tail;      // 다음에 읽을 위치 (기록 스레드만 증가)
+        Slot slots[RingCapacity];
+    };
+
+    struct PendingRecord {
+        int threadIndex;
+        Slot slot;
+    };
+
+    class WriterThread;
+    friend class WriterThread;
+
+    BinaryLogger();
+    ~BinaryLogger();
+
+    ThreadRing* localRing();
+    Slot* beginRecord();
+    void commitRecord();
+    static QString formatArgs(LogEvent event, const char* data, int size, int argCount);
+
+    void writerLoop();
+    void drain();
+    bool openNextFile(QString& errorMessage);
+    void closeFile();
+    void writeRecord(const PendingRecord& record);
+    void removeOldFiles();
+    QStringList existingFiles() const;
+
+    std::atomic<bool> running;
+    std::atomic<quint64> dropped;
+    std::atomic<quint64> written;
+
+    mutable QMutex mutex;               // 링 목록, 기록 스레드 제어, 화면용 기록
+    QWaitCondition wake;                // 기록 스레드를 깨움 (flush, stop)
+    QWaitCondition drained;             // 한 주기를 마침
+    QList<ThreadRing*> rings;
+    QThread* writer;
+    bool stopRequested;
+    bool flushRequested;
+    quint64 cyclesStarted;
+    quint64 cyclesCompleted;
+    bool tailEnabled;
+    QVector<LogRecord> tail;
+
+    // 아래는 기록 스레드만 사용 (start/stop 중에는 기록 스레드가 없음)
+    BinaryLogSettings settings;
+    QVector<PendingRecord> batch;
+    QFile file;
+    QString filePath;
+    int fileNumber;
+    qint64 fileBytes;
+    qint64 fileStartUs;
+    qint64 fileStartMs;
+    qint64 previousUs;
+};
+
+// 파일 하나를 앞에서부터 한 기록씩 읽음
+class BinaryLogReader
+{
+public:
+    BinaryLogReader();
+
+    bool open(const QString& path, QString& errorMessage);
+    void close();
+
+    // 다음 기록 (파일 끝이거나 기록이 잘렸으면 false, 잘린 경우 errorString()에 이유)
+    bool next(LogRecord& record);
+
+    qint64 startedAtMs() const { return startedAt; }
+    QString errorString() const { return error; }
+
+private:
+    bool readVarint(quint64& value);
+
+    QFile file;
+    qint64 startedAt;
+    qint64 baseUs;
+    qint64 previousUs;
+    QString error;
+};
+
+#endif // BINARYLOG_H
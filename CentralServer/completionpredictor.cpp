@@ -0,0 +1,108 @@
+// completionpredictor.cpp
+#include "completionpredictor.h"
+#include <limits>
+
+// 최근 약 10건의 완료에 가중치를 두는 평활 계수
+const double CompletionPredictor::SmoothingFactor = 0.1;
+const double CompletionPredictor::MinimumSpread = 0.05;
+
+CompletionPredictor::CompletionPredictor()
+    : factor(1.0)
+    , spread(0.2)
+    , samples(0)
+{
+}
+
+CompletionEstimate CompletionPredictor::predict(const OrderDispatcher& dispatcher, int ordersAhead) const
+{
+    CompletionEstimate estimate;
+
+    qint64 bestEtaMs = std::numeric_limits<qint64>::max();
+    qint64 shortestPathMs = std::numeric_limits<qint64>::max();
+    double ordersPerMs = 0.0;
+
+    for (int robotId : dispatcher.robotIds()) {
+        const RobotState* robot = dispatcher.robot(robotId);
+        if (!robot || robot->load.modules.isEmpty()) {
+            continue;
+        }
+
+        // 로봇의 처리율은 가장 느린 단계(장치 수 / 처리 시간)가 결정
+        double robotRate = std::numeric_limits<double>::max();
+        qint64 pathMs = 0;
+        for (const ModuleLoad& module : robot->load.modules) {
+            pathMs += module.durationMs;
+            if (module.durationMs > 0) {
+                robotRate = qMin(robotRate, qMax(1, module.devices) / static_cast<double>(module.durationMs));
+            }
+        }
+        if (robotRate == std::numeric_limits<double>::max()) {
+            continue;
+        }
+
+        ordersPerMs += robotRate;
+        shortestPathMs = qMin(shortestPathMs, pathMs);
+        bestEtaMs = qMin(bestEtaMs, dispatcher.estimateCompletionMs(robotId));
+    }
+
+    if (ordersPerMs <= 0.0) {
+        return estimate;
+    }
+
+    // 서버 대기열의 앞선 주문은 로봇 전체 처리율로 빠져나간다고 봄
+    const double modelMs = bestEtaMs + qMax(0, ordersAhead) / ordersPerMs;
+    const double calibratedMs = modelMs * factor;
+    const double marginMs = calibratedMs * qMax(spread, MinimumSpread) * 2.0;
+
+    estimate.valid = true;
+    estimate.etaMs = qRound64(calibratedMs);
+    estimate.lowerMs = qMax(shortestPathMs, qRound64(calibratedMs - marginMs));
+    estimate.upperMs = qRound64(calibratedMs + marginMs);
+    estimate.etaMs = qMax(estimate.etaMs, estimate.lowerMs);
+    return estimate;
+}
+
+void CompletionPredictor::recordPrediction(int orderId, qint64 submittedAtMs,
+                                           const CompletionEstimate& estimate)
+{
+    if (!estimate.valid) {
+        return;
+    }
+
+    Prediction prediction;
+    prediction.submittedAtMs = submittedAtMs;
+    prediction.modelMs = qRound64(estimate.etaMs / factor);
+    prediction.estimate = estimate;
+    predictions.insert(orderId, prediction);
+}
+
+void CompletionPredictor::recordCompletion(int orderId, qint64 completedAtMs)
+{
+    auto it = predictions.find(orderId);
+    if (it == predictions.end()) {
+        return;
+    }
+
+    const qint64 actualMs = completedAtMs - it->submittedAtMs;
+    const qint64 modelMs = it->modelMs;
+    predictions.erase(it);
+    if (actualMs <= 0 || modelMs <= 0) {
+        return;
+    }
+
+    const double ratio = static_cast<double>(actualMs) / modelMs;
+    factor += SmoothingFactor * (ratio - factor);
+    spread += SmoothingFactor * (qAbs(ratio - factor) / factor - spread);
+    samples++;
+}
+
+void CompletionPredictor::forget(int orderId)
+{
+    predictions.remove(orderId);
+}
+
+CompletionEstimate CompletionPredictor::promised(int orderId) const
+{
+    auto it = predictions.constFind(orderId);
+    return it == predictions.constEnd() ? CompletionEstimate() : it->estimate;
+}
@@ -0,0 +1,54 @@
+// completionpredictor.h
+#ifndef COMPLETIONPREDICTOR_H
+#define COMPLETIONPREDICTOR_H
+
+#include <QHash>
+#include "orderdispatcher.h"
+
+// 주문 완료까지 걸릴 예상 시간과 신뢰 구간 (주문 접수 시각 기준)
+struct CompletionEstimate {
+    bool valid = false;     // 연결된 로봇의 부하 보고가 없으면 false
+    qint64 etaMs = 0;
+    qint64 lowerMs = 0;
+    qint64 upperMs = 0;
+};
+
+// 주문 접수 시 완료 시각 예측기
+// 로봇별 부하 보고(모듈별 대기 주문, 장치 수, 처리 시간)와 서버 대기열 길이로 완료 시간을 계산하고,
+// 실제 완료 시간과 비교한 비율의 지수 이동 평균으로 보정합니다.
+// 계산은 로봇 수 x 모듈 수에 비례하므로 주문 접수를 지연시키지 않습니다.
+class CompletionPredictor
+{
+public:
+    CompletionPredictor();
+
+    // ordersAhead: 서버 대기열에서 이 주문보다 먼저 나갈 주문 수
+    CompletionEstimate predict(const OrderDispatcher& dispatcher, int ordersAhead) const;
+
+    // 예측을 기록해 두었다가 완료 시 실제 시간과 비교
+    void recordPrediction(int orderId, qint64 submittedAtMs, const CompletionEstimate& estimate);
+    void recordCompletion(int orderId, qint64 completedAtMs);
+    void forget(int orderId);
+    CompletionEstimate promised(int orderId) const;
+
+    double calibrationFactor() const { return factor; }     // 실제 / 모델 시간 비율
+    double relativeSpread() const { return spread; }        // 비율의 평균 상대 편차
+    int sampleCount() const { return samples; }
+
+private:
+    struct Prediction {
+        qint64 submittedAtMs;
+        qint64 modelMs;         // 보정 전 모델 예측
+        CompletionEstimate estimate;
+    };
+
+    QHash<int, Prediction> predictions;
+    double factor;
+    double spread;
+    int samples;
+
+    static const double SmoothingFactor;
+    static const double MinimumSpread;
+};
+
+#endif // COMPLETIONPREDICTOR_H
@@ -0,0 +1,96 @@
+// framecapture.h
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QDataStream>
+#include <QMutex>
+#include <atomic>
+
+// 캡처 파일에 기록된 프레임 하나
+struct CapturedFrame {
+    enum class Direction : quint8 {
+        Incoming = 0,   // 이 프로세스가 받은 프레임
+        Outgoing = 1    // 이 프로세스가 보낸 프레임
+    };
+
+    qint64 timestampUs = 0;     // 기록 시작 이후 시간 (단조 시계)
+    Direction direction = Direction::Incoming;
+    int connectionId = 0;       // 서버 모드의 연결 ID (클라이언트 모드는 0)
+    QByteArray payload;         // 크기 접두어를 뺀 JSON 본문
+};
+
+// 캡처 파일 형식 (QDataStream, 빅엔디언)
+//   머리말: "RCAP" | quint16 버전 | qint64 기록 시작 시각 (epoch ms)
+//   프레임: qint64 timestampUs | quint8 방향 | quint32 연결 ID | quint32 크기 | 본문
+class FrameCaptureWriter
+{
+public:
+    static const quint16 FormatVersion = 1;
+
+    FrameCaptureWriter();
+    ~FrameCaptureWriter();
+
+    bool open(const QString& path, QString& errorMessage);
+    void close();
+    bool isOpen() const { return file.isOpen(); }
+
+    bool write(const CapturedFrame& frame);
+    qint64 frameCount() const { return frames; }
+
+private:
+    QFile file;
+    QDataStream stream;
+    qint64 frames;
+};
+
+// 캡처 파일을 앞에서부터 한 프레임씩 읽음 (긴 세션도 전체를 메모리에 올리지 않음)
+class FrameCaptureReader
+{
+public:
+    static const quint32 MaxPayloadBytes = 16 * 1024 * 1024;
+
+    FrameCaptureReader();
+
+    bool open(const QString& path, QString& errorMessage);
+    void close();
+
+    // 다음 프레임 (파일 끝이거나 기록이 잘렸으면 false, 잘린 경우 errorString()에 이유)
+    bool next(CapturedFrame& frame);
+
+    qint64 startedAtMs() const { return startedAt; }
+    QString errorString() const { return error; }
+
+private:
+    QFile file;
+    QDataStream stream;
+    qint64 startedAt;
+    QString error;
+};
+
+// 프로세스 전역 프레임 기록기 (기본 꺼짐)
+// NetworkManager가 보내고 받는 모든 프레임을 방향, 연결 ID, 단조 시각과 함께 기록합니다.
+// 꺼져 있으면 원자 변수 하나만 읽고 돌아옵니다.
+class FrameRecorder
+{
+public:
+    static FrameRecorder& instance();
+
+    bool start(const QString& path, QString& errorMessage);
+    void stop();
+    bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+
+    void record(CapturedFrame::Direction direction, int connectionId, const QByteArray& payload);
+
+private:
+    FrameRecorder();
+
+    std::atomic<bool> recording;
+    QMutex mutex;
+    FrameCaptureWriter writer;
+    qint64 startedUs;
+};
+
+#endif // FRAMECAPTURE_H
@@ -0,0 +1,78 @@
+// framescheduler.cpp
+#include "framescheduler.h"
+
+// 주문은 상태보다, 상태는 대량 전송보다 자주 나가지만 어느 레인도 멈추지 않음
+const int FrameScheduler::MaxPassedOver[FrameScheduler::LaneCount] = { 0, 4, 8, 16 };
+
+FrameScheduler::FrameScheduler()
+    : frames(0)
+    , bytes(0)
+{
+    for (int lane = 0; lane < LaneCount; ++lane) {
+        passedOver[lane] = 0;
+    }
+}
+
+void FrameScheduler::push(MessageLane lane, const QByteArray& payload, qint64 nowUs)
+{
+    Frame frame;
+    frame.payload = payload;
+    frame.lane = lane;
+    frame.queuedUs = nowUs;
+    lanes[static_cast<int>(lane)].enqueue(frame);
+    frames++;
+    bytes += payload.size();
+}
+
+bool FrameScheduler::pop(Frame& frame)
+{
+    if (frames == 0) {
+        return false;
+    }
+
+    // 제어 레인이 비어 있으면 오래 밀린 레인부터, 아니면 앞쪽 레인부터
+    int chosen = -1;
+    if (lanes[static_cast<int>(MessageLane::CONTROL)].isEmpty()) {
+        for (int lane = 1; lane < LaneCount; ++lane) {
+            if (!lanes[lane].isEmpty() && passedOver[lane] >= MaxPassedOver[lane]) {
+                chosen = lane;
+                break;
+            }
+        }
+    }
+    if (chosen < 0) {
+        for (int lane = 0; lane < LaneCount; ++lane) {
+            if (!lanes[lane].isEmpty()) {
+                chosen = lane;
+                break;
+            }
+        }
+    }
+
+    for (int lane = chosen + 1; lane < LaneCount; ++lane) {
+        if (!lanes[lane].isEmpty()) {
+            passedOver[lane]++;
+        }
+    }
+    passedOver[chosen] = 0;
+
+    frame = lanes[chosen].dequeue();
+    frames--;
+    bytes -= frame.payload.size();
+    return true;
+}
+
+void FrameScheduler::clear()
+{
+    for (int lane = 0; lane < LaneCount; ++lane) {
+        lanes[lane].clear();
+        passedOver[lane] = 0;
+    }
+    frames = 0;
+    bytes = 0;
+}
+
+int FrameScheduler::queuedFrames(MessageLane lane) const
+{
+    return lanes[static_cast<int>(lane)].size();
+}
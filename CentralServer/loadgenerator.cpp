@@ -0,0 +1,409 @@
+// loadgenerator.cpp
+#include "loadgenerator.h"
+#include "ordermanager.h"
+#include "framecapture.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+#include <algorithm>
+#include <random>
+
+namespace {
+
+LoadProfile::Recipe makeRecipe(int weight, const QString& bread, const QString& egg,
+                               const QStringList& jams, int jamAmount, const QStringList& cheeses)
+{
+    LoadProfile::Recipe recipe;
+    recipe.weight = weight;
+    recipe.order.orderId = 0;
+    recipe.order.bread = bread;
+    recipe.order.egg = egg;
+    recipe.order.jams = jams;
+    recipe.order.jamAmount = jamAmount;
+    recipe.order.cheeses = cheeses;
+    recipe.order.status = OrderStatus::WAITING;
+    return recipe;
+}
+
+double toMs(quint64 us)
+{
+    return static_cast<double>(us) / 1000.0;
+}
+
+} // namespace
+
+LoadProfile LoadProfile::defaults()
+{
+    LoadProfile profile;
+    profile.recipes.append(makeRecipe(3, "흰빵", "반숙", QStringList(), 0, QStringList() << "체다"));
+    profile.recipes.append(makeRecipe(2, "호밀빵", "완숙", QStringList() << "딸기잼", 50, QStringList()));
+    profile.recipes.append(makeRecipe(1, "흰빵", "완숙", QStringList() << "사과잼", 30,
+                                      QStringList() << "모짜렐라" << "체다"));
+    return profile;
+}
+
+bool LoadProfile::fromJson(const QJsonObject& json, LoadProfile& profile, QString& errorMessage)
+{
+    LoadProfile loaded = defaults();
+
+    const QString arrival = json["arrival"].toString("poisson");
+    if (arrival == "poisson") {
+        loaded.arrival = Arrival::Poisson;
+    } else if (arrival == "bursty") {
+        loaded.arrival = Arrival::Bursty;
+    } else if (arrival == "replay") {
+        loaded.arrival = Arrival::Replay;
+    } else {
+        errorMessage = QString("알 수 없는 도착 방식입니다: %1").arg(arrival);
+        return false;
+    }
+
+    loaded.ratePerSecond = json["ratePerSecond"].toDouble(loaded.ratePerSecond);
+    loaded.burstSize = json["burstSize"].toInt(loaded.burstSize);
+    loaded.durationMs = json["durationMs"].toInt(loaded.durationMs);
+    loaded.drainTimeoutMs = json["drainTimeoutMs"].toInt(loaded.drainTimeoutMs);
+    loaded.seed = static_cast<quint32>(json["seed"].toInt(static_cast<int>(loaded.seed)));
+    loaded.simulatedRobots = json["simulatedRobots"].toInt(loaded.simulatedRobots);
+    loaded.robotTimeScale = json["robotTimeScale"].toDouble(loaded.robotTimeScale);
+    loaded.port = static_cast<quint16>(json["port"].toInt(loaded.port));
+
+    if (loaded.ratePerSecond <= 0 || loaded.burstSize < 1 || loaded.durationMs <= 0 ||
+        loaded.drainTimeoutMs < 0 || loaded.simulatedRobots < 0 || loaded.robotTimeScale <= 0) {
+        errorMessage = "부하 설정 값이 범위를 벗어났습니다";
+        return false;
+    }
+
+    for (const QJsonValue& value : json["sweepRates"].toArray()) {
+        const double rate = value.toDouble();
+        if (rate <= 0) {
+            errorMessage = "sweepRates에는 양수만 쓸 수 있습니다";
+            return false;
+        }
+        loaded.sweepRates.append(rate);
+    }
+
+    if (json.contains("recipes")) {
+        loaded.recipes.clear();
+        for (const QJsonValue& value : json["recipes"].toArray()) {
+            const QJsonObject recipeJson = value.toObject();
+            Recipe recipe;
+            recipe.weight = recipeJson["weight"].toInt(1);
+            recipe.order = OrderMessage::fromJson(recipeJson);
+            if (recipe.weight < 1 || recipe.order.bread.isEmpty()) {
+                errorMessage = "레시피에는 빵과 1 이상의 weight가 필요합니다";
+                return false;
+            }
+            loaded.recipes.append(recipe);
+        }
+    }
+    if (loaded.recipes.isEmpty() && loaded.arrival != Arrival::Replay) {
+        errorMessage = "레시피가 비어 있습니다";
+        return false;
+    }
+
+    if (loaded.arrival == Arrival::Replay &&
+        !loadReplay(json["replayCapture"].toString(), loaded.replayOrders, errorMessage)) {
+        return false;
+    }
+
+    profile = loaded;
+    return true;
+}
+
+bool LoadProfile::loadFile(const QString& path, LoadProfile& profile, QString& errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("부하 설정 파일을 열 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        errorMessage = QString("부하 설정 파일 형식 오류: %1 (%2)").arg(path, parseError.errorString());
+        return false;
+    }
+    return fromJson(doc.object(), profile, errorMessage);
+}
+
+bool LoadProfile::loadReplay(const QString& path, QVector<PlannedOrder>& orders, QString& errorMessage)
+{
+    FrameCaptureReader reader;
+    if (!reader.open(path, errorMessage)) {
+        return false;
+    }
+
+    // 서버 캡처에는 로봇으로 보낸 주문, 로봇 캡처에는 받은 주문이 기록되어 있으므로 방향은 보지 않음
+    orders.clear();
+    QSet<int> seen;
+    qint64 firstUs = -1;
+    CapturedFrame frame;
+    while (reader.next(frame)) {
+        const Message message = Message::fromJson(QJsonDocument::fromJson(frame.payload).object());
+        if (message.type != MessageType::ORDER_NEW) {
+            continue;
+        }
+        const OrderMessage order = OrderMessage::fromJson(message.data);
+        if (seen.contains(order.orderId)) {
+            continue;   // 거절 후 재전송
+        }
+        seen.insert(order.orderId);
+        if (firstUs < 0) {
+            firstUs = frame.timestampUs;
+        }
+
+        PlannedOrder planned;
+        planned.atMs = (frame.timestampUs - firstUs) / 1000;
+        planned.order = order;
+        orders.append(planned);
+    }
+    if (!reader.errorString().isEmpty()) {
+        errorMessage = reader.errorString();
+        return false;
+    }
+    if (orders.isEmpty()) {
+        errorMessage = QString("캡처 파일에 주문이 없습니다: %1").arg(path);
+        return false;
+    }
+    return true;
+}
+
+QVector<LoadProfile::PlannedOrder> LoadProfile::plan(double rate) const
+{
+    QVector<PlannedOrder> orders;
+    if (arrival == Arrival::Replay) {
+        // 원래 도착률 대비 배속으로 시각만 조정
+        const double capturedSpanS = replayOrders.isEmpty() ? 0.0 : replayOrders.last().atMs / 1000.0;
+        const double capturedRate = capturedSpanS > 0 ? replayOrders.size() / capturedSpanS : rate;
+        const double speed = rate > 0 && capturedRate > 0 ? rate / capturedRate : 1.0;
+        for (PlannedOrder planned : replayOrders) {
+            planned.atMs = static_cast<qint64>(planned.atMs / speed);
+            orders.append(planned);
+        }
+        return orders;
+    }
+
+    std::mt19937 random(seed);
+    QVector<int> weights;
+    for (const Recipe& recipe : recipes) {
+        weights.append(recipe.weight);
+    }
+    std::discrete_distribution<int> recipeChoice(weights.begin(), weights.end());
+
+    // 포아송: 주문 간격이 평균 1/rate인 지수 분포
+    // 몰림: burstSize건이 한꺼번에 오고, 몰림 간격은 평균 burstSize/rate인 지수 분포 (평균 도착률은 같음)
+    const int groupSize = arrival == Arrival::Bursty ? burstSize : 1;
+    std::exponential_distribution<double> gap(rate / groupSize);
+    double atS = gap(random);
+    while (atS * 1000.0 < durationMs) {
+        for (int i = 0; i < groupSize; ++i) {
+            PlannedOrder planned;
+            planned.atMs = static_cast<qint64>(atS * 1000.0);
+            planned.order = recipes.at(recipeChoice(random)).order;
+            orders.append(planned);
+        }
+        atS += gap(random);
+    }
+    return orders;
+}
+
+QJsonObject LoadReport::toJson() const
+{
+    QJsonObject json;
+    json["offeredRate"] = offeredRate;
+    json["submitted"] = submitted;
+    json["completed"] = completed;
+    json["elapsedMs"] = elapsedMs;
+    json["throughput"] = throughput;
+    json["p50Ms"] = p50Ms;
+    json["p99Ms"] = p99Ms;
+    json["p999Ms"] = p999Ms;
+    json["maxMs"] = maxMs;
+    json["maxPending"] = maxPending;
+    json["drained"] = drained;
+    return json;
+}
+
+LoadGenerator::LoadGenerator(OrderManager* manager, QObject *parent)
+    : QObject(parent)
+    , orderManager(manager)
+    , currentStep(0)
+    , running(false)
+    , nextPlanned(0)
+    , stepStartUs(0)
+    , lastCompletionUs(0)
+{
+    qRegisterMetaType<LoadReport>("LoadReport");
+    qRegisterMetaType<QVector<LoadReport>>("QVector<LoadReport>");
+
+    submitTimer.setSingleShot(true);
+    submitTimer.setTimerType(Qt::PreciseTimer);
+    drainTimer.setSingleShot(true);
+    connect(&submitTimer, &QTimer::timeout, this, &LoadGenerator::submitDueOrders);
+    connect(&drainTimer, &QTimer::timeout, this, &LoadGenerator::handleDrainTimeout);
+    connect(orderManager, &OrderManager::orderCompleted, this, &LoadGenerator::handleOrderCompleted);
+}
+
+void LoadGenerator::start(const LoadProfile& loadProfile)
+{
+    stop();
+
+    profile = loadProfile;
+    rates = profile.sweepRates;
+    if (rates.isEmpty()) {
+        rates.append(profile.ratePerSecond);
+    }
+    reports.clear();
+    currentStep = 0;
+    running = true;
+    startStep();
+}
+
+void LoadGenerator::stop()
+{
+    submitTimer.stop();
+    drainTimer.stop();
+    submittedAtUs.clear();
+    running = false;
+}
+
+void LoadGenerator::startStep()
+{
+    const double rate = rates.at(currentStep);
+    planned = profile.plan(rate);
+    nextPlanned = 0;
+    submittedAtUs.clear();
+    latency.reset(new MetricHistogram);
+
+    report = LoadReport();
+    report.offeredRate = rate;
+    stepStartUs = MetricsRegistry::nowUs();
+    lastCompletionUs = stepStartUs;
+
+    emit logMessage(QString("부하 단계 %1/%2 시작: 초당 %3건, 주문 %4건")
+                        .arg(currentStep + 1).arg(rates.size()).arg(rate).arg(planned.size()));
+    submitDueOrders();
+}
+
+void LoadGenerator::submitDueOrders()
+{
+    const qint64 elapsedMs = (MetricsRegistry::nowUs() - stepStartUs) / 1000;
+    while (nextPlanned < planned.size() && planned.at(nextPlanned).atMs <= elapsedMs) {
+        OrderMessage order = planned.at(nextPlanned++).order;
+        order.orderId = 0;  // OrderManager가 발급
+
+        const qint64 nowUs = MetricsRegistry::nowUs();
+        const int orderId = orderManager->enqueueOrder(order);
+        if (orderId > 0) {
+            submittedAtUs.insert(orderId, nowUs);
+            report.submitted++;
+        }
+        report.maxPending = qMax(report.maxPending, orderManager->pendingOrderCount());
+    }
+
+    if (nextPlanned < planned.size()) {
+        submitTimer.start(static_cast<int>(qMax<qint64>(0, planned.at(nextPlanned).atMs - elapsedMs)));
+        return;
+    }
+
+    // 모두 접수했으면 남은 주문의 완료를 기다림
+    if (submittedAtUs.isEmpty()) {
+        finishStep();
+    } else {
+        drainTimer.start(profile.drainTimeoutMs);
+    }
+}
+
+void LoadGenerator::handleOrderCompleted(int orderId)
+{
+    auto it = submittedAtUs.find(orderId);
+    if (!running || it == submittedAtUs.end()) {
+        return;     // 이 단계에서 넣은 주문이 아님
+    }
+
+    lastCompletionUs = MetricsRegistry::nowUs();
+    latency->record(static_cast<quint64>(qMax<qint64>(0, lastCompletionUs - it.value())));
+    submittedAtUs.erase(it);
+    report.completed++;
+    report.maxPending = qMax(report.maxPending, orderManager->pendingOrderCount());
+
+    if (submittedAtUs.isEmpty() && nextPlanned >= planned.size()) {
+        drainTimer.stop();
+        finishStep();
+    }
+}
+
+void LoadGenerator::handleDrainTimeout()
+{
+    emit logMessage(QString("완료되지 않은 주문 %1건을 남기고 단계를 마칩니다").arg(submittedAtUs.size()));
+    report.drained = false;
+    finishStep();
+}
+
+void LoadGenerator::finishStep()
+{
+    report.elapsedMs = (lastCompletionUs - stepStartUs) / 1000;
+    report.throughput = report.elapsedMs > 0 ? report.completed * 1000.0 / report.elapsedMs : 0.0;
+    report.p50Ms = toMs(latency->percentile(0.5));
+    report.p99Ms = toMs(latency->percentile(0.99));
+    report.p999Ms = toMs(latency->percentile(0.999));
+    report.maxMs = toMs(latency->max());
+    reports.append(report);
+
+    emit logMessage(QString("부하 단계 %1 결과: 처리량 %2건/초, p50 %3ms, p99 %4ms, p999 %5ms")
+                        .arg(currentStep + 1).arg(report.throughput, 0, 'f', 2)
+                        .arg(report.p50Ms, 0, 'f', 1).arg(report.p99Ms, 0, 'f', 1)
+                        .arg(report.p999Ms, 0, 'f', 1));
+    emit stepFinished(report);
+
+    // 남은 주문은 다음 단계 측정에서 제외 (완료 신호가 와도 무시)
+    submittedAtUs.clear();
+
+    if (++currentStep < rates.size()) {
+        startStep();
+        return;
+    }
+
+    running = false;
+    emit finished(reports, findKnee(reports));
+}
+
+int LoadGenerator::findKnee(const QVector<LoadReport>& steps, double efficiency, double latencyFactor)
+{
+    if (steps.isEmpty()) {
+        return -1;
+    }
+
+    const double baseP99 = steps.first().p99Ms;
+    for (int i = 0; i < steps.size(); ++i) {
+        const LoadReport& step = steps.at(i);
+        const bool fallingBehind = !step.drained || step.throughput < step.offeredRate * efficiency;
+        const bool latencyBlowUp = i > 0 && baseP99 > 0 && step.p99Ms > baseP99 * latencyFactor;
+        if (fallingBehind || latencyBlowUp) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QJsonObject LoadGenerator::summaryJson(const QVector<LoadReport>& steps, int kneeIndex)
+{
+    QJsonArray stepArray;
+    for (const LoadReport& step : steps) {
+        stepArray.append(step.toJson());
+    }
+
+    QJsonObject json;
+    json["steps"] = stepArray;
+    // 포화 직전 단계의 도착률 = 지속 가능한 최대 도착률
+    if (kneeIndex >= 0) {
+        json["kneeRate"] = steps.at(kneeIndex).offeredRate;
+        json["sustainableRate"] = kneeIndex > 0 ? steps.at(kneeIndex - 1).offeredRate : 0.0;
+    } else {
+        json["kneeRate"] = QJsonValue::Null;
+        json["sustainableRate"] = steps.isEmpty() ? 0.0 : steps.last().offeredRate;
+    }
+    return json;
+}
@@ -0,0 +1,140 @@
+// loadgenerator.h
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QTimer>
+#include <QScopedPointer>
+#include <QJsonObject>
+#include "message.h"
+#include "metrics.h"
+
+class OrderManager;
+
+// 부하 시험 설정 (JSON 파일)
+// {
+//   "arrival": "poisson" | "bursty" | "replay",
+//   "ratePerSecond": 2.0,           // 평균 도착률
+//   "burstSize": 10,                // bursty: 한 번에 몰려오는 주문 수
+//   "replayCapture": "session.rcap",// replay: 캡처 파일의 ORDER_NEW 시각과 주문 내용
+//   "durationMs": 60000, "seed": 1, "drainTimeoutMs": 60000,
+//   "sweepRates": [1, 2, 4, 8],     // 있으면 도착률을 올려 가며 단계별로 실행
+//   "recipes": [ { "weight": 3, "bread": "호밀빵", "egg": "반숙", "jams": [], "jamAmount": 0,
+//                  "cheeses": [], "priority": 1 } ],
+//   "simulatedRobots": 2, "robotTimeScale": 0.01, "port": 1234   // main.cpp에서 사용
+// }
+struct LoadProfile {
+    enum class Arrival { Poisson, Bursty, Replay };
+
+    struct Recipe {
+        int weight = 1;
+        OrderMessage order;     // 주문 ID와 상태는 무시
+    };
+
+    // 계획된 주문 하나: 시작 후 atMs에 접수
+    struct PlannedOrder {
+        qint64 atMs = 0;
+        OrderMessage order;
+    };
+
+    Arrival arrival = Arrival::Poisson;
+    double ratePerSecond = 1.0;
+    int burstSize = 10;
+    int durationMs = 60000;
+    int drainTimeoutMs = 60000;
+    quint32 seed = 1;
+    QVector<Recipe> recipes;
+    QVector<PlannedOrder> replayOrders;     // replay: 캡처에서 읽은 주문 (시각 순)
+    QVector<double> sweepRates;
+
+    // 시뮬레이션 로봇 (0이면 실제 로봇이 접속하기를 기다림)
+    int simulatedRobots = 0;
+    double robotTimeScale = 1.0;
+    quint16 port = 1234;
+
+    static LoadProfile defaults();
+    static bool fromJson(const QJsonObject& json, LoadProfile& profile, QString& errorMessage);
+    static bool loadFile(const QString& path, LoadProfile& profile, QString& errorMessage);
+
+    // 캡처 파일의 ORDER_NEW 프레임을 도착 시각 순 주문으로 (같은 주문의 재전송은 첫 번째만)
+    static bool loadReplay(const QString& path, QVector<PlannedOrder>& orders, QString& errorMessage);
+
+    // 주어진 도착률로 주문 계획을 만듦 (같은 seed면 같은 계획)
+    QVector<PlannedOrder> plan(double rate) const;
+};
+
+// 한 단계의 결과
+struct LoadReport {
+    double offeredRate = 0;         // 계획한 도착률 (건/초)
+    int submitted = 0;
+    int completed = 0;
+    qint64 elapsedMs = 0;           // 첫 접수부터 마지막 완료까지
+    double throughput = 0;          // 완료 건/초
+    double p50Ms = 0;
+    double p99Ms = 0;
+    double p999Ms = 0;
+    double maxMs = 0;
+    int maxPending = 0;             // 서버 대기열 최대 길이
+    bool drained = true;            // drain 시간 안에 모두 완료되었는지
+
+    QJsonObject toJson() const;
+};
+
+// OrderManager에 계획한 시각대로 주문을 넣고 완료까지의 지연을 측정
+// 로봇은 실제 RobotClient든 SimulatedRobot이든 OrderManager 뒤에 연결된 것을 그대로 사용합니다.
+class LoadGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LoadGenerator(OrderManager* manager, QObject *parent = nullptr);
+
+    // sweepRates가 있으면 단계별로, 없으면 ratePerSecond로 한 번 실행
+    void start(const LoadProfile& profile);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // 처리량이 도착률의 efficiency 미만이거나 p99가 첫 단계의 latencyFactor배를 넘는 첫 단계
+    // (포화 지점, 없으면 -1)
+    static int findKnee(const QVector<LoadReport>& steps, double efficiency = 0.9, double latencyFactor = 2.0);
+
+    static QJsonObject summaryJson(const QVector<LoadReport>& steps, int kneeIndex);
+
+signals:
+    void stepFinished(const LoadReport& report);
+    void finished(const QVector<LoadReport>& steps, int kneeIndex);
+    void logMessage(const QString& message);
+
+private slots:
+    void submitDueOrders();
+    void handleOrderCompleted(int orderId);
+    void handleDrainTimeout();
+
+private:
+    OrderManager* orderManager;
+    LoadProfile profile;
+    QVector<double> rates;
+    int currentStep;
+    bool running;
+
+    QVector<LoadProfile::PlannedOrder> planned;
+    int nextPlanned;
+    QHash<int, qint64> submittedAtUs;   // 주문 ID -> 접수 시각 (단조 시계)
+    qint64 stepStartUs;
+    qint64 lastCompletionUs;
+    QScopedPointer<MetricHistogram> latency;    // 단계마다 새로 만듦 (마이크로초)
+    LoadReport report;
+    QVector<LoadReport> reports;
+
+    QTimer submitTimer;
+    QTimer drainTimer;
+
+    void startStep();
+    void finishStep();
+};
+
+Q_DECLARE_METATYPE(LoadReport)
+
+#endif // LOADGENERATOR_H
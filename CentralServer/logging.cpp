@@ -0,0 +1,78 @@
+// logging.cpp
+#include "logging.h"
+#include <QStringList>
+
+// 분류의 기본 수준은 info (디버그는 켜야만 출력)
+Q_LOGGING_CATEGORY(lcNetwork, "sandwich.network", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcOrders, "sandwich.orders", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcDevice, "sandwich.device", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcGui, "sandwich.gui", QtInfoMsg)
+
+namespace {
+
+const QStringList& levelNames()
+{
+    static const QStringList names = QStringList() << "debug" << "info" << "warning" << "critical" << "off";
+    return names;
+}
+
+const QStringList& categoryNames()
+{
+    static const QStringList names = QStringList() << "network" << "orders" << "device" << "gui";
+    return names;
+}
+
+// level 이상의 메시지만 켜는 규칙 (level이 "off"면 모두 끔)
+QStringList rulesFor(const QString& category, int level)
+{
+    QStringList rules;
+    for (int type = 0; type < 4; ++type) {
+        rules << QString("%1.%2=%3").arg(category, levelNames().at(type), type >= level ? "true" : "false");
+    }
+    return rules;
+}
+
+} // namespace
+
+void Logging::install()
+{
+    qSetMessagePattern("%{time hh:mm:ss.zzz} "
+                       "%{if-debug}D%{endif}%{if-info}I%{endif}%{if-warning}W%{endif}"
+                       "%{if-critical}E%{endif}%{if-fatal}F%{endif} "
+                       "%{if-category}[%{category}] %{endif}%{message}");
+}
+
+bool Logging::applyLevelSpec(const QString& spec, QString& errorMessage)
+{
+    QStringList rules = rulesFor("sandwich.*", levelNames().indexOf("info"));
+
+    for (const QString& part : spec.split(',')) {
+        const QString item = part.trimmed();
+        if (item.isEmpty()) {
+            continue;
+        }
+
+        QString category = "*";
+        QString level = item;
+        const int separator = item.indexOf('=');
+        if (separator >= 0) {
+            category = item.left(separator).trimmed();
+            level = item.mid(separator + 1).trimmed();
+        }
+
+        const int levelIndex = levelNames().indexOf(level.toLower());
+        if (levelIndex < 0) {
+            errorMessage = QString("알 수 없는 로그 수준입니다: %1 (%2)").arg(level, levelNames().join(", "));
+            return false;
+        }
+        if (category != "*" && !categoryNames().contains(category)) {
+            errorMessage = QString("알 수 없는 로그 분류입니다: %1 (%2)").arg(category, categoryNames().join(", "));
+            return false;
+        }
+        rules << rulesFor("sandwich." + category, levelIndex);
+    }
+
+    // 뒤의 규칙이 앞의 규칙보다 우선
+    QLoggingCategory::setFilterRules(rules.join('\n'));
+    return true;
+}
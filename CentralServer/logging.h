@@ -0,0 +1,31 @@
+// logging.h
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+#include <QString>
+
+// 로그 분류 (qCDebug/qCInfo/qCWarning/qCCritical과 함께 사용)
+//
+// - 인자는 분류의 해당 수준이 켜져 있을 때만 평가되므로, 꺼진 디버그 로그는 문자열을 만들지 않습니다.
+// - 실행 중 수준: 기본은 info 이상. --log-level 옵션(Logging::applyLevelSpec)이나
+//   QT_LOGGING_RULES 환경 변수로 분류별로 바꿀 수 있습니다.
+// - 컴파일 시 수준: release 빌드는 QT_NO_DEBUG_OUTPUT을 정의하므로 qCDebug 문장 자체가 빠집니다.
+//   (QT_NO_INFO_OUTPUT, QT_NO_WARNING_OUTPUT을 추가로 정의하면 더 높은 수준까지 제거)
+Q_DECLARE_LOGGING_CATEGORY(lcNetwork)   // sandwich.network: 연결, 프레임 송수신
+Q_DECLARE_LOGGING_CATEGORY(lcOrders)    // sandwich.orders: 주문 접수, 분배, 상태 진행
+Q_DECLARE_LOGGING_CATEGORY(lcDevice)    // sandwich.device: 장치 작업 시작/완료
+Q_DECLARE_LOGGING_CATEGORY(lcGui)       // sandwich.gui: 화면 갱신
+
+namespace Logging {
+
+// 시각, 수준, 분류가 붙은 한 줄 형식으로 출력
+void install();
+
+// 수준 지정: "debug" (전체) 또는 "network=debug,device=warning" (분류별, 나머지는 기본 info)
+// 수준: debug, info, warning, critical, off
+bool applyLevelSpec(const QString& spec, QString& errorMessage);
+
+} // namespace Logging
+
+#endif // LOGGING_H
@@ -1,13 +1,153 @@
 // main.cpp
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QSharedPointer>
 #include "ordermanagergui.h"
+#include "binarylog.h"
+#include "framecapture.h"
+#include "loadgenerator.h"
+#include "logging.h"
+#include "metricsserver.h"
+#include "networkmanager.h"
+#include "simulatedrobot.h"
+#include "tracer.h"
+
+// 부하 시험: 서버를 시작하고 (필요하면 가상 로봇을 띄워) 로봇이 주문을 받을 수 있게 되면 부하를 넣음
+// 끝나면 결과 JSON을 출력(reportPath가 있으면 파일로도 저장)하고 종료
+static bool startLoadTest(QApplication& app, OrderManagerGUI& gui, const QString& profilePath,
+                          const QString& reportPath)
+{
+    LoadProfile profile;
+    QString error;
+    if (!LoadProfile::loadFile(profilePath, profile, error)) {
+        qWarning().noquote() << error;
+        return false;
+    }
+    if (!gui.startServer(profile.port)) {
+        qWarning().noquote() << "부하 시험용 서버를 시작할 수 없습니다. 포트:" << profile.port;
+        return false;
+    }
+
+    for (int i = 0; i < profile.simulatedRobots; ++i) {
+        SimulatedRobot* robot = new SimulatedRobot(&app);
+        robot->setTimeScale(profile.robotTimeScale);
+        robot->connectToServer("localhost", profile.port);
+    }
+
+    OrderManager* orderManager = gui.getOrderManager();
+    LoadGenerator* generator = new LoadGenerator(orderManager, &app);
+    QObject::connect(generator, &LoadGenerator::logMessage,
+                     [](const QString& message) { qInfo().noquote() << message; });
+    QObject::connect(generator, &LoadGenerator::finished, &app,
+                     [&app, reportPath](const QVector<LoadReport>& steps, int kneeIndex) {
+        const QByteArray summary =
+            QJsonDocument(LoadGenerator::summaryJson(steps, kneeIndex)).toJson(QJsonDocument::Indented);
+        qInfo().noquote() << summary;
+        if (!reportPath.isEmpty()) {
+            QFile file(reportPath);
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(summary) < 0) {
+                qWarning().noquote() << "부하 시험 결과를 저장할 수 없습니다:" << reportPath;
+            }
+        }
+        app.quit();
+    });
+
+    // 첫 로봇이 크레딧을 알려 오면 시작 (로봇 접속 시간이 지연에 섞이지 않도록)
+    QSharedPointer<bool> started(new bool(false));
+    QObject::connect(orderManager, &OrderManager::flowControlChanged, generator,
+                     [generator, profile, started](int pendingCount, int credits) {
+        Q_UNUSED(pendingCount);
+        if (!*started && credits > 0) {
+            *started = true;
+            generator->start(profile);
+        }
+    });
+    return true;
+}
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption metricsPortOption("metrics-port", "지표(Prometheus) HTTP 포트, 0이면 사용 안 함", "port", "0");
+    parser.addOption(metricsPortOption);
+    QCommandLineOption traceOption("trace", "종료 시 주문/장치 타임라인을 Chrome trace JSON으로 저장", "path");
+    parser.addOption(traceOption);
+    QCommandLineOption captureOption("capture", "송수신 프레임을 캡처 파일로 기록 (ReplayTool로 재생)", "path");
+    parser.addOption(captureOption);
+    QCommandLineOption loadOption("load", "부하 시험 설정 파일로 부하를 넣고 결과를 출력한 뒤 종료", "profile");
+    QCommandLineOption loadReportOption("load-report", "부하 시험 결과 JSON 저장 경로", "path");
+    parser.addOption(loadOption);
+    parser.addOption(loadReportOption);
+    QCommandLineOption logLevelOption("log-level", "로그 수준: debug|info|warning|critical|off, 분류별로는 network=debug,device=warning", "level", "info");
+    parser.addOption(logLevelOption);
+    QCommandLineOption binaryLogOption("binary-log", "주문/장치 이벤트를 이진 로그로 기록할 폴더 (LogDecoder로 읽음)", "dir");
+    parser.addOption(binaryLogOption);
+    QCommandLineOption tcpOnlyOption("tcp-only", "같은 호스트 연결도 공유 메모리 대신 TCP로 통신");
+    parser.addOption(tcpOnlyOption);
+    parser.process(a);
+
+    Logging::install();
+    if (parser.isSet(tcpOnlyOption)) {
+        NetworkManager::setLocalTransportEnabled(false);
+    }
+    QString logError;
+    if (!Logging::applyLevelSpec(parser.value(logLevelOption), logError)) {
+        qWarning().noquote() << logError;
+    }
+
+    // 추적은 켜 둔 동안 스레드별 버퍼에 모았다가 종료할 때 한 번에 기록
+    const QString tracePath = parser.value(traceOption);
+    if (!tracePath.isEmpty()) {
+        Tracer::instance().setEnabled(true);
+        QObject::connect(&a, &QCoreApplication::aboutToQuit, [tracePath]() {
+            QString error;
+            if (!Tracer::instance().writeChromeTrace(tracePath, error)) {
+                qWarning().noquote() << error;
+            }
+        });
+    }
+
+    // 이진 로그는 전용 스레드가 순환 파일에 씀 (폴더를 주지 않으면 로그 창용으로만 동작)
+    BinaryLogSettings binaryLogSettings;
+    binaryLogSettings.directory = parser.value(binaryLogOption);
+    binaryLogSettings.baseName = "server";
+    QString binaryLogError;
+    if (!BinaryLogger::instance().start(binaryLogSettings, binaryLogError)) {
+        qWarning().noquote() << binaryLogError;
+    }
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, []() { BinaryLogger::instance().stop(); });
+
+    const QString capturePath = parser.value(captureOption);
+    if (!capturePath.isEmpty()) {
+        QString error;
+        if (FrameRecorder::instance().start(capturePath, error)) {
+            QObject::connect(&a, &QCoreApplication::aboutToQuit, []() { FrameRecorder::instance().stop(); });
+        } else {
+            qWarning().noquote() << error;
+        }
+    }
+
+    // 지표 수신기는 전용 스레드에서 동작하므로 주문 처리와 독립적
+    MetricsServer metricsServer;
+    QObject::connect(&metricsServer, &MetricsServer::logMessage,
+                     [](const QString& message) { qInfo().noquote() << message; });
+    const quint16 metricsPort = static_cast<quint16>(parser.value(metricsPortOption).toUInt());
+    if (metricsPort != 0) {
+        metricsServer.start(metricsPort);
+    }
+
     OrderManagerGUI w;
     w.show();
 
+    if (parser.isSet(loadOption)) {
+        startLoadTest(a, w, parser.value(loadOption), parser.value(loadReportOption));
+    }
+
     return a.exec();
 }
@@ -0,0 +1,159 @@
+// metrics.cpp
+#include "metrics.h"
+#include <QDebug>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <chrono>
+
+void MetricGauge::add(double delta)
+{
+    double expected = current.load(std::memory_order_relaxed);
+    while (!current.compare_exchange_weak(expected, expected + delta, std::memory_order_relaxed)) {
+    }
+}
+
+MetricHistogram::MetricHistogram()
+    : total(0)
+    , sumValue(0)
+    , maxValue(0)
+{
+    for (std::atomic<quint64>& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::record(quint64 value)
+{
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sumValue.fetch_add(value, std::memory_order_relaxed);
+
+    quint64 previous = maxValue.load(std::memory_order_relaxed);
+    while (value > previous &&
+           !maxValue.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+
+quint64 MetricHistogram::percentile(double q) const
+{
+    const quint64 recorded = count();
+    if (recorded == 0) {
+        return 0;
+    }
+
+    // 기록 중에도 읽을 수 있으므로 합계 대신 구간을 다시 세며 목표 순위를 찾음
+    const quint64 rank = qMax<quint64>(1, static_cast<quint64>(qBound(0.0, q, 1.0) * recorded + 0.5));
+    quint64 seen = 0;
+    for (int index = 0; index < BucketCount; ++index) {
+        seen += bucketValue(index);
+        if (seen >= rank) {
+            return qMin(bucketUpperBound(index), max());
+        }
+    }
+    return max();
+}
+
+int MetricHistogram::bucketIndex(quint64 value)
+{
+    if (value < static_cast<quint64>(SubBucketCount)) {
+        return static_cast<int>(value);
+    }
+
+    // 최상위 비트 위치로 구간을 정하고, 그 아래 SubBucketBits 비트로 하위 구간을 정함
+    const int exponent = 63 - static_cast<int>(qCountLeadingZeroBits(value));
+    const int subBucket = static_cast<int>((value >> (exponent - SubBucketBits)) & (SubBucketCount - 1));
+    return (exponent - SubBucketBits + 1) * SubBucketCount + subBucket;
+}
+
+quint64 MetricHistogram::bucketUpperBound(int index)
+{
+    if (index < SubBucketCount) {
+        return static_cast<quint64>(index);
+    }
+
+    const int exponent = index / SubBucketCount + SubBucketBits - 1;
+    const quint64 subBucket = static_cast<quint64>(index % SubBucketCount);
+    const int shift = exponent - SubBucketBits;
+    const quint64 lower = (static_cast<quint64>(SubBucketCount) + subBucket) << shift;
+    return lower + ((quint64(1) << shift) - 1);
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::~MetricsRegistry()
+{
+    for (const Entry& entry : metrics) {
+        delete entry.counter;
+        delete entry.gauge;
+        delete entry.histogram;
+    }
+}
+
+MetricsRegistry::Entry* MetricsRegistry::find(const QString& name, const QString& labels,
+                                              Type type, const QString& help)
+{
+    const QString key = labels.isEmpty() ? name : QString("%1{%2}").arg(name, labels);
+    auto it = metrics.find(key);
+    if (it != metrics.end()) {
+        if (it->type != type) {
+            qWarning() << "지표 종류가 다릅니다:" << key;
+            return nullptr;
+        }
+        return &it.value();
+    }
+
+    Entry entry;
+    entry.name = name;
+    entry.labels = labels;
+    entry.help = help;
+    entry.type = type;
+    entry.counter = type == Type::Counter ? new MetricCounter : nullptr;
+    entry.gauge = type == Type::Gauge ? new MetricGauge : nullptr;
+    entry.histogram = type == Type::Histogram ? new MetricHistogram : nullptr;
+    return &metrics.insert(key, entry).value();
+}
+
+MetricCounter* MetricsRegistry::counter(const QString& name, const QString& help, const QString& labels)
+{
+    QMutexLocker locker(&mutex);
+    Entry* entry = find(name, labels, Type::Counter, help);
+    // 종류가 겹치는 잘못된 이름이어도 호출 측이 그대로 기록할 수 있도록 별도 객체를 돌려줌
+    return entry ? entry->counter : new MetricCounter;
+}
+
+MetricGauge* MetricsRegistry::gauge(const QString& name, const QString& help, const QString& labels)
+{
+    QMutexLocker locker(&mutex);
+    Entry* entry = find(name, labels, Type::Gauge, help);
+    return entry ? entry->gauge : new MetricGauge;
+}
+
+MetricHistogram* MetricsRegistry::histogram(const QString& name, const QString& help, const QString& labels)
+{
+    QMutexLocker locker(&mutex);
+    Entry* entry = find(name, labels, Type::Histogram, help);
+    return entry ? entry->histogram : new MetricHistogram;
+}
+
+QList<MetricsRegistry::Entry> MetricsRegistry::entries() const
+{
+    QList<Entry> result;
+    {
+        QMutexLocker locker(&mutex);
+        result = metrics.values();
+    }
+    std::sort(result.begin(), result.end(), [](const Entry& a, const Entry& b) {
+        return a.name != b.name ? a.name < b.name : a.labels < b.labels;
+    });
+    return result;
+}
+
+qint64 MetricsRegistry::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,111 @@
+// metrics.h
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QString>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <atomic>
+
+// 단조 증가 카운터 (프레임 수, 바이트 수, 처리 건수 등)
+class MetricCounter
+{
+public:
+    MetricCounter() : total(0) {}
+
+    void add(quint64 n = 1) { total.fetch_add(n, std::memory_order_relaxed); }
+    quint64 value() const { return total.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<quint64> total;
+};
+
+// 현재 값 (대기열 길이, 가동률 등)
+class MetricGauge
+{
+public:
+    MetricGauge() : current(0.0) {}
+
+    void set(double value) { current.store(value, std::memory_order_relaxed); }
+    void add(double delta);
+    double value() const { return current.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<double> current;
+};
+
+// HDR 방식 히스토그램 (2의 거듭제곱 구간마다 16개 하위 구간, 상대 오차 1/16 이내)
+// 0 ~ 2^64 범위의 값을 고정 크기 배열에 기록하므로 기록 시 메모리 할당이나 잠금이 없습니다.
+// 시간 값은 마이크로초 단위로 기록합니다.
+class MetricHistogram
+{
+public:
+    static const int SubBucketBits = 4;
+    static const int SubBucketCount = 1 << SubBucketBits;
+    static const int BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+    MetricHistogram();
+
+    void record(quint64 value);
+
+    quint64 count() const { return total.load(std::memory_order_relaxed); }
+    quint64 sum() const { return sumValue.load(std::memory_order_relaxed); }
+    quint64 max() const { return maxValue.load(std::memory_order_relaxed); }
+    quint64 bucketValue(int index) const { return buckets[index].load(std::memory_order_relaxed); }
+
+    // q (0~1) 분위수가 속한 구간의 상한 (기록이 없으면 0)
+    quint64 percentile(double q) const;
+
+    static int bucketIndex(quint64 value);
+    static quint64 bucketUpperBound(int index);
+
+private:
+    std::atomic<quint64> buckets[BucketCount];
+    std::atomic<quint64> total;
+    std::atomic<quint64> sumValue;
+    std::atomic<quint64> maxValue;
+};
+
+// 프로세스 전역 지표 저장소
+// 지표 생성(이름/라벨 조회)만 잠금을 쓰므로 생성은 초기화 시점에 하고,
+// 반환된 포인터로 기록하면 잠금 없이 원자적 연산 몇 번으로 끝납니다.
+// 지표 객체는 프로세스가 끝날 때까지 유지됩니다.
+class MetricsRegistry
+{
+public:
+    enum class Type { Counter, Gauge, Histogram };
+
+    struct Entry {
+        QString name;
+        QString labels;     // Prometheus 라벨 형식: module="Bread",device="1"
+        QString help;
+        Type type;
+        MetricCounter* counter;
+        MetricGauge* gauge;
+        MetricHistogram* histogram;
+    };
+
+    static MetricsRegistry& instance();
+
+    // 이름과 라벨이 같으면 기존 지표를 반환
+    MetricCounter* counter(const QString& name, const QString& help, const QString& labels = QString());
+    MetricGauge* gauge(const QString& name, const QString& help, const QString& labels = QString());
+    MetricHistogram* histogram(const QString& name, const QString& help, const QString& labels = QString());
+
+    // 이름, 라벨 순으로 정렬된 지표 목록
+    QList<Entry> entries() const;
+
+    // 단조 시계 (마이크로초)
+    static qint64 nowUs();
+
+private:
+    MetricsRegistry() = default;
+    ~MetricsRegistry();
+    Entry* find(const QString& name, const QString& labels, Type type, const QString& help);
+
+    mutable QMutex mutex;
+    QMap<QString, Entry> metrics;   // "이름{라벨}" -> 지표
+};
+
+#endif // METRICS_H
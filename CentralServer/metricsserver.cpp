@@ -0,0 +1,212 @@
+// metricsserver.cpp
+#include "metricsserver.h"
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QtMath>
+
+namespace {
+
+// summary로 내보낼 분위수
+const double ExportedQuantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+
+QByteArray httpResponse(const QByteArray& status, const QByteArray& contentType, const QByteArray& body)
+{
+    QByteArray response;
+    response.reserve(body.size() + 160);
+    response += "HTTP/1.1 " + status + "\r\n";
+    response += "Content-Type: " + contentType + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += "Connection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+QByteArray formatValue(double value)
+{
+    if (qIsNaN(value)) return "NaN";
+    if (qIsInf(value)) return value > 0 ? "+Inf" : "-Inf";
+    return QByteArray::number(value, 'g', 15);
+}
+
+// 기존 라벨에 라벨 하나를 덧붙여 {..} 형태로 만듦
+QByteArray labelSet(const QString& labels, const QByteArray& extra = QByteArray())
+{
+    QByteArray joined = labels.toUtf8();
+    if (!extra.isEmpty()) {
+        if (!joined.isEmpty()) joined += ',';
+        joined += extra;
+    }
+    return joined.isEmpty() ? QByteArray() : '{' + joined + '}';
+}
+
+QByteArray escapeHelp(const QString& help)
+{
+    QByteArray escaped = help.toUtf8();
+    escaped.replace('\\', "\\\\");
+    escaped.replace('\n', "\\n");
+    return escaped;
+}
+
+const char* typeName(MetricsRegistry::Type type)
+{
+    switch (type) {
+    case MetricsRegistry::Type::Counter: return "counter";
+    case MetricsRegistry::Type::Gauge: return "gauge";
+    case MetricsRegistry::Type::Histogram: return "summary";
+    }
+    return "untyped";
+}
+
+} // namespace
+
+MetricsServer::MetricsServer(QObject *parent)
+    : QObject(parent)
+    , listener(nullptr)
+    , listeningPort(0)
+{
+    thread.setObjectName("MetricsServer");
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+bool MetricsServer::start(quint16 port, const QHostAddress& address)
+{
+    if (listener) {
+        return true;
+    }
+
+    thread.start();
+    QTcpServer* server = new QTcpServer;
+    server->moveToThread(&thread);
+    // 스레드가 끝날 때 수신기와 남은 연결(자식 소켓)을 함께 정리
+    connect(&thread, &QThread::finished, server, &QObject::deleteLater);
+
+    // 수신 시작만 기다리고, 이후 연결 처리는 모두 전용 스레드에서 진행
+    bool listening = false;
+    QString error;
+    QMetaObject::invokeMethod(server, [server, address, port, &listening, &error]() {
+        listening = server->listen(address, port);
+        if (!listening) {
+            error = server->errorString();
+            return;
+        }
+        QObject::connect(server, &QTcpServer::newConnection, server, [server]() {
+            while (QTcpSocket* socket = server->nextPendingConnection()) {
+                serveConnection(socket);
+            }
+        });
+    }, Qt::BlockingQueuedConnection);
+
+    listener = server;
+    if (!listening) {
+        stop();
+        emit logMessage(QString("지표 서버를 시작할 수 없습니다. (포트: %1) - %2").arg(port).arg(error));
+        return false;
+    }
+
+    listeningPort = listener->serverPort();
+    emit logMessage(QString("지표 서버가 시작되었습니다. (포트: %1)").arg(listeningPort));
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    if (!listener) {
+        return;
+    }
+
+    listener = nullptr;
+    listeningPort = 0;
+    thread.quit();
+    thread.wait();
+}
+
+void MetricsServer::serveConnection(QTcpSocket* socket)
+{
+    // 요청을 끝까지 보내지 않는 연결은 일정 시간 후 끊음
+    QTimer::singleShot(RequestTimeoutMs, socket, &QTcpSocket::abort);
+    connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    connect(socket, &QTcpSocket::readyRead, socket, [socket]() {
+        if (socket->state() != QAbstractSocket::ConnectedState) {
+            return;
+        }
+
+        const QByteArray received = socket->peek(MaxRequestBytes + 1);
+        const int headerEnd = received.indexOf("\r\n\r\n");
+        if (headerEnd < 0) {
+            if (received.size() > MaxRequestBytes) {
+                socket->write(httpResponse("431 Request Header Fields Too Large",
+                                           "text/plain; charset=utf-8", "request too large\n"));
+                socket->disconnectFromHost();
+            }
+            return;
+        }
+
+        socket->write(handleRequest(socket->read(headerEnd + 4)));
+        socket->disconnectFromHost();
+    });
+}
+
+QByteArray MetricsServer::handleRequest(const QByteArray& request)
+{
+    const QList<QByteArray> requestLine = request.left(request.indexOf("\r\n")).split(' ');
+    if (requestLine.size() != 3 || !requestLine[2].startsWith("HTTP/")) {
+        return httpResponse("400 Bad Request", "text/plain; charset=utf-8", "bad request\n");
+    }
+    if (requestLine[0] != "GET") {
+        return httpResponse("405 Method Not Allowed", "text/plain; charset=utf-8", "only GET is supported\n");
+    }
+
+    QByteArray path = requestLine[1];
+    const int query = path.indexOf('?');
+    if (query >= 0) {
+        path.truncate(query);
+    }
+    if (path != "/metrics") {
+        return httpResponse("404 Not Found", "text/plain; charset=utf-8", "not found\n");
+    }
+
+    return httpResponse("200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                        renderPrometheus(MetricsRegistry::instance().entries()));
+}
+
+QByteArray MetricsServer::renderPrometheus(const QList<MetricsRegistry::Entry>& entries)
+{
+    QByteArray text;
+    QString family;
+    for (const MetricsRegistry::Entry& entry : entries) {
+        const QByteArray name = entry.name.toUtf8();
+
+        // 같은 이름의 지표는 라벨만 다르므로 HELP/TYPE은 한 번만 출력
+        if (entry.name != family) {
+            family = entry.name;
+            text += "# HELP " + name + ' ' + escapeHelp(entry.help) + '\n';
+            text += "# TYPE " + name + ' ' + typeName(entry.type) + '\n';
+        }
+
+        switch (entry.type) {
+        case MetricsRegistry::Type::Counter:
+            text += name + labelSet(entry.labels) + ' ' + QByteArray::number(entry.counter->value()) + '\n';
+            break;
+        case MetricsRegistry::Type::Gauge:
+            text += name + labelSet(entry.labels) + ' ' + formatValue(entry.gauge->value()) + '\n';
+            break;
+        case MetricsRegistry::Type::Histogram: {
+            const MetricHistogram* histogram = entry.histogram;
+            for (double q : ExportedQuantiles) {
+                const QByteArray quantile = "quantile=\"" + QByteArray::number(q) + '"';
+                text += name + labelSet(entry.labels, quantile) + ' '
+                        + QByteArray::number(histogram->percentile(q)) + '\n';
+            }
+            text += name + "_sum" + labelSet(entry.labels) + ' ' + QByteArray::number(histogram->sum()) + '\n';
+            text += name + "_count" + labelSet(entry.labels) + ' ' + QByteArray::number(histogram->count()) + '\n';
+            break;
+        }
+        }
+    }
+    return text;
+}
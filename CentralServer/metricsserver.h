@@ -0,0 +1,51 @@
+// metricsserver.h
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QThread>
+#include <QHostAddress>
+#include "metrics.h"
+
+class QTcpServer;
+class QTcpSocket;
+
+// 지표를 Prometheus 텍스트 형식으로 내보내는 HTTP 수신기 (GET /metrics)
+// 수신기는 전용 스레드에서 동작하고 지표는 원자 변수만 읽으므로
+// 수집 요청이 주문 처리 스레드(GUI 이벤트 루프)를 막지 않습니다.
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int MaxRequestBytes = 8192;
+    static const int RequestTimeoutMs = 5000;
+
+    explicit MetricsServer(QObject *parent = nullptr);
+    ~MetricsServer();
+
+    // port가 0이면 빈 포트를 골라 사용 (serverPort()로 확인)
+    bool start(quint16 port, const QHostAddress& address = QHostAddress::Any);
+    void stop();
+    bool isRunning() const { return listener != nullptr; }
+    quint16 serverPort() const { return listeningPort; }
+
+    // 지표 목록을 Prometheus 텍스트 형식(0.0.4)으로 변환
+    // 히스토그램은 summary(분위수, 합계, 개수)로 내보냅니다.
+    static QByteArray renderPrometheus(const QList<MetricsRegistry::Entry>& entries);
+
+    // HTTP 요청 전체(헤더 끝까지)에 대한 응답
+    static QByteArray handleRequest(const QByteArray& request);
+
+signals:
+    void logMessage(const QString& message);
+
+private:
+    QThread thread;
+    QTcpServer* listener;       // thread에서 동작
+    quint16 listeningPort;
+
+    static void serveConnection(QTcpSocket* socket);
+};
+
+#endif // METRICSSERVER_H
@@ -1,144 +1,340 @@
 // networkmanager.cpp
 #include "networkmanager.h"
+#include "tracer.h"
+#include "logging.h"
+#include "framecapture.h"
+#include <QCoreApplication>
 #include <QJsonDocument>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
 #include <QDebug>
+#include <QtEndian>
+#include <limits>
 
-NetworkManager::NetworkManager(QObject *parent, bool isServer)
-    : QObject(parent)
-    , isServer(isServer)
-    , server(nullptr)
-    , clientSocket(nullptr)
-    , serverAddress("localhost")
-    , serverPort(1234)
-    , isConnected(false)
+namespace {
+
+// 프로세스 공용 네트워크 I/O 스레드 (처음 만든 NetworkManager가 시작하고 마지막이 종료)
+// 모의 로봇 수십 대를 띄워도 스레드는 하나만 씁니다.
+QMutex& ioThreadMutex()
 {
+    static QMutex mutex;
+    return mutex;
 }
 
-NetworkManager::~NetworkManager()
+QThread* ioThread = nullptr;
+int ioThreadUsers = 0;
+
+std::atomic<bool> localTransport(true);
+std::atomic<int> nextLocalKey(1);
+
+QThread* acquireIoThread()
 {
-    if (isServer) {
-        stopServer();
-    } else {
-        disconnectFromServer();
+    QMutexLocker locker(&ioThreadMutex());
+    if (!ioThread) {
+        ioThread = new QThread;
+        ioThread->setObjectName("NetworkIO");
+        ioThread->start(QThread::HighPriority);
     }
+    ioThreadUsers++;
+    return ioThread;
 }
 
-bool NetworkManager::startServer(quint16 port)
+void releaseIoThread()
 {
-    if (!isServer) {
-        emit errorOccurred("서버 모드로 설정되지 않았습니다");
-        return false;
+    QMutexLocker locker(&ioThreadMutex());
+    if (--ioThreadUsers > 0) {
+        return;
     }
+    ioThread->quit();
+    ioThread->wait();
+    delete ioThread;
+    ioThread = nullptr;
+}
 
-    cleanupServer();
+} // namespace
 
-    server = new QTcpServer(this);
-    if (!server) {
-        emit errorOccurred("서버 객체 생성 실패");
-        return false;
+NetworkWorker::NetworkWorker(NetworkManager* owner, bool isServer)
+    : inbound(InboundCapacity)
+    , outbound(OutboundCapacity)
+    , overflowing(false)
+    , owner(owner)
+    , isServer(isServer)
+    , connecting(false)
+    , server(nullptr)
+    , clientSocket(nullptr)
+    , nextConnectionId(1)
+{
+    MetricsRegistry& metrics = MetricsRegistry::instance();
+    framesSent = metrics.counter("net_frames_sent_total", "전송한 메시지 프레임 수");
+    bytesSent = metrics.counter("net_bytes_sent_total", "전송한 바이트 수");
+    framesReceived = metrics.counter("net_frames_received_total", "수신한 메시지 프레임 수");
+    bytesReceived = metrics.counter("net_bytes_received_total", "수신한 바이트 수");
+    localFramesSent = metrics.counter("net_local_frames_sent_total", "공유 메모리로 전송한 메시지 프레임 수");
+    framesDropped = metrics.counter("net_frames_dropped_total", "느린 구독자에게 보내지 않고 버린 발행 프레임 수");
+    wakeupsSent = metrics.counter("net_local_wakeups_sent_total", "공유 메모리 전송에서 TCP로 보낸 깨우기 신호 수");
+    sendCongestions = metrics.counter("net_send_congested_total", "보내기 대기량이 높은 수위를 넘은 횟수");
+    slowPeersClosed = metrics.counter("net_slow_peers_closed_total", "보내기 대기량이 한도를 넘어 닫은 연결 수");
+    for (int lane = 0; lane < FrameScheduler::LaneCount; ++lane) {
+        const QString labels = QString("lane=\"%1\"").arg(messageLaneName(static_cast<MessageLane>(lane)));
+        laneWait[lane] = metrics.histogram("net_send_queue_wait_us", "보낼 본문이 레인에서 기다린 시간", labels);
     }
+}
+
+bool NetworkWorker::startServer(quint16 port, QString& errorMessage)
+{
+    cleanupServer();
 
+    server = new QTcpServer(this);
     connect(server, &QTcpServer::newConnection,
-            this, &NetworkManager::handleNewConnection);
+            this, &NetworkWorker::handleNewConnection);
 
     if (!server->listen(QHostAddress::Any, port)) {
-        QString errorMsg = QString("서버 시작 실패 (포트: %1) - %2")
-                               .arg(port)
-                               .arg(server->errorString());
-        emit errorOccurred(errorMsg);
+        errorMessage = QString("서버 시작 실패 (포트: %1) - %2")
+                           .arg(port)
+                           .arg(server->errorString());
         cleanupServer();
         return false;
     }
 
-    qDebug() << "서버가 포트" << port << "에서 시작되었습니다";
+    qCInfo(lcNetwork) << "서버가 포트" << port << "에서 시작되었습니다";
     return true;
 }
 
-bool NetworkManager::connectToServer(const QString& address, quint16 port)
+void NetworkWorker::stopServer()
 {
-    if (isServer) {
-        emit errorOccurred("서버 모드에서는 연결할 수 없습니다");
-        return false;
+    if (!server) {
+        return;
     }
 
-    disconnectFromServer();
+    // 이미 맡은 전송은 연결을 닫기 전에 씀
+    drainOutbound();
+    flushLanes();
+    cleanupServer();
 
-    serverAddress = address;
-    serverPort = port;
+    NetworkEvent event;
+    event.type = NetworkEvent::Type::Disconnected;
+    postEvent(std::move(event));
+}
 
+void NetworkWorker::beginConnect(const QString& address, quint16 port, int timeoutMs)
+{
     clientSocket = new QTcpSocket(this);
 
     connect(clientSocket, &QTcpSocket::connected,
-            this, &NetworkManager::handleClientConnected);
+            this, &NetworkWorker::handleClientConnected);
     connect(clientSocket, &QTcpSocket::disconnected,
-            this, &NetworkManager::handleDisconnection);
+            this, &NetworkWorker::handleDisconnection);
     connect(clientSocket, &QTcpSocket::readyRead,
-            this, &NetworkManager::handleRead);
+            this, &NetworkWorker::handleRead);
+    connect(clientSocket, &QTcpSocket::bytesWritten,
+            this, &NetworkWorker::handleBytesWritten);
     connect(clientSocket, &QTcpSocket::errorOccurred,
-            this, &NetworkManager::handleSocketError);
+            this, &NetworkWorker::handleSocketError);
+
+    // 결과는 이벤트 루프에서 handleClientConnected/handleSocketError가 알림
+    // (I/O 스레드를 waitForConnected로 막으면 다른 연결의 수신이 멈춤)
+    connecting = true;
+    QTcpSocket* socket = clientSocket;
+    socket->connectToHost(address, port);
+    QTimer::singleShot(timeoutMs, socket, [this, socket]() {
+        if (socket == clientSocket) {
+            finishConnect(false, "연결 시간이 초과되었습니다");
+        }
+    });
+}
+
+void NetworkWorker::disconnectFromServer(int timeoutMs)
+{
+    connecting = false;
+    if (!clientSocket) {
+        return;
+    }
 
+    drainOutbound();
+    flushLanes();
 
-    clientSocket->connectToHost(address, port);
+    // 남은 데이터를 보내며 닫는 과정은 I/O 스레드에서 이어서 진행하고, 호출한 쪽은 기다리지 않음
+    QTcpSocket* socket = clientSocket;
+    socket->disconnect(this);
+    clientSocket = nullptr;
+    buffer.clear();
+    localChannel.reset();
+    clientLanes.clear();
 
-    if (!clientSocket->waitForConnected(1234)) {
-        emit errorOccurred(QString("서버 연결 실패: %1").arg(clientSocket->errorString()));
-        disconnectFromServer();
-        return false;
+    connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    socket->disconnectFromHost();
+    if (socket->state() == QAbstractSocket::UnconnectedState) {
+        socket->deleteLater();
+    } else {
+        QTimer::singleShot(timeoutMs, socket, [socket]() {
+            socket->abort();
+            socket->deleteLater();
+        });
     }
 
-    qDebug() << "서버에 연결됨:" << address << ":" << port;
-    return true;
+    NetworkEvent event;
+    event.type = NetworkEvent::Type::Disconnected;
+    postEvent(std::move(event));
 }
 
-bool NetworkManager::stopServer()
+void NetworkWorker::shutdown(QThread* target)
 {
-    if (!isServer || !server) {
-        return true;
+    // 이미 맡은 전송은 막지 않는 범위에서 내보낸 뒤 닫음
+    drainOutbound();
+    flushLanes();
+    connecting = false;
+    if (clientSocket) {
+        clientSocket->disconnect(this);
+        clientSocket->flush();
+        clientSocket->abort();
     }
+    clientSocket = nullptr;
+    localChannel.reset();
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        it->socket->disconnect(this);
+        it->socket->flush();
+        it->socket->abort();
+    }
+    clients.clear();
+    if (server) {
+        server->close();
+    }
+    server = nullptr;
 
-    cleanupServer();
-    emit disconnected();
-    return true;
+    // 소켓 알림기는 만든 스레드에서 지워야 하므로 닫는 중인 것까지 여기서 모두 지움
+    qDeleteAll(findChildren<QObject*>(QString(), Qt::FindDirectChildrenOnly));
+
+    // 나머지(객체 자체)는 NetworkManager 스레드에서 지움
+    moveToThread(target);
 }
 
-void NetworkManager::disconnectFromServer()
+void NetworkWorker::drainOutbound()
 {
-    if (isServer || !clientSocket) {
+    do {
+        OutgoingMessage outgoing;
+        while (outbound.pop(outgoing)) {
+            if (!outgoing.encoded.isEmpty()) {
+                writeEncoded(outgoing);
+            } else if (!isServer) {
+                queueFrame(0, outgoing.lane, encodeMessage(outgoing.message));
+            } else if (outgoing.connectionId == BroadcastId) {
+                if (clients.isEmpty()) {
+                    continue;
+                }
+                // 연결이 몇 개든 본문은 한 번만 만듦
+                const QByteArray data = encodeMessage(outgoing.message);
+                for (auto it = clients.constBegin(); it != clients.constEnd(); ++it) {
+                    queueFrame(it.key(), outgoing.lane, data);
+                }
+            } else if (clients.contains(outgoing.connectionId)) {
+                queueFrame(outgoing.connectionId, outgoing.lane, encodeMessage(outgoing.message));
+            }
+        }
+    } while (outbound.finishWake());
+
+    // 한 번에 꺼낸 요청은 레인에 모두 넣은 뒤 넘기므로 늦게 들어온 제어 메시지도 먼저 나감
+    if (!isServer) {
+        pumpLanes(0);
         return;
     }
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        if (!it->lanes.isEmpty()) {
+            pumpLanes(it.key());
+        }
+    }
+}
 
-    clientSocket->disconnectFromHost();
-    if (clientSocket->state() != QAbstractSocket::UnconnectedState) {
-        clientSocket->waitForDisconnected(1000);
+void NetworkWorker::flushOverflow()
+{
+    while (!overflow.isEmpty() && inbound.push(overflow.head())) {
+        overflow.dequeue();
     }
-    cleanupSocket();
-    isConnected = false;
-    emit disconnected();
+    if (overflow.isEmpty()) {
+        overflowing.store(false);
+    }
+    wakeOwner();
 }
 
-bool NetworkManager::isServerRunning() const
+void NetworkWorker::postEvent(NetworkEvent&& event)
 {
-    return isServer && server && server->isListening();
+    // 대기열이 가득 차면 버리거나 기다리지 않고 순서대로 쌓아 두었다가 NetworkManager가 비운 뒤 옮김
+    if (!overflow.isEmpty() || !inbound.push(std::move(event))) {
+        overflow.enqueue(std::move(event));
+        overflowing.store(true);
+    }
+    wakeOwner();
 }
 
-bool NetworkManager::isConnectedToServer() const
+void NetworkWorker::wakeOwner()
+{
+    // 이미 깨울 예정이면 다시 알리지 않음 (수신이 몰리면 한 번 깨어나 모두 처리)
+    if (!inbound.requestWake()) {
+        return;
+    }
+    NetworkManager* manager = owner;
+    QMetaObject::invokeMethod(manager, [manager]() { manager->drainInbound(); }, Qt::QueuedConnection);
+}
+
+void NetworkWorker::finishConnect(bool succeeded, const QString& error)
 {
-    return !isServer && clientSocket &&
-           clientSocket->state() == QAbstractSocket::ConnectedState;
+    if (!connecting) {
+        return;
+    }
+    connecting = false;
+    if (succeeded) {
+        return;
+    }
+
+    // 연결된 적이 없으므로 disconnected 없이 오류만 알림
+    clientSocket->disconnect(this);
+    clientSocket->abort();
+    cleanupSocket();
+
+    NetworkEvent event;
+    event.type = NetworkEvent::Type::Error;
+    event.error = QString("서버 연결 실패: %1").arg(error);
+    postEvent(std::move(event));
 }
 
-void NetworkManager::cleanupSocket()
+void NetworkWorker::cleanupSocket()
 {
     if (clientSocket) {
-        clientSocket->disconnect();
-        delete clientSocket;
+        clientSocket->disconnect(this);
+        clientSocket->deleteLater();
         clientSocket = nullptr;
     }
+    buffer.clear();
+    localChannel.reset();
+    clientLanes.clear();
+    congested.remove(0);
+    stalled.remove(0);
 }
 
-void NetworkManager::cleanupServer()
+void NetworkWorker::cleanupClients()
+{
+    const QList<int> closedIds = clients.keys();
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        it->socket->disconnect(this);
+        it->socket->abort();
+        it->socket->deleteLater();
+        congested.remove(it.key());
+        stalled.remove(it.key());
+    }
+    clients.clear();
+
+    for (int connectionId : closedIds) {
+        NetworkEvent event;
+        event.type = NetworkEvent::Type::ClientDisconnected;
+        event.connectionId = connectionId;
+        postEvent(std::move(event));
+    }
+}
+
+void NetworkWorker::cleanupServer()
 {
     cleanupSocket();
+    cleanupClients();
     if (server) {
         server->close();
         delete server;
@@ -146,81 +342,557 @@ void NetworkManager::cleanupServer()
     }
 }
 
-bool NetworkManager::sendMessage(const Message& message)
+QByteArray NetworkWorker::encodeMessage(const Message& message)
+{
+    const qint64 startedUs = Tracer::enabled() ? MetricsRegistry::nowUs() : 0;
+    QJsonDocument doc(message.toJson());
+    const QByteArray data = doc.toJson(QJsonDocument::Compact);
+    if (Tracer::enabled()) {
+        Tracer::instance().complete(messageTypeName(message.type), "network", startedUs,
+                                    MetricsRegistry::nowUs() - startedUs,
+                                    message.data.value("orderId").toInt(-1));
+    }
+    return data;
+}
+
+void NetworkWorker::configureSocket(QTcpSocket* socket)
+{
+    // 작은 제어 메시지가 앞서 보낸 대량 전송의 ACK를 기다리지 않도록 Nagle을 끔
+    socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, SocketSendBufferBytes);
+}
+
+// 레인을 거치지 않고 바로 씀 (전송 전환처럼 이후 전송 경로를 정하는 메시지)
+bool NetworkWorker::writeMessage(QTcpSocket* socket, LocalChannel* local, const Message& message)
 {
-    if (!clientSocket ||
-        clientSocket->state() != QAbstractSocket::ConnectedState) {
+    if (!socket ||
+        socket->state() != QAbstractSocket::ConnectedState) {
         return false;
     }
+    return writeFrame(socket, local, encodeMessage(message));
+}
 
-    QJsonDocument doc(message.toJson());
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
+bool NetworkWorker::writeFrame(QTcpSocket* socket, LocalChannel* local, const QByteArray& data)
+{
+    if (data.size() > NetworkManager::MaxFramePayload) {
+        qCWarning(lcNetwork) << "본문이" << data.size() << "바이트로 프레임 한도를 넘어 보내지 않습니다";
+        framesDropped->add();
+        return false;
+    }
 
-    // 메시지 크기를 4바이트로 전송
-    QByteArray size = QByteArray::number(data.size());
-    size.prepend(QByteArray(4 - size.size(), '0'));
+    qint64 written;
+    if (local && local->sending) {
+        // 링 기록도 길이 4바이트 + 본문이므로 TCP 프레임과 같은 크기로 셈
+        writeLocal(socket, *local, data);
+        written = 4 + data.size();
+        localFramesSent->add();
+    } else {
+        written = socket->write(NetworkManager::encodeFrame(data));
+        if (written <= 0) {
+            return false;
+        }
+    }
+    FrameRecorder::instance().record(CapturedFrame::Direction::Outgoing,
+                                     socket->property("connectionId").toInt(), data);
+    framesSent->add();
+    bytesSent->add(static_cast<quint64>(written));
+    return true;
+}
+
+void NetworkWorker::writeEncoded(const OutgoingMessage& outgoing)
+{
+    for (int connectionId : outgoing.targets) {
+        auto it = clients.constFind(connectionId);
+        if (it == clients.constEnd() ||
+            it->socket->state() != QAbstractSocket::ConnectedState) {
+            continue;
+        }
 
-    return clientSocket->write(size + data) > 0;
+        // 발행자가 혼잡 알림을 받기 전에 보낸 본문은 여기서 버림 (읽지 않는 구독자 몫은 쌓지 않음)
+        if (congested.contains(connectionId)) {
+            framesDropped->add();
+            continue;
+        }
+        queueFrame(connectionId, outgoing.lane, outgoing.encoded);
+    }
 }
 
-void NetworkManager::handleNewConnection()
+void NetworkWorker::handleNewConnection()
 {
-    cleanupSocket();
+    while (QTcpSocket* socket = server->nextPendingConnection()) {
+        const int connectionId = nextConnectionId++;
+        socket->setProperty("connectionId", connectionId);
+        configureSocket(socket);
 
-    clientSocket = server->nextPendingConnection();
-    if (!clientSocket) {
-        return;
+        connect(socket, &QTcpSocket::disconnected,
+                this, &NetworkWorker::handleDisconnection);
+        connect(socket, &QTcpSocket::readyRead,
+                this, &NetworkWorker::handleRead);
+        connect(socket, &QTcpSocket::bytesWritten,
+                this, &NetworkWorker::handleBytesWritten);
+        connect(socket, &QTcpSocket::errorOccurred,
+                this, &NetworkWorker::handleSocketError);
+
+        ClientConnection connection;
+        connection.socket = socket;
+        clients.insert(connectionId, connection);
+
+        qCInfo(lcNetwork) << "클라이언트 연결됨 (연결 ID:" << connectionId << ")";
+        NetworkEvent event;
+        event.type = NetworkEvent::Type::ClientConnected;
+        event.connectionId = connectionId;
+        postEvent(std::move(event));
+        event = NetworkEvent();
+        event.type = NetworkEvent::Type::Connected;
+        postEvent(std::move(event));
     }
+}
 
-    connect(clientSocket, &QTcpSocket::disconnected,
-            this, &NetworkManager::handleDisconnection);
-    connect(clientSocket, &QTcpSocket::readyRead,
-            this, &NetworkManager::handleRead);
-    connect(clientSocket, &QTcpSocket::errorOccurred,
-            this, &NetworkManager::handleSocketError);
+void NetworkWorker::handleClientConnected()
+{
+    configureSocket(clientSocket);
+    offerLocalChannel();
 
-    isConnected = true;
-    emit connected();
+    qCInfo(lcNetwork) << "서버에 연결됨:" << clientSocket->peerName() << ":" << clientSocket->peerPort();
+    finishConnect(true, QString());
+    NetworkEvent event;
+    event.type = NetworkEvent::Type::Connected;
+    postEvent(std::move(event));
 }
 
-void NetworkManager::handleClientConnected()
+void NetworkWorker::handleDisconnection()
 {
-    isConnected = true;
-    emit connected();
+    if (!isServer) {
+        // 끊기기 전에 링에 남은 본문부터 전달
+        drainLocal(0);
+        NetworkEvent event;
+        event.type = NetworkEvent::Type::Disconnected;
+        postEvent(std::move(event));
+        cleanupSocket();
+        return;
+    }
+
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
+
+    const int connectionId = socket->property("connectionId").toInt();
+    drainLocal(connectionId);
+    clients.remove(connectionId);
+    congested.remove(connectionId);
+    stalled.remove(connectionId);
+    socket->deleteLater();
+
+    NetworkEvent event;
+    event.type = NetworkEvent::Type::ClientDisconnected;
+    event.connectionId = connectionId;
+    postEvent(std::move(event));
+    event = NetworkEvent();
+    event.type = NetworkEvent::Type::Disconnected;
+    postEvent(std::move(event));
 }
 
-void NetworkManager::handleDisconnection()
+void NetworkWorker::handleRead()
 {
-    isConnected = false;
-    emit disconnected();
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
 
     if (!isServer) {
-        cleanupSocket();
+        buffer.append(socket->readAll());
+        processBuffer(buffer, 0);
+        return;
+    }
+
+    const int connectionId = socket->property("connectionId").toInt();
+    auto it = clients.find(connectionId);
+    if (it == clients.end()) return;
+
+    // 메시지는 대기열에 넣기만 하므로 처리 중에 clients가 바뀌지 않음
+    it->buffer.append(socket->readAll());
+    processBuffer(it->buffer, connectionId);
+}
+
+void NetworkWorker::processBuffer(QByteArray& data, int connectionId)
+{
+    while (!data.isEmpty()) {
+        // 공유 메모리 전송의 깨우기 신호
+        const char first = data.at(0);
+        if (first == DataReady || first == SpaceFreed) {
+            data.remove(0, 1);
+            if (first == DataReady) {
+                drainLocal(connectionId);
+            } else if (LocalChannel* local = localFor(connectionId)) {
+                flushLocal(socketFor(connectionId), *local);
+                pumpLanes(connectionId);
+            }
+            continue;
+        }
+
+        if (data.size() < 4) break;
+        const quint32 frameSize = qFromBigEndian<quint32>(data.constData());
+        if (frameSize > static_cast<quint32>(NetworkManager::MaxFramePayload)) {
+            // 프레임 경계를 잃음: 이후 바이트는 해석할 수 없으므로 버리고 연결을 닫음
+            qCWarning(lcNetwork) << "연결" << connectionId << "에서 잘못된 프레임 크기" << frameSize
+                                 << "를 받아 연결을 닫습니다";
+            data.clear();
+            if (QTcpSocket* socket = socketFor(connectionId)) {
+                // 받은 버퍼를 처리하는 중이므로 닫기(와 disconnected 처리)는 다음 이벤트에서
+                QMetaObject::invokeMethod(socket, [socket]() { socket->abort(); }, Qt::QueuedConnection);
+            }
+            break;
+        }
+        const int messageSize = static_cast<int>(frameSize);
+        if (data.size() < 4 + messageSize) break;
+
+        QByteArray messageData = data.mid(4, messageSize);
+        data.remove(0, 4 + messageSize);
+        bytesReceived->add(static_cast<quint64>(4 + messageSize));
+        deliverFrame(messageData, connectionId);
     }
 }
 
-void NetworkManager::handleRead()
+void NetworkWorker::deliverFrame(const QByteArray& messageData, int connectionId)
 {
+    framesReceived->add();
+    FrameRecorder::instance().record(CapturedFrame::Direction::Incoming, connectionId, messageData);
+
+    QJsonDocument doc = QJsonDocument::fromJson(messageData);
+    if (!doc.isObject()) {
+        return;
+    }
+
+    NetworkEvent event;
+    event.type = NetworkEvent::Type::Message;
+    event.connectionId = connectionId;
+    event.message = Message::fromJson(doc.object());
+    if (event.message.type == MessageType::TRANSPORT_SWITCH) {
+        handleTransportSwitch(connectionId, event.message.data);
+        return;
+    }
+    postEvent(std::move(event));
+}
+
+void NetworkWorker::handleBytesWritten()
+{
+    // 소켓이 비워지는 만큼 레인에서 이어서 넘김
     QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
     if (!socket) return;
+    pumpLanes(isServer ? socket->property("connectionId").toInt() : 0);
+}
+
+FrameScheduler* NetworkWorker::lanesFor(int connectionId)
+{
+    if (!isServer) {
+        return &clientLanes;
+    }
+    auto it = clients.find(connectionId);
+    return it != clients.end() ? &it->lanes : nullptr;
+}
+
+void NetworkWorker::queueFrame(int connectionId, MessageLane lane, const QByteArray& data)
+{
+    QTcpSocket* socket = socketFor(connectionId);
+    FrameScheduler* lanes = lanesFor(connectionId);
+    if (!socket || !lanes || socket->state() != QAbstractSocket::ConnectedState ||
+        stalled.contains(connectionId)) {
+        return;
+    }
+    lanes->push(lane, data, MetricsRegistry::nowUs());
+    updateBackpressure(connectionId);
+}
+
+void NetworkWorker::pumpLanes(int connectionId, qint64 windowBytes)
+{
+    FrameScheduler* lanes = lanesFor(connectionId);
+    if (!lanes) {
+        return;
+    }
+    if (lanes->isEmpty()) {
+        // 레인이 비어도 소켓(또는 링)이 비워지면 혼잡 해소를 알려야 함
+        updateBackpressure(connectionId);
+        return;
+    }
+    QTcpSocket* socket = socketFor(connectionId);
+    if (!socket || socket->state() != QAbstractSocket::ConnectedState) {
+        lanes->clear();
+        return;
+    }
+
+    LocalChannel* local = localFor(connectionId);
+    FrameScheduler::Frame frame;
+    while (!lanes->isEmpty()) {
+        if (unsentBytes(socket, local) >= windowBytes) {
+            // TCP는 bytesWritten으로 다시 불림. 링은 상대가 읽어도 알리지 않으므로
+            // 자리가 나면 SpaceFreed를 보내 달라고 표시한 뒤, 그 사이에 읽었는지 한 번 더 확인
+            if (!local || !local->sending) {
+                break;
+            }
+            local->outgoing.markWriterWaiting();
+            if (unsentBytes(socket, local) >= windowBytes) {
+                break;
+            }
+        }
+        lanes->pop(frame);
+        laneWait[static_cast<int>(frame.lane)]->record(
+            static_cast<quint64>(qMax<qint64>(0, MetricsRegistry::nowUs() - frame.queuedUs)));
+        writeFrame(socket, local, frame.payload);
+    }
+    updateBackpressure(connectionId);
+}
+
+void NetworkWorker::flushLanes()
+{
+    // 연결을 닫기 전에는 창 크기와 상관없이 레인에 남은 본문을 모두 넘김
+    const qint64 unlimited = std::numeric_limits<qint64>::max();
+    if (!isServer) {
+        pumpLanes(0, unlimited);
+        return;
+    }
+    for (auto it = clients.begin(); it != clients.end(); ++it) {
+        pumpLanes(it.key(), unlimited);
+    }
+}
+
+qint64 NetworkWorker::unsentBytes(QTcpSocket* socket, LocalChannel* local) const
+{
+    qint64 unsent = socket->bytesToWrite();
+    if (local && local->sending) {
+        unsent += local->outgoing.usedBytes() + local->pendingBytes;
+    }
+    return unsent;
+}
+
+void NetworkWorker::updateBackpressure(int connectionId)
+{
+    QTcpSocket* socket = socketFor(connectionId);
+    FrameScheduler* lanes = lanesFor(connectionId);
+    if (!socket || !lanes || stalled.contains(connectionId)) {
+        return;
+    }
+    LocalChannel* local = localFor(connectionId);
+    qint64 queued = unsentBytes(socket, local) + lanes->queuedBytes();
+
+    if (queued > SendQueueLimit) {
+        // 혼잡을 알린 뒤에도 계속 쌓임: 읽지 않는 상대로 보고 남은 본문을 버린 뒤 닫음
+        qCWarning(lcNetwork) << "연결" << connectionId << "의 보내기 대기량이" << queued
+                             << "바이트로 한도를 넘어 연결을 닫습니다";
+        slowPeersClosed->add();
+        lanes->clear();
+        stalled.insert(connectionId);
+        NetworkEvent event;
+        event.type = NetworkEvent::Type::Error;
+        event.error = QString("연결 %1이(가) 데이터를 읽지 않아 연결을 닫습니다").arg(connectionId);
+        postEvent(std::move(event));
+        // 연결 목록을 도는 중일 수 있으므로 닫기(와 disconnected 처리)는 다음 이벤트에서
+        QMetaObject::invokeMethod(socket, [socket]() { socket->abort(); }, Qt::QueuedConnection);
+        return;
+    }
+
+    if (!congested.contains(connectionId)) {
+        if (queued < SendHighWatermark) {
+            return;
+        }
+        congested.insert(connectionId);
+        sendCongestions->add();
+        NetworkEvent event;
+        event.type = NetworkEvent::Type::SendCongested;
+        event.connectionId = connectionId;
+        postEvent(std::move(event));
+        return;
+    }
+
+    if (queued > SendLowWatermark && local && local->sending) {
+        // 링은 상대가 읽어도 알리지 않으므로 자리가 나면 SpaceFreed를 보내 달라고 표시한 뒤 다시 셈
+        local->outgoing.markWriterWaiting();
+        queued = unsentBytes(socket, local) + lanes->queuedBytes();
+    }
+    if (queued > SendLowWatermark) {
+        return;
+    }
+    congested.remove(connectionId);
+    NetworkEvent event;
+    event.type = NetworkEvent::Type::SendDrained;
+    event.connectionId = connectionId;
+    postEvent(std::move(event));
+}
+
+QTcpSocket* NetworkWorker::socketFor(int connectionId) const
+{
+    if (!isServer) {
+        return clientSocket;
+    }
+    auto it = clients.constFind(connectionId);
+    return it != clients.constEnd() ? it->socket : nullptr;
+}
+
+LocalChannel* NetworkWorker::localFor(int connectionId) const
+{
+    if (!isServer) {
+        return localChannel.data();
+    }
+    auto it = clients.constFind(connectionId);
+    return it != clients.constEnd() ? it->local.data() : nullptr;
+}
 
-    buffer.append(socket->readAll());
+void NetworkWorker::offerLocalChannel()
+{
+    if (!NetworkManager::localTransportEnabled() || !clientSocket->peerAddress().isLoopback()) {
+        return;
+    }
 
-    while (buffer.size() >= 4) {
-        int messageSize = buffer.left(4).toInt();
-        if (buffer.size() < 4 + messageSize) break;
+    // 같은 프로세스에 모의 로봇이 여러 대 있어도 겹치지 않도록 프로세스 ID와 일련번호로 키를 만듦
+    QSharedPointer<LocalChannel> channel(new LocalChannel);
+    channel->memory.setKey(QString("sandwich-net-%1-%2")
+                               .arg(QCoreApplication::applicationPid())
+                               .arg(nextLocalKey++));
+    const int ringBytes = SharedMemoryRing::bytesFor(LocalRingCapacity);
+    if (!channel->memory.create(2 * ringBytes)) {
+        qCWarning(lcNetwork) << "공유 메모리 전송을 만들지 못해 TCP를 사용합니다:"
+                             << channel->memory.errorString();
+        return;
+    }
+
+    char* base = static_cast<char*>(channel->memory.data());
+    channel->outgoing.bind(base, LocalRingCapacity);
+    channel->incoming.bind(base + ringBytes, LocalRingCapacity);
+    channel->outgoing.initialize();
+    channel->incoming.initialize();
+    localChannel = channel;
 
-        QByteArray messageData = buffer.mid(4, messageSize);
-        buffer.remove(0, 4 + messageSize);
+    // 서버가 받아들이면 같은 TCP 흐름으로 답이 오고, 그때부터 보내기를 링으로 바꿈
+    Message offer;
+    offer.type = MessageType::TRANSPORT_SWITCH;
+    offer.data["key"] = channel->memory.key();
+    offer.data["capacity"] = LocalRingCapacity;
+    writeMessage(clientSocket, nullptr, offer);
+}
+
+void NetworkWorker::handleTransportSwitch(int connectionId, const QJsonObject& data)
+{
+    const QString key = data.value("key").toString();
 
-        QJsonDocument doc = QJsonDocument::fromJson(messageData);
-        if (doc.isObject()) {
-            emit messageReceived(Message::fromJson(doc.object()));
+    if (!isServer) {
+        if (!localChannel || localChannel->sending || key != localChannel->memory.key()) {
+            return;
+        }
+        if (data.value("accepted").toBool()) {
+            localChannel->sending = true;
+            qCInfo(lcNetwork) << "같은 호스트 서버와 공유 메모리 전송으로 전환했습니다";
+        } else {
+            localChannel.reset();
+            qCInfo(lcNetwork) << "서버가 공유 메모리 전송을 쓰지 않아 TCP로 통신합니다";
         }
+        return;
     }
+
+    auto it = clients.find(connectionId);
+    if (it == clients.end() || it->local) {
+        return;
+    }
+
+    // 다른 호스트에서 온 요청은 받지 않음 (키가 가리키는 메모리는 이 호스트에만 있음)
+    QSharedPointer<LocalChannel> channel(new LocalChannel);
+    const int capacity = data.value("capacity").toInt();
+    const int ringBytes = SharedMemoryRing::bytesFor(capacity);
+    bool accepted = false;
+    if (NetworkManager::localTransportEnabled() && capacity == LocalRingCapacity &&
+        it->socket->peerAddress().isLoopback()) {
+        channel->memory.setKey(key);
+        if (!channel->memory.attach()) {
+            qCWarning(lcNetwork) << "공유 메모리 전송에 연결하지 못해 TCP를 사용합니다:"
+                                 << channel->memory.errorString();
+        } else {
+            accepted = channel->memory.size() >= 2 * ringBytes;
+        }
+    }
+
+    // 답은 TCP로 보내고, 그 뒤로 이 연결에 보내는 본문은 모두 링으로 감
+    Message reply;
+    reply.type = MessageType::TRANSPORT_SWITCH;
+    reply.data["key"] = key;
+    reply.data["accepted"] = accepted;
+    writeMessage(it->socket, nullptr, reply);
+    if (!accepted) {
+        return;
+    }
+
+    char* base = static_cast<char*>(channel->memory.data());
+    channel->incoming.bind(base, capacity);
+    channel->outgoing.bind(base + ringBytes, capacity);
+    channel->sending = true;
+    it->local = channel;
+    qCInfo(lcNetwork) << "연결" << connectionId << "을(를) 공유 메모리 전송으로 전환했습니다";
 }
 
-void NetworkManager::handleSocketError(QAbstractSocket::SocketError socketError)
+void NetworkWorker::writeLocal(QTcpSocket* socket, LocalChannel& local, const QByteArray& payload)
+{
+    // 앞서 못 쓴 본문이 있으면 그 뒤에 이어서 씀
+    local.pending.enqueue(payload);
+    local.pendingBytes += payload.size();
+    flushLocal(socket, local);
+}
+
+void NetworkWorker::flushLocal(QTcpSocket* socket, LocalChannel& local)
+{
+    bool wrote = false;
+    while (!local.pending.isEmpty()) {
+        // 큰 본문은 LocalFragmentBytes씩 나눠 쓰고, 받는 쪽 링의 read가 다시 이어 붙임
+        const QByteArray& payload = local.pending.head();
+        const int size = qMin(payload.size() - local.pendingOffset, LocalFragmentBytes);
+        const bool more = local.pendingOffset + size < payload.size();
+        const char* fragment = payload.constData() + local.pendingOffset;
+        if (!local.outgoing.write(fragment, size, more)) {
+            // 상대가 읽고 나면 SpaceFreed로 알려 달라고 표시한 뒤, 그 사이에 자리가 났는지 한 번 더 확인
+            local.outgoing.markWriterWaiting();
+            if (!local.outgoing.write(fragment, size, more)) {
+                break;
+            }
+        }
+        local.pendingBytes -= size;
+        wrote = true;
+        if (more) {
+            local.pendingOffset += size;
+        } else {
+            local.pending.dequeue();
+            local.pendingOffset = 0;
+        }
+    }
+
+    // 상대가 이미 깨어날 예정이면 신호를 보내지 않음 (몰려서 보내도 시스템 호출은 한 번)
+    if (wrote && local.outgoing.requestWake()) {
+        sendWakeup(socket, DataReady);
+    }
+}
+
+void NetworkWorker::drainLocal(int connectionId)
+{
+    LocalChannel* local = localFor(connectionId);
+    if (!local) {
+        return;
+    }
+
+    do {
+        QByteArray payload;
+        while (local->incoming.read(payload)) {
+            bytesReceived->add(static_cast<quint64>(4 + payload.size()));
+            deliverFrame(payload, connectionId);
+        }
+    } while (local->incoming.finishWake());
+
+    if (local->incoming.takeWriterWaiting()) {
+        sendWakeup(socketFor(connectionId), SpaceFreed);
+    }
+}
+
+void NetworkWorker::sendWakeup(QTcpSocket* socket, char signal)
+{
+    if (!socket || socket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+    socket->write(&signal, 1);
+    wakeupsSent->add();
+}
+
+void NetworkWorker::handleSocketError(QAbstractSocket::SocketError socketError)
 {
     QString errorMsg = isServer ? "서버 오류: " : "클라이언트 오류: ";
 
@@ -250,5 +922,266 @@ void NetworkManager::handleSocketError(QAbstractSocket::SocketError socketError)
         errorMsg += "알 수 없는 오류가 발생했습니다";
     }
 
-    emit errorOccurred(errorMsg);
+    NetworkEvent event;
+    event.type = NetworkEvent::Type::Error;
+    event.error = errorMsg;
+    postEvent(std::move(event));
+
+    QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+    if (socket && socket == clientSocket) {
+        finishConnect(false, socket->errorString());
+    }
+}
+
+template <typename Function>
+void NetworkManager::runOnWorker(Function function)
+{
+    QMetaObject::invokeMethod(worker, function, Qt::BlockingQueuedConnection);
+}
+
+NetworkManager::NetworkManager(QObject *parent, bool isServer)
+    : QObject(parent)
+    , isServer(isServer)
+    , serverRunning(false)
+    , isConnected(false)
+    , connectTimeoutMs(1234)
+    , disconnectTimeoutMs(1000)
+{
+    worker = new NetworkWorker(this, isServer);
+    worker->moveToThread(acquireIoThread());
+}
+
+NetworkManager::~NetworkManager()
+{
+    // I/O 스레드에서 소켓을 모두 닫은 뒤 객체만 이 스레드로 돌려받아 지움
+    QThread* current = QThread::currentThread();
+    runOnWorker([this, current]() { worker->shutdown(current); });
+    delete worker;
+    releaseIoThread();
+}
+
+bool NetworkManager::startServer(quint16 port)
+{
+    if (!isServer) {
+        emit errorOccurred("서버 모드로 설정되지 않았습니다");
+        return false;
+    }
+
+    bool started = false;
+    QString error;
+    runOnWorker([this, port, &started, &error]() {
+        started = worker->startServer(port, error);
+    });
+    serverRunning = started;
+    drainInbound();
+
+    if (!started) {
+        emit errorOccurred(error);
+        return false;
+    }
+    return true;
+}
+
+bool NetworkManager::connectToServer(const QString& address, quint16 port)
+{
+    if (isServer) {
+        emit errorOccurred("서버 모드에서는 연결할 수 없습니다");
+        return false;
+    }
+
+    disconnectFromServer();
+
+    // 결과는 I/O 스레드가 이벤트로 알리므로 호출한 스레드(화면 스레드 등)는 기다리지 않음
+    const int timeoutMs = connectTimeoutMs;
+    runOnWorker([this, address, port, timeoutMs]() { worker->beginConnect(address, port, timeoutMs); });
+    return true;
+}
+
+void NetworkManager::setTimeouts(int connectMs, int disconnectMs)
+{
+    connectTimeoutMs = qMax(1, connectMs);
+    disconnectTimeoutMs = qMax(0, disconnectMs);
+}
+
+bool NetworkManager::stopServer()
+{
+    if (!isServer || !serverRunning) {
+        return true;
+    }
+
+    runOnWorker([this]() { worker->stopServer(); });
+    serverRunning = false;
+    drainInbound();
+    return true;
+}
+
+void NetworkManager::disconnectFromServer()
+{
+    if (isServer) {
+        return;
+    }
+
+    const int timeoutMs = disconnectTimeoutMs;
+    runOnWorker([this, timeoutMs]() { worker->disconnectFromServer(timeoutMs); });
+    drainInbound();
+}
+
+bool NetworkManager::isServerRunning() const
+{
+    return isServer && serverRunning;
+}
+
+bool NetworkManager::isConnectedToServer() const
+{
+    return !isServer && isConnected;
+}
+
+bool NetworkManager::sendMessage(const Message& message)
+{
+    return sendMessage(message, messageLane(message));
+}
+
+bool NetworkManager::sendMessage(const Message& message, MessageLane lane)
+{
+    if (!isServer) {
+        if (!isConnected) {
+            return false;
+        }
+        enqueue(0, message, lane);
+        return true;
+    }
+
+    if (clients.isEmpty()) {
+        return false;
+    }
+    enqueue(NetworkWorker::BroadcastId, message, lane);
+    return true;
+}
+
+bool NetworkManager::sendMessageTo(int connectionId, const Message& message)
+{
+    return sendMessageTo(connectionId, message, messageLane(message));
+}
+
+bool NetworkManager::sendMessageTo(int connectionId, const Message& message, MessageLane lane)
+{
+    if (!clients.contains(connectionId)) {
+        return false;
+    }
+    enqueue(connectionId, message, lane);
+    return true;
+}
+
+bool NetworkManager::sendEncoded(const QVector<int>& connectionIds, const QByteArray& payload, MessageLane lane)
+{
+    if (!isServer || payload.isEmpty() || connectionIds.isEmpty()) {
+        return false;
+    }
+
+    OutgoingMessage outgoing;
+    outgoing.encoded = payload;
+    outgoing.targets = connectionIds;
+    outgoing.lane = lane;
+    pushOutgoing(std::move(outgoing));
+    return true;
+}
+
+void NetworkManager::enqueue(int connectionId, const Message& message, MessageLane lane)
+{
+    OutgoingMessage outgoing;
+    outgoing.connectionId = connectionId;
+    outgoing.message = message;
+    outgoing.lane = lane;
+    pushOutgoing(std::move(outgoing));
+}
+
+void NetworkManager::pushOutgoing(OutgoingMessage&& outgoing)
+{
+    // 가득 차면 I/O 스레드가 비울 때까지 기다림 (보낼 메시지는 버리지 않음)
+    while (!worker->outbound.push(std::move(outgoing))) {
+        runOnWorker([this]() { worker->drainOutbound(); });
+    }
+
+    if (worker->outbound.requestWake()) {
+        NetworkWorker* target = worker;
+        QMetaObject::invokeMethod(target, [target]() { target->drainOutbound(); }, Qt::QueuedConnection);
+    }
+}
+
+void NetworkManager::drainInbound()
+{
+    do {
+        NetworkEvent event;
+        while (worker->inbound.pop(event)) {
+            dispatchEvent(event);
+        }
+    } while (worker->inbound.finishWake());
+
+    // 깨우기 플래그를 내린 뒤에 확인해야 I/O 스레드가 막 쌓은 이벤트를 놓치지 않음
+    if (worker->overflowing.load()) {
+        NetworkWorker* target = worker;
+        QMetaObject::invokeMethod(target, [target]() { target->flushOverflow(); }, Qt::QueuedConnection);
+    }
+}
+
+void NetworkManager::dispatchEvent(const NetworkEvent& event)
+{
+    switch (event.type) {
+    case NetworkEvent::Type::Message:
+        if (isServer) {
+            emit messageReceivedFrom(event.connectionId, event.message);
+        }
+        emit messageReceived(event.message);
+        break;
+    case NetworkEvent::Type::ClientConnected:
+        clients.append(event.connectionId);
+        emit clientConnected(event.connectionId);
+        break;
+    case NetworkEvent::Type::ClientDisconnected:
+        clients.removeAll(event.connectionId);
+        congestedIds.remove(event.connectionId);
+        emit clientDisconnected(event.connectionId);
+        break;
+    case NetworkEvent::Type::Connected:
+        isConnected = true;
+        emit connected();
+        break;
+    case NetworkEvent::Type::Disconnected:
+        isConnected = isServer && !clients.isEmpty();
+        if (!isServer) {
+            congestedIds.clear();
+        }
+        emit disconnected();
+        break;
+    case NetworkEvent::Type::Error:
+        emit errorOccurred(event.error);
+        break;
+    case NetworkEvent::Type::SendCongested:
+        congestedIds.insert(event.connectionId);
+        emit sendBackpressure(event.connectionId, true);
+        break;
+    case NetworkEvent::Type::SendDrained:
+        congestedIds.remove(event.connectionId);
+        emit sendBackpressure(event.connectionId, false);
+        break;
+    }
+}
+
+void NetworkManager::setLocalTransportEnabled(bool enabled)
+{
+    localTransport.store(enabled);
+}
+
+bool NetworkManager::localTransportEnabled()
+{
+    return localTransport.load();
+}
+
+QByteArray NetworkManager::encodeFrame(const QByteArray& payload)
+{
+    // 메시지 크기를 4바이트 빅 엔디언으로 전송 (자릿수 제한 없이 MaxFramePayload까지)
+    QByteArray frame(4 + payload.size(), Qt::Uninitialized);
+    qToBigEndian<quint32>(static_cast<quint32>(payload.size()), frame.data());
+    memcpy(frame.data() + 4, payload.constData(), static_cast<size_t>(payload.size()));
+    return frame;
 }
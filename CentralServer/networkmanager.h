@@ -7,9 +7,200 @@
 #include <QTcpSocket>
 #include <QHostAddress>
 #include <QJsonDocument>
+#include <QMap>
+#include <QQueue>
+#include <QSharedMemory>
+#include <QSet>
+#include <QSharedPointer>
 #include <QDebug>
+#include <atomic>
 #include "message.h"
+#include "metrics.h"
+#include "spscqueue.h"
+#include "sharedmemoryring.h"
+#include "framescheduler.h"
 
+class NetworkManager;
+
+// I/O 스레드가 호출한 쪽 스레드로 넘기는 네트워크 이벤트 (수신 메시지는 이미 디코딩된 상태)
+struct NetworkEvent {
+    enum class Type {
+        Message,
+        ClientConnected,
+        ClientDisconnected,
+        Connected,
+        Disconnected,
+        Error,
+        SendCongested,      // 보내지 못한 양이 높은 수위를 넘음
+        SendDrained         // 낮은 수위 아래로 내려감
+    };
+
+    Type type = Type::Message;
+    int connectionId = 0;
+    Message message;
+    QString error;
+};
+
+// 호출한 쪽 스레드가 I/O 스레드로 넘기는 전송 요청
+struct OutgoingMessage {
+    int connectionId = 0;   // 서버 모드에서 BroadcastId면 연결된 모든 클라이언트
+    Message message;
+    QByteArray encoded;     // 비어 있지 않으면 message 대신 이미 만든 본문을 targets에 전송
+    QVector<int> targets;
+    MessageLane lane = MessageLane::ORDERS;
+};
+
+// 같은 호스트 연결의 공유 메모리 전송 (방향마다 링 하나)
+// 영역은 클라이언트가 만들고 서버가 붙습니다: [클라이언트 -> 서버 링][서버 -> 클라이언트 링]
+// TCP 연결은 그대로 두고 연결 감지와 깨우기 신호(1바이트)에만 씁니다.
+struct LocalChannel {
+    QSharedMemory memory;
+    SharedMemoryRing incoming;
+    SharedMemoryRing outgoing;
+    QQueue<QByteArray> pending;     // 보내는 링이 가득 차서 아직 못 쓴 본문 (순서 유지)
+    int pendingOffset = 0;          // pending 맨 앞 본문에서 이미 조각으로 쓴 바이트
+    qint64 pendingBytes = 0;
+    bool sending = false;           // 보내기를 공유 메모리로 전환했는지
+};
+
+// 네트워크 I/O 스레드에서 소켓을 소유하고 프레임 분리, JSON 부호화/복호화를 맡는 객체
+// NetworkManager만 생성하고 사용합니다. 두 대기열 모두 단일 생산자/단일 소비자입니다.
+class NetworkWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int BroadcastId = -1;
+    static const int InboundCapacity = 4096;
+    static const int OutboundCapacity = 4096;
+    static const int LocalRingCapacity = 256 * 1024;    // 방향별 공유 메모리 링 크기 (바이트)
+    // 이보다 큰 본문은 링에 조각으로 나눠 씀 (링보다 큰 본문도 보내고, 상대가 읽는 동안 이어 씀)
+    static const int LocalFragmentBytes = LocalRingCapacity / 4;
+    // 연결별 보내기 대기량 (레인 + 소켓/링에 넘겼지만 아직 못 보낸 바이트)
+    // 높은 수위를 넘으면 SendCongested, 낮은 수위 아래로 내려가면 SendDrained를 한 번씩 알림
+    // 한도를 넘으면 상대가 멈춘 것으로 보고 연결을 끊음 (혼잡을 알린 뒤에도 계속 밀린 경우)
+    static const int SendHighWatermark = 256 * 1024;
+    static const int SendLowWatermark = 64 * 1024;
+    static const int SendQueueLimit = 8 * 1024 * 1024;
+    static const int SendWindowBytes = 16 * 1024;       // 소켓(또는 링)에 미리 넘겨 두는 최대 바이트, 나머지는 레인에서 기다림
+    static const int SocketSendBufferBytes = 64 * 1024; // 커널 송신 버퍼도 작게 두어 제어 메시지가 기다리는 양을 제한
+
+    // 공유 메모리 전송에서 TCP로 보내는 깨우기 신호
+    // 프레임 크기 접두어의 첫 바이트는 본문이 NetworkManager::MaxFramePayload 이하라 항상 0이므로 겹치지 않음
+    static const char DataReady = '!';      // 받는 링에 새 본문이 있음
+    static const char SpaceFreed = '~';     // 보내는 링에 자리가 남
+
+    NetworkWorker(NetworkManager* owner, bool isServer);
+
+    // 아래는 모두 I/O 스레드에서 실행
+    bool startServer(quint16 port, QString& errorMessage);
+    void stopServer();
+    void beginConnect(const QString& address, quint16 port, int timeoutMs);
+    void disconnectFromServer(int timeoutMs);
+    void shutdown(QThread* target);
+    void drainOutbound();
+    void flushOverflow();
+
+    // I/O 스레드 -> 호출한 쪽 스레드
+    SpscQueue<NetworkEvent> inbound;
+    // 호출한 쪽 스레드 -> I/O 스레드
+    SpscQueue<OutgoingMessage> outbound;
+
+    // 수신 대기열이 가득 차서 I/O 스레드 쪽에 쌓아 둔 이벤트가 있음
+    std::atomic<bool> overflowing;
+
+private slots:
+    void handleNewConnection();
+    void handleClientConnected();
+    void handleDisconnection();
+    void handleRead();
+    void handleBytesWritten();
+    void handleSocketError(QAbstractSocket::SocketError socketError);
+
+private:
+    NetworkManager* owner;     // 이벤트를 받는 NetworkManager (다른 스레드)
+    bool isServer;
+    bool connecting;        // beginConnect 후 결과(연결, 오류, 시간 초과)를 아직 알리지 않음
+
+    // 네트워크 객체
+    QTcpServer* server;
+    QTcpSocket* clientSocket;     // 클라이언트 모드 소켓
+    QByteArray buffer;
+    QSharedPointer<LocalChannel> localChannel;  // 클라이언트 모드 공유 메모리 전송
+    FrameScheduler clientLanes;                 // 클라이언트 모드 보내기 레인
+
+    // 서버 모드 연결 (연결 ID별 소켓과 수신 버퍼)
+    struct ClientConnection {
+        QTcpSocket* socket;
+        QByteArray buffer;
+        QSharedPointer<LocalChannel> local;     // 공유 메모리로 전환했으면 null 아님
+        FrameScheduler lanes;                   // 아직 소켓에 넘기지 않은 본문
+    };
+    QMap<int, ClientConnection> clients;
+    int nextConnectionId;
+    QSet<int> congested;        // 혼잡을 알린 연결 (클라이언트 모드는 0)
+    QSet<int> stalled;          // 한도를 넘어 닫는 중인 연결 (더 보내지 않음)
+
+    // 수신 대기열이 가득 찼을 때 잠시 보관 (버리지 않고 순서를 유지)
+    QQueue<NetworkEvent> overflow;
+
+    // 송수신 지표 (프레임 수, 크기 접두어를 포함한 바이트 수)
+    MetricCounter* framesSent;
+    MetricCounter* bytesSent;
+    MetricCounter* framesReceived;
+    MetricCounter* bytesReceived;
+    MetricCounter* localFramesSent;
+    MetricCounter* framesDropped;
+    MetricCounter* wakeupsSent;
+    MetricCounter* sendCongestions;
+    MetricCounter* slowPeersClosed;
+    MetricHistogram* laneWait[FrameScheduler::LaneCount];  // 레인에 들어와서 소켓에 넘어가기까지
+
+    void postEvent(NetworkEvent&& event);
+    void wakeOwner();
+    void finishConnect(bool succeeded, const QString& error);
+    void cleanupSocket();
+    void cleanupClients();
+    void cleanupServer();
+    void configureSocket(QTcpSocket* socket);
+    QByteArray encodeMessage(const Message& message);
+    bool writeMessage(QTcpSocket* socket, LocalChannel* local, const Message& message);
+    bool writeFrame(QTcpSocket* socket, LocalChannel* local, const QByteArray& data);
+    void writeEncoded(const OutgoingMessage& outgoing);
+    void processBuffer(QByteArray& data, int connectionId);
+    void deliverFrame(const QByteArray& messageData, int connectionId);
+
+    // 보내기 레인: 본문을 레인에 넣고, 소켓에 넘긴 양이 windowBytes보다 적은 동안 우선순위대로 꺼내 씀
+    FrameScheduler* lanesFor(int connectionId);
+    void queueFrame(int connectionId, MessageLane lane, const QByteArray& data);
+    void pumpLanes(int connectionId, qint64 windowBytes = SendWindowBytes);
+    void flushLanes();
+    qint64 unsentBytes(QTcpSocket* socket, LocalChannel* local) const;
+    // 대기량을 수위와 비교해 혼잡/해소를 알리고, 한도를 넘으면 연결을 닫음
+    void updateBackpressure(int connectionId);
+
+    // 공유 메모리 전송
+    QTcpSocket* socketFor(int connectionId) const;
+    LocalChannel* localFor(int connectionId) const;
+    void offerLocalChannel();
+    void handleTransportSwitch(int connectionId, const QJsonObject& data);
+    void writeLocal(QTcpSocket* socket, LocalChannel& local, const QByteArray& payload);
+    void flushLocal(QTcpSocket* socket, LocalChannel& local);
+    void drainLocal(int connectionId);
+    void sendWakeup(QTcpSocket* socket, char signal);
+};
+
+// 서버/클라이언트 네트워크 연결
+// 소켓 읽기/쓰기, 프레임 분리, JSON 변환은 프로세스 공용 네트워크 I/O 스레드에서 하므로
+// 화면 갱신이나 다른 블로킹 호출이 수신을 늦추지 않습니다.
+// 이 객체는 만든 스레드에 남아 잠금 없는 대기열로 받은 메시지를 꺼내 시그널로 내보냅니다.
+// 여러 메시지가 한꺼번에 도착하면 한 번 깨어나서 모두 처리합니다.
+// 상대가 같은 호스트(루프백)면 연결 직후 공유 메모리 링으로 전환해 본문이 커널을 거치지 않고,
+// TCP에는 상대가 잠들어 있을 때만 1바이트 깨우기 신호를 보냅니다. 시그널과 전송 함수는 그대로입니다.
+// 보낼 본문은 연결마다 레인(제어/주문/상태/대량)에 나눠 두었다가 우선순위대로 소켓에 넘기므로,
+// 큰 상태 본문이나 기록 묶음이 밀려 있어도 흐름 제어나 급한 주문이 그 뒤에서 오래 기다리지 않습니다.
+// 상대가 읽지 않아 연결마다 쌓인 양은 수위로 관리해 sendBackpressure로 알리고, 한도를 넘으면 연결을 끊으므로
+// 로봇이나 화면 하나가 멈춰도 서버 메모리가 끝없이 늘지 않습니다.
 class NetworkManager : public QObject
 {
     Q_OBJECT
@@ -24,42 +215,80 @@ public:
     bool isServerRunning() const;
 
     // 클라이언트 관련 함수
+    // 연결을 시작하고 기다리지 않고 돌아옴 (서버 모드면 false)
+    // 결과는 connected, 실패나 시간 초과는 errorOccurred로 알림
     bool connectToServer(const QString& address, quint16 port = 1234);
     void disconnectFromServer();
     bool isConnectedToServer() const;
 
     // 공통 함수
+    // 서버 모드에서는 연결된 모든 클라이언트에 전송
+    // 전송은 I/O 스레드에 맡기고 바로 돌아옴 (연결이 없으면 false)
+    // 레인을 지정하지 않으면 메시지 종류로 정함 (messageLane)
     bool sendMessage(const Message& message);
+    bool sendMessage(const Message& message, MessageLane lane);
+
+    // 서버 모드: 여러 클라이언트(로봇)를 연결 ID로 구분
+    bool sendMessageTo(int connectionId, const Message& message);
+    bool sendMessageTo(int connectionId, const Message& message, MessageLane lane);
+    // 이미 JSON으로 만든 본문을 여러 연결에 전송 (구독 발행처럼 같은 프레임을 여러 곳에 보낼 때)
+    // 혼잡한 연결(대기량이 NetworkWorker::SendHighWatermark 이상)에는 보내지 않고 버림
+    bool sendEncoded(const QVector<int>& connectionIds, const QByteArray& payload,
+                     MessageLane lane = MessageLane::STATUS);
+    QList<int> connectionIds() const { return clients; }
+    int connectionCount() const { return clients.size(); }
+    // sendBackpressure로 알린 마지막 상태
+    bool isSendCongested(int connectionId = 0) const { return congestedIds.contains(connectionId); }
+
+    // 클라이언트 모드에서 연결/종료를 기다리는 최대 시간 (ms, I/O 스레드가 기다림)
+    // 소켓의 실제 대기라 시계로 진행할 수 없으므로 테스트에서는 짧게 줄여서 사용
+    void setTimeouts(int connectMs, int disconnectMs);
+
+    // 4바이트 크기 접두어(빅 엔디언) + 본문
+    // 본문은 MaxFramePayload 이하여야 하며, 받는 쪽은 이보다 큰 크기를 깨진 스트림으로 보고 연결을 닫음
+    static const int MaxFramePayload = 0xFFFFFF;
+    static QByteArray encodeFrame(const QByteArray& payload);
+
+    // 같은 호스트(루프백) 연결을 공유 메모리 전송으로 전환할지 (프로세스 전역, 기본 켜짐)
+    // 양쪽이 모두 켜져 있어야 전환하며, 이미 연결된 뒤에 바꾸면 다음 연결부터 적용됩니다.
+    static void setLocalTransportEnabled(bool enabled);
+    static bool localTransportEnabled();
 
 signals:
     void messageReceived(const Message& message);
+    void messageReceivedFrom(int connectionId, const Message& message);
     void connected();
     void disconnected();
+    void clientConnected(int connectionId);
+    void clientDisconnected(int connectionId);
     void errorOccurred(const QString& error);
-
-private slots:
-    void handleNewConnection();
-    void handleClientConnected();
-    void handleDisconnection();
-    void handleRead();
-    void handleSocketError(QAbstractSocket::SocketError socketError);
+    // 상대가 늦게 읽어 보내기 대기량이 높은 수위를 넘으면 congested = true, 낮은 수위 아래로 내려가면 false
+    // 보내는 쪽은 이 동안 전송을 멈추거나, 최신 값만 남기거나, 버려야 합니다 (클라이언트 모드는 연결 ID 0).
+    // 전송 함수는 그대로 받으므로 제어 메시지는 혼잡해도 보낼 수 있습니다.
+    void sendBackpressure(int connectionId, bool congested);
 
 private:
-    // 설정 및 상태
+    friend class NetworkWorker;
+
+    // 설정 및 상태 (I/O 스레드가 보낸 이벤트로 갱신)
     bool isServer;
-    QString serverAddress;
-    quint16 serverPort;
+    bool serverRunning;
     bool isConnected;
+    QList<int> clients;
+    QSet<int> congestedIds;
+    int connectTimeoutMs;
+    int disconnectTimeoutMs;
 
-    // 네트워크 객체
-    QTcpServer* server;
-    QTcpSocket* clientSocket;
-    QByteArray buffer;
+    NetworkWorker* worker;
 
-    // 유틸리티 함수
-    void cleanupSocket();
-    void cleanupServer();
+    // 수신 대기열을 비우며 시그널을 내보냄 (I/O 스레드가 깨우거나, 블로킹 호출 직후)
+    void drainInbound();
+    void dispatchEvent(const NetworkEvent& event);
+    void enqueue(int connectionId, const Message& message, MessageLane lane);
+    void pushOutgoing(OutgoingMessage&& outgoing);
+    // I/O 스레드에서 실행하고 끝날 때까지 기다림
+    template <typename Function>
+    void runOnWorker(Function function);
 };
 
 #endif // NETWORKMANAGER_H
-
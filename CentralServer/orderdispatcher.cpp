@@ -0,0 +1,160 @@
+// orderdispatcher.cpp
+#include "orderdispatcher.h"
+#include <limits>
+
+OrderDispatcher::OrderDispatcher()
+    : routingStrategy(Strategy::EarliestFinish)
+    , lastRobotId(0)
+{
+}
+
+void OrderDispatcher::addRobot(int connectionId)
+{
+    // 크레딧은 로봇의 첫 흐름 제어 메시지로 받음
+    RobotState state;
+    state.connectionId = connectionId;
+    robots.insert(connectionId, state);
+}
+
+void OrderDispatcher::removeRobot(int connectionId)
+{
+    robots.remove(connectionId);
+}
+
+const RobotState* OrderDispatcher::robot(int connectionId) const
+{
+    auto it = robots.constFind(connectionId);
+    return it == robots.constEnd() ? nullptr : &it.value();
+}
+
+void OrderDispatcher::updateFlowControl(int connectionId, const FlowControlMessage& flow)
+{
+    auto it = robots.find(connectionId);
+    if (it == robots.end()) return;
+
+    it->limit = flow.limit;
+    it->load.backlog = flow.backlog;
+    it->load.received = qMax(it->load.received, flow.received);
+}
+
+void OrderDispatcher::updateLoad(int connectionId, const RobotLoadMessage& load)
+{
+    auto it = robots.find(connectionId);
+    if (it == robots.end()) return;
+
+    it->load = load;
+}
+
+void OrderDispatcher::orderSent(int connectionId)
+{
+    auto it = robots.find(connectionId);
+    if (it != robots.end()) {
+        it->sentCount++;
+    }
+}
+
+void OrderDispatcher::orderSendFailed(int connectionId)
+{
+    auto it = robots.find(connectionId);
+    if (it == robots.end()) return;
+
+    it->sentCount = qMax(0, it->sentCount - 1);
+    it->limit = it->sentCount;
+}
+
+void OrderDispatcher::setCongested(int connectionId, bool congested)
+{
+    auto it = robots.find(connectionId);
+    if (it != robots.end()) {
+        it->congested = congested;
+    }
+}
+
+int OrderDispatcher::credits(int connectionId) const
+{
+    const RobotState* state = robot(connectionId);
+    return state ? state->credits() : 0;
+}
+
+int OrderDispatcher::totalCredits() const
+{
+    int total = 0;
+    for (const RobotState& state : robots) {
+        total += state.credits();
+    }
+    return total;
+}
+
+int OrderDispatcher::selectRobot()
+{
+    int selected = -1;
+
+    switch (routingStrategy) {
+    case Strategy::EarliestFinish: {
+        qint64 bestEta = std::numeric_limits<qint64>::max();
+        int bestOutstanding = std::numeric_limits<int>::max();
+        for (const RobotState& state : robots) {
+            if (state.credits() <= 0) continue;
+
+            // 추정치가 같으면 맡은 주문이 적은 로봇
+            const qint64 eta = estimateCompletionMs(state.load, state.unreportedOrders());
+            const int outstanding = state.load.backlog + state.unreportedOrders();
+            if (eta < bestEta || (eta == bestEta && outstanding < bestOutstanding)) {
+                bestEta = eta;
+                bestOutstanding = outstanding;
+                selected = state.connectionId;
+            }
+        }
+        break;
+    }
+    case Strategy::LeastBacklog: {
+        int bestOutstanding = std::numeric_limits<int>::max();
+        for (const RobotState& state : robots) {
+            if (state.credits() <= 0) continue;
+
+            const int outstanding = state.load.backlog + state.unreportedOrders();
+            if (outstanding < bestOutstanding) {
+                bestOutstanding = outstanding;
+                selected = state.connectionId;
+            }
+        }
+        break;
+    }
+    case Strategy::RoundRobin: {
+        // 마지막으로 고른 로봇 다음부터 크레딧이 남은 첫 로봇
+        for (const RobotState& state : robots) {
+            if (state.credits() <= 0) continue;
+            if (selected < 0 || (state.connectionId > lastRobotId && selected <= lastRobotId)) {
+                selected = state.connectionId;
+            }
+        }
+        break;
+    }
+    }
+
+    if (selected >= 0) {
+        lastRobotId = selected;
+    }
+    return selected;
+}
+
+qint64 OrderDispatcher::estimateCompletionMs(int connectionId) const
+{
+    const RobotState* state = robot(connectionId);
+    return state ? estimateCompletionMs(state->load, state->unreportedOrders()) : 0;
+}
+
+qint64 OrderDispatcher::estimateCompletionMs(const RobotLoadMessage& load, int unreportedOrders)
+{
+    // 새 주문보다 먼저 해당 단계를 거칠 주문 수: 이 단계와 앞 단계에 있는 주문 전부
+    // 작업 중인 주문도 처리 시간 전체를 남겨 둔 것으로 보수적으로 계산
+    qint64 ahead = unreportedOrders;
+    qint64 finish = 0;
+    for (const ModuleLoad& module : load.modules) {
+        ahead += module.waiting + module.busy;
+        const qint64 devices = qMax(1, module.devices);
+        const qint64 deviceFree = (ahead / devices) * module.durationMs;
+        finish = qMax(finish, deviceFree) + module.durationMs;
+    }
+    return finish;
+}
@@ -0,0 +1,76 @@
+// orderdispatcher.h
+#ifndef ORDERDISPATCHER_H
+#define ORDERDISPATCHER_H
+
+#include <QList>
+#include <QMap>
+#include "message.h"
+
+// 로봇별 연결 상태와 부하
+struct RobotState {
+    int connectionId = 0;
+    int sentCount = 0;          // 이번 연결에서 보낸 주문 수
+    int limit = 0;              // 로봇이 허용한 누적 상한 (흐름 제어)
+    bool congested = false;     // 연결이 밀려 있음 (NetworkManager::sendBackpressure)
+    RobotLoadMessage load;      // 마지막 부하 보고
+
+    // 연결이 밀려 있는 동안은 로봇이 허용해도 보내지 않음
+    int credits() const { return congested ? 0 : qMax(0, limit - sentCount); }
+
+    // 보냈지만 아직 부하 보고에 반영되지 않은 주문 수
+    int unreportedOrders() const { return qMax(0, sentCount - load.received); }
+};
+
+// 여러 로봇 중 새 주문을 보낼 로봇을 고르는 분배기
+// 로봇이 보고한 모듈별 대기 주문 수, 장치 수, 처리 시간으로 새 주문의 완료 시각을 추정하고
+// 크레딧이 남은 로봇 중 가장 빨리 끝낼 로봇을 고릅니다.
+class OrderDispatcher
+{
+public:
+    enum class Strategy {
+        EarliestFinish,     // 예상 완료 시각이 가장 이른 로봇 (기본)
+        LeastBacklog,       // 보관 주문이 가장 적은 로봇
+        RoundRobin          // 순서대로
+    };
+
+    OrderDispatcher();
+
+    void setStrategy(Strategy strategy) { routingStrategy = strategy; }
+    Strategy strategy() const { return routingStrategy; }
+
+    // 로봇 연결 관리
+    void addRobot(int connectionId);
+    void removeRobot(int connectionId);
+    bool hasRobot(int connectionId) const { return robots.contains(connectionId); }
+    QList<int> robotIds() const { return robots.keys(); }
+    const RobotState* robot(int connectionId) const;
+
+    // 로봇 보고 반영
+    void updateFlowControl(int connectionId, const FlowControlMessage& flow);
+    void updateLoad(int connectionId, const RobotLoadMessage& load);
+
+    // 전송 결과 반영
+    void orderSent(int connectionId);
+    void orderSendFailed(int connectionId);     // 크레딧을 돌려받고 다음 보고까지 전송 중단
+    void setCongested(int connectionId, bool congested);
+
+    int credits(int connectionId) const;
+    int totalCredits() const;
+
+    // 주문을 보낼 로봇의 연결 ID (크레딧이 남은 로봇이 없으면 -1)
+    int selectRobot();
+
+    // 지금 새 주문을 보낸다면 완료까지 걸릴 예상 시간
+    qint64 estimateCompletionMs(int connectionId) const;
+
+    // 부하 보고와 아직 반영되지 않은 주문 수로 새 주문의 완료 시간 추정
+    // 단계마다 앞선 주문을 장치 수로 나눠 처리한다고 보고, 이전 단계가 끝나야 다음 단계를 시작
+    static qint64 estimateCompletionMs(const RobotLoadMessage& load, int unreportedOrders);
+
+private:
+    QMap<int, RobotState> robots;
+    Strategy routingStrategy;
+    int lastRobotId;    // RoundRobin용
+};
+
+#endif // ORDERDISPATCHER_H
@@ -1,16 +1,30 @@
 // ordermanager.cpp
 
 #include "ordermanager.h"
+#include "logging.h"
 #include <QDebug>
+#include <QDateTime>
+#include <QMetaMethod>
+#include <algorithm>
 
 OrderManager::OrderManager(QObject *parent)
     : QObject(parent), nextOrderId(1)
 {
+    MetricsRegistry& metrics = MetricsRegistry::instance();
+    ordersReceived = metrics.counter("server_orders_received_total", "접수한 주문 수");
+    ordersCompleted = metrics.counter("server_orders_completed_total", "완료된 주문 수");
+    ordersRejected = metrics.counter("server_orders_rejected_total", "로봇이 거절해 대기열로 돌아온 주문 수");
+    queueWait = metrics.histogram("server_queue_wait_us", "접수부터 로봇 전송까지 대기 시간");
+    orderLatency = metrics.histogram("server_order_latency_us", "접수부터 완료까지 걸린 시간");
+    pendingGauge = metrics.gauge("server_pending_orders", "서버 대기열의 주문 수");
+    creditsGauge = metrics.gauge("server_available_credits", "로봇들이 더 받을 수 있는 주문 수");
 }
 
 void OrderManager::submitOrder(const QString& bread, const QString& egg,
                                const QStringList& jams, int jamAmount,
-                               const QStringList& cheeses)
+                               const QStringList& cheeses,
+                               OrderPriority priority, OrderChannel channel,
+                               qint64 deadline)
 {
     OrderMessage order;
     order.orderId = nextOrderId++;
@@ -20,42 +34,456 @@ void OrderManager::submitOrder(const QString& bread, const QString& egg,
     order.jamAmount = jamAmount;
     order.cheeses = cheeses;
     order.status = OrderStatus::WAITING;
+    order.priority = priority;
+    order.channel = channel;
+    order.deadline = deadline;
 
-    activeOrders[order.orderId] = order;
-    emit newOrderCreated(order);
-    emit logMessage(QString("새로운 주문이 생성되었습니다. (주문 ID: %1)").arg(order.orderId));
+    enqueueOrder(order);
+}
+
+template <typename... Args>
+void OrderManager::logOrderEvent(LogEvent event, const Args&... args)
+{
+    BinaryLogger::instance().log(event, args...);
+    if (isSignalConnected(QMetaMethod::fromSignal(&OrderManager::logMessage))) {
+        emit logMessage(BinaryLogger::format(event, args...));
+    }
+}
+
+int OrderManager::enqueueOrder(OrderMessage order)
+{
+    if (order.orderId <= 0) {
+        order.orderId = nextOrderId++;
+    } else {
+        nextOrderId = qMax(nextOrderId, order.orderId + 1);
+    }
+    order.status = OrderStatus::WAITING;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    OrderHandle handle = activeOrders.insert(order, now);
+    if (handle.isNull()) {
+        emit logMessage(QString("이미 존재하는 주문 ID입니다. (주문 ID: %1)").arg(order.orderId));
+        return 0;
+    }
+    insertPending(handle);
+    ordersReceived->add();
+    Tracer::instance().instant("order received", "orders", order.orderId);
+
+    // 대기열에서 앞선 주문 수를 반영해 완료 시각을 약속
+    predictor.recordPrediction(order.orderId, now,
+                               predictor.predict(dispatcher, pendingOrders.indexOf(handle)));
+
+    emit newOrderCreated(handle);
+    logOrderEvent(LogEvent::OrderCreated, order.orderId);
+
+    dispatchPendingOrders();
+    return order.orderId;
+}
+
+bool OrderManager::cancelPendingOrder(int orderId)
+{
+    OrderHandle handle = activeOrders.find(orderId);
+    if (handle.isNull() || !pendingOrders.removeOne(handle)) {
+        return false;   // 이미 로봇으로 전송된 주문은 취소할 수 없음
+    }
+
+    activeOrders.remove(handle);
+    predictor.forget(orderId);
+    emit logMessage(QString("대기 중인 주문이 취소되었습니다. (주문 ID: %1)").arg(orderId));
+    publishFlowControl();
+    return true;
+}
+
+bool OrderManager::finishOrder(int orderId)
+{
+    OrderHandle handle = activeOrders.find(orderId);
+    if (handle.isNull()) {
+        return false;
+    }
+
+    pendingOrders.removeOne(handle);
+    forgetDispatched(handle);
+    recordCompletion(handle, QDateTime::currentMSecsSinceEpoch());
+    activeOrders.remove(handle);
+    emit orderCompleted(orderId);
+    return true;
+}
+
+bool OrderManager::reprioritizePendingOrder(int orderId, OrderPriority priority)
+{
+    OrderHandle handle = activeOrders.find(orderId);
+    if (handle.isNull() || !pendingOrders.removeOne(handle)) {
+        return false;
+    }
+
+    activeOrders.setPriority(handle, priority);
+    insertPending(handle);
+    emit logMessage(QString("대기 중인 주문의 우선순위를 변경했습니다. (주문 ID: %1)").arg(orderId));
+    return true;
+}
+
+CompletionEstimate OrderManager::estimateCompletion() const
+{
+    return predictor.predict(dispatcher, pendingOrders.size());
+}
+
+CompletionEstimate OrderManager::promisedCompletion(int orderId) const
+{
+    return predictor.promised(orderId);
+}
+
+int OrderManager::availableCredits() const
+{
+    return dispatcher.totalCredits();
+}
+
+void OrderManager::handleFlowControl(int connectionId, const FlowControlMessage& flow)
+{
+    dispatcher.updateFlowControl(connectionId, flow);
+    updateRobotMetrics(connectionId);
+    emit robotLoadChanged(connectionId);
+    dispatchPendingOrders();
+}
+
+void OrderManager::handleRobotLoad(int connectionId, const RobotLoadMessage& load)
+{
+    dispatcher.updateLoad(connectionId, load);
+    updateRobotMetrics(connectionId);
+    emit robotLoadChanged(connectionId);
+}
+
+void OrderManager::handleOrderRejected(int connectionId, int orderId, const QString& reason)
+{
+    // 로봇이 받았다가 거절한 주문: 대기열로 되돌리고 다음 크레딧 통지를 기다림
+    OrderHandle handle = activeOrders.find(orderId);
+    if (handle.isNull() || pendingOrders.contains(handle)) {
+        return;
+    }
+
+    forgetDispatched(handle);
+    insertPending(handle);
+    ordersRejected->add();
+    emit orderRequeued(connectionId, handle, reason);
+    emit logMessage(QString("로봇 %1이 주문을 거절했습니다. (주문 ID: %2) - %3")
+                        .arg(connectionId).arg(orderId).arg(reason));
+    publishFlowControl();
+}
+
+void OrderManager::handleOrderSendFailed(int connectionId, int orderId)
+{
+    // 전송 자체가 실패한 주문: 크레딧을 돌려받고 해당 로봇은 다음 통지까지 제외
+    OrderHandle handle = activeOrders.find(orderId);
+    if (handle.isNull() || pendingOrders.contains(handle)) {
+        return;
+    }
+
+    dispatcher.orderSendFailed(connectionId);
+    updateRobotMetrics(connectionId);
+    forgetDispatched(handle);
+    insertPending(handle);
+    emit logMessage(QString("주문 전송 실패, 대기열로 되돌립니다. (주문 ID: %1)").arg(orderId));
+    dispatchPendingOrders();
+}
+
+void OrderManager::handleSendBackpressure(int connectionId, bool congested)
+{
+    if (!dispatcher.hasRobot(connectionId)) {
+        return;
+    }
+
+    dispatcher.setCongested(connectionId, congested);
+    updateRobotMetrics(connectionId);
+    emit robotLoadChanged(connectionId);
+    if (congested) {
+        publishFlowControl();
+    } else {
+        dispatchPendingOrders();
+    }
+}
+
+void OrderManager::handleRobotConnected(int connectionId)
+{
+    dispatcher.addRobot(connectionId);
+    updateRobotMetrics(connectionId);
+    emit robotLoadChanged(connectionId);
+    publishFlowControl();
+}
+
+void OrderManager::handleRobotDisconnected(int connectionId)
+{
+    dispatcher.removeRobot(connectionId);
+    updateRobotMetrics(connectionId);
+    emit robotLoadChanged(connectionId);
+
+    // 끊긴 로봇이 끝내지 못한 주문은 처음부터 다시 만들어야 하므로 대기열로 되돌려 다른 로봇에 보냄
+    const QList<OrderHandle> orphaned = dispatchedOrders.take(connectionId);
+    for (OrderHandle handle : orphaned) {
+        if (!activeOrders.contains(handle) || pendingOrders.contains(handle)) {
+            continue;
+        }
+        activeOrders.setStatus(handle, OrderStatus::WAITING);
+        activeOrders.touch(handle, QDateTime::currentMSecsSinceEpoch());
+        insertPending(handle);
+        emit orderRequeued(connectionId, handle, QStringLiteral("연결 끊김"));
+        emit logMessage(QString("로봇 %1의 연결이 끊겨 주문을 대기열로 되돌립니다. (주문 ID: %2)")
+                            .arg(connectionId).arg(activeOrders.orderId(handle)));
+    }
+    dispatchPendingOrders();
+}
+
+void OrderManager::insertPending(OrderHandle handle)
+{
+    // 다시 보내면 빵부터 새로 만듦
+    activeOrders.setStep(handle, QUEUED_STEP);
+    activeOrders.setProcessing(handle, false);
+    auto it = std::upper_bound(pendingOrders.begin(), pendingOrders.end(), handle,
+                               [this](OrderHandle a, OrderHandle b) { return comesBefore(a, b); });
+    pendingOrders.insert(it, handle);
+}
+
+bool OrderManager::comesBefore(OrderHandle a, OrderHandle b) const
+{
+    const OrderPriority pa = activeOrders.priority(a);
+    const OrderPriority pb = activeOrders.priority(b);
+    if (pa != pb) {
+        return static_cast<int>(pa) > static_cast<int>(pb);
+    }
+
+    // 약속 시각이 있는 주문이 먼저, 그중에서는 이른 순
+    const qint64 da = activeOrders.deadline(a);
+    const qint64 db = activeOrders.deadline(b);
+    if (da != db) {
+        if (da == 0) return false;
+        if (db == 0) return true;
+        return da < db;
+    }
+    return activeOrders.orderId(a) < activeOrders.orderId(b);
+}
+
+void OrderManager::dispatchPendingOrders()
+{
+    while (!pendingOrders.isEmpty() && availableCredits() > 0) {
+        OrderHandle handle = pendingOrders.takeFirst();
+        if (!activeOrders.contains(handle)) {
+            continue;
+        }
+
+        // 크레딧이 남은 로봇 중 새 주문을 가장 빨리 끝낼 로봇으로 전송
+        const int connectionId = dispatcher.selectRobot();
+        const qint64 waitedMs = qMax<qint64>(0, QDateTime::currentMSecsSinceEpoch() - activeOrders.createdAt(handle));
+        queueWait->record(static_cast<quint64>(waitedMs) * 1000);
+        if (Tracer::enabled()) {
+            const qint64 nowUs = MetricsRegistry::nowUs();
+            Tracer::instance().asyncSpan("queued", "server", activeOrders.orderId(handle),
+                                         nowUs - waitedMs * 1000, nowUs);
+        }
+        dispatcher.orderSent(connectionId);
+        updateRobotMetrics(connectionId);
+        dispatchedOrders[connectionId].append(handle);
+        activeOrders.setStep(handle, BREAD_STEP);
+        emit orderDispatched(connectionId, handle);
+    }
+    publishFlowControl();
+}
+
+void OrderManager::forgetDispatched(OrderHandle handle)
+{
+    for (QList<OrderHandle>& orders : dispatchedOrders) {
+        if (orders.removeOne(handle)) {
+            return;
+        }
+    }
+}
+
+void OrderManager::publishFlowControl()
+{
+    pendingGauge->set(pendingOrders.size());
+    creditsGauge->set(availableCredits());
+    emit flowControlChanged(pendingOrders.size(), availableCredits());
+}
+
+void OrderManager::recordCompletion(OrderHandle handle, qint64 now)
+{
+    const int orderId = activeOrders.orderId(handle);
+    ordersCompleted->add();
+    const qint64 latencyMs = qMax<qint64>(0, now - activeOrders.createdAt(handle));
+    orderLatency->record(static_cast<quint64>(latencyMs) * 1000);
+    if (Tracer::enabled()) {
+        const qint64 nowUs = MetricsRegistry::nowUs();
+        Tracer::instance().asyncSpan("order", "orders", orderId, nowUs - latencyMs * 1000, nowUs);
+    }
+    predictor.recordCompletion(orderId, now);
+}
+
+void OrderManager::updateRobotMetrics(int connectionId)
+{
+    const RobotState* robot = dispatcher.robot(connectionId);
+    auto it = robotMetrics.find(connectionId);
+    if (it == robotMetrics.end()) {
+        if (!robot) return;
+
+        // 연결마다 한 번만 등록하고 이후에는 포인터로 값만 갱신
+        MetricsRegistry& metrics = MetricsRegistry::instance();
+        const QString labels = QString("robot=\"%1\"").arg(connectionId);
+        RobotMetrics created;
+        created.connected = metrics.gauge("server_robot_connected", "로봇 연결 상태 (1: 연결됨)", labels);
+        created.credits = metrics.gauge("server_robot_credits", "로봇이 더 받을 수 있는 주문 수", labels);
+        created.backlog = metrics.gauge("server_robot_backlog", "로봇이 보고한 보관 주문 수", labels);
+        it = robotMetrics.insert(connectionId, created);
+    }
+
+    RobotMetrics& gauges = it.value();
+    if (!robot) {
+        gauges.connected->set(0);
+        gauges.credits->set(0);
+        gauges.backlog->set(0);
+        for (MetricGauge* gauge : gauges.moduleWaiting) gauge->set(0);
+        for (MetricGauge* gauge : gauges.moduleBusy) gauge->set(0);
+        return;
+    }
+
+    gauges.connected->set(1);
+    gauges.credits->set(robot->credits());
+    gauges.backlog->set(robot->load.backlog);
+    for (const ModuleLoad& module : robot->load.modules) {
+        MetricGauge*& waiting = gauges.moduleWaiting[module.module];
+        MetricGauge*& busy = gauges.moduleBusy[module.module];
+        if (!waiting) {
+            MetricsRegistry& metrics = MetricsRegistry::instance();
+            const QString labels = QString("robot=\"%1\",module=\"%2\"").arg(connectionId).arg(module.module);
+            waiting = metrics.gauge("server_robot_module_waiting", "로봇이 보고한 모듈별 대기 주문 수", labels);
+            busy = metrics.gauge("server_robot_module_busy", "로봇이 보고한 모듈별 작업 중인 장치 수", labels);
+        }
+        waiting->set(module.waiting);
+        busy->set(module.busy);
+    }
 }
 
 QList<OrderMessage> OrderManager::getActiveOrders() const
 {
-    return activeOrders.values();
+    return activeOrders.orders();
+}
+
+void OrderManager::handleRobotMessage(int connectionId, const Message& message)
+{
+    // 구독자처럼 로봇으로 등록되지 않은 연결의 메시지는 주문에 영향을 주지 않음
+    if (!dispatcher.hasRobot(connectionId)) {
+        return;
+    }
+
+    switch (message.type) {
+    case MessageType::FLOW_CONTROL: {
+        const FlowControlMessage flow = FlowControlMessage::fromJson(message.data);
+        qCDebug(lcNetwork) << "Flow control: backlog" << flow.backlog << "/" << flow.window
+                           << "limit" << flow.limit;
+        handleFlowControl(connectionId, flow);
+        break;
+    }
+    case MessageType::ROBOT_LOAD:
+        handleRobotLoad(connectionId, RobotLoadMessage::fromJson(message.data));
+        break;
+    case MessageType::ORDER_STATUS_UPDATE: {
+        const int orderId = message.data["orderId"].toInt();
+        const OrderHandle handle = activeOrders.find(orderId);
+        if (handle.isNull()) {
+            qCDebug(lcOrders) << "Order not found in activeOrders:" << orderId;
+            break;
+        }
+        advanceOrderStep(handle, static_cast<OrderStatus>(message.data["status"].toInt()));
+        break;
+    }
+    case MessageType::ERROR_REPORT:
+        // 거절된 주문은 서버 대기열로 돌아가 다음 크레딧을 기다림
+        handleOrderRejected(connectionId, message.data["orderId"].toInt(),
+                            message.data["reason"].toString());
+        break;
+    default:
+        break;
+    }
 }
 
 void OrderManager::handleDeviceStatusUpdate(const DeviceStatusMessage& status)
 {
-    emit logMessage(QString("%1 장치 %2: %3 - %4")
-                        .arg(status.moduleType)
-                        .arg(status.deviceIndex)
-                        .arg(status.status == DeviceStatus::ON ? "작동 중" : "대기 중")
-                        .arg(status.currentTask));
+    logOrderEvent(LogEvent::DeviceStatusReported, status.moduleType, status.deviceIndex,
+                  status.status == DeviceStatus::ON ? "작동 중" : "대기 중", status.currentTask);
+
+    // 작업 시작 시에는 대기 중인 주문, 완료 시에는 처리 중인 주문 중
+    // 해당 모듈 단계에 있는 가장 먼저 들어온 주문을 찾는다
+    // 로봇이 주문 ID를 알려주면 그 주문을 바로 찾는다
+    const bool taskStarted = !status.currentTask.isEmpty();
+    OrderHandle handle;
+    if (status.orderId > 0) {
+        handle = activeOrders.find(status.orderId);
+    } else {
+        handle = activeOrders.findFirst([&](OrderHandle h) {
+            return activeOrders.isProcessing(h) != taskStarted &&
+                   stepModule(activeOrders.step(h)) == status.moduleType;
+        });
+    }
+    if (!handle.isNull()) {
+        advanceOrderStep(handle, taskStarted ? OrderStatus::PROCESSING : OrderStatus::COMPLETED);
+    }
+}
+
+void OrderManager::advanceOrderStep(OrderHandle handle, OrderStatus status)
+{
+    // 서버 대기열로 돌아온 주문의 늦은 보고는 무시
+    const int step = activeOrders.step(handle);
+    if (step < BREAD_STEP || step >= COMPLETE_STEP) {
+        return;
+    }
+
+    OrderStatus orderStatus = OrderStatus::WAITING;
+    if (status == OrderStatus::PROCESSING) {
+        activeOrders.setProcessing(handle, true);
+        orderStatus = OrderStatus::PROCESSING;
+    } else if (status == OrderStatus::COMPLETED) {
+        activeOrders.setProcessing(handle, false);
+        activeOrders.setStep(handle, step + 1);
+        if (step + 1 == COMPLETE_STEP) {
+            orderStatus = OrderStatus::COMPLETED;
+        }
+    } else {
+        return;
+    }
+    activeOrders.setStatus(handle, orderStatus);
+    activeOrders.touch(handle, QDateTime::currentMSecsSinceEpoch());
+    emit orderStepChanged(handle);
+
+    if (activeOrders.step(handle) == COMPLETE_STEP) {
+        finishOrder(activeOrders.orderId(handle));
+    }
+}
+
+QLatin1String OrderManager::stepModule(int step)
+{
+    switch (step) {
+    case BREAD_STEP: return QLatin1String("Bread");
+    case CHEESE_STEP: return QLatin1String("Cheese");
+    case EGG_STEP: return QLatin1String("Egg");
+    case JAM_STEP: return QLatin1String("Jam");
+    default: return QLatin1String();
+    }
 }
 
 void OrderManager::handleOrderStatusUpdate(int orderId, const QString& module, OrderStatus status)
 {
-    if (!activeOrders.contains(orderId)) {
-        qDebug() << "Unknown order ID:" << orderId;
+    OrderHandle handle = activeOrders.find(orderId);
+    if (handle.isNull()) {
+        qCDebug(lcOrders) << "Unknown order ID:" << orderId;
         return;
     }
 
-    updateOrderStatus(orderId, module, status);
+    updateOrderStatus(handle, module, status);
 }
 
-void OrderManager::updateOrderStatus(int orderId, const QString& module, OrderStatus status)
+void OrderManager::updateOrderStatus(OrderHandle handle, const QString& module, OrderStatus status)
 {
-    if (!activeOrders.contains(orderId)) return;
+    if (!activeOrders.contains(handle)) return;
 
-    OrderMessage& order = activeOrders[orderId];
-    order.status = status;
+    const int orderId = activeOrders.orderId(handle);
+    activeOrders.setStatus(handle, status);
+    activeOrders.touch(handle, QDateTime::currentMSecsSinceEpoch());
 
     QString statusStr;
     switch(status) {
@@ -74,15 +502,19 @@ void OrderManager::updateOrderStatus(int orderId, const QString& module, OrderSt
     }
 
     emit orderStatusChanged(orderId, statusStr);
-    emit logMessage(QString("주문 %1: %2").arg(orderId).arg(statusStr));
+    Tracer::instance().instant("status applied", "orders", orderId);
+    logOrderEvent(LogEvent::OrderStatusChanged, orderId, statusStr);
 
-    if (status == OrderStatus::COMPLETED && isOrderComplete(order)) {
+    if (status == OrderStatus::COMPLETED && isOrderComplete(activeOrders.details(handle))) {
         emit orderCompleted(orderId);
-        activeOrders.remove(orderId);
+        pendingOrders.removeOne(handle);
+        forgetDispatched(handle);
+        recordCompletion(handle, QDateTime::currentMSecsSinceEpoch());
+        activeOrders.remove(handle);
     }
 }
 
-bool OrderManager::isOrderComplete(const OrderMessage& order) const
+bool OrderManager::isOrderComplete(const OrderDetails& order) const
 {
     // 모든 필수 작업이 완료되었는지 확인
     bool breadDone = true; // 빵은 필수
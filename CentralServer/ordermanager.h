@@ -4,38 +4,136 @@
 
 #include <QObject>
 #include <QMap>
-#include <QQueue>
+#include "binarylog.h"
 #include "message.h"
+#include "ordertable.h"
+#include "orderdispatcher.h"
+#include "completionpredictor.h"
+#include "metrics.h"
+#include "tracer.h"
 
 class OrderManager : public QObject
 {
     Q_OBJECT
 
 public:
+    // 로봇으로 보낸 주문의 조리 단계 (orderTable()의 step 필드, 서버 대기열에 있는 동안은 QUEUED_STEP)
+    enum OrderStep {
+        QUEUED_STEP = -1,
+        BREAD_STEP = 0,
+        CHEESE_STEP = 1,
+        EGG_STEP = 2,
+        JAM_STEP = 3,
+        COMPLETE_STEP = 4
+    };
+    static QLatin1String stepModule(int step);
+
     explicit OrderManager(QObject *parent = nullptr);
 
     void submitOrder(const QString& bread, const QString& egg,
                      const QStringList& jams, int jamAmount,
-                     const QStringList& cheeses);
+                     const QStringList& cheeses,
+                     OrderPriority priority = OrderPriority::NORMAL,
+                     OrderChannel channel = OrderChannel::DINE_IN,
+                     qint64 deadline = 0);
     QList<OrderMessage> getActiveOrders() const;
+    // 접수한 주문 (newOrderCreated/orderDispatched의 핸들로 조회)
+    const OrderTable& orderTable() const { return activeOrders; }
+
+    // 주문을 서버 대기열에 넣고 로봇 크레딧이 허용하는 만큼만 전송
+    // orderId가 0이면 새 ID를 발급하며, 접수된 주문 ID를 반환 (실패 시 0)
+    int enqueueOrder(OrderMessage order);
+    bool cancelPendingOrder(int orderId);
+    bool finishOrder(int orderId);      // 로봇에서 모든 단계가 끝난 주문 정리
+    bool reprioritizePendingOrder(int orderId, OrderPriority priority);
+    int pendingOrderCount() const { return pendingOrders.size(); }
+    int availableCredits() const;
+
+    // 완료 시각 예측: 지금 접수한다면 / 접수 시 약속한 시간
+    CompletionEstimate estimateCompletion() const;
+    CompletionEstimate promisedCompletion(int orderId) const;
+    const CompletionPredictor& completionPredictor() const { return predictor; }
+
+    // 로봇별 부하 (연결 ID 기준)
+    OrderDispatcher& orderDispatcher() { return dispatcher; }
+    const OrderDispatcher& orderDispatcher() const { return dispatcher; }
 
 signals:
     void orderStatusChanged(int orderId, const QString& status);
     void orderCompleted(int orderId);
-    void newOrderCreated(const OrderMessage& order);
+    // 주문은 orderTable()의 핸들로 전달 (OrderMessage를 복사하지 않음, 직접 연결에서만 사용)
+    void newOrderCreated(OrderHandle handle);
+    void orderDispatched(int connectionId, OrderHandle handle);   // 로봇으로 전송할 주문
+    // 로봇이 거절했거나 연결이 끊긴 로봇에 보냈던 주문이 대기열로 돌아옴 (다시 전송되기 전에 발생)
+    void orderRequeued(int connectionId, OrderHandle handle, const QString& reason);
+    // 로봇이 알린 조리 단계 진행 (COMPLETE_STEP이면 이어서 orderCompleted가 오고 핸들은 무효가 됨)
+    void orderStepChanged(OrderHandle handle);
+    void flowControlChanged(int pendingCount, int credits);
+    void robotLoadChanged(int connectionId);
     void logMessage(const QString& message);
 
 public slots:
+    // 로봇이 보낸 흐름 제어, 부하, 주문 단계, 거절 (NetworkManager::messageReceivedFrom에 직접 연결)
+    // 그 밖의 메시지(장치 상태, 구독 요청)는 화면과 StatusPublisher가 처리하므로 무시
+    void handleRobotMessage(int connectionId, const Message& message);
+    // 장치 상태 기록, 작업 시작/완료에 맞춰 그 모듈 단계에 있는 주문을 진행
     void handleDeviceStatusUpdate(const DeviceStatusMessage& status);
     void handleOrderStatusUpdate(int orderId, const QString& module, OrderStatus status);
 
+    // 흐름 제어 및 로봇 분배 (connectionId: 로봇 연결 ID)
+    void handleFlowControl(int connectionId, const FlowControlMessage& flow);
+    void handleRobotLoad(int connectionId, const RobotLoadMessage& load);
+    void handleOrderRejected(int connectionId, int orderId, const QString& reason);
+    void handleOrderSendFailed(int connectionId, int orderId);
+    // 로봇 연결의 보내기 대기량이 높은 수위를 넘으면 그 로봇으로는 보내지 않고, 풀리면 대기열을 이어서 보냄
+    void handleSendBackpressure(int connectionId, bool congested);
+    void handleRobotConnected(int connectionId);
+    void handleRobotDisconnected(int connectionId);
+
 private:
     int nextOrderId;
-    QMap<int, OrderMessage> activeOrders;
-    QQueue<OrderMessage> pendingOrders;
+    OrderTable activeOrders;
+    QList<OrderHandle> pendingOrders;   // 우선순위 > 약속 시각 > 주문 ID 순
+
+    // 로봇 연결 ID -> 보냈지만 아직 끝나지 않은 주문 (연결이 끊기면 대기열로 되돌림)
+    QMap<int, QList<OrderHandle>> dispatchedOrders;
+
+    OrderDispatcher dispatcher;         // 로봇별 크레딧과 부하
+    CompletionPredictor predictor;
+
+    // 지표 (시간은 마이크로초)
+    MetricCounter* ordersReceived;
+    MetricCounter* ordersCompleted;
+    MetricCounter* ordersRejected;
+    MetricHistogram* queueWait;         // 접수 -> 로봇 전송
+    MetricHistogram* orderLatency;      // 접수 -> 완료
+    MetricGauge* pendingGauge;
+    MetricGauge* creditsGauge;
+
+    // 로봇별 연결 상태와 부하 (라벨 robot=연결 ID)
+    struct RobotMetrics {
+        MetricGauge* connected = nullptr;
+        MetricGauge* credits = nullptr;
+        MetricGauge* backlog = nullptr;
+        QMap<QString, MetricGauge*> moduleWaiting;
+        QMap<QString, MetricGauge*> moduleBusy;
+    };
+    QMap<int, RobotMetrics> robotMetrics;
+
+    void insertPending(OrderHandle handle);
+    bool comesBefore(OrderHandle a, OrderHandle b) const;
+    void dispatchPendingOrders();
+    void forgetDispatched(OrderHandle handle);
+    void publishFlowControl();
+    void recordCompletion(OrderHandle handle, qint64 now);
+    void updateRobotMetrics(int connectionId);
 
-    void updateOrderStatus(int orderId, const QString& module, OrderStatus status);
-    bool isOrderComplete(const OrderMessage& order) const;
+    void updateOrderStatus(OrderHandle handle, const QString& module, OrderStatus status);
+    void advanceOrderStep(OrderHandle handle, OrderStatus status);
+    // 주문마다 일어나는 이벤트: 이진 로그에 기록하고, logMessage 문장은 받는 쪽이 있을 때만 만듦
+    template <typename... Args>
+    void logOrderEvent(LogEvent event, const Args&... args);
+    bool isOrderComplete(const OrderDetails& order) const;
 };
 
 #endif // ORDERMANAGER_H
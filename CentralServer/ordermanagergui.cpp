@@ -1,9 +1,11 @@
 // ordermanagergui.cpp
 #include "ordermanagergui.h"
+#include "logging.h"
+#include <QDateTime>
 
 OrderManagerGUI::OrderManagerGUI(QWidget *parent)
     : QMainWindow(parent)
-    , nextOrderId(1)
+    , orderManager(new OrderManager(this))
 {
     centralWidget = new QWidget(this);
     setCentralWidget(centralWidget);
@@ -12,12 +14,25 @@ OrderManagerGUI::OrderManagerGUI(QWidget *parent)
     initializeGUI();
     setupNetworkConnections();
 
+    // 주문 처리 중에는 이진 로그에 기록만 하고, 문장은 로그 창을 갱신할 때 만듦
+    // (main에서 --binary-log로 시작하지 않았으면 파일 없이 화면용으로만 시작)
+    BinaryLogger& binaryLog = BinaryLogger::instance();
+    if (!binaryLog.isRunning()) {
+        QString error;
+        binaryLog.start(BinaryLogSettings(), error);
+    }
+    binaryLog.setTailEnabled(true);
+    logTailTimer = new QTimer(this);
+    connect(logTailTimer, &QTimer::timeout, this, &OrderManagerGUI::showLoggedEvents);
+    logTailTimer->start(LogTailIntervalMs);
+
     setWindowTitle("샌드위치 주문 관리 시스템");
     setMinimumSize(400, 600);
 }
 
 OrderManagerGUI::~OrderManagerGUI()
 {
+    BinaryLogger::instance().setTailEnabled(false);
     if (networkManager) {
         networkManager->stopServer();
         delete networkManager;
@@ -29,6 +44,7 @@ void OrderManagerGUI::initializeGUI()
     setupServerControl();
     setupOrderInputs();
     setupOrderStatusTable();
+    setupRobotLoadTable();
 }
 
 void OrderManagerGUI::setupServerControl()
@@ -119,6 +135,27 @@ void OrderManagerGUI::setupOrderInputs()
     cheeseLayout->addStretch();
     mainLayout->addLayout(cheeseLayout);
 
+    // 주문 채널 / 우선순위 / 픽업 시간
+    channelLabel = new QLabel("주문 채널:", this);
+    channelComboBox = new QComboBox(this);
+    channelComboBox->addItem("매장", static_cast<int>(OrderChannel::DINE_IN));
+    channelComboBox->addItem("포장", static_cast<int>(OrderChannel::TAKEOUT));
+    channelComboBox->addItem("배달", static_cast<int>(OrderChannel::DELIVERY));
+    urgentCheckBox = new QCheckBox("급한 주문", this);
+    pickupLabel = new QLabel("픽업 시간(분):", this);
+    pickupSpinBox = new QSpinBox(this);
+    pickupSpinBox->setRange(0, 180);
+    pickupSpinBox->setSpecialValueText("지정 안 함");
+
+    QHBoxLayout *channelLayout = new QHBoxLayout;
+    channelLayout->addWidget(channelLabel);
+    channelLayout->addWidget(channelComboBox);
+    channelLayout->addWidget(urgentCheckBox);
+    channelLayout->addWidget(pickupLabel);
+    channelLayout->addWidget(pickupSpinBox);
+    channelLayout->addStretch();
+    mainLayout->addLayout(channelLayout);
+
     // 주문 제출 버튼
     submitButton = new QPushButton("주문 제출", this);
     mainLayout->addWidget(submitButton);
@@ -129,11 +166,18 @@ void OrderManagerGUI::setupOrderInputs()
 void OrderManagerGUI::setupOrderStatusTable()
 {
     statusLabel = new QLabel("주문 상태:", this);
-    mainLayout->addWidget(statusLabel);
+    queueStatusLabel = new QLabel(this);
+
+    QHBoxLayout *statusLayout = new QHBoxLayout;
+    statusLayout->addWidget(statusLabel);
+    statusLayout->addStretch();
+    statusLayout->addWidget(queueStatusLabel);
+    mainLayout->addLayout(statusLayout);
+    updateQueueStatus(0, 0);
 
     orderStatusTable = new QTableWidget(this);
-    orderStatusTable->setColumnCount(3);
-    orderStatusTable->setHorizontalHeaderLabels(QStringList() << "주문 ID" << "세부 사항" << "상태");
+    orderStatusTable->setColumnCount(4);
+    orderStatusTable->setHorizontalHeaderLabels(QStringList() << "주문 ID" << "세부 사항" << "상태" << "예상 완료");
     orderStatusTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     orderStatusTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
     mainLayout->addWidget(orderStatusTable);
@@ -147,20 +191,60 @@ void OrderManagerGUI::setupOrderStatusTable()
     mainLayout->addWidget(logTextEdit);
 }
 
+void OrderManagerGUI::setupRobotLoadTable()
+{
+    robotLoadLabel = new QLabel("로봇 부하:", this);
+    mainLayout->addWidget(robotLoadLabel);
+
+    robotLoadTable = new QTableWidget(this);
+    robotLoadTable->setColumnCount(4);
+    robotLoadTable->setHorizontalHeaderLabels(QStringList() << "로봇" << "보관 주문" << "크레딧" << "예상 완료");
+    robotLoadTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    robotLoadTable->verticalHeader()->setVisible(false);
+    robotLoadTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    robotLoadTable->setMaximumHeight(120);
+    mainLayout->addWidget(robotLoadTable);
+}
+
 void OrderManagerGUI::setupNetworkConnections()
 {
     networkManager = new NetworkManager(this, true);  // 서버 모드
 
-    connect(networkManager, &NetworkManager::messageReceived,
+    // 주문에 관한 메시지는 화면을 거치지 않고 OrderManager로 바로 감 (화면은 장치 상태만)
+    connect(networkManager, &NetworkManager::messageReceivedFrom,
+            orderManager, &OrderManager::handleRobotMessage);
+    connect(networkManager, &NetworkManager::messageReceivedFrom,
             this, &OrderManagerGUI::handleNetworkMessage);
     connect(networkManager, &NetworkManager::errorOccurred,
             this, &OrderManagerGUI::handleNetworkError);
-    connect(networkManager, &NetworkManager::connected,
+    connect(networkManager, &NetworkManager::clientConnected,
             this, &OrderManagerGUI::handleNetworkConnection);
-    connect(networkManager, &NetworkManager::disconnected,
+    connect(networkManager, &NetworkManager::clientDisconnected,
             this, &OrderManagerGUI::handleNetworkDisconnection);
+    connect(networkManager, &NetworkManager::sendBackpressure,
+            this, &OrderManagerGUI::handleSendBackpressure);
+
+    statusPublisher = new StatusPublisher(networkManager, this);
+    connect(statusPublisher, &StatusPublisher::subscriberAdded,
+            this, &OrderManagerGUI::handleSubscriberAdded);
+    connect(orderManager, &OrderManager::robotLoadChanged,
+            this, &OrderManagerGUI::publishRobotStatus);
     connect(startServerButton, &QPushButton::clicked,
             this, &OrderManagerGUI::onStartServerClicked);
+
+    connect(orderManager, &OrderManager::newOrderCreated,
+            this, &OrderManagerGUI::handleOrderQueued);
+    connect(orderManager, &OrderManager::orderDispatched,
+            this, &OrderManagerGUI::handleOrderDispatched);
+    connect(orderManager, &OrderManager::orderRequeued,
+            this, &OrderManagerGUI::handleOrderRequeued);
+    connect(orderManager, &OrderManager::orderStepChanged,
+            this, &OrderManagerGUI::handleOrderStepChanged);
+    // 수신한 메시지를 한꺼번에 처리할 때 메시지마다 표를 다시 그리지 않도록 모아서 갱신
+    connect(orderManager, &OrderManager::flowControlChanged,
+            this, &OrderManagerGUI::scheduleStatusRefresh);
+    connect(orderManager, &OrderManager::robotLoadChanged,
+            this, &OrderManagerGUI::scheduleStatusRefresh);
 }
 
 QString OrderManagerGUI::validateOrder()
@@ -190,16 +274,28 @@ void OrderManagerGUI::onStartServerClicked()
         portSpinBox->setEnabled(true);
         updateNetworkStatus("서버가 중지되었습니다", "orange");
     } else {
-        startServerButton->setEnabled(false);
-        updateNetworkStatus("서버 시작 중...", "orange");
+        startServer(static_cast<quint16>(portSpinBox->value()));
+    }
+}
 
-        if (networkManager->startServer(portSpinBox->value())) {
-            startServerButton->setText("서버 중지");
-            portSpinBox->setEnabled(false);
-            updateNetworkStatus(QString("서버 실행 중 (포트: %1)").arg(portSpinBox->value()), "green");
-        }
-        startServerButton->setEnabled(true);
+bool OrderManagerGUI::startServer(quint16 port)
+{
+    if (networkManager->isServerRunning()) {
+        return true;
     }
+
+    startServerButton->setEnabled(false);
+    portSpinBox->setValue(port);
+    updateNetworkStatus("서버 시작 중...", "orange");
+
+    const bool started = networkManager->startServer(port);
+    if (started) {
+        startServerButton->setText("서버 중지");
+        portSpinBox->setEnabled(false);
+        updateNetworkStatus(QString("서버 실행 중 (포트: %1)").arg(port), "green");
+    }
+    startServerButton->setEnabled(true);
+    return started;
 }
 
 void OrderManagerGUI::onOrderSubmit()
@@ -217,7 +313,8 @@ void OrderManagerGUI::onOrderSubmit()
 
     try {
         OrderMessage order;
-        order.orderId = nextOrderId;
+        order.orderId = 0;  // OrderManager가 발급
+        order.status = OrderStatus::WAITING;
         order.bread = breadButtonGroup->checkedButton()->text();
         order.egg = eggButtonGroup->checkedButton()->text();
 
@@ -232,172 +329,207 @@ void OrderManagerGUI::onOrderSubmit()
         if (cheddarCheckBox->isChecked())
             order.cheeses << "체다";
 
-        Message message;
-        message.type = MessageType::ORDER_NEW;
-        message.data = order.toJson();
-
-        if (networkManager->sendMessage(message)) {
-            ActiveOrder activeOrder;
-            activeOrder.order = order;
-            activeOrder.currentStep = BREAD_STEP;
-            activeOrder.isProcessing = false;
-            activeOrder.status = "대기 중";
+        order.channel = static_cast<OrderChannel>(channelComboBox->currentData().toInt());
+        order.priority = urgentCheckBox->isChecked() ? OrderPriority::HIGH : OrderPriority::NORMAL;
+        if (pickupSpinBox->value() > 0) {
+            order.deadline = QDateTime::currentMSecsSinceEpoch() +
+                             static_cast<qint64>(pickupSpinBox->value()) * 60 * 1000;
+        }
 
-            activeOrders[nextOrderId] = activeOrder;
-            updateOrderStatusTable(nextOrderId, "빵 준비 대기 중", "대기 중");
-            appendLog(QString("새로운 주문이 접수되었습니다. (주문 ID: %1)").arg(nextOrderId));
+        // 요청한 픽업 시간이 가장 빠른 예상 완료보다 이르면 접수하지 않음
+        const CompletionEstimate quote = orderManager->estimateCompletion();
+        if (quote.valid && order.deadline > 0 &&
+            order.deadline < QDateTime::currentMSecsSinceEpoch() + quote.lowerMs) {
+            appendLog(QString("주문 오류: 요청한 픽업 시간까지 완성할 수 없습니다. (예상 %1)")
+                          .arg(formatMinutes(quote.etaMs)));
+            return;
+        }
+        if (quote.valid && quote.etaMs > RushHourEtaMs) {
+            appendLog(QString("혼잡: 예상 완료까지 %1 걸립니다.").arg(formatMinutes(quote.etaMs)));
+        }
 
-            nextOrderId++;
+        // 로봇에 여유(크레딧)가 있으면 바로 전송되고, 없으면 서버 대기열에서 기다림
+        if (orderManager->enqueueOrder(order) > 0) {
             resetOrderForm();
         } else {
-            appendLog("주문 전송 실패: 서버 연결을 확인해주세요.");
+            appendLog("주문 오류: 주문을 대기열에 넣지 못했습니다.");
         }
     } catch (const std::exception& e) {
-        qDebug() << "Order submit error:" << e.what();
+        qCWarning(lcOrders) << "Order submit error:" << e.what();
         appendLog(QString("주문 처리 중 오류 발생: %1").arg(e.what()));
     }
 }
-void OrderManagerGUI::handleNetworkMessage(const Message& message)
+
+void OrderManagerGUI::handleOrderQueued(OrderHandle handle)
 {
-    try {
-        qDebug() << "Received message type:" << static_cast<int>(message.type);
-        qDebug() << "Message data:" << message.data;
+    const int orderId = orderManager->orderTable().orderId(handle);
+    updateOrderStatusTable(orderId, "서버 대기열", "대기 중");
+    updateOrderEta(orderId, orderManager->promisedCompletion(orderId),
+                   QDateTime::currentMSecsSinceEpoch());
+    BinaryLogger::instance().log(LogEvent::OrderAccepted, orderId);
+}
 
-        switch (message.type) {
-        case MessageType::DEVICE_STATUS_UPDATE: {
-            DeviceStatusMessage status = DeviceStatusMessage::fromJson(message.data);
-            QString statusStr = status.status == DeviceStatus::ON ? "작동 중" : "대기 중";
-
-            // 디바이스 상태에 따른 주문 상태 업데이트 추가
-            if (!status.currentTask.isEmpty()) {
-                // 작업 시작 시
-                for (auto it = activeOrders.begin(); it != activeOrders.end(); ++it) {
-                    if (!it.value().isProcessing) {
-                        QString currentStepModule;
-                        switch (it.value().currentStep) {
-                        case BREAD_STEP: currentStepModule = "Bread"; break;
-                        case CHEESE_STEP: currentStepModule = "Cheese"; break;
-                        case EGG_STEP: currentStepModule = "Egg"; break;
-                        case JAM_STEP: currentStepModule = "Jam"; break;
-                        default: continue;
-                        }
-
-                        if (status.moduleType == currentStepModule) {
-                            Message orderUpdate;
-                            orderUpdate.type = MessageType::ORDER_STATUS_UPDATE;
-                            QJsonObject updateData;
-                            updateData["orderId"] = it.key();
-                            updateData["module"] = status.moduleType;
-                            updateData["status"] = static_cast<int>(OrderStatus::PROCESSING);
-                            orderUpdate.data = updateData;
-                            handleNetworkMessage(orderUpdate);
-                            break;
-                        }
-                    }
-                }
-            } else {
-                // 작업 완료 시
-                for (auto it = activeOrders.begin(); it != activeOrders.end(); ++it) {
-                    if (it.value().isProcessing) {
-                        QString currentStepModule;
-                        switch (it.value().currentStep) {
-                        case BREAD_STEP: currentStepModule = "Bread"; break;
-                        case CHEESE_STEP: currentStepModule = "Cheese"; break;
-                        case EGG_STEP: currentStepModule = "Egg"; break;
-                        case JAM_STEP: currentStepModule = "Jam"; break;
-                        default: continue;
-                        }
-
-                        if (status.moduleType == currentStepModule) {
-                            Message orderUpdate;
-                            orderUpdate.type = MessageType::ORDER_STATUS_UPDATE;
-                            QJsonObject updateData;
-                            updateData["orderId"] = it.key();
-                            updateData["module"] = status.moduleType;
-                            updateData["status"] = static_cast<int>(OrderStatus::COMPLETED);
-                            orderUpdate.data = updateData;
-                            handleNetworkMessage(orderUpdate);
-                            break;
-                        }
-                    }
-                }
-            }
+void OrderManagerGUI::handleOrderDispatched(int connectionId, OrderHandle handle)
+{
+    const OrderTable& orders = orderManager->orderTable();
+    const int orderId = orders.orderId(handle);
 
-            appendLog(QString("%1 장치 %2: %3 - %4")
-                          .arg(status.moduleType)
-                          .arg(status.deviceIndex)
-                          .arg(statusStr)
-                          .arg(status.currentTask));
-            break;
+    Message message;
+    message.type = MessageType::ORDER_NEW;
+    message.data = orders.toJson(handle);
+
+    if (!networkManager->sendMessageTo(connectionId, message)) {
+        appendLog(QString("주문 전송 실패: 서버 연결을 확인해주세요. (주문 ID: %1)").arg(orderId));
+        orderManager->handleOrderSendFailed(connectionId, orderId);
+        return;
+    }
+
+    markOrderDirty(orderId, "빵 준비 대기 중", "대기 중");
+    BinaryLogger::instance().log(LogEvent::OrderSent, connectionId, orderId);
+}
+
+void OrderManagerGUI::handleOrderRequeued(int connectionId, OrderHandle handle, const QString& reason)
+{
+    // 진행 단계는 다시 전송될 때 빵부터 새로 시작
+    const int orderId = orderManager->orderTable().orderId(handle);
+    appendLog(QString("주문 %1이(가) 로봇 %2에서 서버 대기열로 돌아왔습니다 - %3")
+                  .arg(orderId).arg(connectionId).arg(reason));
+    markOrderDirty(orderId, "서버 대기열", "재전송 대기");
+}
+
+void OrderManagerGUI::handleOrderStepChanged(OrderHandle handle)
+{
+    static const char* const stepNames[] = { "빵", "치즈", "계란", "잼" };
+
+    const OrderTable& orders = orderManager->orderTable();
+    const int orderId = orders.orderId(handle);
+    const int step = orders.step(handle);
+    QString stepText;
+    QString statusText;
+    if (step == OrderManager::COMPLETE_STEP) {
+        stepText = "주문 완료";
+        statusText = "완료";
+    } else if (step >= OrderManager::BREAD_STEP && step < OrderManager::COMPLETE_STEP) {
+        const bool processing = orders.isProcessing(handle);
+        stepText = QString("%1 준비 %2").arg(stepNames[step]).arg(processing ? "중" : "대기 중");
+        statusText = processing ? "처리 중" : "대기 중";
+    } else {
+        return;
+    }
+
+    markOrderDirty(orderId, stepText, statusText);
+    BinaryLogger::instance().log(LogEvent::OrderStepChanged, orderId, stepText, statusText);
+}
+
+void OrderManagerGUI::updateQueueStatus(int pendingCount, int credits)
+{
+    QString text = QString("대기열: %1건 / 크레딧: %2").arg(pendingCount).arg(credits);
+    QString color = "black";
+
+    const CompletionEstimate estimate = orderManager->estimateCompletion();
+    if (estimate.valid) {
+        text += QString(" / 예상 완료: %1").arg(formatMinutes(estimate.etaMs));
+        if (estimate.etaMs > RushHourEtaMs) {
+            text += " (혼잡)";
+            color = "red";
         }
-        case MessageType::ORDER_STATUS_UPDATE: {
-            int orderId = message.data["orderId"].toInt();
-            QString module = message.data["module"].toString();
-            OrderStatus status = static_cast<OrderStatus>(message.data["status"].toInt());
-
-            if (!activeOrders.contains(orderId)) {
-                qDebug() << "Order not found in activeOrders:" << orderId;
-                return;
-            }
+    }
 
-            ActiveOrder& activeOrder = activeOrders[orderId];
-            QString stepText;
-            QString statusText;
-
-            if (status == OrderStatus::PROCESSING) {
-                activeOrder.isProcessing = true;
-                statusText = "처리 중";
-
-                switch (activeOrder.currentStep) {
-                case BREAD_STEP: stepText = "빵 준비 중"; break;
-                case CHEESE_STEP: stepText = "치즈 준비 중"; break;
-                case EGG_STEP: stepText = "계란 준비 중"; break;
-                case JAM_STEP: stepText = "잼 준비 중"; break;
-                default: stepText = "알 수 없는 단계";
-                }
-            }
-            else if (status == OrderStatus::COMPLETED) {
-                activeOrder.isProcessing = false;
-
-                switch (activeOrder.currentStep) {
-                case BREAD_STEP:
-                    activeOrder.currentStep = CHEESE_STEP;
-                    stepText = "치즈 준비 대기 중";
-                    break;
-                case CHEESE_STEP:
-                    activeOrder.currentStep = EGG_STEP;
-                    stepText = "계란 준비 대기 중";
-                    break;
-                case EGG_STEP:
-                    activeOrder.currentStep = JAM_STEP;
-                    stepText = "잼 준비 대기 중";
-                    break;
-                case JAM_STEP:
-                    activeOrder.currentStep = COMPLETE_STEP;
-                    stepText = "주문 완료";
-                    statusText = "완료";
-                    break;
-                default:
-                    stepText = "알 수 없는 단계";
-                }
-
-                if (statusText.isEmpty()) {
-                    statusText = "대기 중";
-                }
-            }
+    queueStatusLabel->setText(text);
+    queueStatusLabel->setStyleSheet(QString("QLabel { color: %1; }").arg(color));
+}
 
-            if (!stepText.isEmpty()) {
-                updateOrderStatusTable(orderId, stepText, statusText);
-                appendLog(QString("주문 %1: %2 - %3").arg(orderId).arg(stepText).arg(statusText));
+void OrderManagerGUI::updateRobotLoadTable()
+{
+    const OrderDispatcher& dispatcher = orderManager->orderDispatcher();
+    const QList<int> robotIds = dispatcher.robotIds();
+
+    robotLoadTable->setRowCount(robotIds.size());
+    for (int row = 0; row < robotIds.size(); ++row) {
+        const RobotState* robot = dispatcher.robot(robotIds.at(row));
+        const qint64 etaMs = dispatcher.estimateCompletionMs(robot->connectionId);
+
+        const QStringList cells = QStringList()
+            << QString::number(robot->connectionId)
+            << QString::number(robot->load.backlog + robot->unreportedOrders())
+            << QString::number(robot->credits())
+            << QString("%1초").arg(etaMs / 1000);
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem* item = new QTableWidgetItem(cells.at(column));
+            item->setTextAlignment(Qt::AlignCenter);
+            robotLoadTable->setItem(row, column, item);
+        }
+    }
+
+    // 부하가 바뀌면 예상 완료 시간도 바뀜
+    updateQueueStatus(orderManager->pendingOrderCount(), orderManager->availableCredits());
+}
+
+void OrderManagerGUI::scheduleStatusRefresh()
+{
+    if (statusRefreshPending) {
+        return;
+    }
+    statusRefreshPending = true;
+    QTimer::singleShot(0, this, &OrderManagerGUI::refreshStatus);
+}
+
+void OrderManagerGUI::refreshStatus()
+{
+    statusRefreshPending = false;
+    updateRobotLoadTable();
+}
+
+void OrderManagerGUI::handleDeviceStatus(int connectionId, const DeviceStatusMessage& status)
+{
+    // 작업 시작/완료에 맞춘 주문 단계 진행과 이진 로그 기록은 OrderManager가 함
+    orderManager->handleDeviceStatusUpdate(status);
+
+    QJsonObject deviceEvent = status.toJson();
+    deviceEvent["robot"] = connectionId;
+    statusPublisher->publish("devices", deviceKey(connectionId, status), deviceEvent);
+}
+
+void OrderManagerGUI::handleNetworkMessage(int connectionId, const Message& message)
+{
+    try {
+        // 본문 전체를 출력하면 프레임마다 JSON 직렬화가 일어나므로 종류와 주문 ID만
+        qCDebug(lcNetwork) << "수신:" << messageTypeName(message.type) << "연결" << connectionId
+                           << "주문" << message.data.value("orderId").toInt(-1);
+
+        // 구독 요청은 StatusPublisher가 처리하고, 구독자는 읽기 전용이라 다른 메시지는 무시
+        if (message.type == MessageType::SUBSCRIBE || statusPublisher->isSubscriber(connectionId)) {
+            return;
+        }
+
+        switch (message.type) {
+        case MessageType::DEVICE_STATUS_UPDATE:
+            handleDeviceStatus(connectionId, DeviceStatusMessage::fromJson(message.data));
+            break;
+        case MessageType::DEVICE_STATE_SYNC: {
+            // 변경분을 풀어 예전 DEVICE_STATUS_UPDATE와 같은 순서로 처리
+            QVector<DeviceStatusMessage> changes;
+            QString error;
+            if (!deviceStates[connectionId].decode(DeviceStateSyncMessage::fromJson(message.data),
+                                                   changes, error)) {
+                qCWarning(lcNetwork) << "로봇" << connectionId << error;
+            }
+            for (const DeviceStatusMessage& status : changes) {
+                handleDeviceStatus(connectionId, status);
             }
             break;
         }
+        case MessageType::ORDER_STATUS_UPDATE:
+        case MessageType::FLOW_CONTROL:
+        case MessageType::ROBOT_LOAD:
+        case MessageType::ERROR_REPORT:
+            break;      // OrderManager::handleRobotMessage가 직접 받음
         default:
-            qDebug() << "Unknown message type received:" << static_cast<int>(message.type);
+            qCWarning(lcNetwork) << "Unknown message type received:" << static_cast<int>(message.type);
             break;
         }
     } catch (const std::exception& e) {
-        qDebug() << "Network message handling error:" << e.what();
+        qCWarning(lcNetwork) << "Network message handling error:" << e.what();
         appendLog(QString("네트워크 메시지 처리 중 오류: %1").arg(e.what()));
     }
 }
@@ -410,16 +542,114 @@ void OrderManagerGUI::handleNetworkError(const QString& error)
     portSpinBox->setEnabled(true);
 }
 
-void OrderManagerGUI::handleNetworkConnection()
+void OrderManagerGUI::handleNetworkConnection(int connectionId)
+{
+    appendLog(QString("클라이언트가 연결되었습니다. (로봇 %1)").arg(connectionId));
+    updateNetworkStatus(QString("클라이언트 %1대 연결됨").arg(networkManager->connectionCount()), "green");
+
+    // 로봇의 첫 흐름 제어 메시지가 올 때까지 이 로봇으로는 전송 보류
+    orderManager->handleRobotConnected(connectionId);
+}
+
+void OrderManagerGUI::handleSubscriberAdded(int connectionId)
+{
+    // 접속할 때는 로봇으로 등록되었으므로 분배 대상에서 뺌 (흐름 제어 전이라 주문은 가지 않았음)
+    appendLog(QString("상태 구독자가 연결되었습니다. (연결 %1: %2)")
+                  .arg(connectionId).arg(statusPublisher->topics(connectionId).join(", ")));
+    orderManager->handleRobotDisconnected(connectionId);
+
+    // 구독 전에 일어난 일은 발행되지 않았으므로 지금 보이는 상태를 이 구독자에게만 먼저 보냄
+    sendStatusSnapshot(connectionId);
+}
+
+void OrderManagerGUI::sendStatusSnapshot(int connectionId)
+{
+    // 아직 표에 반영하지 않은 변경부터 반영해 스냅샷과 뒤이은 발행이 어긋나지 않게 함
+    if (orderRefreshPending) {
+        refreshOrderTable();
+    }
+
+    // 주문 표에서 아직 끝나지 않은 주문의 행 (완료된 주문의 행은 화면에만 남김)
+    const OrderTable& orders = orderManager->orderTable();
+    for (int row = 0; row < orderStatusTable->rowCount(); ++row) {
+        const QTableWidgetItem* idItem = orderStatusTable->item(row, 0);
+        if (!idItem || orders.find(idItem->text().toInt()).isNull()) {
+            continue;
+        }
+        const QTableWidgetItem* stepItem = orderStatusTable->item(row, 1);
+        const QTableWidgetItem* statusItem = orderStatusTable->item(row, 2);
+        QJsonObject orderEvent;
+        orderEvent["orderId"] = idItem->text().toInt();
+        orderEvent["step"] = stepItem ? stepItem->text() : QString();
+        orderEvent["status"] = statusItem ? statusItem->text() : QString();
+        statusPublisher->sendSnapshot(connectionId, "orders", idItem->text(), orderEvent);
+    }
+
+    for (auto it = deviceStates.constBegin(); it != deviceStates.constEnd(); ++it) {
+        for (const DeviceStatusMessage& status : it.value().snapshot()) {
+            QJsonObject deviceEvent = status.toJson();
+            deviceEvent["robot"] = it.key();
+            statusPublisher->sendSnapshot(connectionId, "devices", deviceKey(it.key(), status), deviceEvent);
+        }
+    }
+
+    for (int robotId : orderManager->orderDispatcher().robotIds()) {
+        statusPublisher->sendSnapshot(connectionId, StatusPublisher::robotTopic(robotId), "load",
+                                      robotStatusEvent(robotId));
+    }
+}
+
+QString OrderManagerGUI::deviceKey(int connectionId, const DeviceStatusMessage& status)
+{
+    return QString("%1/%2/%3").arg(connectionId).arg(status.moduleType).arg(status.deviceIndex);
+}
+
+QJsonObject OrderManagerGUI::robotStatusEvent(int connectionId) const
 {
-    appendLog("클라이언트가 연결되었습니다.");
-    updateNetworkStatus("클라이언트 연결됨", "green");
+    const RobotState* robot = orderManager->orderDispatcher().robot(connectionId);
+    QJsonObject event;
+    event["robot"] = connectionId;
+    event["connected"] = robot != nullptr;
+    if (robot) {
+        event["credits"] = robot->credits();
+        event["congested"] = robot->congested;
+        event["backlog"] = robot->load.backlog + robot->unreportedOrders();
+        event["load"] = robot->load.toJson();
+    }
+    return event;
 }
 
-void OrderManagerGUI::handleNetworkDisconnection()
+void OrderManagerGUI::publishRobotStatus(int connectionId)
 {
-    appendLog("클라이언트 연결이 끊어졌습니다.");
-    updateNetworkStatus("클라이언트 연결 끊김", "orange");
+    statusPublisher->publish(StatusPublisher::robotTopic(connectionId), "load", robotStatusEvent(connectionId));
+}
+
+void OrderManagerGUI::handleNetworkDisconnection(int connectionId)
+{
+    if (statusPublisher->isSubscriber(connectionId)) {
+        return;     // StatusPublisher가 정리
+    }
+    deviceStates.remove(connectionId);
+    appendLog(QString("클라이언트 연결이 끊어졌습니다. (로봇 %1)").arg(connectionId));
+    if (networkManager->connectionCount() > 0) {
+        updateNetworkStatus(QString("클라이언트 %1대 연결됨").arg(networkManager->connectionCount()), "green");
+    } else {
+        updateNetworkStatus("클라이언트 연결 끊김", "orange");
+    }
+    orderManager->handleRobotDisconnected(connectionId);
+}
+
+void OrderManagerGUI::handleSendBackpressure(int connectionId, bool congested)
+{
+    if (statusPublisher->isSubscriber(connectionId)) {
+        return;     // StatusPublisher가 발행을 멈추고 모아 둠
+    }
+    if (congested) {
+        appendLog(QString("로봇 %1이(가) 데이터를 늦게 읽어 새 주문 전송을 멈춥니다.").arg(connectionId));
+    } else {
+        appendLog(QString("로봇 %1의 전송이 풀려 주문 전송을 다시 시작합니다.").arg(connectionId));
+    }
+    orderManager->handleSendBackpressure(connectionId, congested);
 }
 
 void OrderManagerGUI::updateNetworkStatus(const QString& status, const QString& color)
@@ -431,15 +661,43 @@ void OrderManagerGUI::updateNetworkStatus(const QString& status, const QString&
     }
 }
 
+void OrderManagerGUI::markOrderDirty(int orderId, const QString& step, const QString& status)
+{
+    OrderRow& row = dirtyOrders[orderId];
+    row.step = step;
+    row.status = status;
+    if (!orderRefreshPending) {
+        orderRefreshPending = true;
+        QTimer::singleShot(0, this, &OrderManagerGUI::refreshOrderTable);
+    }
+}
+
+void OrderManagerGUI::refreshOrderTable()
+{
+    orderRefreshPending = false;
+    QMap<int, OrderRow> rows;
+    rows.swap(dirtyOrders);
+    for (auto it = rows.constBegin(); it != rows.constEnd(); ++it) {
+        updateOrderStatusTable(it.key(), it.value().step, it.value().status);
+    }
+}
+
 void OrderManagerGUI::updateOrderStatusTable(int orderId, const QString& step, const QString& status)
 {
     // 테이블이 없으면 리턴
     if (!orderStatusTable) {
-        qDebug() << "Order status table is null";
+        qCWarning(lcGui) << "Order status table is null";
         return;
     }
 
-    qDebug() << "Updating table for order:" << orderId << "Step:" << step << "Status:" << status;
+    qCDebug(lcGui) << "Updating table for order:" << orderId << "Step:" << step << "Status:" << status;
+
+    // 주문 표에 보이는 내용을 그대로 구독자에게도 발행
+    QJsonObject orderEvent;
+    orderEvent["orderId"] = orderId;
+    orderEvent["step"] = step;
+    orderEvent["status"] = status;
+    statusPublisher->publish("orders", QString::number(orderId), orderEvent);
 
     int row = -1;
     // 기존 행 찾기
@@ -487,6 +745,39 @@ void OrderManagerGUI::updateOrderStatusTable(int orderId, const QString& step, c
     orderStatusTable->viewport()->update();
 }
 
+void OrderManagerGUI::updateOrderEta(int orderId, const CompletionEstimate& estimate, qint64 submittedAtMs)
+{
+    for (int row = 0; row < orderStatusTable->rowCount(); ++row) {
+        QTableWidgetItem* idItem = orderStatusTable->item(row, 0);
+        if (!idItem || idItem->text().toInt() != orderId) {
+            continue;
+        }
+
+        QString text = "알 수 없음";
+        if (estimate.valid) {
+            const QString format = "hh:mm";
+            text = QString("%1 (%2~%3)")
+                       .arg(QDateTime::fromMSecsSinceEpoch(submittedAtMs + estimate.etaMs).toString(format))
+                       .arg(QDateTime::fromMSecsSinceEpoch(submittedAtMs + estimate.lowerMs).toString(format))
+                       .arg(QDateTime::fromMSecsSinceEpoch(submittedAtMs + estimate.upperMs).toString(format));
+        }
+
+        QTableWidgetItem* etaItem = new QTableWidgetItem(text);
+        etaItem->setTextAlignment(Qt::AlignCenter);
+        orderStatusTable->setItem(row, 3, etaItem);
+        return;
+    }
+}
+
+QString OrderManagerGUI::formatMinutes(qint64 durationMs)
+{
+    const qint64 seconds = durationMs / 1000;
+    if (seconds < 60) {
+        return QString("%1초").arg(seconds);
+    }
+    return QString("약 %1분").arg((seconds + 30) / 60);
+}
+
 void OrderManagerGUI::resetOrderForm()
 {
     try {
@@ -510,14 +801,59 @@ void OrderManagerGUI::resetOrderForm()
         // 치즈 선택 초기화
         mozzarellaCheckBox->setChecked(false);
         cheddarCheckBox->setChecked(false);
+
+        // 채널 / 우선순위 / 픽업 시간 초기화
+        channelComboBox->setCurrentIndex(0);
+        urgentCheckBox->setChecked(false);
+        pickupSpinBox->setValue(0);
     } catch (const std::exception& e) {
-        qDebug() << "Form reset error:" << e.what();
+        qCWarning(lcGui) << "Form reset error:" << e.what();
+    }
+}
+
+bool OrderManagerGUI::isShownEvent(quint16 eventId)
+{
+    // OrderManager의 주문 생성/상태 기록은 아래 화면 기록과 겹치므로 파일에만 남김
+    switch (static_cast<LogEvent>(eventId)) {
+    case LogEvent::OrderAccepted:
+    case LogEvent::OrderSent:
+    case LogEvent::DeviceStatusReported:
+    case LogEvent::OrderStepChanged:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void OrderManagerGUI::showLoggedEvents()
+{
+    QVector<LogRecord> records;
+    for (const LogRecord& record : BinaryLogger::instance().takeTail()) {
+        if (isShownEvent(record.eventId)) {
+            records.append(record);
+        }
+    }
+
+    // 한꺼번에 많이 쌓였으면 최근 것만 표시 (전체 기록은 --binary-log 파일에 있음)
+    int first = 0;
+    if (records.size() > MaxLoggedEventsPerUpdate) {
+        first = records.size() - MaxLoggedEventsPerUpdate;
+        appendLog(QString("주문 기록 %1건 생략").arg(first));
+    }
+    for (int i = first; i < records.size(); ++i) {
+        appendLogAt(BinaryLog::render(records.at(i)),
+                    QDateTime::fromMSecsSinceEpoch(records.at(i).wallMs).time());
     }
 }
 
 void OrderManagerGUI::appendLog(const QString& message)
 {
-    QString timestamp = QTime::currentTime().toString("hh:mm:ss");
+    appendLogAt(message, QTime::currentTime());
+}
+
+void OrderManagerGUI::appendLogAt(const QString& message, const QTime& time)
+{
+    QString timestamp = time.toString("hh:mm:ss");
     QString logMessage = QString("[%1] %2").arg(timestamp).arg(message);
 
     if (logTextEdit) {
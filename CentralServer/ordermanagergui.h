@@ -16,11 +16,18 @@
 #include <QHeaderView>
 #include <QScrollBar>
 #include <QSpinBox>
+#include <QComboBox>
 #include <QTime>
+#include <QTimer>
 #include <QMessageBox>
 #include <QDebug>
+#include "binarylog.h"
+#include "devicestatesync.h"
 #include "networkmanager.h"
 #include "message.h"
+#include "ordertable.h"
+#include "ordermanager.h"
+#include "statuspublisher.h"
 
 class OrderManagerGUI : public QMainWindow
 {
@@ -31,13 +38,30 @@ public:
     ~OrderManagerGUI() override;
     QString validateOrder();
 
+    // 버튼과 같은 동작 (부하 시험 등에서 화면 조작 없이 시작)
+    bool startServer(quint16 port);
+    OrderManager* getOrderManager() const { return orderManager; }
+
 private slots:
     void onStartServerClicked();
     void onOrderSubmit();
-    void handleNetworkMessage(const Message& message);
+    void handleNetworkMessage(int connectionId, const Message& message);
     void handleNetworkError(const QString& error);
-    void handleNetworkConnection();
-    void handleNetworkDisconnection();
+    void handleNetworkConnection(int connectionId);
+    void handleNetworkDisconnection(int connectionId);
+    void handleSendBackpressure(int connectionId, bool congested);
+    void handleOrderQueued(OrderHandle handle);
+    void handleOrderDispatched(int connectionId, OrderHandle handle);
+    void handleOrderRequeued(int connectionId, OrderHandle handle, const QString& reason);
+    void handleOrderStepChanged(OrderHandle handle);
+    void updateQueueStatus(int pendingCount, int credits);
+    void updateRobotLoadTable();
+    void scheduleStatusRefresh();
+    void refreshStatus();
+    void refreshOrderTable();
+    void showLoggedEvents();
+    void handleSubscriberAdded(int connectionId);
+    void publishRobotStatus(int connectionId);
 
 private:
     // GUI 요소
@@ -70,47 +94,77 @@ private:
     QCheckBox *mozzarellaCheckBox;
     QCheckBox *cheddarCheckBox;
 
+    QLabel *channelLabel;
+    QComboBox *channelComboBox;
+    QCheckBox *urgentCheckBox;
+    QLabel *pickupLabel;
+    QSpinBox *pickupSpinBox;
+
     QPushButton *submitButton;
 
     // 주문 상태 및 로그
     QLabel *statusLabel;
+    QLabel *queueStatusLabel;
     QTableWidget *orderStatusTable;
+    QLabel *robotLoadLabel;
+    QTableWidget *robotLoadTable;
     QLabel *logLabel;
     QTextEdit *logTextEdit;
+    QTimer *logTailTimer;       // 주문마다 남는 기록은 이진 로그에서 모아 주기적으로 표시
+    bool statusRefreshPending = false;  // 부하/크레딧 변화는 한 번 깨어날 때 모아서 표시
 
     // 네트워크 매니저
     NetworkManager *networkManager;
+    // 읽기 전용 화면에 주문/장치/로봇 상태 발행
+    StatusPublisher *statusPublisher;
 
-    // 주문 관리
-    int nextOrderId;
-    enum OrderStep {
-        BREAD_STEP = 0,
-        CHEESE_STEP = 1,
-        EGG_STEP = 2,
-        JAM_STEP = 3,
-        COMPLETE_STEP = 4
-    };
+    // 주문 관리 (ID 발급, 서버 대기열, 로봇 크레딧, 조리 단계)
+    // 로봇이 보낸 흐름 제어/부하/단계/거절은 NetworkManager에서 바로 받음
+    OrderManager *orderManager;
+
+    // 예상 완료까지 이 시간을 넘으면 혼잡으로 표시
+    static const qint64 RushHourEtaMs = 20 * 60 * 1000;
+
+    // 로그 창 갱신 주기와 한 번에 표시하는 주문 기록 수 (넘으면 최근 것만)
+    static const int LogTailIntervalMs = 250;
+    static const int MaxLoggedEventsPerUpdate = 200;
 
-    struct ActiveOrder {
-        OrderMessage order;
-        OrderStep currentStep;
-        bool isProcessing;
+    // 로봇별 장치 상태 동기화 (DEVICE_STATE_SYNC 변경분을 풀 때 쓰는 장치/작업 표)
+    QMap<int, DeviceStateDecoder> deviceStates;
+
+    // 한 번 깨어날 때 바뀐 주문은 마지막 표시만 모아 표를 한 번씩 갱신하고 발행
+    struct OrderRow {
+        QString step;
         QString status;
     };
-
-    QMap<int, ActiveOrder> activeOrders;
+    QMap<int, OrderRow> dirtyOrders;
+    bool orderRefreshPending = false;
 
     // 초기화 함수
     void initializeGUI();
     void setupServerControl();
     void setupOrderInputs();
     void setupOrderStatusTable();
+    void setupRobotLoadTable();
     void setupNetworkConnections();
 
+    // 장치 상태 변경 하나 처리 (DEVICE_STATUS_UPDATE, 또는 DEVICE_STATE_SYNC에서 푼 변경)
+    void handleDeviceStatus(int connectionId, const DeviceStatusMessage& status);
+
+    // 구독자에게 발행하는 장치/로봇 상태 (실시간 발행과 새 구독자 스냅샷이 같은 모양을 씀)
+    static QString deviceKey(int connectionId, const DeviceStatusMessage& status);
+    QJsonObject robotStatusEvent(int connectionId) const;
+    void sendStatusSnapshot(int connectionId);
+
     // 유틸리티 함수
     void updateNetworkStatus(const QString& status, const QString& color);
     void updateOrderStatusTable(int orderId, const QString& status, const QString& details = "");
+    void markOrderDirty(int orderId, const QString& step, const QString& status);
+    void updateOrderEta(int orderId, const CompletionEstimate& estimate, qint64 submittedAtMs);
+    static QString formatMinutes(qint64 durationMs);
     void appendLog(const QString& message);
+    void appendLogAt(const QString& message, const QTime& time);
+    static bool isShownEvent(quint16 eventId);
     void resetOrderForm();
 };
 
@@ -0,0 +1,146 @@
+// sharedmemoryring.cpp
+#include "sharedmemoryring.h"
+#include <cstring>
+#include <new>
+
+SharedMemoryRing::SharedMemoryRing()
+    : header(nullptr)
+    , data(nullptr)
+    , mask(0)
+{
+}
+
+void SharedMemoryRing::bind(void* memory, int capacity)
+{
+    static_assert(ATOMIC_INT_LOCK_FREE == 2, "공유 메모리 링에는 잠금 없는 원자 변수가 필요합니다");
+    static_assert(sizeof(Header) <= HeaderSize, "머리말이 HeaderSize보다 큽니다");
+    Q_ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+
+    header = static_cast<Header*>(memory);
+    data = static_cast<char*>(memory) + HeaderSize;
+    mask = static_cast<quint32>(capacity - 1);
+}
+
+void SharedMemoryRing::initialize()
+{
+    new (header) Header;
+    header->head.store(0);
+    header->tail.store(0);
+    header->wakePending.store(0);
+    header->writerWaiting.store(0);
+}
+
+bool SharedMemoryRing::write(const QByteArray& payload)
+{
+    return write(payload.constData(), payload.size(), false);
+}
+
+bool SharedMemoryRing::write(const char* source, int size, bool more)
+{
+    const quint32 length = static_cast<quint32>(size);
+    const quint32 position = header->head.load(std::memory_order_relaxed);
+    // 자리가 났는지 확인하는 읽기는 markWriterWaiting과 순서를 맞추려고 seq_cst
+    const quint32 used = position - header->tail.load(std::memory_order_seq_cst);
+    if (used + sizeof(quint32) + length > mask + 1) {
+        return false;
+    }
+
+    const quint32 field = more ? (length | MoreFragments) : length;
+    copyIn(position, reinterpret_cast<const char*>(&field), sizeof(quint32));
+    copyIn(position + sizeof(quint32), source, size);
+    header->head.store(position + sizeof(quint32) + length, std::memory_order_seq_cst);
+    return true;
+}
+
+bool SharedMemoryRing::read(QByteArray& payload)
+{
+    for (;;) {
+        const quint32 position = header->tail.load(std::memory_order_relaxed);
+        if (position == header->head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        quint32 field = 0;
+        copyOut(position, reinterpret_cast<char*>(&field), sizeof(quint32));
+        const bool more = (field & MoreFragments) != 0;
+        const quint32 size = field & ~MoreFragments;
+        if (size > mask + 1 - sizeof(quint32)) {
+            // 상대가 영역을 잘못 썼음. 남은 기록은 믿을 수 없으므로 모두 버림
+            header->tail.store(header->head.load(std::memory_order_acquire), std::memory_order_seq_cst);
+            partial.clear();
+            return false;
+        }
+
+        // 조각이 아닌 기록은 바로 돌려주고, 조각은 마지막 것까지 모아서 돌려줌
+        if (!more && partial.isEmpty()) {
+            payload.resize(static_cast<int>(size));
+            copyOut(position + sizeof(quint32), payload.data(), static_cast<int>(size));
+            header->tail.store(position + sizeof(quint32) + size, std::memory_order_seq_cst);
+            return true;
+        }
+
+        const int offset = partial.size();
+        partial.resize(offset + static_cast<int>(size));
+        copyOut(position + sizeof(quint32), partial.data() + offset, static_cast<int>(size));
+        header->tail.store(position + sizeof(quint32) + size, std::memory_order_seq_cst);
+        if (!more) {
+            payload.swap(partial);
+            partial.clear();
+            return true;
+        }
+    }
+}
+
+bool SharedMemoryRing::isEmpty() const
+{
+    return header->tail.load(std::memory_order_relaxed) == header->head.load(std::memory_order_seq_cst);
+}
+
+int SharedMemoryRing::usedBytes() const
+{
+    // markWriterWaiting 뒤에 다시 확인할 때도 쓰므로 seq_cst
+    return static_cast<int>(header->head.load(std::memory_order_relaxed) -
+                            header->tail.load(std::memory_order_seq_cst));
+}
+
+bool SharedMemoryRing::requestWake()
+{
+    return header->wakePending.exchange(1, std::memory_order_seq_cst) == 0;
+}
+
+bool SharedMemoryRing::finishWake()
+{
+    header->wakePending.store(0, std::memory_order_seq_cst);
+    return !isEmpty() && requestWake();
+}
+
+void SharedMemoryRing::markWriterWaiting()
+{
+    header->writerWaiting.store(1, std::memory_order_seq_cst);
+}
+
+bool SharedMemoryRing::takeWriterWaiting()
+{
+    return header->writerWaiting.load(std::memory_order_seq_cst) != 0 &&
+           header->writerWaiting.exchange(0, std::memory_order_seq_cst) != 0;
+}
+
+void SharedMemoryRing::copyIn(quint32 position, const char* source, int size)
+{
+    const quint32 offset = position & mask;
+    const int first = qMin(size, static_cast<int>(mask + 1 - offset));
+    std::memcpy(data + offset, source, static_cast<size_t>(first));
+    if (first < size) {
+        std::memcpy(data, source + first, static_cast<size_t>(size - first));
+    }
+}
+
+void SharedMemoryRing::copyOut(quint32 position, char* target, int size) const
+{
+    const quint32 offset = position & mask;
+    const int first = qMin(size, static_cast<int>(mask + 1 - offset));
+    std::memcpy(target, data + offset, static_cast<size_t>(first));
+    if (first < size) {
+        std::memcpy(target + first, data, static_cast<size_t>(size - first));
+    }
+}
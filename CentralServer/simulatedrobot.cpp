@@ -0,0 +1,145 @@
+// simulatedrobot.cpp
+#include "simulatedrobot.h"
+#include <QTimer>
+
+SimulatedRobot::SimulatedRobot(QObject *parent)
+    : QObject(parent)
+    , network(nullptr, false)
+    , timeScale(1.0)
+    , window(1)
+    , received(0)
+    , held(0)
+    , completed(0)
+{
+    setStages(defaultStages());
+
+    connect(&network, &NetworkManager::messageReceived, this, &SimulatedRobot::handleMessage);
+    connect(&network, &NetworkManager::connected, this, [this]() {
+        received = 0;
+        sendFlowControl();
+    });
+}
+
+QVector<SimulatedRobot::Stage> SimulatedRobot::defaultStages()
+{
+    return QVector<Stage>()
+        << Stage{ "Bread", 2, 10000 }
+        << Stage{ "Cheese", 2, 3000 }
+        << Stage{ "Egg", 2, 7000 }
+        << Stage{ "Jam", 2, 4000 };
+}
+
+void SimulatedRobot::setStages(const QVector<Stage>& value)
+{
+    stages = value;
+    waiting = QVector<QQueue<int>>(stages.size());
+    deviceBusy.clear();
+    int devices = 0;
+    for (const Stage& stage : stages) {
+        deviceBusy.append(QVector<bool>(qMax(1, stage.devices), false));
+        devices += qMax(1, stage.devices);
+    }
+    window = qMax(1, devices * 2);
+}
+
+bool SimulatedRobot::connectToServer(const QString& address, quint16 port)
+{
+    return network.connectToServer(address, port);
+}
+
+void SimulatedRobot::disconnectFromServer()
+{
+    network.disconnectFromServer();
+}
+
+void SimulatedRobot::handleMessage(const Message& message)
+{
+    if (message.type != MessageType::ORDER_NEW) {
+        return;
+    }
+
+    const OrderMessage order = OrderMessage::fromJson(message.data);
+    received++;
+    if (held >= window) {
+        // RobotClient처럼 보관 한도를 넘으면 거절하고 서버 대기열로 돌려보냄
+        Message reject;
+        reject.type = MessageType::ERROR_REPORT;
+        QJsonObject data;
+        data["orderId"] = order.orderId;
+        data["reason"] = QString("로봇 보관 한도 초과 (%1/%2)").arg(held).arg(window);
+        reject.data = data;
+        network.sendMessage(reject);
+        sendFlowControl();
+        return;
+    }
+
+    held++;
+    waiting[0].enqueue(order.orderId);
+    startWork(0);
+}
+
+void SimulatedRobot::startWork(int stage)
+{
+    QVector<bool>& busy = deviceBusy[stage];
+    for (int device = 0; device < busy.size() && !waiting[stage].isEmpty(); ++device) {
+        if (busy[device]) {
+            continue;
+        }
+
+        const int orderId = waiting[stage].dequeue();
+        busy[device] = true;
+        sendDeviceStatus(stage, device, DeviceStatus::ON, orderId);
+
+        const int delayMs = static_cast<int>(stages.at(stage).serviceMs * timeScale);
+        QTimer::singleShot(delayMs, Qt::PreciseTimer, this, [this, stage, device, orderId]() {
+            finishWork(stage, device, orderId);
+        });
+    }
+}
+
+void SimulatedRobot::finishWork(int stage, int deviceIndex, int orderId)
+{
+    deviceBusy[stage][deviceIndex] = false;
+    sendDeviceStatus(stage, deviceIndex, DeviceStatus::OFF, orderId);
+
+    if (stage + 1 < stages.size()) {
+        waiting[stage + 1].enqueue(orderId);
+        startWork(stage + 1);
+    } else {
+        held--;
+        completed++;
+        emit orderFinished(orderId);
+        sendFlowControl();
+    }
+    startWork(stage);
+}
+
+void SimulatedRobot::sendDeviceStatus(int stage, int deviceIndex, DeviceStatus status, int orderId)
+{
+    // 작업 시작은 currentTask가 있고, 완료는 비어 있음 (서버가 이것으로 단계를 진행)
+    DeviceStatusMessage statusMessage;
+    statusMessage.moduleType = stages.at(stage).module;
+    statusMessage.deviceIndex = deviceIndex + 1;
+    statusMessage.status = status;
+    statusMessage.currentTask = status == DeviceStatus::ON ? stages.at(stage).module : QString();
+    statusMessage.orderId = orderId;
+
+    Message message;
+    message.type = MessageType::DEVICE_STATUS_UPDATE;
+    message.data = statusMessage.toJson();
+    network.sendMessage(message);
+}
+
+void SimulatedRobot::sendFlowControl()
+{
+    FlowControlMessage flow;
+    flow.window = window;
+    flow.backlog = held;
+    flow.received = received;
+    flow.limit = received + qMax(0, window - held);
+
+    Message message;
+    message.type = MessageType::FLOW_CONTROL;
+    message.data = flow.toJson();
+    network.sendMessage(message);
+}
@@ -0,0 +1,65 @@
+// simulatedrobot.h
+#ifndef SIMULATEDROBOT_H
+#define SIMULATEDROBOT_H
+
+#include <QObject>
+#include <QQueue>
+#include <QVector>
+#include "networkmanager.h"
+
+// 부하 시험용 가상 로봇
+// RobotClient와 같은 프로토콜(흐름 제어, 장치 상태, 거절 보고)로 서버에 접속하고
+// 단계별 장치 수와 처리 시간만 흉내 내므로 한 프로세스에서 여러 대를 띄울 수 있습니다.
+class SimulatedRobot : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Stage {
+        QString module;
+        int devices;
+        int serviceMs;
+    };
+
+    explicit SimulatedRobot(QObject *parent = nullptr);
+
+    // 서버의 주문 단계 순서(빵 -> 치즈 -> 계란 -> 잼)와 RobotClient 기본 구성 (모듈당 장치 2대)
+    static QVector<Stage> defaultStages();
+    void setStages(const QVector<Stage>& value);
+
+    // 처리 시간 배율 (0.01이면 빵 10초 -> 100ms)
+    void setTimeScale(double scale) { timeScale = qMax(0.0, scale); }
+    // 동시에 보관할 수 있는 주문 수 (기본: 장치 수 x 2, RobotClient와 같음)
+    void setWindow(int value) { window = qMax(1, value); }
+    int getWindow() const { return window; }
+
+    bool connectToServer(const QString& address, quint16 port);
+    void disconnectFromServer();
+
+    int backlog() const { return held; }
+    int completedOrders() const { return completed; }
+
+signals:
+    void orderFinished(int orderId);
+
+private slots:
+    void handleMessage(const Message& message);
+
+private:
+    NetworkManager network;
+    QVector<Stage> stages;
+    QVector<QQueue<int>> waiting;       // 단계별 대기 주문
+    QVector<QVector<bool>> deviceBusy;  // 단계별 장치 사용 여부
+    double timeScale;
+    int window;
+    int received;                       // 이번 연결에서 받은 주문 수
+    int held;                           // 보관 중인 주문 수
+    int completed;
+
+    void startWork(int stage);
+    void finishWork(int stage, int deviceIndex, int orderId);
+    void sendDeviceStatus(int stage, int deviceIndex, DeviceStatus status, int orderId);
+    void sendFlowControl();
+};
+
+#endif // SIMULATEDROBOT_H
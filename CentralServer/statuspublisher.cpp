@@ -0,0 +1,227 @@
+// statuspublisher.cpp
+#include "statuspublisher.h"
+#include "networkmanager.h"
+#include "logging.h"
+#include <QJsonDocument>
+
+StatusPublisher::StatusPublisher(NetworkManager* network, QObject* parent)
+    : QObject(parent)
+    , network(network)
+{
+    MetricsRegistry& metrics = MetricsRegistry::instance();
+    eventsPublished = metrics.counter("server_status_events_total", "구독자에게 발행한 상태 이벤트 수");
+    eventsConflated = metrics.counter("server_status_events_conflated_total", "보내기 전에 새 이벤트로 대체된 상태 이벤트 수");
+    framesEncoded = metrics.counter("server_status_frames_encoded_total", "발행하려고 만든 본문 수 (구독자 수와 무관)");
+    eventsDropped = metrics.counter("server_status_events_dropped_total", "멈춘 구독자에게 보내지 못하고 버린 상태 이벤트 수");
+    subscribersGauge = metrics.gauge("server_status_subscribers", "상태 구독자 연결 수");
+    pausedGauge = metrics.gauge("server_status_subscribers_paused", "혼잡해서 보내기를 멈춘 구독자 수");
+
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(FlushIntervalMs);
+    connect(&flushTimer, &QTimer::timeout, this, &StatusPublisher::flush);
+
+    connect(network, &NetworkManager::messageReceivedFrom, this, &StatusPublisher::handleMessage);
+    connect(network, &NetworkManager::clientDisconnected, this, &StatusPublisher::handleDisconnected);
+    connect(network, &NetworkManager::sendBackpressure, this, &StatusPublisher::handleBackpressure);
+}
+
+bool StatusPublisher::matches(const QString& subscription, const QString& topic)
+{
+    if (subscription.endsWith(QLatin1String("/*"))) {
+        return topic.startsWith(subscription.left(subscription.size() - 1));
+    }
+    return subscription == topic;
+}
+
+bool StatusPublisher::hasSubscriber(const QString& topic) const
+{
+    for (auto it = subscribers.constBegin(); it != subscribers.constEnd(); ++it) {
+        for (const QString& subscription : it.value()) {
+            if (matches(subscription, topic)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void StatusPublisher::publish(const QString& topic, const QString& key, const QJsonObject& event)
+{
+    // 아무도 보지 않는 주제는 모으지도 않음
+    if (!hasSubscriber(topic)) {
+        return;
+    }
+
+    if (!key.isEmpty()) {
+        const QString slot = topic + QLatin1Char('\n') + key;
+        auto it = pendingIndex.constFind(slot);
+        if (it != pendingIndex.constEnd()) {
+            pending[it.value()].event = event;
+            eventsConflated->add();
+            return;
+        }
+        pendingIndex.insert(slot, pending.size());
+    }
+
+    PendingEvent entry;
+    entry.topic = topic;
+    entry.key = key;
+    entry.event = event;
+    pending.append(entry);
+
+    if (pending.size() >= MaxPendingEvents) {
+        flush();
+    } else if (!flushTimer.isActive()) {
+        flushTimer.start();
+    }
+}
+
+void StatusPublisher::flush()
+{
+    flushTimer.stop();
+    QVector<PendingEvent> events;
+    events.swap(pending);
+    pendingIndex.clear();
+
+    QVector<int> targets;
+    for (const PendingEvent& entry : events) {
+        targets.clear();
+        for (auto it = subscribers.constBegin(); it != subscribers.constEnd(); ++it) {
+            for (const QString& subscription : it.value()) {
+                if (matches(subscription, entry.topic)) {
+                    if (held.contains(it.key())) {
+                        hold(it.key(), entry);
+                    } else {
+                        targets.append(it.key());
+                    }
+                    break;
+                }
+            }
+        }
+        if (targets.isEmpty()) {
+            continue;
+        }
+
+        // 구독자가 몇이든 본문은 한 번만 만듦
+        eventsPublished->add();
+        network->sendEncoded(targets, encode(entry));
+    }
+}
+
+void StatusPublisher::sendSnapshot(int connectionId, const QString& topic, const QString& key,
+                                   const QJsonObject& event)
+{
+    bool subscribed = false;
+    for (const QString& subscription : subscribers.value(connectionId)) {
+        if (matches(subscription, topic)) {
+            subscribed = true;
+            break;
+        }
+    }
+    if (!subscribed) {
+        return;
+    }
+
+    PendingEvent entry;
+    entry.topic = topic;
+    entry.key = key;
+    entry.event = event;
+    if (held.contains(connectionId)) {
+        hold(connectionId, entry);
+        return;
+    }
+    eventsPublished->add();
+    network->sendEncoded(QVector<int>(1, connectionId), encode(entry));
+}
+
+QByteArray StatusPublisher::encode(const PendingEvent& entry)
+{
+    PublishMessage publishMessage;
+    publishMessage.topic = entry.topic;
+    publishMessage.key = entry.key;
+    publishMessage.event = entry.event;
+    Message message;
+    message.type = MessageType::PUBLISH;
+    message.data = publishMessage.toJson();
+    framesEncoded->add();
+    return QJsonDocument(message.toJson()).toJson(QJsonDocument::Compact);
+}
+
+void StatusPublisher::hold(int connectionId, const PendingEvent& entry)
+{
+    // 키가 없는 이벤트는 합칠 수 없으므로 멈춘 동안에는 버림
+    HeldEvents& events = held[connectionId];
+    if (entry.key.isEmpty()) {
+        eventsDropped->add();
+        return;
+    }
+
+    const QString slot = entry.topic + QLatin1Char('\n') + entry.key;
+    auto it = events.index.constFind(slot);
+    if (it != events.index.constEnd()) {
+        events.events[it.value()].event = entry.event;
+        eventsConflated->add();
+        return;
+    }
+    if (events.events.size() >= MaxHeldEvents) {
+        eventsDropped->add();
+        return;
+    }
+    events.index.insert(slot, events.events.size());
+    events.events.append(entry);
+}
+
+void StatusPublisher::handleMessage(int connectionId, const Message& message)
+{
+    if (message.type != MessageType::SUBSCRIBE) {
+        return;
+    }
+
+    const bool added = !subscribers.contains(connectionId);
+    const SubscribeMessage subscribe = SubscribeMessage::fromJson(message.data);
+    subscribers.insert(connectionId, subscribe.topics);
+    subscribersGauge->set(subscribers.size());
+    qCInfo(lcNetwork) << "상태 구독 (연결" << connectionId << "):" << subscribe.topics.join(", ");
+
+    if (added) {
+        emit subscriberAdded(connectionId);
+    }
+}
+
+void StatusPublisher::handleDisconnected(int connectionId)
+{
+    if (subscribers.remove(connectionId) == 0) {
+        return;
+    }
+    held.remove(connectionId);
+    subscribersGauge->set(subscribers.size());
+    pausedGauge->set(held.size());
+    emit subscriberRemoved(connectionId);
+}
+
+void StatusPublisher::handleBackpressure(int connectionId, bool congested)
+{
+    if (!subscribers.contains(connectionId)) {
+        return;
+    }
+
+    if (congested) {
+        if (!held.contains(connectionId)) {
+            held.insert(connectionId, HeldEvents());
+            qCInfo(lcNetwork) << "구독자" << connectionId << "이(가) 늦게 읽어 상태 발행을 멈춥니다";
+        }
+        pausedGauge->set(held.size());
+        return;
+    }
+
+    // 풀리면 모아 둔 최신 상태를 처음 발행한 순서대로 보냄
+    const HeldEvents events = held.take(connectionId);
+    pausedGauge->set(held.size());
+    const QVector<int> target(1, connectionId);
+    for (const PendingEvent& entry : events.events) {
+        eventsPublished->add();
+        network->sendEncoded(target, encode(entry));
+    }
+    qCInfo(lcNetwork) << "구독자" << connectionId << "의 상태 발행을 다시 시작합니다 (모아 둔 이벤트"
+                      << events.events.size() << "개)";
+}
@@ -0,0 +1,102 @@
+// statuspublisher.h
+#ifndef STATUSPUBLISHER_H
+#define STATUSPUBLISHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "message.h"
+#include "metrics.h"
+
+class NetworkManager;
+
+// 읽기 전용 화면(주방 표시, 관리자 태블릿, 모니터링)에 주문/장치/로봇 상태를 발행
+// 구독자는 로봇과 같은 포트로 접속해 SUBSCRIBE를 보내며, 그때부터 로봇이 아닌 구독자로 취급됩니다.
+//
+// 주제: orders (주문 ID별 단계), devices (로봇/모듈/장치별 상태), robot/<연결 ID> (크레딧과 부하)
+// 발행한 이벤트는 FlushIntervalMs 동안 모았다가 이벤트마다 한 번만 JSON으로 만들고,
+// 같은 본문을 그 주제를 구독한 모든 연결에 보냅니다.
+// 한 주기 안에 같은 주제와 키의 이벤트가 다시 오면 앞의 것을 대체하고(합침),
+// 늦게 읽는 구독자는 NetworkManager가 혼잡을 알리면 보내기를 멈추고 키가 있는 이벤트만 최신 값으로 모아 두었다가
+// 풀리면 한꺼번에 보냅니다 (키가 없는 이벤트와 MaxHeldEvents를 넘는 이벤트는 버림).
+// 로봇 연결과 다른 구독자는 영향을 받지 않습니다.
+// 처음 구독한 연결에는 주문 표, 장치 상태, 로봇 부하의 현재 값을 그 연결에만 먼저 보냅니다 (sendSnapshot).
+class StatusPublisher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int FlushIntervalMs = 100;
+    static const int MaxPendingEvents = 4096;   // 넘으면 주기를 기다리지 않고 바로 보냄
+    static const int MaxHeldEvents = 1024;      // 멈춘 구독자마다 모아 두는 최대 이벤트 수
+
+    explicit StatusPublisher(NetworkManager* network, QObject* parent = nullptr);
+
+    bool isSubscriber(int connectionId) const { return subscribers.contains(connectionId); }
+    int subscriberCount() const { return subscribers.size(); }
+    QStringList topics(int connectionId) const { return subscribers.value(connectionId); }
+    // 혼잡해서 보내기를 멈춘 구독자와 그동안 모아 둔 이벤트 수
+    bool isPaused(int connectionId) const { return held.contains(connectionId); }
+    int heldEventCount(int connectionId) const { return held.value(connectionId).events.size(); }
+
+    // key가 비어 있지 않으면 아직 보내지 않은 같은 주제/키의 이벤트를 대체
+    void publish(const QString& topic, const QString& key, const QJsonObject& event);
+
+    // 새 구독자 한 연결에만 현재 상태를 바로 보냄 (구독한 주제만, 다른 구독자와 아직 보내지 않은 발행에는 영향 없음)
+    // subscriberAdded를 받은 쪽이 보이는 상태를 이벤트마다 한 번씩 넘김
+    void sendSnapshot(int connectionId, const QString& topic, const QString& key, const QJsonObject& event);
+
+    static QString robotTopic(int connectionId) { return QString("robot/%1").arg(connectionId); }
+    // "robot/*"는 모든 robot/<연결 ID>와 일치
+    static bool matches(const QString& subscription, const QString& topic);
+
+public slots:
+    void flush();
+
+signals:
+    // 로봇 목록에서 빼야 하는 연결 (처음 구독했을 때 한 번)
+    void subscriberAdded(int connectionId);
+    void subscriberRemoved(int connectionId);
+
+private slots:
+    void handleMessage(int connectionId, const Message& message);
+    void handleDisconnected(int connectionId);
+    void handleBackpressure(int connectionId, bool congested);
+
+private:
+    struct PendingEvent {
+        QString topic;
+        QString key;
+        QJsonObject event;
+    };
+
+    NetworkManager* network;
+    QMap<int, QStringList> subscribers;     // 연결 ID -> 구독 주제
+    QVector<PendingEvent> pending;          // 발행 순서 (합친 이벤트는 처음 자리에 둠)
+    QHash<QString, int> pendingIndex;       // 주제 + 키 -> pending 위치
+    QTimer flushTimer;
+
+    // 멈춘 구독자별로 모아 둔 이벤트 (같은 주제/키는 합침)
+    struct HeldEvents {
+        QVector<PendingEvent> events;
+        QHash<QString, int> index;
+    };
+    QMap<int, HeldEvents> held;
+
+    MetricCounter* eventsPublished;
+    MetricCounter* eventsConflated;
+    MetricCounter* framesEncoded;
+    MetricCounter* eventsDropped;
+    MetricGauge* subscribersGauge;
+    MetricGauge* pausedGauge;
+
+    bool hasSubscriber(const QString& topic) const;
+    QByteArray encode(const PendingEvent& entry);
+    void hold(int connectionId, const PendingEvent& entry);
+};
+
+#endif // STATUSPUBLISHER_H
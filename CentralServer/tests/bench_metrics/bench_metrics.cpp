@@ -0,0 +1,85 @@
+#include <QtTest/QtTest>
+#include <QThread>
+#include "metrics.h"
+#include "../benchbaseline.h"
+
+// 지표 기록 비용 (켜 둔 채로 운영해도 되는지 확인)
+// 각 반복에서 OperationsPerIteration번 기록하므로 결과를 그 수로 나누면 1회 비용
+class BenchMetrics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchCounterAdd();
+    void benchHistogramRecord();
+    void benchHistogramRecordContended();
+    void benchClock();
+
+private:
+    static const int OperationsPerIteration = 100000;
+};
+
+void BenchMetrics::benchCounterAdd()
+{
+    MetricCounter* counter = MetricsRegistry::instance().counter("bench_counter_total", "벤치마크");
+    QBENCHMARK {
+        for (int i = 0; i < OperationsPerIteration; ++i) {
+            counter->add();
+        }
+    }
+    QVERIFY(counter->value() > 0);
+}
+
+void BenchMetrics::benchHistogramRecord()
+{
+    MetricHistogram* histogram = MetricsRegistry::instance().histogram("bench_latency_us", "벤치마크");
+    QBENCHMARK {
+        for (int i = 0; i < OperationsPerIteration; ++i) {
+            histogram->record(static_cast<quint64>(i) * 37);
+        }
+    }
+    QVERIFY(histogram->count() > 0);
+}
+
+void BenchMetrics::benchHistogramRecordContended()
+{
+    // 장치 스레드 여러 개가 같은 히스토그램에 기록하는 최악의 경우
+    MetricHistogram histogram;
+    std::atomic<bool> running(true);
+    QList<QThread*> writers;
+    for (int t = 0; t < 3; ++t) {
+        writers.append(QThread::create([&histogram, &running]() {
+            quint64 value = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                histogram.record(value++ & 0xFFFF);
+            }
+        }));
+        writers.last()->start();
+    }
+
+    QBENCHMARK {
+        for (int i = 0; i < OperationsPerIteration; ++i) {
+            histogram.record(static_cast<quint64>(i));
+        }
+    }
+
+    running = false;
+    for (QThread* writer : writers) {
+        writer->wait();
+        delete writer;
+    }
+}
+
+void BenchMetrics::benchClock()
+{
+    qint64 last = 0;
+    QBENCHMARK {
+        for (int i = 0; i < OperationsPerIteration; ++i) {
+            last = MetricsRegistry::nowUs();
+        }
+    }
+    QVERIFY(last > 0);
+}
+
+BENCH_MAIN(BenchMetrics)
+#include "bench_metrics.moc"
@@ -0,0 +1,275 @@
+#include <QtTest/QtTest>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+#include "orderdispatcher.h"
+#include "../benchbaseline.h"
+
+// 로봇 여러 대에 주문을 나누는 전략별 지연 시간 비교
+// 각 로봇은 단계별 장치 수가 다르며, 단계 안에서는 도착 순서대로 처리한다고 가정합니다.
+// 처리 시간이 단계마다 같으므로 주문을 보내는 순간 각 단계의 시작/완료 시각을 바로 계산할 수 있습니다.
+class BenchOrderDispatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchRouting_data();
+    void benchRouting();
+    void benchSelectRobot_data();
+    void benchSelectRobot();
+
+private:
+    static const int StepCount = 4;
+
+    struct SimulatedOrder {
+        qint64 arrivalMs;
+        qint64 dispatchMs;
+        qint64 predictedMs;                 // 보낼 때 추정한 완료까지 시간
+        qint64 stepStart[StepCount];
+        qint64 stepFinish[StepCount];
+    };
+
+    struct SimulatedRobot {
+        int devices[StepCount];
+        QVector<qint64> deviceFree[StepCount];
+        QVector<int> inSystem;              // 아직 끝나지 않은 주문 인덱스
+        int window;
+        int sent;
+    };
+
+    static const qint64 durations[StepCount];
+    static QVector<SimulatedRobot> makeFleet();
+    static RobotLoadMessage loadAt(const SimulatedRobot& robot,
+                                   const QVector<SimulatedOrder>& orders, qint64 now);
+    static void report(OrderDispatcher& dispatcher, int robotId, SimulatedRobot& robot,
+                       const QVector<SimulatedOrder>& orders, qint64 now);
+};
+
+// Bread -> Cheese -> Egg -> Jam
+const qint64 BenchOrderDispatcher::durations[StepCount] = { 10000, 3000, 7000, 4000 };
+
+QVector<BenchOrderDispatcher::SimulatedRobot> BenchOrderDispatcher::makeFleet()
+{
+    // 로봇 1: 전 단계 2대 (분당 12건), 로봇 2: 전 단계 1대 (분당 6건),
+    // 로봇 3: 빵만 2대이고 나머지 1대 (계란 단계가 병목, 분당 약 8.5건)
+    const int layouts[3][StepCount] = { { 2, 2, 2, 2 }, { 1, 1, 1, 1 }, { 2, 1, 1, 1 } };
+
+    QVector<SimulatedRobot> fleet;
+    for (const auto& layout : layouts) {
+        SimulatedRobot robot;
+        int deviceCount = 0;
+        for (int step = 0; step < StepCount; ++step) {
+            robot.devices[step] = layout[step];
+            robot.deviceFree[step].fill(0, layout[step]);
+            deviceCount += layout[step];
+        }
+        robot.window = deviceCount * 2;
+        robot.sent = 0;
+        fleet.append(robot);
+    }
+    return fleet;
+}
+
+RobotLoadMessage BenchOrderDispatcher::loadAt(const SimulatedRobot& robot,
+                                              const QVector<SimulatedOrder>& orders, qint64 now)
+{
+    RobotLoadMessage load;
+    load.backlog = robot.inSystem.size();
+    load.received = robot.sent;
+    for (int step = 0; step < StepCount; ++step) {
+        ModuleLoad module;
+        module.devices = robot.devices[step];
+        module.durationMs = durations[step];
+        load.modules.append(module);
+    }
+
+    for (int index : robot.inSystem) {
+        const SimulatedOrder& order = orders.at(index);
+        for (int step = 0; step < StepCount; ++step) {
+            if (order.stepFinish[step] <= now) continue;
+            if (order.stepStart[step] <= now) {
+                load.modules[step].busy++;
+            } else {
+                load.modules[step].waiting++;
+            }
+            break;
+        }
+    }
+    return load;
+}
+
+void BenchOrderDispatcher::report(OrderDispatcher& dispatcher, int robotId, SimulatedRobot& robot,
+                                  const QVector<SimulatedOrder>& orders, qint64 now)
+{
+    // 끝난 주문 정리 후 로봇이 보내는 부하 보고와 흐름 제어를 흉내냄
+    robot.inSystem.erase(std::remove_if(robot.inSystem.begin(), robot.inSystem.end(),
+                                        [&](int index) { return orders.at(index).stepFinish[StepCount - 1] <= now; }),
+                         robot.inSystem.end());
+
+    FlowControlMessage flow;
+    flow.window = robot.window;
+    flow.backlog = robot.inSystem.size();
+    flow.received = robot.sent;
+    flow.limit = robot.sent + qMax(0, robot.window - flow.backlog);
+
+    dispatcher.updateLoad(robotId, loadAt(robot, orders, now));
+    dispatcher.updateFlowControl(robotId, flow);
+}
+
+void BenchOrderDispatcher::benchRouting_data()
+{
+    QTest::addColumn<int>("strategy");
+    QTest::addColumn<double>("ordersPerMinute");
+
+    // 세 로봇을 합친 처리 한계는 분당 약 26건
+    const QList<double> loads = QList<double>() << 15.0 << 21.0 << 25.0;
+    const QStringList names = QStringList() << "ETA" << "LeastBacklog" << "RoundRobin";
+    for (double load : loads) {
+        for (int strategy = 0; strategy < names.size(); ++strategy) {
+            QTest::newRow(qPrintable(QString("%1@%2/min").arg(names.at(strategy)).arg(load)))
+                << strategy << load;
+        }
+    }
+}
+
+void BenchOrderDispatcher::benchRouting()
+{
+    QFETCH(int, strategy);
+    QFETCH(double, ordersPerMinute);
+
+    const int orderCount = 3000;
+    QVector<SimulatedOrder> orders(orderCount);
+    QRandomGenerator rng(2024);
+    double arrival = 0.0;
+    for (SimulatedOrder& order : orders) {
+        arrival += -(60000.0 / ordersPerMinute) * qLn(1.0 - rng.generateDouble());
+        order.arrivalMs = static_cast<qint64>(arrival);
+    }
+
+    QVector<qint64> latencies;
+    qint64 absoluteErrorSum = 0;
+    QBENCHMARK_ONCE {
+        QVector<SimulatedRobot> fleet = makeFleet();
+        OrderDispatcher dispatcher;
+        dispatcher.setStrategy(static_cast<OrderDispatcher::Strategy>(strategy));
+        for (int robotId = 0; robotId < fleet.size(); ++robotId) {
+            dispatcher.addRobot(robotId);
+        }
+
+        latencies.clear();
+        absoluteErrorSum = 0;
+        int nextArrival = 0;
+        int nextDispatch = 0;   // 서버 대기열 맨 앞 (도착 순서)
+        while (nextDispatch < orderCount) {
+            // 다음 사건: 새 주문 도착 또는 대기열이 있을 때 가장 이른 주문 완료
+            qint64 now = std::numeric_limits<qint64>::max();
+            if (nextArrival < orderCount) {
+                now = orders.at(nextArrival).arrivalMs;
+            }
+            if (nextDispatch < nextArrival) {
+                for (const SimulatedRobot& robot : fleet) {
+                    for (int index : robot.inSystem) {
+                        now = qMin(now, orders.at(index).stepFinish[StepCount - 1]);
+                    }
+                }
+            }
+            while (nextArrival < orderCount && orders.at(nextArrival).arrivalMs <= now) {
+                ++nextArrival;
+            }
+
+            for (int robotId = 0; robotId < fleet.size(); ++robotId) {
+                report(dispatcher, robotId, fleet[robotId], orders, now);
+            }
+
+            while (nextDispatch < nextArrival) {
+                const int robotId = dispatcher.selectRobot();
+                if (robotId < 0) break;
+
+                SimulatedOrder& order = orders[nextDispatch];
+                SimulatedRobot& robot = fleet[robotId];
+                order.dispatchMs = now;
+                order.predictedMs = dispatcher.estimateCompletionMs(robotId);
+
+                qint64 ready = now;
+                for (int step = 0; step < StepCount; ++step) {
+                    QVector<qint64>& free = robot.deviceFree[step];
+                    auto device = std::min_element(free.begin(), free.end());
+                    order.stepStart[step] = qMax(ready, *device);
+                    order.stepFinish[step] = order.stepStart[step] + durations[step];
+                    *device = order.stepFinish[step];
+                    ready = order.stepFinish[step];
+                }
+
+                robot.inSystem.append(nextDispatch);
+                robot.sent++;
+                dispatcher.orderSent(robotId);
+                report(dispatcher, robotId, robot, orders, now);
+
+                latencies.append(ready - order.arrivalMs);
+                absoluteErrorSum += qAbs((ready - now) - order.predictedMs);
+                ++nextDispatch;
+            }
+        }
+    }
+
+    QCOMPARE(latencies.size(), orderCount);
+    std::sort(latencies.begin(), latencies.end());
+    qint64 latencySum = 0;
+    for (qint64 latency : latencies) {
+        latencySum += latency;
+    }
+
+    qInfo().noquote() << QString("[%1/min] 평균 %2초, p95 %3초, 최대 %4초, 완료 예측 평균 오차 %5초")
+                             .arg(ordersPerMinute)
+                             .arg(latencySum / 1000.0 / orderCount, 0, 'f', 1)
+                             .arg(latencies.at(orderCount * 95 / 100) / 1000.0, 0, 'f', 1)
+                             .arg(latencies.last() / 1000.0, 0, 'f', 1)
+                             .arg(absoluteErrorSum / 1000.0 / orderCount, 0, 'f', 1);
+}
+
+void BenchOrderDispatcher::benchSelectRobot_data()
+{
+    QTest::addColumn<int>("robotCount");
+    QTest::newRow("2") << 2;
+    QTest::newRow("8") << 8;
+    QTest::newRow("32") << 32;
+}
+
+void BenchOrderDispatcher::benchSelectRobot()
+{
+    QFETCH(int, robotCount);
+
+    OrderDispatcher dispatcher;
+    QRandomGenerator rng(7);
+    for (int robotId = 0; robotId < robotCount; ++robotId) {
+        RobotLoadMessage load;
+        for (int step = 0; step < StepCount; ++step) {
+            ModuleLoad module;
+            module.devices = 1 + static_cast<int>(rng.bounded(3));
+            module.busy = static_cast<int>(rng.bounded(module.devices + 1));
+            module.waiting = static_cast<int>(rng.bounded(4));
+            module.durationMs = durations[step];
+            load.modules.append(module);
+        }
+
+        FlowControlMessage flow;
+        flow.window = 16;
+        flow.backlog = 0;
+        flow.received = 0;
+        flow.limit = std::numeric_limits<int>::max();
+
+        dispatcher.addRobot(robotId);
+        dispatcher.updateLoad(robotId, load);
+        dispatcher.updateFlowControl(robotId, flow);
+    }
+
+    int selected = -1;
+    QBENCHMARK {
+        selected = dispatcher.selectRobot();
+    }
+    QVERIFY(selected >= 0);
+}
+
+BENCH_MAIN(BenchOrderDispatcher)
+#include "bench_orderdispatcher.moc"
@@ -0,0 +1,77 @@
+#include <QtTest/QtTest>
+#include <QTableWidget>
+#include "ordermanagergui.h"
+#include "../benchbaseline.h"
+
+// 주문 상태 표 갱신 비용 (표에 쌓인 행 수별)
+// updateOrderStatusTable은 주문 ID로 행을 찾으므로 행이 많을수록 느려지는지 확인합니다.
+class BenchOrderManagerGUI : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchUpdateExisting_data();
+    void benchUpdateExisting();
+    void benchInsertNew_data();
+    void benchInsertNew();
+
+private:
+    static void addRowCounts();
+    static void fillTable(QTableWidget* table, int rowCount);
+};
+
+void BenchOrderManagerGUI::addRowCounts()
+{
+    QTest::addColumn<int>("rowCount");
+    QTest::newRow("10") << 10;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("100k") << 100000;
+}
+
+// updateOrderStatusTable로 채우면 준비만 O(n^2)이므로 표에 직접 채움
+void BenchOrderManagerGUI::fillTable(QTableWidget* table, int rowCount)
+{
+    table->setRowCount(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        table->setItem(row, 0, new QTableWidgetItem(QString::number(row + 1)));
+        table->setItem(row, 1, new QTableWidgetItem("빵 준비 대기 중"));
+        table->setItem(row, 2, new QTableWidgetItem("대기 중"));
+    }
+}
+
+void BenchOrderManagerGUI::benchUpdateExisting_data() { addRowCounts(); }
+
+void BenchOrderManagerGUI::benchUpdateExisting()
+{
+    QFETCH(int, rowCount);
+
+    OrderManagerGUI gui;
+    fillTable(gui.orderStatusTable, rowCount);
+
+    // 가장 최근 주문(마지막 행)의 단계 진행: 실제 운영에서 가장 흔한 갱신
+    int step = 0;
+    QBENCHMARK {
+        gui.updateOrderStatusTable(rowCount, step++ % 2 ? "치즈 추가 중" : "빵 굽는 중", "처리 중");
+    }
+    QCOMPARE(gui.orderStatusTable->rowCount(), rowCount);
+}
+
+void BenchOrderManagerGUI::benchInsertNew_data() { addRowCounts(); }
+
+void BenchOrderManagerGUI::benchInsertNew()
+{
+    QFETCH(int, rowCount);
+
+    OrderManagerGUI gui;
+    fillTable(gui.orderStatusTable, rowCount);
+
+    // 새 주문 접수: 전체를 찾아본 뒤 행 추가 (행 수를 유지하려고 추가한 행은 바로 제거)
+    QBENCHMARK {
+        gui.updateOrderStatusTable(rowCount + 1, "서버 대기열", "대기 중");
+        gui.orderStatusTable->removeRow(rowCount);
+    }
+    QCOMPARE(gui.orderStatusTable->rowCount(), rowCount);
+}
+
+BENCH_MAIN(BenchOrderManagerGUI)
+#include "bench_ordermanagergui.moc"
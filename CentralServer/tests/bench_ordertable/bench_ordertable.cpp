@@ -0,0 +1,189 @@
+#include <QtTest/QtTest>
+#include <QMap>
+#include <QRandomGenerator>
+#include "ordertable.h"
+#include "../benchbaseline.h"
+
+// 기존 QMap<int, OrderMessage> 저장 방식과 OrderTable의 조회/갱신 비용 비교
+class BenchOrderTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchQMapLookup_data();
+    void benchQMapLookup();
+    void benchOrderTableLookup_data();
+    void benchOrderTableLookup();
+    void benchQMapUpdate_data();
+    void benchQMapUpdate();
+    void benchOrderTableUpdate_data();
+    void benchOrderTableUpdate();
+    void benchHandOff_data();
+    void benchHandOff();
+
+private:
+    static const int OperationsPerIteration = 10000;
+
+    static void addOrderCounts();
+    static OrderMessage makeOrder(int orderId);
+    static QVector<int> randomOrderIds(int orderCount);
+};
+
+void BenchOrderTable::addOrderCounts()
+{
+    QTest::addColumn<int>("orderCount");
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+    QTest::newRow("1M") << 1000000;
+}
+
+OrderMessage BenchOrderTable::makeOrder(int orderId)
+{
+    OrderMessage order;
+    order.orderId = orderId;
+    order.bread = "호밀빵";
+    order.egg = "완숙";
+    order.jams << "딸기잼";
+    order.jamAmount = 50;
+    order.cheeses << "모짜렐라" << "체다";
+    order.status = OrderStatus::WAITING;
+    return order;
+}
+
+QVector<int> BenchOrderTable::randomOrderIds(int orderCount)
+{
+    QVector<int> ids;
+    ids.reserve(OperationsPerIteration);
+    QRandomGenerator rng(42);
+    for (int i = 0; i < OperationsPerIteration; ++i) {
+        ids.append(1 + static_cast<int>(rng.bounded(orderCount)));
+    }
+    return ids;
+}
+
+void BenchOrderTable::benchQMapLookup_data() { addOrderCounts(); }
+
+void BenchOrderTable::benchQMapLookup()
+{
+    QFETCH(int, orderCount);
+
+    QMap<int, OrderMessage> orders;
+    for (int id = 1; id <= orderCount; ++id) {
+        orders.insert(id, makeOrder(id));
+    }
+    const QVector<int> ids = randomOrderIds(orderCount);
+
+    int checksum = 0;
+    QBENCHMARK {
+        for (int id : ids) {
+            auto it = orders.constFind(id);
+            checksum += static_cast<int>(it.value().status);
+        }
+    }
+    QVERIFY(checksum >= 0);
+}
+
+void BenchOrderTable::benchOrderTableLookup_data() { addOrderCounts(); }
+
+void BenchOrderTable::benchOrderTableLookup()
+{
+    QFETCH(int, orderCount);
+
+    OrderTable orders;
+    orders.reserve(orderCount);
+    for (int id = 1; id <= orderCount; ++id) {
+        orders.insert(makeOrder(id), id);
+    }
+    const QVector<int> ids = randomOrderIds(orderCount);
+
+    int checksum = 0;
+    QBENCHMARK {
+        for (int id : ids) {
+            OrderHandle handle = orders.find(id);
+            checksum += static_cast<int>(orders.status(handle));
+        }
+    }
+    QVERIFY(checksum >= 0);
+}
+
+void BenchOrderTable::benchQMapUpdate_data() { addOrderCounts(); }
+
+void BenchOrderTable::benchQMapUpdate()
+{
+    QFETCH(int, orderCount);
+
+    QMap<int, OrderMessage> orders;
+    for (int id = 1; id <= orderCount; ++id) {
+        orders.insert(id, makeOrder(id));
+    }
+    const QVector<int> ids = randomOrderIds(orderCount);
+
+    QBENCHMARK {
+        for (int id : ids) {
+            auto it = orders.find(id);
+            it.value().status = OrderStatus::PROCESSING;
+        }
+    }
+}
+
+void BenchOrderTable::benchOrderTableUpdate_data() { addOrderCounts(); }
+
+void BenchOrderTable::benchOrderTableUpdate()
+{
+    QFETCH(int, orderCount);
+
+    OrderTable orders;
+    orders.reserve(orderCount);
+    for (int id = 1; id <= orderCount; ++id) {
+        orders.insert(makeOrder(id), id);
+    }
+    const QVector<int> ids = randomOrderIds(orderCount);
+
+    qint64 timestamp = 0;
+    QBENCHMARK {
+        for (int id : ids) {
+            OrderHandle handle = orders.find(id);
+            orders.setStatus(handle, OrderStatus::PROCESSING);
+            orders.setStep(handle, (orders.step(handle) + 1) & 3);
+            orders.touch(handle, ++timestamp);
+        }
+    }
+}
+
+void BenchOrderTable::benchHandOff_data()
+{
+    QTest::addColumn<bool>("shared");
+    QTest::newRow("copy") << false;
+    QTest::newRow("shared") << true;
+}
+
+// 서버 주문 테이블에서 화면 테이블로 주문을 넘기는 비용 (OrderMessage 복원 후 삽입 / 레코드 공유)
+void BenchOrderTable::benchHandOff()
+{
+    QFETCH(bool, shared);
+
+    OrderTable source;
+    source.reserve(OperationsPerIteration);
+    QVector<OrderHandle> handles;
+    handles.reserve(OperationsPerIteration);
+    for (int id = 1; id <= OperationsPerIteration; ++id) {
+        handles.append(source.insert(makeOrder(id), id));
+    }
+
+    OrderTable shown;
+    QBENCHMARK {
+        shown.clear();
+        shown.reserve(OperationsPerIteration);
+        for (OrderHandle handle : handles) {
+            if (shared) {
+                shown.insertShared(source, handle, 1);
+            } else {
+                shown.insert(source.order(handle), 1);
+            }
+        }
+    }
+    QCOMPARE(shown.size(), OperationsPerIteration);
+}
+
+BENCH_MAIN(BenchOrderTable)
+#include "bench_ordertable.moc"
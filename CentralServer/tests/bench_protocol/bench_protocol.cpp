@@ -0,0 +1,265 @@
+#include <QtTest/QtTest>
+#include <QJsonDocument>
+#include "message.h"
+#include "networkmanager.h"
+#include "devicestatesync.h"
+#include "../benchbaseline.h"
+
+// 프로토콜 경로 비용: 메시지 JSON 변환과 수신 버퍼의 프레임 분리
+// 각 반복에서 MessagesPerIteration개를 처리하므로 결과를 그 수로 나누면 메시지 1개 비용
+class BenchProtocol : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchToJson_data();
+    void benchToJson();
+    void benchFromJson_data();
+    void benchFromJson();
+    void benchFraming_data();
+    void benchFraming();
+    void benchDeviceStatusStream_data();
+    void benchDeviceStatusStream();
+
+private:
+    static const int MessagesPerIteration = 1000;
+
+    static void addMessageTypes();
+    static Message makeMessage(int type);
+    static QByteArray serialize(const Message& message);
+};
+
+void BenchProtocol::addMessageTypes()
+{
+    QTest::addColumn<int>("type");
+    QTest::newRow("ORDER_NEW") << static_cast<int>(MessageType::ORDER_NEW);
+    QTest::newRow("DEVICE_STATUS_UPDATE") << static_cast<int>(MessageType::DEVICE_STATUS_UPDATE);
+    QTest::newRow("ROBOT_LOAD") << static_cast<int>(MessageType::ROBOT_LOAD);
+}
+
+Message BenchProtocol::makeMessage(int type)
+{
+    Message message;
+    message.type = static_cast<MessageType>(type);
+
+    switch (message.type) {
+    case MessageType::ORDER_NEW: {
+        OrderMessage order;
+        order.orderId = 12345;
+        order.bread = "호밀빵";
+        order.egg = "완숙";
+        order.jams << "딸기잼" << "사과잼";
+        order.jamAmount = 50;
+        order.cheeses << "모짜렐라" << "체다";
+        order.status = OrderStatus::WAITING;
+        order.deadline = 1700000000000LL;
+        message.data = order.toJson();
+        break;
+    }
+    case MessageType::DEVICE_STATUS_UPDATE: {
+        DeviceStatusMessage status;
+        status.moduleType = "Bread";
+        status.deviceIndex = 2;
+        status.status = DeviceStatus::ON;
+        status.currentTask = "빵 굽기: 호밀빵";
+        status.orderId = 12345;
+        message.data = status.toJson();
+        break;
+    }
+    default: {
+        RobotLoadMessage load;
+        load.backlog = 12;
+        load.received = 340;
+        const QStringList modules = QStringList() << "Bread" << "Cheese" << "Egg" << "Jam";
+        for (const QString& name : modules) {
+            ModuleLoad module;
+            module.module = name;
+            module.devices = 2;
+            module.busy = 1;
+            module.waiting = 3;
+            module.durationMs = 7000;
+            load.modules.append(module);
+        }
+        message.data = load.toJson();
+        break;
+    }
+    }
+    return message;
+}
+
+// NetworkManager::writeMessage와 같은 직렬화
+QByteArray BenchProtocol::serialize(const Message& message)
+{
+    return QJsonDocument(message.toJson()).toJson(QJsonDocument::Compact);
+}
+
+void BenchProtocol::benchToJson_data() { addMessageTypes(); }
+
+void BenchProtocol::benchToJson()
+{
+    QFETCH(int, type);
+
+    // 보내는 쪽: 구조체 -> data 객체 -> 전송 바이트
+    const Message prototype = makeMessage(type);
+    const OrderMessage order = OrderMessage::fromJson(prototype.data);
+    const DeviceStatusMessage status = DeviceStatusMessage::fromJson(prototype.data);
+    const RobotLoadMessage load = RobotLoadMessage::fromJson(prototype.data);
+
+    int bytes = 0;
+    QBENCHMARK {
+        for (int i = 0; i < MessagesPerIteration; ++i) {
+            Message message;
+            message.type = prototype.type;
+            switch (prototype.type) {
+            case MessageType::ORDER_NEW: message.data = order.toJson(); break;
+            case MessageType::DEVICE_STATUS_UPDATE: message.data = status.toJson(); break;
+            default: message.data = load.toJson(); break;
+            }
+            bytes += serialize(message).size();
+        }
+    }
+    QVERIFY(bytes > 0);
+}
+
+void BenchProtocol::benchFromJson_data() { addMessageTypes(); }
+
+void BenchProtocol::benchFromJson()
+{
+    QFETCH(int, type);
+
+    // 받는 쪽: 수신 바이트 -> Message -> 구조체
+    const QByteArray payload = serialize(makeMessage(type));
+
+    int checksum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < MessagesPerIteration; ++i) {
+            const Message message = Message::fromJson(QJsonDocument::fromJson(payload).object());
+            switch (message.type) {
+            case MessageType::ORDER_NEW:
+                checksum += OrderMessage::fromJson(message.data).orderId;
+                break;
+            case MessageType::DEVICE_STATUS_UPDATE:
+                checksum += DeviceStatusMessage::fromJson(message.data).deviceIndex;
+                break;
+            default:
+                checksum += RobotLoadMessage::fromJson(message.data).modules.size();
+                break;
+            }
+        }
+    }
+    QVERIFY(checksum > 0);
+}
+
+void BenchProtocol::benchFraming_data()
+{
+    // chunkBytes: 한 번의 readyRead로 들어오는 바이트 수 (0이면 전체가 한 번에)
+    // 한 번에 많이 쌓일수록 버퍼 앞쪽을 지우는 비용이 커지는지 확인
+    QTest::addColumn<int>("chunkBytes");
+    QTest::newRow("read-1460B") << 1460;
+    QTest::newRow("read-64KB") << 65536;
+    QTest::newRow("read-all") << 0;
+}
+
+void BenchProtocol::benchFraming()
+{
+    QFETCH(int, chunkBytes);
+
+    QByteArray stream;
+    const QByteArray frame = NetworkManager::encodeFrame(serialize(makeMessage(static_cast<int>(MessageType::ORDER_NEW))));
+    for (int i = 0; i < MessagesPerIteration; ++i) {
+        stream.append(frame);
+    }
+
+    QVector<QByteArray> chunks;
+    const int step = chunkBytes > 0 ? chunkBytes : stream.size();
+    for (int offset = 0; offset < stream.size(); offset += step) {
+        chunks.append(stream.mid(offset, step));
+    }
+
+    NetworkManager manager(nullptr, false);
+    int received = 0;
+    connect(&manager, &NetworkManager::messageReceived, this, [&received]() { received++; });
+
+    // 클라이언트 모드 handleRead와 같은 처리 (readAll을 미리 나눈 조각으로 대신함)
+    // 디코딩한 메시지를 대기열에 넣고 NetworkManager가 꺼내 시그널을 내보내기까지 포함
+    NetworkWorker* worker = manager.worker;
+    QBENCHMARK {
+        for (const QByteArray& chunk : chunks) {
+            worker->buffer.append(chunk);
+            worker->processBuffer(worker->buffer, 0);
+        }
+        manager.drainInbound();
+    }
+    QVERIFY(worker->buffer.isEmpty());
+    QVERIFY(received > 0);
+    QCOMPARE(received % MessagesPerIteration, 0);
+}
+
+void BenchProtocol::benchDeviceStatusStream_data()
+{
+    // full: 변경마다 DEVICE_STATUS_UPDATE 전체, state-sync: 변경 20개씩 DEVICE_STATE_SYNC 한 메시지
+    QTest::addColumn<bool>("stateSync");
+    QTest::newRow("full") << false;
+    QTest::newRow("state-sync") << true;
+}
+
+void BenchProtocol::benchDeviceStatusStream()
+{
+    QFETCH(bool, stateSync);
+
+    // 장치 200대가 작업을 시작/완료하는 변경 MessagesPerIteration개를 보내는 쪽에서 만들고 받는 쪽에서 풂
+    const QStringList modules = QStringList() << "Bread" << "Cheese" << "Egg" << "Jam";
+    QVector<DeviceStatusMessage> updates;
+    for (int i = 0; i < MessagesPerIteration; ++i) {
+        DeviceStatusMessage status;
+        status.moduleType = modules.at(i % 4);
+        status.deviceIndex = 1 + (i / 4) % 50;
+        status.status = (i / 200) % 2 == 0 ? DeviceStatus::ON : DeviceStatus::OFF;
+        status.currentTask = status.status == DeviceStatus::ON ? "빵 굽기: 호밀빵" : "";
+        status.orderId = 12345 + i;
+        updates.append(status);
+    }
+
+    DeviceStateEncoder encoder;
+    DeviceStateDecoder decoder;
+    qint64 bytes = 0;
+    int checksum = 0;
+    QBENCHMARK {
+        bytes = 0;
+        QVector<QByteArray> payloads;
+        for (int i = 0; i < updates.size(); ++i) {
+            Message message;
+            if (!stateSync) {
+                message.type = MessageType::DEVICE_STATUS_UPDATE;
+                message.data = updates.at(i).toJson();
+            } else {
+                encoder.update(updates.at(i));
+                if (i % 20 != 19) {
+                    continue;
+                }
+                message.type = MessageType::DEVICE_STATE_SYNC;
+                message.data = encoder.takeMessage().toJson();
+            }
+            payloads.append(serialize(message));
+            bytes += payloads.last().size();
+        }
+
+        QString error;
+        QVector<DeviceStatusMessage> changes;
+        for (const QByteArray& payload : payloads) {
+            const Message message = Message::fromJson(QJsonDocument::fromJson(payload).object());
+            if (message.type == MessageType::DEVICE_STATUS_UPDATE) {
+                changes.append(DeviceStatusMessage::fromJson(message.data));
+            } else {
+                decoder.decode(DeviceStateSyncMessage::fromJson(message.data), changes, error);
+            }
+        }
+        checksum += changes.size();
+    }
+    qInfo().noquote() << QString("[%1] 변경 %2개에 %3바이트").arg(stateSync ? "state-sync" : "full")
+                             .arg(MessagesPerIteration).arg(bytes);
+    QVERIFY(checksum > 0);
+}
+
+BENCH_MAIN(BenchProtocol)
+#include "bench_protocol.moc"
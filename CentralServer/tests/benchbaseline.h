@@ -0,0 +1,214 @@
+// benchbaseline.h
+#ifndef BENCHBASELINE_H
+#define BENCHBASELINE_H
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QTemporaryFile>
+#include <QXmlStreamReader>
+
+// QBENCHMARK 결과를 기준선 파일(JSON)로 저장하고 다음 실행에서 비교
+//   bench_x -save-baseline base.json
+//       결과를 기준선에 저장 (이번에 실행한 항목만 덮어씀)
+//   bench_x -compare-baseline base.json [-regression-threshold 10]
+//       기준선보다 threshold% 넘게 느려진 항목을 출력하고 종료 코드 1
+// 두 옵션을 함께 쓰면 비교한 뒤 저장합니다. 나머지 인자(함수 이름, -minimumvalue 등)는 QtTest에 그대로 전달합니다.
+namespace BenchBaseline {
+
+struct Result {
+    QString metric;
+    double perIteration = 0;    // 반복 1회 측정값
+};
+
+typedef QMap<QString, Result> Results;     // "함수/태그" -> 결과
+
+// QtTest XML 출력의 BenchmarkResult (value는 모든 반복의 합)
+inline Results parseXml(const QString& path)
+{
+    Results results;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return results;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString function;
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = attributes.value(QLatin1String("name")).toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            const double iterations = qMax(1.0, attributes.value(QLatin1String("iterations")).toString().toDouble());
+            const QString tag = attributes.value(QLatin1String("tag")).toString();
+            Result result;
+            result.metric = attributes.value(QLatin1String("metric")).toString();
+            result.perIteration = attributes.value(QLatin1String("value")).toString().toDouble() / iterations;
+            results.insert(tag.isEmpty() ? function : function + "/" + tag, result);
+        }
+    }
+    return results;
+}
+
+inline bool load(const QString& path, Results& results, QString& errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("기준선 파일을 열 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        errorMessage = QString("기준선 파일 형식 오류: %1").arg(path);
+        return false;
+    }
+
+    const QJsonObject json = doc.object();
+    for (auto it = json.constBegin(); it != json.constEnd(); ++it) {
+        const QJsonObject entry = it.value().toObject();
+        Result result;
+        result.metric = entry["metric"].toString();
+        result.perIteration = entry["value"].toDouble();
+        results.insert(it.key(), result);
+    }
+    return true;
+}
+
+inline bool save(const QString& path, const Results& results, QString& errorMessage)
+{
+    // 일부 함수만 실행한 경우에도 나머지 기준선은 유지
+    Results merged;
+    QString ignored;
+    load(path, merged, ignored);
+    for (auto it = results.constBegin(); it != results.constEnd(); ++it) {
+        merged.insert(it.key(), it.value());
+    }
+
+    QJsonObject json;
+    for (auto it = merged.constBegin(); it != merged.constEnd(); ++it) {
+        QJsonObject entry;
+        entry["metric"] = it->metric;
+        entry["value"] = it->perIteration;
+        json[it.key()] = entry;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QString("기준선 파일을 쓸 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+    file.write(QJsonDocument(json).toJson());
+    return true;
+}
+
+// 기준선 대비 변화를 출력하고 회귀 항목 수 반환
+inline int compare(const Results& baseline, const Results& results, double thresholdPercent)
+{
+    int regressions = 0;
+    for (auto it = results.constBegin(); it != results.constEnd(); ++it) {
+        auto base = baseline.constFind(it.key());
+        if (base == baseline.constEnd() || base->metric != it->metric || base->perIteration <= 0) {
+            qInfo().noquote() << QString("  새 항목   %1: %2 %3").arg(it.key()).arg(it->perIteration).arg(it->metric);
+            continue;
+        }
+
+        const double changePercent = (it->perIteration / base->perIteration - 1.0) * 100.0;
+        const bool regressed = changePercent > thresholdPercent;
+        if (regressed) {
+            regressions++;
+        }
+        qInfo().noquote() << QString("  %1 %2: %3 -> %4 %5 (%6%7%)")
+                             .arg(regressed ? "회귀     " : "통과     ")
+                             .arg(it.key())
+                             .arg(base->perIteration).arg(it->perIteration).arg(it->metric)
+                             .arg(changePercent >= 0 ? "+" : "")
+                             .arg(changePercent, 0, 'f', 1);
+    }
+    qInfo().noquote() << QString("기준선 비교: %1개 중 %2개 회귀 (허용 %3%)")
+                         .arg(results.size()).arg(regressions).arg(thresholdPercent);
+    return regressions;
+}
+
+inline int exec(QObject* testObject, int argc, char** argv)
+{
+    QString savePath;
+    QString comparePath;
+    double thresholdPercent = 10.0;
+    QStringList arguments;
+    for (int i = 0; i < argc; ++i) {
+        const QString argument = QString::fromLocal8Bit(argv[i]);
+        if (argument == "-save-baseline" && i + 1 < argc) {
+            savePath = QString::fromLocal8Bit(argv[++i]);
+        } else if (argument == "-compare-baseline" && i + 1 < argc) {
+            comparePath = QString::fromLocal8Bit(argv[++i]);
+        } else if (argument == "-regression-threshold" && i + 1 < argc) {
+            thresholdPercent = QString::fromLocal8Bit(argv[++i]).toDouble();
+        } else {
+            arguments << argument;
+        }
+    }
+    if (savePath.isEmpty() && comparePath.isEmpty()) {
+        return QTest::qExec(testObject, arguments);
+    }
+
+    // 화면 출력은 그대로 두고 결과는 XML로 따로 받음
+    QTemporaryFile xmlFile;
+    if (!xmlFile.open()) {
+        qWarning().noquote() << "벤치마크 결과용 임시 파일을 만들 수 없습니다";
+        return 1;
+    }
+    xmlFile.close();
+    arguments << "-o" << xmlFile.fileName() + ",xml" << "-o" << "-,txt";
+
+    const int status = QTest::qExec(testObject, arguments);
+    const Results results = parseXml(xmlFile.fileName());
+
+    QString errorMessage;
+    int regressions = 0;
+    if (!comparePath.isEmpty()) {
+        Results baseline;
+        if (!load(comparePath, baseline, errorMessage)) {
+            qWarning().noquote() << errorMessage;
+            return 1;
+        }
+        regressions = compare(baseline, results, thresholdPercent);
+    }
+    if (!savePath.isEmpty()) {
+        if (!save(savePath, results, errorMessage)) {
+            qWarning().noquote() << errorMessage;
+            return 1;
+        }
+        qInfo().noquote() << QString("기준선 저장: %1 (%2개)").arg(savePath).arg(results.size());
+    }
+
+    if (status != 0) {
+        return status;
+    }
+    return regressions > 0 ? 1 : 0;
+}
+
+} // namespace BenchBaseline
+
+#ifdef QT_WIDGETS_LIB
+#include <QApplication>
+#define BENCH_APPLICATION QApplication
+#else
+#define BENCH_APPLICATION QCoreApplication
+#endif
+
+// QTEST_MAIN 대신 사용 (기준선 옵션 처리)
+#define BENCH_MAIN(TestObject) \
+int main(int argc, char *argv[]) \
+{ \
+    BENCH_APPLICATION app(argc, argv); \
+    TestObject tc; \
+    QTEST_SET_MAIN_SOURCE_PATH \
+    return BenchBaseline::exec(&tc, argc, argv); \
+}
+
+#endif // BENCHBASELINE_H
@@ -0,0 +1,262 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QThread>
+#include "binarylog.h"
+
+// 이진 로그 기록/재생, 파일 순환, 여러 스레드의 기록 확인
+class TestBinaryLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void testFormatMatchesTemplate();
+    void testRoundTrip();
+    void testLongStringIsTruncated();
+    void testRotation();
+    void testThreads();
+    void testDroppedWhenRingFull();
+    void testTail();
+
+private:
+    static QList<LogRecord> readAll(const QString& directory, const QString& baseName);
+};
+
+// 스레드마다 정해진 수만큼 기록
+class LoggingThread : public QThread
+{
+public:
+    LoggingThread(int id, int count) : id(id), count(count) {}
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; ++i) {
+            BinaryLogger::instance().log(LogEvent::TaskStarted, i, id);
+        }
+    }
+
+private:
+    int id;
+    int count;
+};
+
+QList<LogRecord> TestBinaryLog::readAll(const QString& directory, const QString& baseName)
+{
+    QList<LogRecord> records;
+    const QDir dir(directory);
+    for (const QString& name : dir.entryList(QStringList() << baseName + ".*.blog", QDir::Files, QDir::Name)) {
+        BinaryLogReader reader;
+        QString error;
+        if (!reader.open(dir.filePath(name), error)) {
+            qWarning() << error;
+            continue;
+        }
+        LogRecord record;
+        while (reader.next(record)) {
+            records.append(record);
+        }
+        if (!reader.errorString().isEmpty()) {
+            qWarning() << reader.errorString();
+        }
+    }
+    return records;
+}
+
+void TestBinaryLog::cleanup()
+{
+    BinaryLogger::instance().setTailEnabled(false);
+    BinaryLogger::instance().stop();
+}
+
+void TestBinaryLog::testFormatMatchesTemplate()
+{
+    QCOMPARE(BinaryLogger::format(LogEvent::TaskStarted, 1, QString("치즈 추가: Cheddar")),
+             QString("주문 1: 치즈 추가: Cheddar 시작"));
+    QCOMPARE(BinaryLogger::format(LogEvent::DeviceStatusReported, QString("Bread"), 1, "작동 중", QString("Slice bread")),
+             QString("Bread 장치 1: 작동 중 - Slice bread"));
+}
+
+void TestBinaryLog::testRoundTrip()
+{
+    QTemporaryDir dir;
+    BinaryLogSettings settings;
+    settings.directory = dir.path();
+    settings.baseName = "roundtrip";
+    QString error;
+    const qint64 before = QDateTime::currentMSecsSinceEpoch();
+    QVERIFY2(BinaryLogger::instance().start(settings, error), qPrintable(error));
+
+    BinaryLogger& logger = BinaryLogger::instance();
+    logger.log(LogEvent::RobotOrderReceived, 42);
+    logger.log(LogEvent::TaskStarted, 42, QString("치즈 추가: Cheddar"));
+    logger.log(LogEvent::OrderRejectedBacklog, -7, Q_INT64_C(1) << 40);
+    logger.log(LogEvent::OrderStatusChanged, 3, 2.5);
+    logger.log(LogEvent::RobotOrderCompleted, 42);
+    logger.stop();
+
+    const QList<LogRecord> records = readAll(dir.path(), "roundtrip");
+    QCOMPARE(records.size(), 5);
+    QCOMPARE(BinaryLog::render(records.at(0)), QString("새 주문 수신 (ID: 42)"));
+    QCOMPARE(BinaryLog::render(records.at(1)), QString("주문 42: 치즈 추가: Cheddar 시작"));
+    QCOMPARE(records.at(2).args.at(0).toLongLong(), qint64(-7));
+    QCOMPARE(records.at(2).args.at(1).toLongLong(), Q_INT64_C(1) << 40);
+    QCOMPARE(records.at(3).args.at(1).toDouble(), 2.5);
+    QCOMPARE(BinaryLog::render(records.at(4)), QString("주문 42 완료"));
+    QCOMPARE(BinaryLog::eventName(records.at(4).eventId), QString("RobotOrderCompleted"));
+
+    // 시각은 기록 순서대로, 벽시계 시각도 복원됨
+    for (int i = 1; i < records.size(); ++i) {
+        QVERIFY(records.at(i).timestampUs >= records.at(i - 1).timestampUs);
+    }
+    QVERIFY(records.first().wallMs >= before - 1);
+    QVERIFY(records.last().wallMs <= QDateTime::currentMSecsSinceEpoch() + 1);
+}
+
+void TestBinaryLog::testLongStringIsTruncated()
+{
+    QTemporaryDir dir;
+    BinaryLogSettings settings;
+    settings.directory = dir.path();
+    settings.baseName = "long";
+    QString error;
+    QVERIFY2(BinaryLogger::instance().start(settings, error), qPrintable(error));
+
+    // 한글 3바이트 글자가 칸 경계에 걸려도 글자 중간에서 자르지 않음
+    const QString task = QString("치즈").repeated(200);
+    BinaryLogger::instance().log(LogEvent::TaskStarted, 1, task);
+    BinaryLogger::instance().stop();
+
+    const QList<LogRecord> records = readAll(dir.path(), "long");
+    QCOMPARE(records.size(), 1);
+    const QString logged = records.first().args.at(1).toString();
+    QVERIFY(!logged.isEmpty());
+    QVERIFY(task.startsWith(logged));
+    QVERIFY(!logged.contains(QChar(QChar::ReplacementCharacter)));
+}
+
+void TestBinaryLog::testRotation()
+{
+    QTemporaryDir dir;
+    BinaryLogSettings settings;
+    settings.directory = dir.path();
+    settings.baseName = "rotate";
+    settings.maxFileBytes = 4096;
+    settings.maxFiles = 3;
+    QString error;
+    QVERIFY2(BinaryLogger::instance().start(settings, error), qPrintable(error));
+
+    const int total = 3000;
+    for (int i = 0; i < total; ++i) {
+        BinaryLogger::instance().log(LogEvent::OrderSent, 1, i);
+        if (i % 500 == 0) {
+            BinaryLogger::instance().flush();
+        }
+    }
+    BinaryLogger::instance().stop();
+
+    const QStringList files = QDir(dir.path()).entryList(QStringList() << "rotate.*.blog", QDir::Files, QDir::Name);
+    QCOMPARE(files.size(), 3);
+    for (const QString& name : files) {
+        QVERIFY(QFileInfo(dir.filePath(name)).size() <= settings.maxFileBytes + 64);
+    }
+
+    // 남은 파일에는 가장 최근 기록이 끊김 없이 있음
+    const QList<LogRecord> records = readAll(dir.path(), "rotate");
+    QVERIFY(!records.isEmpty());
+    QVERIFY(records.size() < total);
+    QCOMPARE(records.last().args.at(1).toInt(), total - 1);
+    for (int i = 1; i < records.size(); ++i) {
+        QCOMPARE(records.at(i).args.at(1).toInt(), records.at(i - 1).args.at(1).toInt() + 1);
+    }
+
+    // 다시 시작하면 번호를 이어서 씀
+    QVERIFY2(BinaryLogger::instance().start(settings, error), qPrintable(error));
+    const QString path = BinaryLogger::instance().currentFilePath();
+    BinaryLogger::instance().stop();
+    QVERIFY(QFileInfo(path).fileName() > files.last());
+}
+
+void TestBinaryLog::testThreads()
+{
+    QTemporaryDir dir;
+    BinaryLogSettings settings;
+    settings.directory = dir.path();
+    settings.baseName = "threads";
+    settings.flushIntervalMs = 5;
+    QString error;
+    QVERIFY2(BinaryLogger::instance().start(settings, error), qPrintable(error));
+
+    const int threadCount = 4;
+    const int perThread = 20000;
+    const quint64 droppedBefore = BinaryLogger::instance().droppedRecords();
+    QList<LoggingThread*> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.append(new LoggingThread(i, perThread));
+        threads.last()->start();
+    }
+    for (LoggingThread* thread : threads) {
+        QVERIFY(thread->wait(30000));
+    }
+    qDeleteAll(threads);
+    BinaryLogger::instance().stop();
+    const quint64 dropped = BinaryLogger::instance().droppedRecords() - droppedBefore;
+
+    // 스레드마다 기록 순서가 유지되고, 버린 것을 빼면 빠짐 없음
+    QMap<int, int> lastIndex;
+    int count = 0;
+    for (const LogRecord& record : readAll(dir.path(), "threads")) {
+        const int id = record.args.at(1).toInt();
+        const int index = record.args.at(0).toInt();
+        QVERIFY(index > lastIndex.value(id, -1));
+        lastIndex[id] = index;
+        count++;
+    }
+    QCOMPARE(quint64(count) + dropped, quint64(threadCount * perThread));
+    QCOMPARE(lastIndex.size(), threadCount);
+}
+
+void TestBinaryLog::testDroppedWhenRingFull()
+{
+    BinaryLogSettings settings;
+    settings.flushIntervalMs = 60000;   // 기록 스레드가 비우지 않는 동안 링을 채움
+    QString error;
+    QVERIFY2(BinaryLogger::instance().start(settings, error), qPrintable(error));
+
+    const quint64 droppedBefore = BinaryLogger::instance().droppedRecords();
+    for (int i = 0; i < BinaryLogger::RingCapacity + 100; ++i) {
+        BinaryLogger::instance().log(LogEvent::RobotOrderReceived, i);
+    }
+    QCOMPARE(BinaryLogger::instance().droppedRecords() - droppedBefore, quint64(100));
+
+    // 비우고 나면 다시 기록됨
+    BinaryLogger::instance().flush();
+    BinaryLogger::instance().log(LogEvent::RobotOrderReceived, 1);
+    QCOMPARE(BinaryLogger::instance().droppedRecords() - droppedBefore, quint64(100));
+}
+
+void TestBinaryLog::testTail()
+{
+    BinaryLogSettings settings;
+    QString error;
+    QVERIFY2(BinaryLogger::instance().start(settings, error), qPrintable(error));
+    QVERIFY(BinaryLogger::instance().currentFilePath().isEmpty());
+
+    BinaryLogger::instance().log(LogEvent::OrderAccepted, 1);
+    BinaryLogger::instance().flush();
+    QVERIFY(BinaryLogger::instance().takeTail().isEmpty());     // 켜기 전 기록은 모으지 않음
+
+    BinaryLogger::instance().setTailEnabled(true);
+    BinaryLogger::instance().log(LogEvent::OrderAccepted, 2);
+    BinaryLogger::instance().log(LogEvent::OrderSent, 3, 2);
+    BinaryLogger::instance().flush();
+
+    const QVector<LogRecord> records = BinaryLogger::instance().takeTail();
+    QCOMPARE(records.size(), 2);
+    QCOMPARE(BinaryLog::render(records.at(0)), QString("새로운 주문이 접수되었습니다. (주문 ID: 2)"));
+    QCOMPARE(BinaryLog::render(records.at(1)), QString("주문을 로봇 3(으)로 전송했습니다. (주문 ID: 2)"));
+    QVERIFY(BinaryLogger::instance().takeTail().isEmpty());
+}
+
+QTEST_MAIN(TestBinaryLog)
+#include "test_binarylog.moc"
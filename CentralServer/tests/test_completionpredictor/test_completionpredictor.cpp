@@ -0,0 +1,125 @@
+#include <QtTest/QtTest>
+#include "completionpredictor.h"
+
+class TestCompletionPredictor : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testNoRobotIsInvalid();
+    void testIdleRobotTakesPipelineTime();
+    void testBacklogAndQueueIncreaseEta();
+    void testBoundsContainEstimate();
+    void testCalibrationFollowsActuals();
+
+private:
+    static RobotLoadMessage pipelineLoad(int devicesPerModule, int waitingAtBread);
+    static void addRobot(OrderDispatcher& dispatcher, int robotId, const RobotLoadMessage& load);
+};
+
+RobotLoadMessage TestCompletionPredictor::pipelineLoad(int devicesPerModule, int waitingAtBread)
+{
+    const QStringList modules = QStringList() << "Bread" << "Cheese" << "Egg" << "Jam";
+    const qint64 durations[] = { 10000, 3000, 7000, 4000 };
+
+    RobotLoadMessage load;
+    for (int step = 0; step < modules.size(); ++step) {
+        ModuleLoad module;
+        module.module = modules.at(step);
+        module.devices = devicesPerModule;
+        module.durationMs = durations[step];
+        load.modules.append(module);
+    }
+    load.modules[0].waiting = waitingAtBread;
+    load.backlog = waitingAtBread;
+    return load;
+}
+
+void TestCompletionPredictor::addRobot(OrderDispatcher& dispatcher, int robotId, const RobotLoadMessage& load)
+{
+    dispatcher.addRobot(robotId);
+    dispatcher.updateLoad(robotId, load);
+}
+
+void TestCompletionPredictor::testNoRobotIsInvalid()
+{
+    OrderDispatcher dispatcher;
+    CompletionPredictor predictor;
+    QVERIFY(!predictor.predict(dispatcher, 0).valid);
+
+    // 부하 보고 전 로봇도 예측 불가
+    dispatcher.addRobot(1);
+    QVERIFY(!predictor.predict(dispatcher, 0).valid);
+}
+
+void TestCompletionPredictor::testIdleRobotTakesPipelineTime()
+{
+    OrderDispatcher dispatcher;
+    addRobot(dispatcher, 1, pipelineLoad(2, 0));
+
+    CompletionPredictor predictor;
+    CompletionEstimate estimate = predictor.predict(dispatcher, 0);
+    QVERIFY(estimate.valid);
+    QCOMPARE(estimate.etaMs, qint64(24000));
+    QCOMPARE(estimate.lowerMs, qint64(24000));  // 단계 처리 시간 합보다 빠를 수 없음
+}
+
+void TestCompletionPredictor::testBacklogAndQueueIncreaseEta()
+{
+    OrderDispatcher dispatcher;
+    addRobot(dispatcher, 1, pipelineLoad(2, 4));
+
+    CompletionPredictor predictor;
+    const qint64 robotBacklogEta = predictor.predict(dispatcher, 0).etaMs;
+    QVERIFY(robotBacklogEta > 24000);
+
+    // 서버 대기열 6건은 빵 단계 처리율(2대 / 10초)로 30초 추가
+    const qint64 queuedEta = predictor.predict(dispatcher, 6).etaMs;
+    QCOMPARE(queuedEta - robotBacklogEta, qint64(30000));
+
+    // 한가한 로봇이 추가되면 더 빨라짐
+    addRobot(dispatcher, 2, pipelineLoad(1, 0));
+    QVERIFY(predictor.predict(dispatcher, 6).etaMs < queuedEta);
+}
+
+void TestCompletionPredictor::testBoundsContainEstimate()
+{
+    OrderDispatcher dispatcher;
+    addRobot(dispatcher, 1, pipelineLoad(1, 5));
+
+    CompletionPredictor predictor;
+    CompletionEstimate estimate = predictor.predict(dispatcher, 3);
+    QVERIFY(estimate.lowerMs <= estimate.etaMs);
+    QVERIFY(estimate.etaMs <= estimate.upperMs);
+    QVERIFY(estimate.upperMs > estimate.lowerMs);
+}
+
+void TestCompletionPredictor::testCalibrationFollowsActuals()
+{
+    OrderDispatcher dispatcher;
+    addRobot(dispatcher, 1, pipelineLoad(2, 0));
+
+    // 실제로는 모델보다 1.5배 오래 걸리는 로봇
+    CompletionPredictor predictor;
+    for (int orderId = 1; orderId <= 60; ++orderId) {
+        const qint64 submittedAt = orderId * 100000;
+        CompletionEstimate estimate = predictor.predict(dispatcher, 0);
+        predictor.recordPrediction(orderId, submittedAt, estimate);
+        QCOMPARE(predictor.promised(orderId).etaMs, estimate.etaMs);
+        predictor.recordCompletion(orderId, submittedAt + 36000);
+    }
+
+    QCOMPARE(predictor.sampleCount(), 60);
+    QVERIFY(qAbs(predictor.calibrationFactor() - 1.5) < 0.01);
+    QVERIFY(predictor.relativeSpread() < 0.05);
+
+    CompletionEstimate calibrated = predictor.predict(dispatcher, 0);
+    QVERIFY(qAbs(calibrated.etaMs - 36000) < 500);
+    QVERIFY(calibrated.lowerMs <= 36000 && 36000 <= calibrated.upperMs);
+
+    // 완료된 주문의 기록은 정리됨
+    QVERIFY(!predictor.promised(1).valid);
+}
+
+QTEST_MAIN(TestCompletionPredictor)
+#include "test_completionpredictor.moc"
@@ -0,0 +1,313 @@
+#include <QtTest/QtTest>
+#include <QJsonDocument>
+#include "devicestatesync.h"
+
+// 장치 상태 동기화: 키프레임과 변경분이 원래 변경 순서대로 풀리는지, 빠진 메시지 뒤의 재동기화, 크기
+// 보내는 쪽 메시지는 JSON을 거쳐 받는 쪽에 넘겨 실제 전송과 같은 경로로 확인
+class TestDeviceStateSync : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip();
+    void testKeyframeInterval();
+    void testResyncAfterGap();
+    void testReconnect();
+    void testCollapsePending();
+    void testMalformedRecords();
+    void testSmallerThanFullStatus();
+
+private:
+    static DeviceStatusMessage status(const QString& module, int deviceIndex, DeviceStatus state,
+                                      const QString& task, int orderId);
+    static DeviceStateSyncMessage transmit(DeviceStateEncoder& encoder);
+    static void compare(const DeviceStatusMessage& actual, const DeviceStatusMessage& expected);
+};
+
+DeviceStatusMessage TestDeviceStateSync::status(const QString& module, int deviceIndex, DeviceStatus state,
+                                                const QString& task, int orderId)
+{
+    DeviceStatusMessage message;
+    message.moduleType = module;
+    message.deviceIndex = deviceIndex;
+    message.status = state;
+    message.currentTask = task;
+    message.orderId = orderId;
+    return message;
+}
+
+DeviceStateSyncMessage TestDeviceStateSync::transmit(DeviceStateEncoder& encoder)
+{
+    const QByteArray payload = QJsonDocument(encoder.takeMessage().toJson()).toJson(QJsonDocument::Compact);
+    return DeviceStateSyncMessage::fromJson(QJsonDocument::fromJson(payload).object());
+}
+
+void TestDeviceStateSync::compare(const DeviceStatusMessage& actual, const DeviceStatusMessage& expected)
+{
+    QCOMPARE(actual.moduleType, expected.moduleType);
+    QCOMPARE(actual.deviceIndex, expected.deviceIndex);
+    QCOMPARE(actual.status, expected.status);
+    QCOMPARE(actual.currentTask, expected.currentTask);
+    QCOMPARE(actual.orderId, expected.orderId);
+}
+
+void TestDeviceStateSync::testRoundTrip()
+{
+    DeviceStateEncoder encoder;
+    DeviceStateDecoder decoder;
+    QString error;
+
+    // 같은 장치의 시작/완료가 한 메시지에 들어가도 합치지 않고 순서대로
+    QVector<DeviceStatusMessage> sent;
+    sent << status("Bread", 1, DeviceStatus::ON, "호밀빵", 101)
+         << status("Bread", 2, DeviceStatus::ON, "호밀빵 x2", 102)
+         << status("Bread", 1, DeviceStatus::OFF, "", 101)
+         << status("Egg", 1, DeviceStatus::ON, "완숙", 101);
+    for (const DeviceStatusMessage& message : sent) {
+        encoder.update(message);
+    }
+
+    const DeviceStateSyncMessage first = transmit(encoder);
+    QVERIFY(first.keyframe);
+    QCOMPARE(first.devices, QStringList() << "Bread/1" << "Bread/2" << "Egg/1");
+    QCOMPARE(first.count, sent.size());
+
+    QVector<DeviceStatusMessage> changes;
+    QVERIFY2(decoder.decode(first, changes, error), qPrintable(error));
+    QCOMPARE(changes.size(), sent.size());
+    for (int i = 0; i < sent.size(); ++i) {
+        compare(changes.at(i), sent.at(i));
+    }
+
+    // 변경분: 이미 보낸 이름은 다시 보내지 않음 (주문 ID가 줄어드는 경우도 포함)
+    sent.clear();
+    sent << status("Egg", 1, DeviceStatus::OFF, "", 101)
+         << status("Bread", 2, DeviceStatus::ERROR, "호밀빵 x2", 102)
+         << status("Bread", 1, DeviceStatus::ON, "호밀빵", 99)
+         << status("Jam", 3, DeviceStatus::ON, "딸기잼", 103);
+    for (const DeviceStatusMessage& message : sent) {
+        encoder.update(message);
+    }
+    const DeviceStateSyncMessage delta = transmit(encoder);
+    QVERIFY(!delta.keyframe);
+    QCOMPARE(delta.devices, QStringList() << "Jam/3");
+    QCOMPARE(delta.tasks, QStringList() << "딸기잼");
+
+    changes.clear();
+    QVERIFY2(decoder.decode(delta, changes, error), qPrintable(error));
+    QCOMPARE(changes.size(), sent.size());
+    for (int i = 0; i < sent.size(); ++i) {
+        compare(changes.at(i), sent.at(i));
+    }
+    QCOMPARE(decoder.deviceCount(), 4);
+    QVERIFY(!encoder.hasPending());
+}
+
+void TestDeviceStateSync::testKeyframeInterval()
+{
+    DeviceStateEncoder encoder(3);
+    DeviceStateDecoder decoder;
+    QString error;
+    QVector<DeviceStatusMessage> changes;
+
+    QList<bool> keyframes;
+    for (int i = 0; i < 9; ++i) {
+        encoder.update(status("Cheese", 1 + i % 2, i % 2 ? DeviceStatus::ON : DeviceStatus::OFF, "체다", 200 + i));
+        const DeviceStateSyncMessage message = transmit(encoder);
+        keyframes << message.keyframe;
+        QVERIFY2(decoder.decode(message, changes, error), qPrintable(error));
+    }
+    QCOMPARE(keyframes, QList<bool>() << true << false << false << false << true << false << false << false << true);
+
+    // 요청하면 변경이 없어도 키프레임을 보냄 (받는 쪽은 달라진 것이 없으므로 변경 없음)
+    encoder.requestKeyframe();
+    QVERIFY(encoder.hasPending());
+    const DeviceStateSyncMessage keyframe = transmit(encoder);
+    QVERIFY(keyframe.keyframe);
+    QCOMPARE(keyframe.count, 0);
+    changes.clear();
+    QVERIFY2(decoder.decode(keyframe, changes, error), qPrintable(error));
+    QVERIFY(changes.isEmpty());
+
+    const QVector<DeviceStatusMessage> devices = decoder.snapshot();
+    QCOMPARE(devices.size(), 2);
+    compare(devices.at(0), status("Cheese", 1, DeviceStatus::OFF, "체다", 208));
+    compare(devices.at(1), status("Cheese", 2, DeviceStatus::ON, "체다", 207));
+}
+
+void TestDeviceStateSync::testResyncAfterGap()
+{
+    DeviceStateEncoder encoder;
+    DeviceStateDecoder decoder;
+    QString error;
+    QVector<DeviceStatusMessage> changes;
+
+    encoder.update(status("Bread", 1, DeviceStatus::ON, "호밀빵", 1));
+    encoder.update(status("Egg", 1, DeviceStatus::ON, "반숙", 1));
+    QVERIFY(decoder.decode(transmit(encoder), changes, error));
+
+    // 두 번째 메시지를 잃음
+    encoder.update(status("Bread", 1, DeviceStatus::OFF, "", 1));
+    transmit(encoder);
+    encoder.update(status("Egg", 1, DeviceStatus::OFF, "", 1));
+    changes.clear();
+    QVERIFY(!decoder.decode(transmit(encoder), changes, error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(changes.isEmpty());
+    QVERIFY(!decoder.isSynchronized());
+
+    // 키프레임 전 변경분은 계속 버림
+    encoder.update(status("Egg", 1, DeviceStatus::ON, "완숙", 2));
+    QVERIFY(!decoder.decode(transmit(encoder), changes, error));
+
+    // 키프레임으로 놓친 장치 상태를 한 번씩 알림
+    encoder.requestKeyframe();
+    changes.clear();
+    QVERIFY2(decoder.decode(transmit(encoder), changes, error), qPrintable(error));
+    QVERIFY(decoder.isSynchronized());
+    QCOMPARE(changes.size(), 2);
+    compare(changes.at(0), status("Bread", 1, DeviceStatus::OFF, "", 1));
+    compare(changes.at(1), status("Egg", 1, DeviceStatus::ON, "완숙", 2));
+}
+
+void TestDeviceStateSync::testReconnect()
+{
+    DeviceStateEncoder encoder;
+    QString error;
+    QVector<DeviceStatusMessage> changes;
+
+    {
+        DeviceStateDecoder decoder;
+        encoder.update(status("Jam", 1, DeviceStatus::ON, "사과잼", 7));
+        QVERIFY(decoder.decode(transmit(encoder), changes, error));
+    }
+
+    // 연결이 끊긴 동안의 변경은 버리고, 새 연결에는 현재 상태를 키프레임으로
+    encoder.update(status("Jam", 1, DeviceStatus::OFF, "", 7));
+    encoder.reset();
+    const DeviceStateSyncMessage keyframe = transmit(encoder);
+    QVERIFY(keyframe.keyframe);
+    QCOMPARE(keyframe.sequence, 1);
+    QCOMPARE(keyframe.count, 0);
+
+    // 새 연결의 받는 쪽은 처음 보는 장치이므로 변경으로 내보내지 않고 상태만 앎
+    DeviceStateDecoder decoder;
+    changes.clear();
+    QVERIFY2(decoder.decode(keyframe, changes, error), qPrintable(error));
+    QVERIFY(changes.isEmpty());
+    QCOMPARE(decoder.snapshot().size(), 1);
+    compare(decoder.snapshot().first(), status("Jam", 1, DeviceStatus::OFF, "", 7));
+}
+
+void TestDeviceStateSync::testCollapsePending()
+{
+    DeviceStateEncoder encoder;
+    DeviceStateDecoder decoder;
+    QString error;
+    QVector<DeviceStatusMessage> changes;
+
+    encoder.update(status("Bread", 1, DeviceStatus::ON, "호밀빵", 1));
+    encoder.update(status("Egg", 1, DeviceStatus::ON, "반숙", 1));
+    QVERIFY(decoder.decode(transmit(encoder), changes, error));
+
+    // 전송이 밀린 동안 쌓인 변경 중 주문이 없는 것만 키프레임으로 접음
+    for (int deviceIndex = 2; deviceIndex < 50; ++deviceIndex) {
+        encoder.update(status("Cheese", deviceIndex, DeviceStatus::OFF, "", 0));
+    }
+    encoder.update(status("Bread", 1, DeviceStatus::OFF, "", 1));
+    encoder.update(status("Bread", 1, DeviceStatus::ON, "호밀빵", 2));
+    encoder.update(status("Bread", 1, DeviceStatus::OFF, "", 2));
+    QCOMPARE(encoder.pendingCount(), 51);
+    encoder.collapsePending();
+    QCOMPARE(encoder.pendingCount(), 3);
+    QVERIFY(encoder.hasPending());
+
+    const DeviceStateSyncMessage keyframe = transmit(encoder);
+    QVERIFY(keyframe.keyframe);
+    QCOMPARE(keyframe.count, 3);
+    changes.clear();
+    QVERIFY2(decoder.decode(keyframe, changes, error), qPrintable(error));
+    // 주문 단계 전환은 하나도 빠지거나 겹치지 않음
+    QCOMPARE(changes.size(), 3);
+    compare(changes.at(0), status("Bread", 1, DeviceStatus::OFF, "", 1));
+    compare(changes.at(1), status("Bread", 1, DeviceStatus::ON, "호밀빵", 2));
+    compare(changes.at(2), status("Bread", 1, DeviceStatus::OFF, "", 2));
+    QCOMPARE(decoder.deviceCount(), 50);
+
+    // 이후 변경분은 이어서 풀림
+    encoder.update(status("Egg", 1, DeviceStatus::OFF, "", 1));
+    changes.clear();
+    QVERIFY2(decoder.decode(transmit(encoder), changes, error), qPrintable(error));
+    QCOMPARE(changes.size(), 1);
+}
+
+void TestDeviceStateSync::testMalformedRecords()
+{
+    DeviceStateEncoder encoder;
+    DeviceStateDecoder decoder;
+    QString error;
+    QVector<DeviceStatusMessage> changes;
+
+    encoder.update(status("Bread", 1, DeviceStatus::ON, "호밀빵", 300));
+    QVERIFY(decoder.decode(transmit(encoder), changes, error));
+
+    encoder.update(status("Bread", 1, DeviceStatus::OFF, "", 300));
+    DeviceStateSyncMessage truncated = transmit(encoder);
+    truncated.records.clear();
+    changes.clear();
+    QVERIFY(!decoder.decode(truncated, changes, error));
+    QVERIFY(changes.isEmpty());
+    QVERIFY(!decoder.isSynchronized());
+
+    DeviceStateSyncMessage badName;
+    badName.keyframe = true;
+    badName.sequence = 1;
+    badName.devices << "Bread";
+    QVERIFY(!decoder.decode(badName, changes, error));
+}
+
+void TestDeviceStateSync::testSmallerThanFullStatus()
+{
+    // 장치 200대가 번갈아 작업을 시작/완료: 예전 DEVICE_STATUS_UPDATE 전체 대비 크기
+    const QStringList modules = QStringList() << "Bread" << "Cheese" << "Egg" << "Jam";
+    DeviceStateEncoder encoder;
+    DeviceStateDecoder decoder;
+    QString error;
+    QVector<DeviceStatusMessage> changes;
+
+    qint64 fullBytes = 0;
+    qint64 syncBytes = 0;
+    int orderId = 1000;
+    for (int round = 0; round < 50; ++round) {
+        for (int device = 0; device < 200; ++device) {
+            const bool start = (round + device) % 2 == 0;
+            const DeviceStatusMessage message = status(modules.at(device % 4), 1 + device / 4,
+                                                       start ? DeviceStatus::ON : DeviceStatus::OFF,
+                                                       start ? modules.at(device % 4) + " 준비" : QString(),
+                                                       orderId++);
+            Message full;
+            full.type = MessageType::DEVICE_STATUS_UPDATE;
+            full.data = message.toJson();
+            fullBytes += QJsonDocument(full.toJson()).toJson(QJsonDocument::Compact).size();
+            encoder.update(message);
+
+            // 한 메시지에 변경 20개씩 (한 번 깨어날 때 모이는 정도)
+            if (device % 20 == 19) {
+                Message sync;
+                sync.type = MessageType::DEVICE_STATE_SYNC;
+                sync.data = encoder.takeMessage().toJson();
+                const QByteArray payload = QJsonDocument(sync.toJson()).toJson(QJsonDocument::Compact);
+                syncBytes += payload.size();
+                const Message received = Message::fromJson(QJsonDocument::fromJson(payload).object());
+                QVERIFY2(decoder.decode(DeviceStateSyncMessage::fromJson(received.data), changes, error),
+                         qPrintable(error));
+            }
+        }
+    }
+    QCOMPARE(changes.size(), 50 * 200);
+    QVERIFY2(syncBytes * 10 < fullBytes,
+             qPrintable(QString("동기화 %1바이트, 전체 %2바이트").arg(syncBytes).arg(fullBytes)));
+}
+
+QTEST_MAIN(TestDeviceStateSync)
+#include "test_devicestatesync.moc"
@@ -0,0 +1,140 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include "framecapture.h"
+#include "networkmanager.h"
+
+class TestFrameCapture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testWriteAndReadBack();
+    void testTruncatedFile();
+    void testRejectsOtherFiles();
+    void testRecorderCapturesNetworkTraffic();
+
+private:
+    QTemporaryDir dir;
+};
+
+void TestFrameCapture::testWriteAndReadBack()
+{
+    const QString path = dir.filePath("roundtrip.rcap");
+    QString error;
+
+    FrameCaptureWriter writer;
+    QVERIFY2(writer.open(path, error), qPrintable(error));
+    for (int i = 0; i < 3; ++i) {
+        CapturedFrame frame;
+        frame.timestampUs = i * 1500;
+        frame.direction = i == 1 ? CapturedFrame::Direction::Outgoing : CapturedFrame::Direction::Incoming;
+        frame.connectionId = i + 1;
+        frame.payload = QByteArray("{\"type\":") + QByteArray::number(i) + "}";
+        QVERIFY(writer.write(frame));
+    }
+    QCOMPARE(writer.frameCount(), qint64(3));
+    writer.close();
+
+    FrameCaptureReader reader;
+    QVERIFY2(reader.open(path, error), qPrintable(error));
+    QVERIFY(reader.startedAtMs() > 0);
+
+    CapturedFrame frame;
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(reader.next(frame));
+        QCOMPARE(frame.timestampUs, qint64(i * 1500));
+        QCOMPARE(frame.direction, i == 1 ? CapturedFrame::Direction::Outgoing : CapturedFrame::Direction::Incoming);
+        QCOMPARE(frame.connectionId, i + 1);
+        QCOMPARE(frame.payload, QByteArray("{\"type\":") + QByteArray::number(i) + "}");
+    }
+    QVERIFY(!reader.next(frame));
+    QVERIFY(reader.errorString().isEmpty());
+}
+
+void TestFrameCapture::testTruncatedFile()
+{
+    const QString path = dir.filePath("truncated.rcap");
+    QString error;
+
+    FrameCaptureWriter writer;
+    QVERIFY(writer.open(path, error));
+    CapturedFrame frame;
+    frame.payload = QByteArray(100, 'x');
+    QVERIFY(writer.write(frame));
+    QVERIFY(writer.write(frame));
+    writer.close();
+
+    // 두 번째 프레임 본문 중간에서 잘린 파일
+    QFile file(path);
+    QVERIFY(file.resize(file.size() - 10));
+
+    FrameCaptureReader reader;
+    QVERIFY(reader.open(path, error));
+    QVERIFY(reader.next(frame));
+    QVERIFY(!reader.next(frame));
+    QVERIFY(!reader.errorString().isEmpty());
+}
+
+void TestFrameCapture::testRejectsOtherFiles()
+{
+    const QString path = dir.filePath("not_a_capture.json");
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("{\"modules\":[]}");
+    file.close();
+
+    FrameCaptureReader reader;
+    QString error;
+    QVERIFY(!reader.open(path, error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestFrameCapture::testRecorderCapturesNetworkTraffic()
+{
+    const QString path = dir.filePath("session.rcap");
+    QString error;
+    QVERIFY2(FrameRecorder::instance().start(path, error), qPrintable(error));
+
+    NetworkManager server(nullptr, true);
+    NetworkManager client(nullptr, false);
+    QVERIFY(server.startServer(12360));
+    QSignalSpy connectedSpy(&server, &NetworkManager::clientConnected);
+    QVERIFY(client.connectToServer("localhost", 12360));
+    QTRY_COMPARE(connectedSpy.count(), 1);
+    QTRY_VERIFY(client.isConnectedToServer());
+    const int connectionId = connectedSpy.first().first().toInt();
+
+    QSignalSpy receivedSpy(&server, &NetworkManager::messageReceivedFrom);
+    Message message;
+    message.type = MessageType::FLOW_CONTROL;
+    message.data["limit"] = 4;
+    QVERIFY(client.sendMessage(message));
+    QTRY_COMPARE(receivedSpy.count(), 1);
+
+    FrameRecorder::instance().stop();
+    QVERIFY(!FrameRecorder::instance().isRecording());
+
+    // 같은 프로세스의 두 관리자가 모두 기록: 클라이언트가 보낸 프레임, 서버가 받은 프레임
+    FrameCaptureReader reader;
+    QVERIFY(reader.open(path, error));
+    QList<CapturedFrame> frames;
+    CapturedFrame frame;
+    while (reader.next(frame)) {
+        frames.append(frame);
+    }
+    QCOMPARE(frames.size(), 2);
+    QCOMPARE(frames[0].direction, CapturedFrame::Direction::Outgoing);
+    QCOMPARE(frames[0].connectionId, 0);
+    QCOMPARE(frames[1].direction, CapturedFrame::Direction::Incoming);
+    QCOMPARE(frames[1].connectionId, connectionId);
+    QCOMPARE(frames[0].payload, frames[1].payload);
+    QVERIFY(frames[0].timestampUs <= frames[1].timestampUs);
+
+    const Message recorded = Message::fromJson(QJsonDocument::fromJson(frames[1].payload).object());
+    QCOMPARE(recorded.type, MessageType::FLOW_CONTROL);
+    QCOMPARE(recorded.data["limit"].toInt(), 4);
+}
+
+QTEST_MAIN(TestFrameCapture)
+#include "test_framecapture.moc"
@@ -0,0 +1,127 @@
+#include <QtTest/QtTest>
+#include "framescheduler.h"
+
+// 보내기 레인 스케줄러: 레인 우선순위, 레인 안의 순서, 뒤쪽 레인이 멈추지 않는지, 대기량 집계
+class TestFrameScheduler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPriorityOrder();
+    void testFifoWithinLane();
+    void testNoStarvation();
+    void testControlNeverWaitsForAging();
+    void testQueuedCounts();
+
+private:
+    static QList<MessageLane> drainLanes(FrameScheduler& scheduler, int count);
+};
+
+QList<MessageLane> TestFrameScheduler::drainLanes(FrameScheduler& scheduler, int count)
+{
+    QList<MessageLane> order;
+    FrameScheduler::Frame frame;
+    while (order.size() < count && scheduler.pop(frame)) {
+        order << frame.lane;
+    }
+    return order;
+}
+
+void TestFrameScheduler::testPriorityOrder()
+{
+    FrameScheduler scheduler;
+    scheduler.push(MessageLane::BULK, "bulk", 1);
+    scheduler.push(MessageLane::STATUS, "status", 2);
+    scheduler.push(MessageLane::ORDERS, "order", 3);
+    scheduler.push(MessageLane::CONTROL, "control", 4);
+
+    FrameScheduler::Frame frame;
+    QVERIFY(scheduler.pop(frame));
+    QCOMPARE(frame.payload, QByteArray("control"));
+    QCOMPARE(frame.queuedUs, qint64(4));
+    QVERIFY(scheduler.pop(frame));
+    QCOMPARE(frame.payload, QByteArray("order"));
+    QVERIFY(scheduler.pop(frame));
+    QCOMPARE(frame.payload, QByteArray("status"));
+    QVERIFY(scheduler.pop(frame));
+    QCOMPARE(frame.payload, QByteArray("bulk"));
+    QVERIFY(!scheduler.pop(frame));
+    QVERIFY(scheduler.isEmpty());
+}
+
+void TestFrameScheduler::testFifoWithinLane()
+{
+    FrameScheduler scheduler;
+    for (int i = 0; i < 100; ++i) {
+        scheduler.push(i % 2 ? MessageLane::STATUS : MessageLane::ORDERS, QByteArray::number(i), i);
+    }
+
+    // 레인끼리는 섞여도 같은 레인 안에서는 넣은 순서대로
+    int lastOrder = -1;
+    int lastStatus = -1;
+    FrameScheduler::Frame frame;
+    while (scheduler.pop(frame)) {
+        int& last = frame.lane == MessageLane::ORDERS ? lastOrder : lastStatus;
+        QVERIFY(frame.payload.toInt() > last);
+        last = frame.payload.toInt();
+    }
+    QCOMPARE(lastOrder, 98);
+    QCOMPARE(lastStatus, 99);
+}
+
+void TestFrameScheduler::testNoStarvation()
+{
+    FrameScheduler scheduler;
+    for (int i = 0; i < 200; ++i) {
+        scheduler.push(MessageLane::ORDERS, "order", i);
+    }
+    scheduler.push(MessageLane::BULK, "bulk", 0);
+    scheduler.push(MessageLane::STATUS, "status", 0);
+
+    // 주문이 계속 밀려 있어도 상태와 대량 본문이 제한된 횟수 안에 나감
+    const QList<MessageLane> order = drainLanes(scheduler, 30);
+    const int statusAt = order.indexOf(MessageLane::STATUS);
+    const int bulkAt = order.indexOf(MessageLane::BULK);
+    QVERIFY(statusAt >= 0 && statusAt <= 8);
+    QVERIFY(bulkAt >= 0 && bulkAt <= 17);
+}
+
+void TestFrameScheduler::testControlNeverWaitsForAging()
+{
+    FrameScheduler scheduler;
+    scheduler.push(MessageLane::BULK, "bulk", 0);
+    for (int i = 0; i < 40; ++i) {
+        scheduler.push(MessageLane::ORDERS, "order", i);
+    }
+    // 대량 본문이 오래 밀렸어도 제어 메시지가 있으면 제어가 먼저
+    drainLanes(scheduler, 16);
+    for (int i = 0; i < 3; ++i) {
+        scheduler.push(MessageLane::CONTROL, "control", i);
+    }
+    const QList<MessageLane> order = drainLanes(scheduler, 4);
+    QCOMPARE(order, QList<MessageLane>() << MessageLane::CONTROL << MessageLane::CONTROL
+                                         << MessageLane::CONTROL << MessageLane::BULK);
+}
+
+void TestFrameScheduler::testQueuedCounts()
+{
+    FrameScheduler scheduler;
+    scheduler.push(MessageLane::STATUS, QByteArray(100, 's'), 0);
+    scheduler.push(MessageLane::STATUS, QByteArray(50, 's'), 0);
+    scheduler.push(MessageLane::CONTROL, QByteArray(10, 'c'), 0);
+    QCOMPARE(scheduler.queuedFrames(), 3);
+    QCOMPARE(scheduler.queuedFrames(MessageLane::STATUS), 2);
+    QCOMPARE(scheduler.queuedBytes(), qint64(160));
+
+    FrameScheduler::Frame frame;
+    QVERIFY(scheduler.pop(frame));
+    QCOMPARE(scheduler.queuedBytes(), qint64(150));
+
+    scheduler.clear();
+    QVERIFY(scheduler.isEmpty());
+    QCOMPARE(scheduler.queuedBytes(), qint64(0));
+    QVERIFY(!scheduler.pop(frame));
+}
+
+QTEST_MAIN(TestFrameScheduler)
+#include "test_framescheduler.moc"
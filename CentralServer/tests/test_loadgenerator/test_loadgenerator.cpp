@@ -0,0 +1,203 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QJsonDocument>
+#include "loadgenerator.h"
+#include "ordermanager.h"
+#include "ordermanagergui.h"
+#include "simulatedrobot.h"
+#include "framecapture.h"
+
+class TestLoadGenerator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testPoissonPlan();
+    void testBurstyPlan();
+    void testReplayPlanFromCapture();
+    void testFindKnee();
+    void testMeasuresLatencyAgainstFixedServiceTime();
+    void testEndToEndWithSimulatedRobots();
+};
+
+void TestLoadGenerator::testPoissonPlan()
+{
+    LoadProfile profile = LoadProfile::defaults();
+    profile.durationMs = 100000;
+
+    // 초당 5건으로 100초: 평균 500건, 같은 seed면 같은 계획
+    const QVector<LoadProfile::PlannedOrder> first = profile.plan(5.0);
+    const QVector<LoadProfile::PlannedOrder> second = profile.plan(5.0);
+    QVERIFY(qAbs(first.size() - 500) < 75);
+    QCOMPARE(first.size(), second.size());
+    for (int i = 0; i < first.size(); ++i) {
+        QCOMPARE(first[i].atMs, second[i].atMs);
+        QCOMPARE(first[i].order.bread, second[i].order.bread);
+        if (i > 0) QVERIFY(first[i].atMs >= first[i - 1].atMs);
+    }
+    QVERIFY(first.last().atMs < profile.durationMs);
+
+    // 레시피 비율은 weight를 따름 (3:2:1)
+    int plain = 0;
+    for (const LoadProfile::PlannedOrder& planned : first) {
+        if (planned.order.cheeses == QStringList() << "체다") plain++;
+    }
+    QVERIFY(qAbs(plain / double(first.size()) - 0.5) < 0.1);
+
+    profile.seed = 2;
+    QVERIFY(profile.plan(5.0).first().atMs != first.first().atMs);
+}
+
+void TestLoadGenerator::testBurstyPlan()
+{
+    LoadProfile profile = LoadProfile::defaults();
+    profile.arrival = LoadProfile::Arrival::Bursty;
+    profile.burstSize = 8;
+    profile.durationMs = 200000;
+
+    const QVector<LoadProfile::PlannedOrder> orders = profile.plan(2.0);
+    QCOMPARE(orders.size() % 8, 0);
+    for (int i = 0; i < orders.size(); i += 8) {
+        QCOMPARE(orders[i + 7].atMs, orders[i].atMs);   // 한 몰림은 같은 시각
+    }
+    // 평균 도착률은 포아송과 같음
+    QVERIFY(qAbs(orders.size() - 400) < 120);
+}
+
+void TestLoadGenerator::testReplayPlanFromCapture()
+{
+    QTemporaryDir dir;
+    const QString path = dir.filePath("orders.rcap");
+    QString error;
+    FrameCaptureWriter writer;
+    QVERIFY(writer.open(path, error));
+
+    const int ids[] = { 10, 11, 10, 12 };  // 10번은 거절 후 재전송
+    for (int i = 0; i < 4; ++i) {
+        OrderMessage order = LoadProfile::defaults().recipes.first().order;
+        order.orderId = ids[i];
+        Message message;
+        message.type = MessageType::ORDER_NEW;
+        message.data = order.toJson();
+
+        CapturedFrame frame;
+        frame.timestampUs = 1000000 + i * 500000;
+        frame.direction = CapturedFrame::Direction::Outgoing;
+        frame.payload = QJsonDocument(message.toJson()).toJson(QJsonDocument::Compact);
+        QVERIFY(writer.write(frame));
+    }
+    writer.close();
+
+    LoadProfile profile;
+    const QJsonObject json{ { "arrival", "replay" }, { "replayCapture", path } };
+    QVERIFY2(LoadProfile::fromJson(json, profile, error), qPrintable(error));
+    QCOMPARE(profile.replayOrders.size(), 3);
+    QCOMPARE(profile.replayOrders[0].atMs, qint64(0));
+    QCOMPARE(profile.replayOrders[1].atMs, qint64(500));
+    QCOMPARE(profile.replayOrders[2].atMs, qint64(1500));
+
+    // 원래 도착률(3건/1.5초)의 두 배로 재생하면 시각이 절반
+    const QVector<LoadProfile::PlannedOrder> faster = profile.plan(4.0);
+    QCOMPARE(faster[2].atMs, qint64(750));
+}
+
+void TestLoadGenerator::testFindKnee()
+{
+    QVector<LoadReport> steps;
+    const double rates[] = { 1, 2, 4, 8 };
+    const double throughputs[] = { 1, 2, 3.95, 5 };
+    for (int i = 0; i < 4; ++i) {
+        LoadReport report;
+        report.offeredRate = rates[i];
+        report.throughput = throughputs[i];
+        report.p99Ms = 100;
+        steps.append(report);
+    }
+    QCOMPARE(LoadGenerator::findKnee(steps), 3);
+
+    // 처리량은 따라가도 지연이 크게 늘면 포화
+    steps[2].p99Ms = 250;
+    QCOMPARE(LoadGenerator::findKnee(steps), 2);
+
+    const QJsonObject summary = LoadGenerator::summaryJson(steps, 2);
+    QCOMPARE(summary["kneeRate"].toDouble(), 4.0);
+    QCOMPARE(summary["sustainableRate"].toDouble(), 2.0);
+    QCOMPARE(LoadGenerator::findKnee(steps.mid(0, 2)), -1);
+}
+
+void TestLoadGenerator::testMeasuresLatencyAgainstFixedServiceTime()
+{
+    // 로봇 대신 전송된 주문을 20ms 뒤 완료 처리
+    OrderManager manager;
+    manager.handleRobotConnected(1);
+    FlowControlMessage flow;
+    flow.window = 1000;
+    flow.backlog = 0;
+    flow.received = 0;
+    flow.limit = 1000;
+    manager.handleFlowControl(1, flow);
+    connect(&manager, &OrderManager::orderDispatched, &manager, [&manager](int, OrderHandle handle) {
+        const int orderId = manager.orderTable().orderId(handle);
+        QTimer::singleShot(20, &manager, [&manager, orderId]() { manager.finishOrder(orderId); });
+    });
+
+    LoadProfile profile = LoadProfile::defaults();
+    profile.durationMs = 300;
+    profile.sweepRates = QVector<double>() << 50 << 100;
+
+    LoadGenerator generator(&manager);
+    QSignalSpy finishedSpy(&generator, &LoadGenerator::finished);
+    generator.start(profile);
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 5000);
+
+    const QVector<LoadReport> steps = finishedSpy.first().at(0).value<QVector<LoadReport>>();
+    QCOMPARE(steps.size(), 2);
+    for (const LoadReport& step : steps) {
+        QVERIFY(step.submitted > 0);
+        QCOMPARE(step.completed, step.submitted);
+        QVERIFY(step.drained);
+        QVERIFY(step.p50Ms >= 19);
+        QVERIFY(step.p999Ms >= step.p99Ms);
+        QVERIFY(step.p99Ms >= step.p50Ms);
+        QVERIFY(step.throughput > 0);
+    }
+}
+
+void TestLoadGenerator::testEndToEndWithSimulatedRobots()
+{
+    // 실제 서버 화면(프로토콜 처리 포함)에 가상 로봇 두 대를 붙여 실행
+    OrderManagerGUI gui;
+    QVERIFY(gui.startServer(12380));
+
+    SimulatedRobot first;
+    SimulatedRobot second;
+    first.setTimeScale(0.002);      // 빵 20ms
+    second.setTimeScale(0.002);
+    QVERIFY(first.connectToServer("localhost", 12380));
+    QVERIFY(second.connectToServer("localhost", 12380));
+    QTRY_VERIFY(gui.getOrderManager()->availableCredits() > 0);
+
+    LoadProfile profile = LoadProfile::defaults();
+    profile.ratePerSecond = 40;
+    profile.durationMs = 500;
+    profile.drainTimeoutMs = 5000;
+
+    LoadGenerator generator(gui.getOrderManager());
+    QSignalSpy finishedSpy(&generator, &LoadGenerator::finished);
+    generator.start(profile);
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+
+    const QVector<LoadReport> steps = finishedSpy.first().at(0).value<QVector<LoadReport>>();
+    QCOMPARE(steps.size(), 1);
+    QVERIFY(steps.first().submitted > 0);
+    QCOMPARE(steps.first().completed, steps.first().submitted);
+    QCOMPARE(first.completedOrders() + second.completedOrders(), steps.first().completed);
+    QVERIFY(first.completedOrders() > 0);
+    QVERIFY(second.completedOrders() > 0);
+    // 빵(20ms) + 치즈 + 계란 + 잼 단계를 거치므로 최소 처리 시간 이상
+    QVERIFY(steps.first().p50Ms >= 48);
+}
+
+QTEST_MAIN(TestLoadGenerator)
+#include "test_loadgenerator.moc"
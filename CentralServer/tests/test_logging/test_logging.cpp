@@ -0,0 +1,116 @@
+#include <QtTest/QtTest>
+#include "logging.h"
+
+// 로그 수준 지정과 꺼진 로그의 인자 평가 여부 확인
+class TestLogging : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void testDefaultIsInfo();
+    void testGlobalLevel();
+    void testPerCategoryLevel();
+    void testOff();
+    void testInvalidSpec();
+    void testDisabledArgumentsAreNotEvaluated();
+
+private:
+    static int evaluations;
+    static QString expensiveDump();
+};
+
+int TestLogging::evaluations = 0;
+
+QString TestLogging::expensiveDump()
+{
+    evaluations++;
+    return QString("dump");
+}
+
+void TestLogging::cleanup()
+{
+    QString error;
+    QVERIFY(Logging::applyLevelSpec("info", error));
+}
+
+void TestLogging::testDefaultIsInfo()
+{
+    QString error;
+    QVERIFY(Logging::applyLevelSpec("", error));
+    QVERIFY(!lcNetwork().isDebugEnabled());
+    QVERIFY(lcNetwork().isInfoEnabled());
+    QVERIFY(lcDevice().isWarningEnabled());
+}
+
+void TestLogging::testGlobalLevel()
+{
+    QString error;
+    QVERIFY(Logging::applyLevelSpec("debug", error));
+    QVERIFY(lcNetwork().isDebugEnabled());
+    QVERIFY(lcGui().isDebugEnabled());
+
+    QVERIFY(Logging::applyLevelSpec("WARNING", error));
+    QVERIFY(!lcOrders().isInfoEnabled());
+    QVERIFY(lcOrders().isWarningEnabled());
+}
+
+void TestLogging::testPerCategoryLevel()
+{
+    QString error;
+    QVERIFY(Logging::applyLevelSpec("network=debug, device=critical", error));
+    QVERIFY(lcNetwork().isDebugEnabled());
+    QVERIFY(!lcDevice().isWarningEnabled());
+    QVERIFY(lcDevice().isCriticalEnabled());
+
+    // 지정하지 않은 분류는 기본값 (info)
+    QVERIFY(!lcOrders().isDebugEnabled());
+    QVERIFY(lcOrders().isInfoEnabled());
+
+    // 나중에 쓴 항목이 우선
+    QVERIFY(Logging::applyLevelSpec("debug,gui=off", error));
+    QVERIFY(lcOrders().isDebugEnabled());
+    QVERIFY(!lcGui().isCriticalEnabled());
+}
+
+void TestLogging::testOff()
+{
+    QString error;
+    QVERIFY(Logging::applyLevelSpec("off", error));
+    QVERIFY(!lcNetwork().isWarningEnabled());
+    QVERIFY(!lcNetwork().isCriticalEnabled());
+}
+
+void TestLogging::testInvalidSpec()
+{
+    QString error;
+    QVERIFY(!Logging::applyLevelSpec("verbose", error));
+    QVERIFY(error.contains("verbose"));
+
+    error.clear();
+    QVERIFY(!Logging::applyLevelSpec("printer=debug", error));
+    QVERIFY(error.contains("printer"));
+}
+
+void TestLogging::testDisabledArgumentsAreNotEvaluated()
+{
+    QString error;
+    QVERIFY(Logging::applyLevelSpec("info", error));
+
+    evaluations = 0;
+    for (int i = 0; i < 100; ++i) {
+        qCDebug(lcNetwork) << "Message data:" << expensiveDump();
+    }
+    QCOMPARE(evaluations, 0);
+
+#ifndef QT_NO_DEBUG_OUTPUT
+    // 켜면 평가됨 (release 빌드에서는 문장 자체가 빠지므로 확인하지 않음)
+    QVERIFY(Logging::applyLevelSpec("network=debug", error));
+    QTest::ignoreMessage(QtDebugMsg, "Message data: \"dump\"");
+    qCDebug(lcNetwork) << "Message data:" << expensiveDump();
+    QCOMPARE(evaluations, 1);
+#endif
+}
+
+QTEST_MAIN(TestLogging)
+#include "test_logging.moc"
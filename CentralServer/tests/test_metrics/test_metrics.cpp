@@ -0,0 +1,114 @@
+#include <QtTest/QtTest>
+#include <QThread>
+#include <limits>
+#include "metrics.h"
+
+class TestMetrics : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testBucketBoundaries();
+    void testPercentiles();
+    void testRegistryReturnsSameMetric();
+    void testConcurrentRecording();
+};
+
+void TestMetrics::testBucketBoundaries()
+{
+    // 16 미만은 값 그대로, 그 이상은 구간 상한과의 상대 오차가 1/16 이내
+    for (quint64 value = 0; value < 16; ++value) {
+        QCOMPARE(MetricHistogram::bucketIndex(value), static_cast<int>(value));
+    }
+
+    const quint64 samples[] = { 16, 31, 32, 1000, 123456, 10000000, quint64(1) << 40,
+                                std::numeric_limits<quint64>::max() };
+    int previousIndex = -1;
+    for (quint64 value : samples) {
+        const int index = MetricHistogram::bucketIndex(value);
+        QVERIFY(index > previousIndex);
+        QVERIFY(index < MetricHistogram::BucketCount);
+        const quint64 upper = MetricHistogram::bucketUpperBound(index);
+        QVERIFY(upper >= value);
+        QVERIFY(upper - value <= value / 16);
+        if (index > 0) {
+            QVERIFY(MetricHistogram::bucketUpperBound(index - 1) < value);
+        }
+        previousIndex = index;
+    }
+}
+
+void TestMetrics::testPercentiles()
+{
+    MetricHistogram histogram;
+    QCOMPARE(histogram.percentile(0.5), quint64(0));
+
+    // 1ms ~ 100ms를 1ms 간격으로 기록 (마이크로초)
+    for (quint64 ms = 1; ms <= 100; ++ms) {
+        histogram.record(ms * 1000);
+    }
+
+    QCOMPARE(histogram.count(), quint64(100));
+    QCOMPARE(histogram.sum(), quint64(5050 * 1000));
+    QCOMPARE(histogram.max(), quint64(100000));
+    QVERIFY(qAbs(static_cast<double>(histogram.percentile(0.5)) - 50000) <= 50000 / 16.0);
+    QVERIFY(qAbs(static_cast<double>(histogram.percentile(0.99)) - 99000) <= 99000 / 16.0);
+    QCOMPARE(histogram.percentile(1.0), quint64(100000));
+}
+
+void TestMetrics::testRegistryReturnsSameMetric()
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    MetricCounter* bread = registry.counter("test_tasks_total", "테스트", "module=\"Bread\"");
+    MetricCounter* egg = registry.counter("test_tasks_total", "테스트", "module=\"Egg\"");
+    QVERIFY(bread != egg);
+    QCOMPARE(registry.counter("test_tasks_total", "테스트", "module=\"Bread\""), bread);
+
+    bread->add(3);
+    egg->add();
+
+    int found = 0;
+    for (const MetricsRegistry::Entry& entry : registry.entries()) {
+        if (entry.name == "test_tasks_total") {
+            QCOMPARE(entry.type, MetricsRegistry::Type::Counter);
+            QCOMPARE(entry.counter->value(), entry.labels.contains("Bread") ? quint64(3) : quint64(1));
+            found++;
+        }
+    }
+    QCOMPARE(found, 2);
+
+    MetricGauge* depth = registry.gauge("test_depth", "테스트");
+    depth->set(4);
+    depth->add(-1.5);
+    QCOMPARE(depth->value(), 2.5);
+}
+
+void TestMetrics::testConcurrentRecording()
+{
+    MetricCounter counter;
+    MetricHistogram histogram;
+    const int threadCount = 4;
+    const int perThread = 100000;
+
+    QList<QThread*> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.append(QThread::create([&counter, &histogram, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                counter.add();
+                histogram.record(static_cast<quint64>(t * perThread + i));
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    QCOMPARE(counter.value(), quint64(threadCount * perThread));
+    QCOMPARE(histogram.count(), quint64(threadCount * perThread));
+    QCOMPARE(histogram.max(), quint64(threadCount * perThread - 1));
+}
+
+QTEST_MAIN(TestMetrics)
+#include "test_metrics.moc"
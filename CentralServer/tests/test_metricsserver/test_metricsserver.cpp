@@ -0,0 +1,107 @@
+#include <QtTest/QtTest>
+#include <QTcpSocket>
+#include "metricsserver.h"
+
+class TestMetricsServer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testRenderPrometheus();
+    void testRequestRouting();
+    void testScrapeOverHttp();
+    void testStartFailsOnBusyPort();
+};
+
+void TestMetricsServer::testRenderPrometheus()
+{
+    MetricCounter frames;
+    frames.add(7);
+    MetricGauge breadDepth;
+    breadDepth.set(3);
+    MetricGauge eggDepth;
+    eggDepth.set(0.5);
+    MetricHistogram latency;
+    for (quint64 us = 1; us <= 100; ++us) {
+        latency.record(us);
+    }
+
+    QList<MetricsRegistry::Entry> entries;
+    entries.append({ "test_frames_total", QString(), "보낸 프레임", MetricsRegistry::Type::Counter,
+                     &frames, nullptr, nullptr });
+    entries.append({ "test_queue_depth", "module=\"Bread\"", "대기열", MetricsRegistry::Type::Gauge,
+                     nullptr, &breadDepth, nullptr });
+    entries.append({ "test_queue_depth", "module=\"Egg\"", "대기열", MetricsRegistry::Type::Gauge,
+                     nullptr, &eggDepth, nullptr });
+    entries.append({ "test_latency_us", "module=\"Bread\"", "지연\n시간", MetricsRegistry::Type::Histogram,
+                     nullptr, nullptr, &latency });
+
+    const QString text = QString::fromUtf8(MetricsServer::renderPrometheus(entries));
+    QVERIFY(text.contains("# TYPE test_frames_total counter\ntest_frames_total 7\n"));
+    QCOMPARE(text.count("# TYPE test_queue_depth gauge"), 1);     // 라벨이 달라도 HELP/TYPE은 한 번
+    QVERIFY(text.contains("test_queue_depth{module=\"Bread\"} 3\n"));
+    QVERIFY(text.contains("test_queue_depth{module=\"Egg\"} 0.5\n"));
+    QVERIFY(text.contains("# HELP test_latency_us 지연\\n시간\n"));
+    QVERIFY(text.contains("# TYPE test_latency_us summary\n"));
+    // 분위수는 속한 구간의 상한으로 보고 (50 -> [50, 51] 구간)
+    QVERIFY(text.contains("test_latency_us{module=\"Bread\",quantile=\"0.5\"} 51\n"));
+    QVERIFY(text.contains("test_latency_us{module=\"Bread\",quantile=\"0.99\"} 99\n"));
+    QVERIFY(text.contains("test_latency_us_sum{module=\"Bread\"} 5050\n"));
+    QVERIFY(text.contains("test_latency_us_count{module=\"Bread\"} 100\n"));
+}
+
+void TestMetricsServer::testRequestRouting()
+{
+    QVERIFY(MetricsServer::handleRequest("GET /metrics HTTP/1.1\r\nHost: x\r\n\r\n").startsWith("HTTP/1.1 200 OK"));
+    QVERIFY(MetricsServer::handleRequest("GET /metrics?name=x HTTP/1.1\r\n\r\n").startsWith("HTTP/1.1 200 OK"));
+    QVERIFY(MetricsServer::handleRequest("GET / HTTP/1.1\r\n\r\n").startsWith("HTTP/1.1 404"));
+    QVERIFY(MetricsServer::handleRequest("POST /metrics HTTP/1.1\r\n\r\n").startsWith("HTTP/1.1 405"));
+    QVERIFY(MetricsServer::handleRequest("garbage\r\n\r\n").startsWith("HTTP/1.1 400"));
+}
+
+void TestMetricsServer::testScrapeOverHttp()
+{
+    MetricsRegistry::instance().counter("test_scrape_total", "테스트")->add(42);
+
+    MetricsServer server;
+    QVERIFY(server.start(0, QHostAddress::LocalHost));
+    QVERIFY(server.isRunning());
+    QVERIFY(server.serverPort() != 0);
+
+    // 수신기는 별도 스레드에서 응답하므로 테스트 스레드에서 블로킹 대기 가능
+    QTcpSocket socket;
+    socket.connectToHost(QHostAddress::LocalHost, server.serverPort());
+    QVERIFY(socket.waitForConnected(3000));
+    socket.write("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    QVERIFY(socket.waitForBytesWritten(3000));
+
+    QByteArray response;
+    while (socket.state() == QAbstractSocket::ConnectedState && socket.waitForReadyRead(3000)) {
+        response += socket.readAll();
+    }
+    response += socket.readAll();
+
+    QVERIFY(response.startsWith("HTTP/1.1 200 OK\r\n"));
+    QVERIFY(response.contains("Content-Type: text/plain; version=0.0.4"));
+    const QByteArray body = response.mid(response.indexOf("\r\n\r\n") + 4);
+    QVERIFY(body.contains("test_scrape_total 42\n"));
+    QVERIFY(response.contains("Content-Length: " + QByteArray::number(body.size())));
+
+    server.stop();
+    QVERIFY(!server.isRunning());
+}
+
+void TestMetricsServer::testStartFailsOnBusyPort()
+{
+    MetricsServer first;
+    QVERIFY(first.start(0, QHostAddress::LocalHost));
+
+    MetricsServer second;
+    QSignalSpy logSpy(&second, &MetricsServer::logMessage);
+    QVERIFY(!second.start(first.serverPort(), QHostAddress::LocalHost));
+    QVERIFY(!second.isRunning());
+    QCOMPARE(logSpy.count(), 1);
+}
+
+QTEST_MAIN(TestMetricsServer)
+#include "test_metricsserver.moc"
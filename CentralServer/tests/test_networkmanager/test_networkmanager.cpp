@@ -1,7 +1,9 @@
 #include <QtTest/QtTest>
 #include "networkmanager.h"
+#include "devicestatesync.h"
 #include <QSignalSpy>
 #include <QTimer>
+#include <QElapsedTimer>
 
 class TestNetworkManager : public QObject
 {
@@ -12,9 +14,24 @@ private slots:
     void cleanupTestCase();
     void testServerStartStop();
     void testClientConnectDisconnect();
+    void testConnectFailureReported();
     void testMessageSendReceive();
+    void testMultipleClients();
+    void testReceiveWhileCallerBlocked();
+    void testLocalTransport();
+    void testLocalTransportDisabled();
+    void testLargeFramesOverLocalTransport();
+    void testLargeFramesOverTcp();
+    void testControlLaneLatency_data();
+    void testControlLaneLatency();
+    void testSendBackpressure();
+    void testStalledPeerClosed();
 
 private:
+    static bool usesLocalTransport(NetworkManager& manager);
+    // 연결만 하고 받은 데이터를 1KB까지만 가져가는 상대 (커널 버퍼가 차면 서버 쪽 전송이 밀림)
+    bool connectStalledPeer(QTcpSocket& socket, int& connectionId);
+
     NetworkManager *serverManager;
     NetworkManager *clientManager;
     quint16 testPort;
@@ -78,6 +95,26 @@ void TestNetworkManager::testClientConnectDisconnect()
     QCOMPARE(errorSpy.count(), 0);
 }
 
+void TestNetworkManager::testConnectFailureReported()
+{
+    // 서버가 없는 포트: 호출은 기다리지 않고 돌아오고 실패는 errorOccurred로만 알림
+    NetworkManager robot(nullptr, false);
+    QSignalSpy connectedSpy(&robot, &NetworkManager::connected);
+    QSignalSpy disconnectedSpy(&robot, &NetworkManager::disconnected);
+    QSignalSpy errorSpy(&robot, &NetworkManager::errorOccurred);
+
+    QVERIFY(robot.connectToServer("127.0.0.1", testPort + 1));
+    QCOMPARE(errorSpy.count(), 0);
+    QTRY_VERIFY(!errorSpy.isEmpty());
+    QTRY_VERIFY(errorSpy.last().at(0).toString().startsWith("서버 연결 실패"));
+    QCOMPARE(connectedSpy.count(), 0);
+    QCOMPARE(disconnectedSpy.count(), 0);
+    QVERIFY(!robot.isConnectedToServer());
+    Message flow;
+    flow.type = MessageType::FLOW_CONTROL;
+    QVERIFY(!robot.sendMessage(flow));
+}
+
 void TestNetworkManager::testMessageSendReceive()
 {
     // 서버 시작
@@ -95,6 +132,7 @@ void TestNetworkManager::testMessageSendReceive()
 
     // 클라이언트 연결
     QVERIFY(clientManager->connectToServer("localhost", testPort));
+    QTRY_VERIFY(clientManager->isConnectedToServer());
     QTRY_COMPARE(clientConnectedSpy.count(), 1);
     QTRY_COMPARE(serverConnectedSpy.count(), 1);
 
@@ -146,5 +184,486 @@ void TestNetworkManager::testMessageSendReceive()
     QCOMPARE(clientErrorSpy.count(), 0);
 }
 
+void TestNetworkManager::testMultipleClients()
+{
+    QVERIFY(serverManager->startServer(testPort));
+
+    QSignalSpy clientConnectedSpy(serverManager, &NetworkManager::clientConnected);
+    QSignalSpy clientDisconnectedSpy(serverManager, &NetworkManager::clientDisconnected);
+    QSignalSpy serverMessageSpy(serverManager, &NetworkManager::messageReceivedFrom);
+
+    NetworkManager firstRobot(nullptr, false);
+    NetworkManager secondRobot(nullptr, false);
+    QSignalSpy firstMessageSpy(&firstRobot, &NetworkManager::messageReceived);
+    QSignalSpy secondMessageSpy(&secondRobot, &NetworkManager::messageReceived);
+
+    QVERIFY(firstRobot.connectToServer("localhost", testPort));
+    QTRY_VERIFY(firstRobot.isConnectedToServer());
+    QTRY_COMPARE(clientConnectedSpy.count(), 1);
+    QVERIFY(secondRobot.connectToServer("localhost", testPort));
+    QTRY_VERIFY(secondRobot.isConnectedToServer());
+    QTRY_COMPARE(clientConnectedSpy.count(), 2);
+    QCOMPARE(serverManager->connectionCount(), 2);
+
+    const int firstId = clientConnectedSpy.at(0).at(0).toInt();
+    const int secondId = clientConnectedSpy.at(1).at(0).toInt();
+    QVERIFY(firstId != secondId);
+
+    // 연결 ID를 지정하면 해당 로봇에만 전송
+    Message order;
+    order.type = MessageType::ORDER_NEW;
+    QJsonObject dataObj;
+    dataObj["orderId"] = 7;
+    order.data = dataObj;
+    QVERIFY(serverManager->sendMessageTo(secondId, order));
+    QTRY_COMPARE(secondMessageSpy.count(), 1);
+    QTest::qWait(100);
+    QCOMPARE(firstMessageSpy.count(), 0);
+
+    // 수신 메시지에는 보낸 로봇의 연결 ID가 붙음
+    Message status;
+    status.type = MessageType::FLOW_CONTROL;
+    QVERIFY(firstRobot.sendMessage(status));
+    QTRY_COMPARE(serverMessageSpy.count(), 1);
+    QCOMPARE(serverMessageSpy.at(0).at(0).toInt(), firstId);
+
+    firstRobot.disconnectFromServer();
+    QTRY_COMPARE(clientDisconnectedSpy.count(), 1);
+    QCOMPARE(clientDisconnectedSpy.at(0).at(0).toInt(), firstId);
+    QCOMPARE(serverManager->connectionCount(), 1);
+
+    QVERIFY(serverManager->stopServer());
+    QTRY_COMPARE(clientDisconnectedSpy.count(), 2);
+}
+
+void TestNetworkManager::testReceiveWhileCallerBlocked()
+{
+    QVERIFY(serverManager->startServer(testPort));
+    QSignalSpy serverMessageSpy(serverManager, &NetworkManager::messageReceivedFrom);
+
+    NetworkManager robot(nullptr, false);
+    QVERIFY(robot.connectToServer("localhost", testPort));
+    QTRY_VERIFY(robot.isConnectedToServer());
+    QTRY_COMPARE(serverManager->connectionCount(), 1);
+
+    const int count = 50;
+    for (int i = 0; i < count; ++i) {
+        Message status;
+        status.type = MessageType::DEVICE_STATUS_UPDATE;
+        QJsonObject dataObj;
+        dataObj["orderId"] = i;
+        status.data = dataObj;
+        QVERIFY(robot.sendMessage(status));
+    }
+
+    // 이 스레드가 이벤트 루프 없이 막혀 있어도 I/O 스레드가 송신, 수신, 디코딩까지 끝내 둠
+    QElapsedTimer timer;
+    timer.start();
+    while (serverManager->worker->inbound.size() < count && timer.elapsed() < 5000) {
+        QThread::msleep(5);
+    }
+    QCOMPARE(serverManager->worker->inbound.size(), count);
+    QCOMPARE(serverMessageSpy.count(), 0);
+
+    // 이벤트 루프로 돌아오면 받은 순서대로 한꺼번에 전달
+    QTRY_COMPARE(serverMessageSpy.count(), count);
+    for (int i = 0; i < count; ++i) {
+        const Message received = qvariant_cast<Message>(serverMessageSpy.at(i).at(1));
+        QCOMPARE(received.data["orderId"].toInt(), i);
+    }
+
+    QVERIFY(serverManager->stopServer());
+}
+
+// 공유 메모리 전송으로 전환했는지 (연결 상태는 I/O 스레드에서 읽음)
+bool TestNetworkManager::usesLocalTransport(NetworkManager& manager)
+{
+    bool result = false;
+    NetworkWorker* worker = manager.worker;
+    QMetaObject::invokeMethod(worker, [worker, &result]() {
+        if (!worker->isServer) {
+            result = worker->localChannel && worker->localChannel->sending;
+            return;
+        }
+        result = !worker->clients.isEmpty();
+        for (auto it = worker->clients.constBegin(); it != worker->clients.constEnd(); ++it) {
+            result = result && it->local && it->local->sending;
+        }
+    }, Qt::BlockingQueuedConnection);
+    return result;
+}
+
+void TestNetworkManager::testLocalTransport()
+{
+    QVERIFY(serverManager->startServer(testPort));
+    QSignalSpy serverMessageSpy(serverManager, &NetworkManager::messageReceivedFrom);
+
+    NetworkManager robot(nullptr, false);
+    QSignalSpy robotMessageSpy(&robot, &NetworkManager::messageReceived);
+    QVERIFY(robot.connectToServer("127.0.0.1", testPort));
+    QTRY_VERIFY(robot.isConnectedToServer());
+    QTRY_COMPARE(serverManager->connectionCount(), 1);
+    QTRY_VERIFY(usesLocalTransport(*serverManager) && usesLocalTransport(robot));
+
+    MetricCounter* localFrames = MetricsRegistry::instance().counter("net_local_frames_sent_total", QString());
+    MetricCounter* wakeups = MetricsRegistry::instance().counter("net_local_wakeups_sent_total", QString());
+    const quint64 framesBefore = localFrames->value();
+    const quint64 wakeupsBefore = wakeups->value();
+
+    // 링(256KB)보다 많이 보내서 가득 찬 뒤 이어 쓰는 경로까지 확인
+    const int count = 6000;
+    for (int i = 0; i < count; ++i) {
+        Message status;
+        status.type = MessageType::DEVICE_STATUS_UPDATE;
+        QJsonObject dataObj;
+        dataObj["orderId"] = i;
+        dataObj["padding"] = QString(40, 'x');
+        status.data = dataObj;
+        QVERIFY(robot.sendMessage(status));
+
+        Message order;
+        order.type = MessageType::ORDER_NEW;
+        order.data = dataObj;
+        QVERIFY(serverManager->sendMessage(order));
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(serverMessageSpy.count(), count, 10000);
+    QTRY_COMPARE_WITH_TIMEOUT(robotMessageSpy.count(), count, 10000);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(qvariant_cast<Message>(serverMessageSpy.at(i).at(1)).data["orderId"].toInt(), i);
+        QCOMPARE(qvariant_cast<Message>(robotMessageSpy.at(i).at(0)).data["orderId"].toInt(), i);
+    }
+
+    // 본문은 모두 링으로 가고, 깨우기 신호는 몰려 보낸 만큼 묶임
+    QCOMPARE(localFrames->value() - framesBefore, quint64(2 * count));
+    QVERIFY(wakeups->value() - wakeupsBefore < quint64(2 * count));
+
+    robot.disconnectFromServer();
+    QTRY_COMPARE(serverManager->connectionCount(), 0);
+    QVERIFY(serverManager->stopServer());
+}
+
+void TestNetworkManager::testLocalTransportDisabled()
+{
+    NetworkManager::setLocalTransportEnabled(false);
+    QVERIFY(serverManager->startServer(testPort));
+    QSignalSpy serverMessageSpy(serverManager, &NetworkManager::messageReceivedFrom);
+
+    NetworkManager robot(nullptr, false);
+    QVERIFY(robot.connectToServer("127.0.0.1", testPort));
+    QTRY_VERIFY(robot.isConnectedToServer());
+    QTRY_COMPARE(serverManager->connectionCount(), 1);
+
+    Message status;
+    status.type = MessageType::FLOW_CONTROL;
+    QVERIFY(robot.sendMessage(status));
+    QTRY_COMPARE(serverMessageSpy.count(), 1);
+    QVERIFY(!usesLocalTransport(*serverManager));
+    QVERIFY(!usesLocalTransport(robot));
+
+    NetworkManager::setLocalTransportEnabled(true);
+    QVERIFY(serverManager->stopServer());
+}
+
+void TestNetworkManager::testLargeFramesOverLocalTransport()
+{
+    QVERIFY(serverManager->startServer(testPort));
+    QSignalSpy serverMessageSpy(serverManager, &NetworkManager::messageReceivedFrom);
+
+    NetworkManager robot(nullptr, false);
+    QSignalSpy robotMessageSpy(&robot, &NetworkManager::messageReceived);
+    QVERIFY(robot.connectToServer("127.0.0.1", testPort));
+    QTRY_VERIFY(robot.isConnectedToServer());
+    QTRY_COMPARE(serverManager->connectionCount(), 1);
+    QTRY_VERIFY(usesLocalTransport(*serverManager) && usesLocalTransport(robot));
+
+    // 링(256KB)보다 큰 본문은 조각으로 나뉘어 가고, 같은 레인에서 뒤에 보낸 작은 메시지가 앞지르지 않음
+    Message large;
+    large.type = MessageType::PUBLISH;
+    QJsonObject largeData;
+    largeData["padding"] = QString(600000, 'p');
+    large.data = largeData;
+
+    for (int round = 0; round < 3; ++round) {
+        Message small;
+        small.type = MessageType::PUBLISH;
+        QJsonObject smallData;
+        smallData["sequence"] = round;
+        small.data = smallData;
+        QVERIFY(serverManager->sendMessage(large));
+        QVERIFY(serverManager->sendMessage(small));
+        QVERIFY(robot.sendMessage(large));
+        QVERIFY(robot.sendMessage(small));
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(robotMessageSpy.count(), 6, 10000);
+    QTRY_COMPARE_WITH_TIMEOUT(serverMessageSpy.count(), 6, 10000);
+    for (int round = 0; round < 3; ++round) {
+        const int i = round * 2;
+        QCOMPARE(qvariant_cast<Message>(robotMessageSpy.at(i).at(0)).data["padding"].toString().size(), 600000);
+        QCOMPARE(qvariant_cast<Message>(robotMessageSpy.at(i + 1).at(0)).data["sequence"].toInt(), round);
+        QCOMPARE(qvariant_cast<Message>(serverMessageSpy.at(i).at(1)).data["padding"].toString().size(), 600000);
+        QCOMPARE(qvariant_cast<Message>(serverMessageSpy.at(i + 1).at(1)).data["sequence"].toInt(), round);
+    }
+    QVERIFY(usesLocalTransport(*serverManager) && usesLocalTransport(robot));
+
+    robot.disconnectFromServer();
+    QTRY_COMPARE(serverManager->connectionCount(), 0);
+    QVERIFY(serverManager->stopServer());
+}
+
+void TestNetworkManager::testLargeFramesOverTcp()
+{
+    // 크기 접두어는 자릿수 제한 없는 4바이트 (첫 바이트는 깨우기 신호와 겹치지 않도록 항상 0)
+    const QByteArray frame = NetworkManager::encodeFrame(QByteArray(70000, 'x'));
+    QCOMPARE(frame.size(), 70004);
+    QCOMPARE(frame.left(4), QByteArray::fromHex("00011170"));
+
+    NetworkManager::setLocalTransportEnabled(false);
+    QVERIFY(serverManager->startServer(testPort));
+    NetworkManager robot(nullptr, false);
+    QSignalSpy robotSpy(&robot, &NetworkManager::messageReceived);
+    QSignalSpy serverSpy(serverManager, &NetworkManager::messageReceivedFrom);
+    QVERIFY(robot.connectToServer("127.0.0.1", testPort));
+    QTRY_VERIFY(robot.isConnectedToServer());
+    QTRY_COMPARE(serverManager->connectionCount(), 1);
+    QVERIFY(!usesLocalTransport(robot));
+    const int connectionId = serverManager->connectionIds().first();
+
+    // 10000바이트가 넘는 본문 다음에 오는 작은 메시지도 경계가 어긋나지 않고 도착
+    Message large;
+    large.type = MessageType::PUBLISH;
+    large.data["padding"] = QString(50000, 'x');
+    Message small;
+    small.type = MessageType::FLOW_CONTROL;
+    small.data["limit"] = 3;
+    QVERIFY(serverManager->sendMessageTo(connectionId, large));
+    QVERIFY(serverManager->sendMessageTo(connectionId, small));
+    QTRY_COMPARE(robotSpy.count(), 2);
+    QCOMPARE(qvariant_cast<Message>(robotSpy.at(0).at(0)).data["padding"].toString().size(), 50000);
+    QCOMPARE(qvariant_cast<Message>(robotSpy.at(1).at(0)).data["limit"].toInt(), 3);
+
+    // 장치 1000대의 키프레임 (장치 이름 표와 모든 상태를 한 메시지에 실음)
+    DeviceStateEncoder encoder;
+    for (int device = 1; device <= 1000; ++device) {
+        DeviceStatusMessage status;
+        status.moduleType = device % 2 ? "Bread" : "Cheese";
+        status.deviceIndex = device;
+        status.status = device % 3 ? DeviceStatus::ON : DeviceStatus::OFF;
+        status.currentTask = QString("작업 %1").arg(device % 40);
+        status.orderId = 1000 + device;
+        encoder.update(status);
+    }
+    Message keyframe;
+    keyframe.type = MessageType::DEVICE_STATE_SYNC;
+    keyframe.data = encoder.takeMessage().toJson();
+    QVERIFY(QJsonDocument(keyframe.toJson()).toJson(QJsonDocument::Compact).size() > 10000);
+    QVERIFY(robot.sendMessage(keyframe));
+    QVERIFY(robot.sendMessage(small));
+    QTRY_COMPARE(serverSpy.count(), 2);
+
+    const Message received = qvariant_cast<Message>(serverSpy.at(0).at(1));
+    QCOMPARE(received.type, MessageType::DEVICE_STATE_SYNC);
+    DeviceStateDecoder decoder;
+    QVector<DeviceStatusMessage> changes;
+    QString error;
+    QVERIFY2(decoder.decode(DeviceStateSyncMessage::fromJson(received.data), changes, error), qPrintable(error));
+    QCOMPARE(decoder.deviceCount(), 1000);
+    const DeviceStatusMessage last = decoder.snapshot().last();
+    QCOMPARE(last.moduleType, QString("Cheese"));
+    QCOMPARE(last.deviceIndex, 1000);
+    QCOMPARE(last.orderId, 2000);
+    QCOMPARE(qvariant_cast<Message>(serverSpy.at(1).at(1)).type, MessageType::FLOW_CONTROL);
+
+    robot.disconnectFromServer();
+    QTRY_COMPARE(serverManager->connectionCount(), 0);
+    NetworkManager::setLocalTransportEnabled(true);
+    QVERIFY(serverManager->stopServer());
+}
+
+void TestNetworkManager::testControlLaneLatency_data()
+{
+    QTest::addColumn<bool>("local");
+    QTest::newRow("tcp") << false;
+    QTest::newRow("shared-memory") << true;
+}
+
+void TestNetworkManager::testControlLaneLatency()
+{
+    QFETCH(bool, local);
+    NetworkManager::setLocalTransportEnabled(local);
+    QVERIFY(serverManager->startServer(testPort));
+
+    NetworkManager robot(nullptr, false);
+    QVERIFY(robot.connectToServer("127.0.0.1", testPort));
+    QTRY_VERIFY(robot.isConnectedToServer());
+    QTRY_COMPARE(serverManager->connectionCount(), 1);
+    if (local) {
+        QTRY_VERIFY(usesLocalTransport(*serverManager) && usesLocalTransport(robot));
+    }
+    const int connectionId = serverManager->connectionIds().first();
+
+    // 12KB 상태 본문(큰 스냅숏) 500개(약 6MB, 연결을 닫는 한도보다 적게)를 대량 레인에 쌓은 직후 제어 메시지 하나를 보냄
+    // 한 줄로 보냈다면 제어 메시지는 대량 전송이 다 끝난 뒤에 도착함
+    const int bulkCount = 500;
+    QElapsedTimer clock;
+    int bulkReceived = 0;
+    int controlPosition = -1;
+    qint64 controlReceivedMs = -1;
+    qint64 bulkFinishedMs = -1;
+    connect(&robot, &NetworkManager::messageReceived, this, [&](const Message& message) {
+        if (message.type == MessageType::FLOW_CONTROL) {
+            controlPosition = bulkReceived;
+            controlReceivedMs = clock.elapsed();
+        } else if (++bulkReceived == bulkCount) {
+            bulkFinishedMs = clock.elapsed();
+        }
+    });
+
+    Message bulk;
+    bulk.type = MessageType::PUBLISH;
+    bulk.data["padding"] = QString(12000, 'x');
+    clock.start();
+    for (int i = 0; i < bulkCount; ++i) {
+        QVERIFY(serverManager->sendMessageTo(connectionId, bulk, MessageLane::BULK));
+    }
+    const qint64 controlSentMs = clock.elapsed();
+    Message control;
+    control.type = MessageType::FLOW_CONTROL;
+    control.data["limit"] = 1;
+    QVERIFY(serverManager->sendMessageTo(connectionId, control));
+
+    QVERIFY(QJsonDocument(bulk.toJson()).toJson(QJsonDocument::Compact).size() > 10000);
+    QTRY_VERIFY_WITH_TIMEOUT(bulkFinishedMs >= 0 && controlReceivedMs >= 0, 30000);
+    qInfo().noquote() << QString("제어 메시지 %1ms (대량 %2개 중 %3개 뒤), 대량 전송 %4ms")
+                             .arg(controlReceivedMs - controlSentMs).arg(bulkCount)
+                             .arg(controlPosition).arg(bulkFinishedMs);
+
+    // 제어 메시지 앞에는 이미 소켓(창과 커널 버퍼)에 넘긴 대량 본문만 있음
+    QVERIFY(controlPosition < bulkCount / 2);
+    QVERIFY(controlReceivedMs - controlSentMs < (bulkFinishedMs - controlSentMs) / 2);
+
+    // 레인마다 기다린 시간이 기록됨
+    MetricHistogram* controlWait = MetricsRegistry::instance().histogram(
+        "net_send_queue_wait_us", QString(), "lane=\"control\"");
+    MetricHistogram* bulkWait = MetricsRegistry::instance().histogram(
+        "net_send_queue_wait_us", QString(), "lane=\"bulk\"");
+    QVERIFY(controlWait->count() > 0);
+    QVERIFY(bulkWait->count() >= quint64(bulkCount));
+
+    robot.disconnectFromServer();
+    QTRY_COMPARE(serverManager->connectionCount(), 0);
+    NetworkManager::setLocalTransportEnabled(true);
+    QVERIFY(serverManager->stopServer());
+}
+
+bool TestNetworkManager::connectStalledPeer(QTcpSocket& socket, int& connectionId)
+{
+    const int before = serverManager->connectionCount();
+    socket.setReadBufferSize(1024);
+    socket.connectToHost(QHostAddress::LocalHost, testPort);
+    if (!socket.waitForConnected(5000)) {
+        return false;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    while (serverManager->connectionCount() == before && timer.elapsed() < 5000) {
+        QTest::qWait(5);
+    }
+    if (serverManager->connectionCount() == before) {
+        return false;
+    }
+    connectionId = serverManager->connectionIds().last();
+    return true;
+}
+
+void TestNetworkManager::testSendBackpressure()
+{
+    QVERIFY(serverManager->startServer(testPort));
+    QSignalSpy backpressureSpy(serverManager, &NetworkManager::sendBackpressure);
+
+    QTcpSocket stalled;
+    int connectionId = 0;
+    QVERIFY(connectStalledPeer(stalled, connectionId));
+
+    // 혼잡 알림을 받을 때까지만 보냄 (알림을 따르는 보내는 쪽)
+    Message load;
+    load.type = MessageType::ROBOT_LOAD;
+    load.data["padding"] = QString(4000, 'x');
+    int sent = 0;
+    QElapsedTimer timer;
+    timer.start();
+    while (!serverManager->isSendCongested(connectionId) && timer.elapsed() < 30000) {
+        for (int i = 0; i < 16; ++i) {
+            QVERIFY(serverManager->sendMessageTo(connectionId, load));
+            sent++;
+        }
+        QTest::qWait(1);
+    }
+    QVERIFY(serverManager->isSendCongested(connectionId));
+    QCOMPARE(backpressureSpy.count(), 1);
+    QCOMPARE(backpressureSpy.at(0).at(0).toInt(), connectionId);
+    QVERIFY(backpressureSpy.at(0).at(1).toBool());
+    QCOMPARE(serverManager->connectionCount(), 1);
+
+    // 다시 읽기 시작하면 낮은 수위 아래에서 한 번 풀리고, 보낸 메시지는 빠짐없이 도착
+    stalled.setReadBufferSize(0);
+    QByteArray received;
+    timer.restart();
+    while (received.count("\"padding\"") < sent && timer.elapsed() < 30000) {
+        QTest::qWait(5);
+        received += stalled.readAll();
+    }
+    QCOMPARE(received.count("\"padding\""), sent);
+    QTRY_VERIFY(!serverManager->isSendCongested(connectionId));
+    QCOMPARE(backpressureSpy.count(), 2);
+    QVERIFY(!backpressureSpy.at(1).at(1).toBool());
+
+    stalled.disconnectFromHost();
+    QTRY_COMPARE(serverManager->connectionCount(), 0);
+    QVERIFY(serverManager->stopServer());
+}
+
+void TestNetworkManager::testStalledPeerClosed()
+{
+    QVERIFY(serverManager->startServer(testPort));
+    QSignalSpy errorSpy(serverManager, &NetworkManager::errorOccurred);
+    QSignalSpy disconnectedSpy(serverManager, &NetworkManager::clientDisconnected);
+    MetricCounter* closed = MetricsRegistry::instance().counter("net_slow_peers_closed_total", QString());
+    const quint64 closedBefore = closed->value();
+
+    QTcpSocket stalled;
+    int connectionId = 0;
+    QVERIFY(connectStalledPeer(stalled, connectionId));
+
+    // 혼잡 알림을 무시하고 한도(8MB)보다 많이 보내면 연결을 닫고 쌓인 본문을 버림
+    Message load;
+    load.type = MessageType::ROBOT_LOAD;
+    load.data["padding"] = QString(4000, 'x');
+    for (int i = 0; i < 3000 && serverManager->connectionCount() > 0; ++i) {
+        serverManager->sendMessageTo(connectionId, load);
+    }
+
+    QTRY_COMPARE_WITH_TIMEOUT(disconnectedSpy.count(), 1, 30000);
+    QCOMPARE(disconnectedSpy.at(0).at(0).toInt(), connectionId);
+    QCOMPARE(serverManager->connectionCount(), 0);
+    QVERIFY(!serverManager->isSendCongested(connectionId));
+    QCOMPARE(closed->value() - closedBefore, quint64(1));
+    QVERIFY(errorSpy.count() >= 1);
+
+    // 다른 연결은 계속 받음
+    NetworkManager robot(nullptr, false);
+    QSignalSpy robotSpy(&robot, &NetworkManager::messageReceived);
+    QVERIFY(robot.connectToServer("127.0.0.1", testPort));
+    QTRY_VERIFY(robot.isConnectedToServer());
+    QTRY_COMPARE(serverManager->connectionCount(), 1);
+    QVERIFY(serverManager->sendMessageTo(serverManager->connectionIds().first(), load));
+    QTRY_COMPARE(robotSpy.count(), 1);
+
+    robot.disconnectFromServer();
+    QTRY_COMPARE(serverManager->connectionCount(), 0);
+    QVERIFY(serverManager->stopServer());
+}
+
 QTEST_MAIN(TestNetworkManager)
 #include "test_networkmanager.moc"
\ No newline at end of file
@@ -14,6 +14,12 @@ private slots:
     void testHandleOrderStatusUpdate();
     void testHandleDeviceStatusUpdate();
     void testOrderCompletion();
+    void testFlowControlCredits();
+    void testRejectedOrderIsRequeued();
+    void testDispatchToEarliestFinishingRobot();
+    void testCongestedRobotSkipped();
+    void testDisconnectedRobotOrdersRequeued();
+    void testRobotMessagesAdvanceSteps();
 
 private:
     OrderManager *manager;
@@ -163,5 +169,290 @@ void TestOrderManager::testOrderCompletion()
     QVERIFY(!isStillActive);
 }
 
+void TestOrderManager::testFlowControlCredits()
+{
+    OrderManager flowManager;
+    QSignalSpy dispatchSpy(&flowManager, &OrderManager::orderDispatched);
+
+    // 로봇이 연결되기 전에는 대기열에만 쌓임
+    flowManager.submitOrder("흰빵", "완숙", {}, 0, {});
+    flowManager.submitOrder("흰빵", "반숙", {}, 0, {}, OrderPriority::HIGH);
+    flowManager.submitOrder("호밀빵", "완숙", {}, 0, {});
+    QCOMPARE(dispatchSpy.count(), 0);
+    QCOMPARE(flowManager.pendingOrderCount(), 3);
+
+    // 크레딧 2개: 급한 주문이 먼저, 이후 ID 순
+    flowManager.handleRobotConnected(1);
+    FlowControlMessage flow;
+    flow.window = 2;
+    flow.backlog = 0;
+    flow.received = 0;
+    flow.limit = 2;
+    flowManager.handleFlowControl(1, flow);
+
+    QCOMPARE(dispatchSpy.count(), 2);
+    QCOMPARE(qvariant_cast<OrderMessage>(dispatchSpy.at(0).at(1)).egg, QString("반숙"));
+    QCOMPARE(qvariant_cast<OrderMessage>(dispatchSpy.at(1).at(1)).bread, QString("흰빵"));
+    QCOMPARE(flowManager.pendingOrderCount(), 1);
+    QCOMPARE(flowManager.availableCredits(), 0);
+
+    // 같은 상한이 다시 와도 중복 전송하지 않음
+    flowManager.handleFlowControl(1, flow);
+    QCOMPARE(dispatchSpy.count(), 2);
+
+    // 로봇이 한 건을 끝내면 상한이 늘어남
+    flow.backlog = 1;
+    flow.limit = 3;
+    flowManager.handleFlowControl(1, flow);
+    QCOMPARE(dispatchSpy.count(), 3);
+    QCOMPARE(flowManager.pendingOrderCount(), 0);
+}
+
+void TestOrderManager::testRejectedOrderIsRequeued()
+{
+    OrderManager flowManager;
+    QSignalSpy dispatchSpy(&flowManager, &OrderManager::orderDispatched);
+
+    flowManager.handleRobotConnected(1);
+    FlowControlMessage flow;
+    flow.window = 1;
+    flow.backlog = 0;
+    flow.received = 0;
+    flow.limit = 1;
+    flowManager.handleFlowControl(1, flow);
+
+    OrderMessage order;
+    order.orderId = 0;
+    order.bread = "흰빵";
+    order.egg = "완숙";
+    order.jamAmount = 0;
+    const int orderId = flowManager.enqueueOrder(order);
+    QVERIFY(orderId > 0);
+    QCOMPARE(dispatchSpy.count(), 1);
+
+    flowManager.handleOrderRejected(1, orderId, "로봇 보관 한도 초과 (1/1)");
+    QCOMPARE(flowManager.pendingOrderCount(), 1);
+
+    flow.received = 1;
+    flow.limit = 2;
+    flowManager.handleFlowControl(1, flow);
+    QCOMPARE(dispatchSpy.count(), 2);
+    QCOMPARE(qvariant_cast<OrderMessage>(dispatchSpy.at(1).at(1)).orderId, orderId);
+
+    // 전송 실패 시 크레딧을 돌려받고 연결 회복 전까지 멈춤
+    flowManager.handleOrderSendFailed(1, orderId);
+    QCOMPARE(flowManager.pendingOrderCount(), 1);
+    QCOMPARE(flowManager.availableCredits(), 0);
+
+    QVERIFY(flowManager.cancelPendingOrder(orderId));
+    QCOMPARE(flowManager.pendingOrderCount(), 0);
+}
+
+void TestOrderManager::testDispatchToEarliestFinishingRobot()
+{
+    OrderManager flowManager;
+    QSignalSpy dispatchSpy(&flowManager, &OrderManager::orderDispatched);
+
+    FlowControlMessage flow;
+    flow.window = 4;
+    flow.backlog = 0;
+    flow.received = 0;
+    flow.limit = 4;
+
+    // 로봇 1은 빵 장치 1대에 대기 주문 3건, 로봇 2는 빵 장치 2대에 대기 없음
+    RobotLoadMessage busyLoad;
+    ModuleLoad bread;
+    bread.module = "Bread";
+    bread.devices = 1;
+    bread.busy = 1;
+    bread.waiting = 2;
+    bread.durationMs = 10000;
+    busyLoad.modules << bread;
+    busyLoad.backlog = 3;
+
+    RobotLoadMessage idleLoad;
+    bread.devices = 2;
+    bread.busy = 0;
+    bread.waiting = 0;
+    idleLoad.modules << bread;
+
+    flowManager.handleRobotConnected(1);
+    flowManager.handleRobotConnected(2);
+    flowManager.handleRobotLoad(1, busyLoad);
+    flowManager.handleRobotLoad(2, idleLoad);
+    flowManager.handleFlowControl(1, flow);
+    flowManager.handleFlowControl(2, flow);
+
+    flowManager.submitOrder("흰빵", "완숙", {}, 0, {});
+    QCOMPARE(dispatchSpy.count(), 1);
+    QCOMPARE(dispatchSpy.at(0).at(0).toInt(), 2);
+
+    QVERIFY(flowManager.orderDispatcher().estimateCompletionMs(2) <
+            flowManager.orderDispatcher().estimateCompletionMs(1));
+}
+
+void TestOrderManager::testCongestedRobotSkipped()
+{
+    OrderManager flowManager;
+    QSignalSpy dispatchSpy(&flowManager, &OrderManager::orderDispatched);
+
+    FlowControlMessage flow;
+    flow.window = 4;
+    flow.backlog = 0;
+    flow.received = 0;
+    flow.limit = 4;
+    flowManager.handleRobotConnected(1);
+    flowManager.handleRobotConnected(2);
+    flowManager.handleFlowControl(1, flow);
+    flowManager.handleFlowControl(2, flow);
+    QCOMPARE(flowManager.availableCredits(), 8);
+
+    // 연결이 밀린 로봇은 크레딧이 남아도 고르지 않음
+    flowManager.handleSendBackpressure(2, true);
+    QCOMPARE(flowManager.availableCredits(), 4);
+    flowManager.submitOrder("흰빵", "완숙", {}, 0, {});
+    QCOMPARE(dispatchSpy.count(), 1);
+    QCOMPARE(dispatchSpy.at(0).at(0).toInt(), 1);
+
+    // 모두 밀리면 대기열에서 기다렸다가, 풀린 로봇으로 이어서 보냄
+    flowManager.handleSendBackpressure(1, true);
+    flowManager.submitOrder("호밀빵", "반숙", {}, 0, {});
+    QCOMPARE(dispatchSpy.count(), 1);
+    QCOMPARE(flowManager.pendingOrderCount(), 1);
+
+    flowManager.handleSendBackpressure(2, false);
+    QCOMPARE(dispatchSpy.count(), 2);
+    QCOMPARE(dispatchSpy.at(1).at(0).toInt(), 2);
+    QCOMPARE(flowManager.pendingOrderCount(), 0);
+    QCOMPARE(flowManager.availableCredits(), 3);
+
+    // 로봇이 아닌 연결(구독자)의 알림은 무시
+    flowManager.handleSendBackpressure(7, true);
+    QCOMPARE(flowManager.availableCredits(), 3);
+}
+
+void TestOrderManager::testDisconnectedRobotOrdersRequeued()
+{
+    OrderManager flowManager;
+    QSignalSpy dispatchSpy(&flowManager, &OrderManager::orderDispatched);
+    QSignalSpy requeueSpy(&flowManager, &OrderManager::orderRequeued);
+
+    FlowControlMessage flow;
+    flow.window = 4;
+    flow.backlog = 0;
+    flow.received = 0;
+    flow.limit = 4;
+    flowManager.handleRobotConnected(1);
+    flowManager.handleRobotConnected(2);
+    flowManager.handleFlowControl(1, flow);
+
+    flowManager.submitOrder("흰빵", "완숙", {}, 0, {});
+    flowManager.submitOrder("호밀빵", "반숙", {}, 0, {});
+    flowManager.submitOrder("통밀빵", "완숙", {}, 0, {});
+    QCOMPARE(dispatchSpy.count(), 3);
+    const int finishedId = flowManager.orderTable().orderId(qvariant_cast<OrderHandle>(dispatchSpy.at(0).at(1)));
+    QVERIFY(flowManager.finishOrder(finishedId));
+
+    // 로봇 1이 끊기면 끝내지 못한 두 주문만 대기열로 돌아와 다음 로봇을 기다림
+    flowManager.handleRobotDisconnected(1);
+    QCOMPARE(requeueSpy.count(), 2);
+    QCOMPARE(requeueSpy.at(0).at(0).toInt(), 1);
+    QCOMPARE(flowManager.pendingOrderCount(), 2);
+    QCOMPARE(flowManager.orderTable().size(), 2);
+    const OrderHandle requeued = qvariant_cast<OrderHandle>(requeueSpy.at(0).at(1));
+    QCOMPARE(flowManager.orderTable().status(requeued), OrderStatus::WAITING);
+
+    flowManager.handleFlowControl(2, flow);
+    QCOMPARE(dispatchSpy.count(), 5);
+    QCOMPARE(dispatchSpy.at(3).at(0).toInt(), 2);
+    QCOMPARE(dispatchSpy.at(4).at(0).toInt(), 2);
+    QCOMPARE(flowManager.pendingOrderCount(), 0);
+
+    // 이미 정리한 연결이 다시 끊겨도 되돌릴 주문이 없음
+    flowManager.handleRobotDisconnected(1);
+    QCOMPARE(requeueSpy.count(), 2);
+
+    flowManager.handleRobotDisconnected(2);
+    QCOMPARE(requeueSpy.count(), 4);
+    QCOMPARE(flowManager.pendingOrderCount(), 2);
+}
+
+void TestOrderManager::testRobotMessagesAdvanceSteps()
+{
+    OrderManager flowManager;
+    QSignalSpy dispatchSpy(&flowManager, &OrderManager::orderDispatched);
+    QSignalSpy stepSpy(&flowManager, &OrderManager::orderStepChanged);
+    QSignalSpy completedSpy(&flowManager, &OrderManager::orderCompleted);
+    QSignalSpy requeueSpy(&flowManager, &OrderManager::orderRequeued);
+
+    // 로봇이 보낸 메시지를 화면을 거치지 않고 그대로 받음
+    FlowControlMessage flow;
+    flow.window = 2;
+    flow.backlog = 0;
+    flow.received = 0;
+    flow.limit = 2;
+    Message flowMessage;
+    flowMessage.type = MessageType::FLOW_CONTROL;
+    flowMessage.data = flow.toJson();
+    flowManager.handleRobotMessage(1, flowMessage);     // 아직 로봇으로 등록되지 않은 연결
+    QCOMPARE(flowManager.availableCredits(), 0);
+    flowManager.handleRobotConnected(1);
+    flowManager.handleRobotMessage(1, flowMessage);
+    QCOMPARE(flowManager.availableCredits(), 2);
+
+    flowManager.submitOrder("흰빵", "완숙", {}, 0, {});
+    flowManager.submitOrder("호밀빵", "반숙", {}, 0, {});
+    QCOMPARE(dispatchSpy.count(), 2);
+    const OrderHandle first = qvariant_cast<OrderHandle>(dispatchSpy.at(0).at(1));
+    const int firstId = flowManager.orderTable().orderId(first);
+    const int secondId = flowManager.orderTable().orderId(qvariant_cast<OrderHandle>(dispatchSpy.at(1).at(1)));
+    QCOMPARE(flowManager.orderTable().step(first), int(OrderManager::BREAD_STEP));
+
+    Message update;
+    update.type = MessageType::ORDER_STATUS_UPDATE;
+    QJsonObject updateData;
+    updateData["orderId"] = firstId;
+    updateData["module"] = "Bread";
+    updateData["status"] = static_cast<int>(OrderStatus::PROCESSING);
+    update.data = updateData;
+    flowManager.handleRobotMessage(1, update);
+    QCOMPARE(stepSpy.count(), 1);
+    QVERIFY(flowManager.orderTable().isProcessing(first));
+
+    // 장치 상태로도 같은 주문이 진행됨 (작업 완료 보고)
+    DeviceStatusMessage oven;
+    oven.moduleType = "Bread";
+    oven.deviceIndex = 1;
+    oven.status = DeviceStatus::OFF;
+    oven.orderId = firstId;
+    flowManager.handleDeviceStatusUpdate(oven);
+    QCOMPARE(stepSpy.count(), 2);
+    QVERIFY(!flowManager.orderTable().isProcessing(first));
+    QCOMPARE(flowManager.orderTable().step(first), int(OrderManager::CHEESE_STEP));
+
+    updateData["status"] = static_cast<int>(OrderStatus::COMPLETED);
+    update.data = updateData;
+    for (int step = OrderManager::CHEESE_STEP; step < OrderManager::COMPLETE_STEP; ++step) {
+        flowManager.handleRobotMessage(1, update);
+    }
+    QCOMPARE(completedSpy.count(), 1);
+    QCOMPARE(completedSpy.at(0).at(0).toInt(), firstId);
+    QVERIFY(flowManager.orderTable().find(firstId).isNull());
+
+    // 거절은 이유와 함께 대기열로 돌아옴
+    Message reject;
+    reject.type = MessageType::ERROR_REPORT;
+    QJsonObject rejectData;
+    rejectData["orderId"] = secondId;
+    rejectData["reason"] = "로봇 보관 한도 초과 (2/2)";
+    reject.data = rejectData;
+    flowManager.handleRobotMessage(1, reject);
+    QCOMPARE(requeueSpy.count(), 1);
+    QCOMPARE(requeueSpy.at(0).at(2).toString(), QString("로봇 보관 한도 초과 (2/2)"));
+    QCOMPARE(flowManager.pendingOrderCount(), 1);
+    QCOMPARE(flowManager.orderTable().step(flowManager.orderTable().find(secondId)),
+             int(OrderManager::QUEUED_STEP));
+}
+
 QTEST_MAIN(TestOrderManager)
 #include "test_ordermanager.moc"
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include <QtTest/QtTest>
 #include "ordermanagergui.h"
+#include "devicestatesync.h"
+#include "networkmanager.h"
 #include <QApplication>
 #include <QTextBlock>
 #include <QRadioButton>
@@ -23,8 +25,11 @@ private slots:
     void testValidateOrder_FullSelection();
     void testOnOrderSubmit_ServerNotRunning();
     void testOnOrderSubmit_ValidOrder();
+    void testLateSubscriberGetsSnapshot();
 
 private:
+    static int countPublished(const QSignalSpy& spy, const QString& topicPrefix, const QString& key = QString());
+
     QApplication *m_app;
     OrderManagerGUI *m_gui;
 };
@@ -133,8 +138,8 @@ void TestOrderManagerGUI::testOnOrderSubmit_ValidOrder()
 
     // 서버 시작
     QTest::mouseClick(startServerBtn, Qt::LeftButton);
-    // 서버 시작 후 상태가 변경되는데 약간의 대기 필요
-    QTest::qWait(1000);
+    // 서버 시작은 동기식이므로 고정 시간 대신 상태 변화를 확인
+    QTRY_VERIFY(!portBox->isEnabled());
 
     // 필수항목 선택
     QRadioButton *ryeBreadRB = m_gui->findChild<QRadioButton*>("ryeBreadRadioButton");
@@ -161,5 +166,107 @@ void TestOrderManagerGUI::testOnOrderSubmit_ValidOrder()
     QVERIFY(idItem->text().toInt() > 0);
 }
 
+int TestOrderManagerGUI::countPublished(const QSignalSpy& spy, const QString& topicPrefix, const QString& key)
+{
+    int count = 0;
+    for (const QList<QVariant>& arguments : spy) {
+        const Message message = qvariant_cast<Message>(arguments.at(0));
+        if (message.type != MessageType::PUBLISH) {
+            continue;
+        }
+        const PublishMessage publish = PublishMessage::fromJson(message.data);
+        if (publish.topic.startsWith(topicPrefix) && (key.isEmpty() || publish.key == key)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void TestOrderManagerGUI::testLateSubscriberGetsSnapshot()
+{
+    // 앞의 테스트에서 켠 서버에 로봇이 붙어 대기 중인 주문을 받고 장치 상태를 보고한 뒤에 구독
+    QSpinBox *portBox = m_gui->findChild<QSpinBox*>("portSpinBox");
+    QTableWidget *orderTable = m_gui->findChild<QTableWidget*>("orderStatusTable");
+    QVERIFY(portBox && !portBox->isEnabled());
+    QVERIFY(orderTable && orderTable->rowCount() > 0);
+    const quint16 port = static_cast<quint16>(portBox->value());
+    const int lastRow = orderTable->rowCount() - 1;
+    const QString orderId = orderTable->item(lastRow, 0)->text();
+
+    NetworkManager robot(nullptr, false);
+    QVERIFY(robot.connectToServer("127.0.0.1", port));
+    QTRY_VERIFY(robot.isConnectedToServer());
+
+    DeviceStateEncoder encoder;
+    DeviceStatusMessage oven;
+    oven.moduleType = "Bread";
+    oven.deviceIndex = 1;
+    oven.status = DeviceStatus::OFF;
+    encoder.update(oven);
+    Message keyframe;
+    keyframe.type = MessageType::DEVICE_STATE_SYNC;
+    keyframe.data = encoder.takeMessage().toJson();
+    QVERIFY(robot.sendMessage(keyframe));
+
+    FlowControlMessage flow;
+    flow.window = 4;
+    flow.backlog = 0;
+    flow.received = 0;
+    flow.limit = 4;
+    Message flowMessage;
+    flowMessage.type = MessageType::FLOW_CONTROL;
+    flowMessage.data = flow.toJson();
+    QVERIFY(robot.sendMessage(flowMessage));
+    QTRY_COMPARE(orderTable->item(lastRow, 1)->text(), QString("빵 준비 대기 중"));
+
+    // 구독한 연결에만 지금의 주문 행, 장치 상태, 로봇 부하를 보냄
+    NetworkManager viewer(nullptr, false);
+    QSignalSpy viewerSpy(&viewer, &NetworkManager::messageReceived);
+    QVERIFY(viewer.connectToServer("127.0.0.1", port));
+    QTRY_VERIFY(viewer.isConnectedToServer());
+    SubscribeMessage subscribe;
+    subscribe.topics = QStringList() << "orders" << "devices" << "robot/*";
+    Message subscribeMessage;
+    subscribeMessage.type = MessageType::SUBSCRIBE;
+    subscribeMessage.data = subscribe.toJson();
+    QVERIFY(viewer.sendMessage(subscribeMessage));
+
+    QTRY_COMPARE(countPublished(viewerSpy, "orders", orderId), 1);
+    QTRY_COMPARE(countPublished(viewerSpy, "devices"), 1);
+    QTRY_VERIFY(countPublished(viewerSpy, "robot/", "load") >= 1);
+
+    bool sawOrderStep = false;
+    bool sawConnectedRobot = false;
+    for (const QList<QVariant>& arguments : viewerSpy) {
+        const PublishMessage publish = PublishMessage::fromJson(qvariant_cast<Message>(arguments.at(0)).data);
+        if (publish.topic == "orders" && publish.key == orderId) {
+            sawOrderStep = publish.event["step"].toString() == "빵 준비 대기 중";
+        } else if (publish.topic.startsWith("robot/") && publish.event["connected"].toBool()) {
+            // 보낸 주문만큼 크레딧이 줄고 보관 주문으로 잡힘
+            sawConnectedRobot = publish.event["credits"].toInt() + publish.event["backlog"].toInt() == flow.limit;
+        }
+    }
+    QVERIFY(sawOrderStep);
+    QVERIFY(sawConnectedRobot);
+
+    // 다음 구독자의 스냅샷은 앞의 구독자에게 다시 가지 않음
+    NetworkManager kitchen(nullptr, false);
+    QSignalSpy kitchenSpy(&kitchen, &NetworkManager::messageReceived);
+    QVERIFY(kitchen.connectToServer("127.0.0.1", port));
+    QTRY_VERIFY(kitchen.isConnectedToServer());
+    subscribe.topics = QStringList() << "orders";
+    subscribeMessage.data = subscribe.toJson();
+    QVERIFY(kitchen.sendMessage(subscribeMessage));
+    QTRY_COMPARE(countPublished(kitchenSpy, "orders", orderId), 1);
+    QTest::qWait(200);
+    QCOMPARE(countPublished(kitchenSpy, "devices"), 0);
+    QCOMPARE(countPublished(viewerSpy, "orders", orderId), 1);
+    QCOMPARE(countPublished(viewerSpy, "devices"), 1);
+
+    kitchen.disconnectFromServer();
+    viewer.disconnectFromServer();
+    robot.disconnectFromServer();
+}
+
 QTEST_MAIN(TestOrderManagerGUI)
 #include "test_ordermanagergui.moc"
\ No newline at end of file
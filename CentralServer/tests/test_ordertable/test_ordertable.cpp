@@ -0,0 +1,186 @@
+#include <QtTest/QtTest>
+#include "ordertable.h"
+
+class TestOrderTable : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testInsertAndFind();
+    void testDuplicateInsert();
+    void testRemoveInvalidatesHandle();
+    void testSlotReuseChangesGeneration();
+    void testArrivalOrderIteration();
+    void testManyOrders();
+    void testSharedDetails();
+    void testInternedIngredients();
+
+private:
+    static OrderMessage makeOrder(int orderId);
+};
+
+OrderMessage TestOrderTable::makeOrder(int orderId)
+{
+    OrderMessage order;
+    order.orderId = orderId;
+    order.bread = "호밀빵";
+    order.egg = "완숙";
+    order.jams << "딸기잼";
+    order.jamAmount = 50;
+    order.cheeses << "모짜렐라";
+    order.status = OrderStatus::WAITING;
+    return order;
+}
+
+void TestOrderTable::testInsertAndFind()
+{
+    OrderTable table;
+    OrderHandle handle = table.insert(makeOrder(7), 100);
+
+    QVERIFY(!handle.isNull());
+    QCOMPARE(table.size(), 1);
+    QVERIFY(table.find(7) == handle);
+    QVERIFY(table.find(8).isNull());
+
+    QCOMPARE(table.orderId(handle), 7);
+    QCOMPARE(table.status(handle), OrderStatus::WAITING);
+    QCOMPARE(table.step(handle), 0);
+    QCOMPARE(table.isProcessing(handle), false);
+    QCOMPARE(table.createdAt(handle), qint64(100));
+    QCOMPARE(table.details(handle).bread, QString("호밀빵"));
+
+    // 필드 갱신
+    table.setStatus(handle, OrderStatus::PROCESSING);
+    table.setStep(handle, 2);
+    table.setProcessing(handle, true);
+    table.touch(handle, 200);
+
+    OrderMessage order = table.order(handle);
+    QCOMPARE(order.orderId, 7);
+    QCOMPARE(order.status, OrderStatus::PROCESSING);
+    QCOMPARE(order.cheeses, QStringList() << "모짜렐라");
+    QCOMPARE(table.step(handle), 2);
+    QCOMPARE(table.updatedAt(handle), qint64(200));
+}
+
+void TestOrderTable::testDuplicateInsert()
+{
+    OrderTable table;
+    QVERIFY(!table.insert(makeOrder(1)).isNull());
+    QVERIFY(table.insert(makeOrder(1)).isNull());
+    QCOMPARE(table.size(), 1);
+}
+
+void TestOrderTable::testRemoveInvalidatesHandle()
+{
+    OrderTable table;
+    OrderHandle handle = table.insert(makeOrder(3));
+
+    QVERIFY(table.remove(handle));
+    QVERIFY(!table.contains(handle));
+    QVERIFY(!table.remove(handle));
+    QVERIFY(table.find(3).isNull());
+    QCOMPARE(table.size(), 0);
+}
+
+void TestOrderTable::testSlotReuseChangesGeneration()
+{
+    OrderTable table;
+    OrderHandle oldHandle = table.insert(makeOrder(1));
+    table.remove(oldHandle);
+
+    // 같은 슬롯이 재사용되어도 이전 핸들은 무효여야 함
+    OrderHandle newHandle = table.insert(makeOrder(2));
+    QCOMPARE(newHandle.index, oldHandle.index);
+    QVERIFY(newHandle.generation != oldHandle.generation);
+    QVERIFY(!table.contains(oldHandle));
+    QVERIFY(table.contains(newHandle));
+    QCOMPARE(table.orderId(newHandle), 2);
+}
+
+void TestOrderTable::testArrivalOrderIteration()
+{
+    OrderTable table;
+    for (int id = 1; id <= 5; ++id) {
+        table.insert(makeOrder(id));
+    }
+    table.remove(table.find(2));
+    table.insert(makeOrder(6));  // 2번 슬롯을 재사용하지만 순서는 맨 뒤
+
+    QList<int> ids;
+    table.forEach([&](OrderHandle handle) {
+        ids.append(table.orderId(handle));
+    });
+    QCOMPARE(ids, QList<int>() << 1 << 3 << 4 << 5 << 6);
+
+    OrderHandle first = table.findFirst([&](OrderHandle handle) {
+        return table.orderId(handle) > 3;
+    });
+    QCOMPARE(table.orderId(first), 4);
+}
+
+void TestOrderTable::testManyOrders()
+{
+    OrderTable table;
+    const int count = 50000;
+    for (int id = 1; id <= count; ++id) {
+        QVERIFY(!table.insert(makeOrder(id)).isNull());
+    }
+    for (int id = 1; id <= count; id += 2) {
+        QVERIFY(table.remove(table.find(id)));
+    }
+
+    QCOMPARE(table.size(), count / 2);
+    for (int id = 1; id <= count; ++id) {
+        QCOMPARE(table.find(id).isNull(), id % 2 == 1);
+    }
+    QCOMPARE(table.orders().size(), count / 2);
+}
+
+void TestOrderTable::testSharedDetails()
+{
+    OrderTable source;
+    OrderMessage message = makeOrder(3);
+    message.priority = OrderPriority::HIGH;
+    message.deadline = 5000;
+    OrderHandle sourceHandle = source.insert(message, 100);
+    source.setStatus(sourceHandle, OrderStatus::PROCESSING);
+
+    // 재료 목록은 복사하지 않고 같은 레코드를 가리킴
+    OrderTable shown;
+    OrderHandle handle = shown.insertShared(source, sourceHandle, 200);
+    QVERIFY(!handle.isNull());
+    QVERIFY(shown.sharedDetails(handle) == source.sharedDetails(sourceHandle));
+    QCOMPARE(shown.orderId(handle), 3);
+    QCOMPARE(shown.status(handle), OrderStatus::PROCESSING);
+    QCOMPARE(shown.priority(handle), OrderPriority::HIGH);
+    QCOMPARE(shown.deadline(handle), qint64(5000));
+    QCOMPARE(shown.createdAt(handle), qint64(200));
+    QVERIFY(shown.insertShared(source, sourceHandle).isNull());
+
+    // 원래 테이블에서 지워도 공유한 쪽은 그대로 남음
+    SharedOrderDetails details = source.sharedDetails(sourceHandle);
+    source.remove(sourceHandle);
+    QVERIFY(shown.insertShared(source, sourceHandle).isNull());
+    QCOMPARE(shown.details(handle).bread, QString("호밀빵"));
+    QVERIFY(shown.sharedDetails(handle) == details);
+
+    // 전송 형식은 OrderMessage::toJson과 같음
+    QCOMPARE(shown.toJson(handle), shown.order(handle).toJson());
+}
+
+void TestOrderTable::testInternedIngredients()
+{
+    OrderTable table;
+    OrderHandle first = table.insert(makeOrder(1));
+    OrderHandle second = table.insert(makeOrder(2));
+
+    // 같은 재료 이름과 조합은 테이블 안에서 한 번만 할당
+    QVERIFY(table.sharedDetails(first) != table.sharedDetails(second));
+    QCOMPARE(table.details(first).bread.constData(), table.details(second).bread.constData());
+    QVERIFY(table.details(first).jams.constBegin() == table.details(second).jams.constBegin());
+    QCOMPARE(table.details(second).cheeses, QStringList() << "모짜렐라");
+}
+
+QTEST_MAIN(TestOrderTable)
+#include "test_ordertable.moc"
@@ -0,0 +1,224 @@
+#include <QtTest/QtTest>
+#include <QThread>
+#include <QQueue>
+#include <QVector>
+#include "sharedmemoryring.h"
+
+// 공유 메모리 링: 가변 길이 기록, 끝에서 이어 쓰기, 가득 참 표시, 깨우기 묶음, 두 스레드 사이 순서 보장
+// 공유 메모리 대신 같은 프로세스의 버퍼에 생산자/소비자 쪽을 각각 bind해서 확인
+class TestSharedMemoryRing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testWriteReadOrder();
+    void testFullAndWraparound();
+    void testWakeCoalescing();
+    void testWriterWaiting();
+    void testFragmentedPayload();
+    void testTwoThreads();
+
+private:
+    static const int Capacity = 64;
+};
+
+void TestSharedMemoryRing::testWriteReadOrder()
+{
+    QVector<char> memory(SharedMemoryRing::bytesFor(Capacity));
+    SharedMemoryRing producer;
+    producer.bind(memory.data(), Capacity);
+    producer.initialize();
+    SharedMemoryRing consumer;
+    consumer.bind(memory.data(), Capacity);
+
+    QVERIFY(consumer.isEmpty());
+    QVERIFY(producer.write("first"));
+    QVERIFY(producer.write(QByteArray()));
+    QVERIFY(producer.write("third"));
+    QVERIFY(!consumer.isEmpty());
+
+    QByteArray payload;
+    QVERIFY(consumer.read(payload));
+    QCOMPARE(payload, QByteArray("first"));
+    QVERIFY(consumer.read(payload));
+    QVERIFY(payload.isEmpty());
+    QVERIFY(consumer.read(payload));
+    QCOMPARE(payload, QByteArray("third"));
+    QVERIFY(!consumer.read(payload));
+    QVERIFY(consumer.isEmpty());
+}
+
+void TestSharedMemoryRing::testFullAndWraparound()
+{
+    QVector<char> memory(SharedMemoryRing::bytesFor(Capacity));
+    SharedMemoryRing producer;
+    producer.bind(memory.data(), Capacity);
+    producer.initialize();
+    SharedMemoryRing consumer;
+    consumer.bind(memory.data(), Capacity);
+
+    // 기록 하나 = 길이 4바이트 + 본문 10바이트: 네 개면 56바이트라 다섯 번째는 자리가 없음
+    QQueue<QByteArray> expected;
+    for (int i = 0; i < 4; ++i) {
+        expected.enqueue(QByteArray(10, static_cast<char>('a' + i)));
+        QVERIFY(producer.write(expected.last()));
+    }
+    QVERIFY(!producer.write(QByteArray(10, 'x')));
+
+    // 읽은 만큼 자리가 나고, 길이가 제각각이라 링 끝을 넘는 기록도 그대로 읽힘
+    QByteArray read;
+    for (int round = 0; round < 40; ++round) {
+        QVERIFY(consumer.read(read));
+        QCOMPARE(read, expected.dequeue());
+        expected.enqueue(QByteArray::number(round).repeated(1 + round % 5));
+        QVERIFY(producer.write(expected.last()));
+    }
+    while (!expected.isEmpty()) {
+        QVERIFY(consumer.read(read));
+        QCOMPARE(read, expected.dequeue());
+    }
+    QVERIFY(consumer.isEmpty());
+
+    // 링보다 큰 본문은 쓰지 않음
+    SharedMemoryRing empty;
+    QVector<char> other(SharedMemoryRing::bytesFor(Capacity));
+    empty.bind(other.data(), Capacity);
+    empty.initialize();
+    QVERIFY(!empty.write(QByteArray(Capacity, 'y')));
+    QVERIFY(empty.write(QByteArray(Capacity - 4, 'y')));
+}
+
+void TestSharedMemoryRing::testFragmentedPayload()
+{
+    QVector<char> memory(SharedMemoryRing::bytesFor(Capacity));
+    SharedMemoryRing producer;
+    producer.bind(memory.data(), Capacity);
+    producer.initialize();
+    SharedMemoryRing consumer;
+    consumer.bind(memory.data(), Capacity);
+
+    // 링(64바이트)보다 큰 본문을 16바이트 조각으로 나눠, 소비자가 읽는 동안 이어 씀
+    QByteArray large;
+    for (int i = 0; i < 300; ++i) {
+        large.append(static_cast<char>('a' + i % 26));
+    }
+    QByteArray payload;
+    int offset = 0;
+    while (offset < large.size()) {
+        const int size = qMin(16, large.size() - offset);
+        const bool more = offset + size < large.size();
+        if (!producer.write(large.constData() + offset, size, more)) {
+            // 마지막 조각 전에는 본문을 돌려주지 않음
+            QVERIFY(!consumer.read(payload));
+            continue;
+        }
+        offset += size;
+    }
+    QVERIFY(producer.write("after"));
+
+    QVERIFY(consumer.read(payload));
+    QCOMPARE(payload, large);
+    QVERIFY(consumer.read(payload));
+    QCOMPARE(payload, QByteArray("after"));
+    QVERIFY(!consumer.read(payload));
+    QVERIFY(consumer.isEmpty());
+}
+
+void TestSharedMemoryRing::testWakeCoalescing()
+{
+    QVector<char> memory(SharedMemoryRing::bytesFor(Capacity));
+    SharedMemoryRing producer;
+    producer.bind(memory.data(), Capacity);
+    producer.initialize();
+    SharedMemoryRing consumer;
+    consumer.bind(memory.data(), Capacity);
+
+    // 소비자가 깨어나기 전에 여러 번 써도 알림은 한 번
+    QVERIFY(producer.write("a"));
+    QVERIFY(producer.requestWake());
+    QVERIFY(producer.write("b"));
+    QVERIFY(!producer.requestWake());
+
+    QByteArray payload;
+    while (consumer.read(payload)) {
+    }
+    QVERIFY(!consumer.finishWake());
+
+    // 처리 도중 들어온 기록은 finishWake가 알려 줌
+    QVERIFY(producer.write("c"));
+    QVERIFY(producer.requestWake());
+    QVERIFY(consumer.read(payload));
+    QVERIFY(producer.write("d"));
+    QVERIFY(!producer.requestWake());
+    QVERIFY(consumer.finishWake());
+    QVERIFY(consumer.read(payload));
+    QCOMPARE(payload, QByteArray("d"));
+    QVERIFY(!consumer.finishWake());
+}
+
+void TestSharedMemoryRing::testWriterWaiting()
+{
+    QVector<char> memory(SharedMemoryRing::bytesFor(Capacity));
+    SharedMemoryRing producer;
+    producer.bind(memory.data(), Capacity);
+    producer.initialize();
+    SharedMemoryRing consumer;
+    consumer.bind(memory.data(), Capacity);
+
+    QVERIFY(!consumer.takeWriterWaiting());
+    producer.markWriterWaiting();
+    QVERIFY(consumer.takeWriterWaiting());
+    QVERIFY(!consumer.takeWriterWaiting());
+}
+
+// 0부터 count-1까지 차례로 씀 (가득 차면 비워질 때까지 양보)
+class RingProducerThread : public QThread
+{
+public:
+    RingProducerThread(SharedMemoryRing& ring, int count) : ring(ring), count(count) {}
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; ++i) {
+            const QByteArray payload = QByteArray::number(i);
+            while (!ring.write(payload)) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    }
+
+private:
+    SharedMemoryRing& ring;
+    int count;
+};
+
+void TestSharedMemoryRing::testTwoThreads()
+{
+    QVector<char> memory(SharedMemoryRing::bytesFor(Capacity));
+    SharedMemoryRing producer;
+    producer.bind(memory.data(), Capacity);
+    producer.initialize();
+    SharedMemoryRing consumer;
+    consumer.bind(memory.data(), Capacity);
+
+    const int count = 100000;
+    RingProducerThread thread(producer, count);
+    thread.start();
+
+    int expected = 0;
+    QByteArray payload;
+    while (expected < count) {
+        if (consumer.read(payload)) {
+            QCOMPARE(payload.toInt(), expected);
+            expected++;
+        } else {
+            QThread::yieldCurrentThread();
+        }
+    }
+    QVERIFY(thread.wait(5000));
+    QVERIFY(consumer.isEmpty());
+}
+
+QTEST_MAIN(TestSharedMemoryRing)
+#include "test_sharedmemoryring.moc"
@@ -0,0 +1,138 @@
+#include <QtTest/QtTest>
+#include <QThread>
+#include "spscqueue.h"
+
+// 단일 생산자/단일 소비자 대기열: 용량, 순환, 깨우기 묶음, 두 스레드 사이 순서 보장
+class TestSpscQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testCapacityRoundsUp();
+    void testPushPopOrder();
+    void testFullAndWraparound();
+    void testWakeCoalescing();
+    void testTwoThreads();
+};
+
+// 0부터 count-1까지 차례로 넣음 (가득 차면 비워질 때까지 양보)
+class ProducerThread : public QThread
+{
+public:
+    ProducerThread(SpscQueue<QByteArray>& queue, int count) : queue(queue), count(count) {}
+
+protected:
+    void run() override
+    {
+        for (int i = 0; i < count; ++i) {
+            QByteArray value = QByteArray::number(i);
+            while (!queue.push(std::move(value))) {
+                QThread::yieldCurrentThread();
+            }
+        }
+    }
+
+private:
+    SpscQueue<QByteArray>& queue;
+    int count;
+};
+
+void TestSpscQueue::testCapacityRoundsUp()
+{
+    QCOMPARE(SpscQueue<int>(1).capacity(), 2);
+    QCOMPARE(SpscQueue<int>(8).capacity(), 8);
+    QCOMPARE(SpscQueue<int>(1000).capacity(), 1024);
+}
+
+void TestSpscQueue::testPushPopOrder()
+{
+    SpscQueue<QString> queue(4);
+    QVERIFY(queue.isEmpty());
+
+    QVERIFY(queue.push(QString("a")));
+    QVERIFY(queue.push(QString("b")));
+    QCOMPARE(queue.size(), 2);
+
+    QString value;
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, QString("a"));
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, QString("b"));
+    QVERIFY(!queue.pop(value));
+    QVERIFY(queue.isEmpty());
+}
+
+void TestSpscQueue::testFullAndWraparound()
+{
+    SpscQueue<int> queue(4);
+    int next = 0;
+    int expected = 0;
+
+    // 여러 바퀴 돌며 가득 찬 상태와 빈 상태를 반복
+    for (int round = 0; round < 10; ++round) {
+        while (queue.push(next)) {
+            next++;
+        }
+        QCOMPARE(queue.size(), queue.capacity());
+
+        int value = -1;
+        while (queue.pop(value)) {
+            QCOMPARE(value, expected++);
+        }
+        QVERIFY(queue.isEmpty());
+    }
+    QCOMPARE(expected, next);
+    QCOMPARE(next, 10 * queue.capacity());
+}
+
+void TestSpscQueue::testWakeCoalescing()
+{
+    SpscQueue<int> queue(8);
+
+    // 첫 항목만 알림, 소비자가 처리를 마칠 때까지는 다시 알리지 않음
+    QVERIFY(queue.push(1));
+    QVERIFY(queue.requestWake());
+    QVERIFY(queue.push(2));
+    QVERIFY(!queue.requestWake());
+
+    int value = 0;
+    while (queue.pop(value)) {}
+    QVERIFY(!queue.finishWake());
+    QVERIFY(queue.requestWake());
+
+    // 비운 뒤 finishWake 전에 들어온 항목이 있으면 소비자가 이어서 처리
+    while (queue.pop(value)) {}
+    QVERIFY(queue.push(3));
+    QVERIFY(!queue.requestWake());
+    QVERIFY(queue.finishWake());
+    QVERIFY(queue.pop(value));
+    QCOMPARE(value, 3);
+    QVERIFY(!queue.finishWake());
+}
+
+void TestSpscQueue::testTwoThreads()
+{
+    // 작은 대기열로 가득 참/빔이 자주 일어나게 함
+    SpscQueue<QByteArray> queue(16);
+    const int count = 200000;
+
+    ProducerThread producer(queue, count);
+    producer.start();
+
+    int expected = 0;
+    QByteArray value;
+    while (expected < count) {
+        if (!queue.pop(value)) {
+            QThread::yieldCurrentThread();
+            continue;
+        }
+        QCOMPARE(value.toInt(), expected);
+        expected++;
+    }
+
+    QVERIFY(producer.wait(30000));
+    QVERIFY(queue.isEmpty());
+}
+
+QTEST_MAIN(TestSpscQueue)
+#include "test_spscqueue.moc"
@@ -0,0 +1,238 @@
+#include <QtTest/QtTest>
+#include <QSignalSpy>
+#include <QTcpSocket>
+#include "statuspublisher.h"
+#include "networkmanager.h"
+
+// 구독/발행: 주제 일치, 본문 한 번 만들기, 합치기, 느린 구독자 버리기
+class TestStatusPublisher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testTopicMatching();
+    void testFanOutSharesFrame();
+    void testConflation();
+    void testSlowSubscriberPaused();
+
+private:
+    NetworkManager* server;
+    StatusPublisher* publisher;
+    quint16 testPort;
+
+    bool connectViewer(NetworkManager& viewer, const QStringList& topics);
+    static quint64 counterValue(const QString& name);
+};
+
+void TestStatusPublisher::init()
+{
+    testPort = 12346;
+    server = new NetworkManager(nullptr, true);
+    QVERIFY(server->startServer(testPort));
+    publisher = new StatusPublisher(server);
+}
+
+void TestStatusPublisher::cleanup()
+{
+    delete publisher;
+    delete server;
+}
+
+bool TestStatusPublisher::connectViewer(NetworkManager& viewer, const QStringList& topics)
+{
+    const int before = publisher->subscriberCount();
+    if (!viewer.connectToServer("127.0.0.1", testPort) ||
+        !QTest::qWaitFor([&viewer]() { return viewer.isConnectedToServer(); })) {
+        return false;
+    }
+
+    SubscribeMessage subscribe;
+    subscribe.topics = topics;
+    Message message;
+    message.type = MessageType::SUBSCRIBE;
+    message.data = subscribe.toJson();
+    viewer.sendMessage(message);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (publisher->subscriberCount() == before && timer.elapsed() < 5000) {
+        QTest::qWait(5);
+    }
+    return publisher->subscriberCount() > before;
+}
+
+quint64 TestStatusPublisher::counterValue(const QString& name)
+{
+    return MetricsRegistry::instance().counter(name, QString())->value();
+}
+
+void TestStatusPublisher::testTopicMatching()
+{
+    QVERIFY(StatusPublisher::matches("orders", "orders"));
+    QVERIFY(!StatusPublisher::matches("orders", "devices"));
+    QVERIFY(StatusPublisher::matches("robot/*", StatusPublisher::robotTopic(3)));
+    QVERIFY(StatusPublisher::matches("robot/3", "robot/3"));
+    QVERIFY(!StatusPublisher::matches("robot/3", "robot/31"));
+    QVERIFY(!StatusPublisher::matches("robot/*", "orders"));
+}
+
+void TestStatusPublisher::testFanOutSharesFrame()
+{
+    NetworkManager kitchen(nullptr, false);
+    NetworkManager tablet(nullptr, false);
+    NetworkManager monitor(nullptr, false);
+    QSignalSpy kitchenSpy(&kitchen, &NetworkManager::messageReceived);
+    QSignalSpy tabletSpy(&tablet, &NetworkManager::messageReceived);
+    QSignalSpy monitorSpy(&monitor, &NetworkManager::messageReceived);
+    QSignalSpy addedSpy(publisher, &StatusPublisher::subscriberAdded);
+
+    QVERIFY(connectViewer(kitchen, QStringList() << "orders"));
+    QVERIFY(connectViewer(tablet, QStringList() << "orders" << "robot/*"));
+    QVERIFY(connectViewer(monitor, QStringList() << "devices"));
+    QCOMPARE(addedSpy.count(), 3);
+
+    const quint64 encodedBefore = counterValue("server_status_frames_encoded_total");
+
+    QJsonObject order;
+    order["orderId"] = 1;
+    order["step"] = "빵 준비 중";
+    publisher->publish("orders", "1", order);
+    QJsonObject robot;
+    robot["credits"] = 3;
+    publisher->publish(StatusPublisher::robotTopic(5), "load", robot);
+    publisher->publish("nobody", "x", QJsonObject());    // 구독자 없음
+    publisher->flush();
+
+    QTRY_COMPARE(kitchenSpy.count(), 1);
+    QTRY_COMPARE(tabletSpy.count(), 2);
+    QTest::qWait(50);
+    QCOMPARE(monitorSpy.count(), 0);
+    QCOMPARE(kitchenSpy.count(), 1);
+
+    const Message received = qvariant_cast<Message>(kitchenSpy.at(0).at(0));
+    QCOMPARE(received.type, MessageType::PUBLISH);
+    const PublishMessage publish = PublishMessage::fromJson(received.data);
+    QCOMPARE(publish.topic, QString("orders"));
+    QCOMPARE(publish.key, QString("1"));
+    QCOMPARE(publish.event["step"].toString(), QString("빵 준비 중"));
+
+    // 구독자 수와 무관하게 이벤트마다 한 번만 부호화
+    QCOMPARE(counterValue("server_status_frames_encoded_total") - encodedBefore, quint64(2));
+
+    // 구독자가 끊기면 목록에서 빠짐
+    QSignalSpy removedSpy(publisher, &StatusPublisher::subscriberRemoved);
+    monitor.disconnectFromServer();
+    QTRY_COMPARE(removedSpy.count(), 1);
+    QCOMPARE(publisher->subscriberCount(), 2);
+}
+
+void TestStatusPublisher::testConflation()
+{
+    NetworkManager kitchen(nullptr, false);
+    QSignalSpy kitchenSpy(&kitchen, &NetworkManager::messageReceived);
+    QVERIFY(connectViewer(kitchen, QStringList() << "orders"));
+
+    // 한 주기 안의 같은 주문 이벤트는 마지막 것만, 다른 주문은 처음 발행한 순서대로
+    for (int step = 0; step < 5; ++step) {
+        QJsonObject first;
+        first["orderId"] = 1;
+        first["step"] = step;
+        publisher->publish("orders", "1", first);
+        QJsonObject second;
+        second["orderId"] = 2;
+        second["step"] = step;
+        publisher->publish("orders", "2", second);
+    }
+
+    // 주기가 지나면 알아서 보냄
+    QTRY_COMPARE(kitchenSpy.count(), 2);
+    QTest::qWait(StatusPublisher::FlushIntervalMs * 2);
+    QCOMPARE(kitchenSpy.count(), 2);
+
+    for (int i = 0; i < 2; ++i) {
+        const PublishMessage publish =
+            PublishMessage::fromJson(qvariant_cast<Message>(kitchenSpy.at(i).at(0)).data);
+        QCOMPARE(publish.event["orderId"].toInt(), i + 1);
+        QCOMPARE(publish.event["step"].toInt(), 4);
+    }
+}
+
+void TestStatusPublisher::testSlowSubscriberPaused()
+{
+    // 읽지 않는 구독자: 받은 데이터를 가져가지 않아 커널 버퍼가 차면 서버 쪽 전송이 밀림
+    QSignalSpy backpressureSpy(server, &NetworkManager::sendBackpressure);
+    QSignalSpy addedSpy(publisher, &StatusPublisher::subscriberAdded);
+    QTcpSocket stalled;
+    stalled.setReadBufferSize(1024);
+    stalled.connectToHost(QHostAddress::LocalHost, testPort);
+    QVERIFY(stalled.waitForConnected(5000));
+    SubscribeMessage subscribe;
+    subscribe.topics << "orders";
+    Message message;
+    message.type = MessageType::SUBSCRIBE;
+    message.data = subscribe.toJson();
+    stalled.write(NetworkManager::encodeFrame(QJsonDocument(message.toJson()).toJson(QJsonDocument::Compact)));
+    QTRY_COMPARE(addedSpy.count(), 1);
+    const int stalledId = addedSpy.at(0).at(0).toInt();
+
+    NetworkManager kitchen(nullptr, false);
+    QSignalSpy kitchenSpy(&kitchen, &NetworkManager::messageReceived);
+    QVERIFY(connectViewer(kitchen, QStringList() << "orders"));
+
+    const QString padding(200, 'x');
+    int published = 0;
+    QElapsedTimer timer;
+    timer.start();
+    while (!publisher->isPaused(stalledId) && timer.elapsed() < 30000) {
+        for (int i = 0; i < 100; ++i) {
+            QJsonObject event;
+            event["orderId"] = published;
+            event["padding"] = padding;
+            publisher->publish("orders", QString::number(published), event);
+            published++;
+        }
+        publisher->flush();
+        // 읽는 구독자는 밀리지 않으므로 빠짐없이 받음
+        QTRY_COMPARE(kitchenSpy.count(), published);
+    }
+    QVERIFY(publisher->isPaused(stalledId));
+    QVERIFY(server->isSendCongested(stalledId));
+    QCOMPARE(backpressureSpy.at(0).at(0).toInt(), stalledId);
+    QCOMPARE(backpressureSpy.at(0).at(1).toBool(), true);
+
+    // 멈춘 동안 같은 키는 최신 값만, 키가 없는 이벤트는 버림
+    const int heldBefore = publisher->heldEventCount(stalledId);
+    const quint64 droppedBefore = counterValue("server_status_events_dropped_total");
+    for (int round = 0; round < 5; ++round) {
+        for (int key = 0; key < 10; ++key) {
+            QJsonObject event;
+            event["round"] = round;
+            publisher->publish("orders", QString("k%1").arg(key), event);
+        }
+        publisher->publish("orders", QString(), QJsonObject());
+        publisher->flush();
+    }
+    QCOMPARE(publisher->heldEventCount(stalledId), heldBefore + 10);
+    QCOMPARE(counterValue("server_status_events_dropped_total") - droppedBefore, quint64(5));
+    QTRY_COMPARE(kitchenSpy.count(), published + 55);
+
+    // 다시 읽기 시작하면 풀리고, 모아 둔 이벤트는 키마다 한 번씩 옴
+    stalled.setReadBufferSize(0);
+    QByteArray received;
+    timer.restart();
+    while (!received.contains("\"key\":\"k9\"") && timer.elapsed() < 30000) {
+        QTest::qWait(5);
+        received += stalled.readAll();
+    }
+    QVERIFY(!publisher->isPaused(stalledId));
+    QVERIFY(!server->isSendCongested(stalledId));
+    QCOMPARE(backpressureSpy.last().at(1).toBool(), false);
+    QCOMPARE(received.count("\"key\":\"k3\""), 1);
+    QVERIFY(received.contains("\"round\":4"));
+    QVERIFY(!received.contains("\"round\":0"));
+}
+
+QTEST_MAIN(TestStatusPublisher)
+#include "test_statuspublisher.moc"
@@ -0,0 +1,155 @@
+#include <QtTest/QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include "tracer.h"
+
+class TestTracer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void testDisabledRecordsNothing();
+    void testChromeTraceFormat();
+    void testConcurrentThreads();
+    void testClearAndOverflow();
+    void testClearWhileRecording();
+};
+
+void TestTracer::init()
+{
+    Tracer::instance().clear();
+    Tracer::instance().setEnabled(true);
+}
+
+void TestTracer::cleanup()
+{
+    Tracer::instance().setEnabled(false);
+}
+
+void TestTracer::testDisabledRecordsNothing()
+{
+    Tracer::instance().setEnabled(false);
+    Tracer::instance().instant("order received", "orders", 1);
+    Tracer::instance().complete("Bread", "Bread #1", 0, 100, 1);
+    QVERIFY(Tracer::instance().events().isEmpty());
+}
+
+void TestTracer::testChromeTraceFormat()
+{
+    Tracer& tracer = Tracer::instance();
+    tracer.complete("Bread", "Bread #1", 1000, 500, 7, 2);
+    tracer.complete("Egg", "Egg #1", 1600, 300, 7);
+    tracer.asyncSpan("queued", "Egg", 7, 1500, 1600);
+    tracer.instant("status applied", "orders", 7);
+
+    const QJsonDocument doc = QJsonDocument::fromJson(tracer.toChromeJson());
+    QVERIFY(doc.isObject());
+    const QJsonArray events = doc.object()["traceEvents"].toArray();
+
+    QMap<QString, int> trackIds;
+    QJsonObject bread;
+    int asyncBegin = 0;
+    int asyncEnd = 0;
+    for (const QJsonValue& value : events) {
+        const QJsonObject event = value.toObject();
+        const QString phase = event["ph"].toString();
+        if (phase == "M" && event["name"] == "thread_name") {
+            trackIds.insert(event["args"].toObject()["name"].toString(), event["tid"].toInt());
+        } else if (phase == "X" && event["name"] == "Bread") {
+            bread = event;
+        } else if (phase == "b" || phase == "e") {
+            QCOMPARE(event["cat"].toString(), QString("Egg"));
+            QCOMPARE(event["id"].toInt(), 7);
+            (phase == "b" ? asyncBegin : asyncEnd)++;
+        }
+    }
+
+    // 장치마다 별도 줄(tid)로 표시
+    QVERIFY(trackIds.contains("Bread #1"));
+    QVERIFY(trackIds.contains("Egg #1"));
+    QVERIFY(trackIds["Bread #1"] != trackIds["Egg #1"]);
+    QCOMPARE(bread["tid"].toInt(), trackIds["Bread #1"]);
+    QCOMPARE(bread["ts"].toInt(), 1000);
+    QCOMPARE(bread["dur"].toInt(), 500);
+    QCOMPARE(bread["args"].toObject()["orderId"].toInt(), 7);
+    QCOMPARE(bread["args"].toObject()["count"].toInt(), 2);
+    QCOMPARE(asyncBegin, 1);
+    QCOMPARE(asyncEnd, 1);
+}
+
+void TestTracer::testConcurrentThreads()
+{
+    const int threadCount = 4;
+    const int perThread = 1000;
+
+    QList<QThread*> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.append(QThread::create([t]() {
+            const QByteArray track = QString("Device #%1").arg(t).toUtf8();
+            for (int i = 0; i < perThread; ++i) {
+                Tracer::instance().complete("work", track.constData(), i * 10, 5, t * perThread + i);
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    const QList<TraceEvent> events = Tracer::instance().events();
+    QCOMPARE(events.size(), threadCount * perThread);
+    for (int i = 1; i < events.size(); ++i) {
+        QVERIFY(events[i - 1].timestampUs <= events[i].timestampUs);
+    }
+}
+
+void TestTracer::testClearAndOverflow()
+{
+    Tracer& tracer = Tracer::instance();
+    tracer.instant("before clear", "orders");
+    tracer.clear();
+    QVERIFY(tracer.events().isEmpty());
+
+    // 버퍼가 가득 차면 새 이벤트를 버리고 개수만 셈
+    const int extra = 10;
+    for (int i = 0; i < Tracer::BufferCapacity + extra; ++i) {
+        tracer.complete("work", "Bread #1", i, 1);
+    }
+    QCOMPARE(tracer.events().size(), int(Tracer::BufferCapacity));
+    QCOMPARE(tracer.droppedEvents(), quint64(extra));
+}
+
+void TestTracer::testClearWhileRecording()
+{
+    // 기록 중인 스레드가 clear() 뒤 버퍼를 다시 쓰는 동안 읽어도 두 세대가 섞이지 않음
+    // (한 스레드의 이벤트는 항상 빈틈없이 이어진 번호)
+    std::atomic<bool> running(true);
+    QThread* writer = QThread::create([&running]() {
+        for (int i = 0; running.load(std::memory_order_relaxed); ++i) {
+            Tracer::instance().complete("work", "Bread #1", i, 1, i);
+        }
+    });
+    writer->start();
+
+    Tracer& tracer = Tracer::instance();
+    for (int round = 0; round < 200; ++round) {
+        tracer.clear();
+        QThread::usleep(100);
+        const QList<TraceEvent> events = tracer.events();
+        for (int i = 1; i < events.size(); ++i) {
+            QCOMPARE(events[i].orderId, events[i - 1].orderId + 1);
+        }
+    }
+
+    running.store(false);
+    writer->wait();
+    delete writer;
+}
+
+QTEST_MAIN(TestTracer)
+#include "test_tracer.moc"
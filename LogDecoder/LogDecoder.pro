@@ -0,0 +1,21 @@
+QT += core
+QT -= gui
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# 이진 로그 형식과 이벤트 표는 CentralServer의 소스를 그대로 사용 (RobotClient와 동일한 파일)
+INCLUDEPATH += ../CentralServer
+
+SOURCES += \
+    ../CentralServer/binarylog.cpp \
+    ../CentralServer/metrics.cpp \
+    main.cpp
+
+HEADERS += \
+    ../CentralServer/binarylog.h \
+    ../CentralServer/metrics.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
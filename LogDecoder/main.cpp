@@ -0,0 +1,93 @@
+// main.cpp
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QTextStream>
+#include "binarylog.h"
+
+// 인자로 받은 파일과 폴더(안의 *.blog, 이름 순 = 기록 순)를 읽을 순서대로 나열
+static QStringList collectFiles(const QStringList& arguments)
+{
+    QStringList files;
+    for (const QString& argument : arguments) {
+        const QFileInfo info(argument);
+        if (info.isDir()) {
+            const QDir dir(argument);
+            for (const QString& name : dir.entryList(QStringList() << "*.blog", QDir::Files, QDir::Name)) {
+                files << dir.filePath(name);
+            }
+        } else {
+            files << argument;
+        }
+    }
+    return files;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CentralServer/RobotClient 이진 로그(--binary-log)를 문장으로 출력");
+    parser.addHelpOption();
+    parser.addPositionalArgument("files", "이진 로그 파일 또는 폴더", "<파일|폴더>...");
+    QCommandLineOption rawOption("raw", "문장 대신 이벤트 이름과 인자를 그대로 출력");
+    QCommandLineOption eventOption("event", "이 이벤트만 출력 (이름 또는 번호, 여러 번 지정 가능)", "event");
+    parser.addOption(rawOption);
+    parser.addOption(eventOption);
+    parser.process(a);
+
+    const QStringList files = collectFiles(parser.positionalArguments());
+    if (files.isEmpty()) {
+        parser.showHelp(1);
+    }
+    const QStringList events = parser.values(eventOption);
+
+    QTextStream out(stdout);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    out.setCodec("UTF-8");
+#endif
+
+    int failures = 0;
+    for (const QString& path : files) {
+        BinaryLogReader reader;
+        QString error;
+        if (!reader.open(path, error)) {
+            qCritical().noquote() << error;
+            failures++;
+            continue;
+        }
+
+        LogRecord record;
+        while (reader.next(record)) {
+            const QString name = BinaryLog::eventName(record.eventId);
+            if (!events.isEmpty() && !events.contains(name) && !events.contains(QString::number(record.eventId))) {
+                continue;
+            }
+
+            out << QDateTime::fromMSecsSinceEpoch(record.wallMs).toString("yyyy-MM-dd hh:mm:ss.zzz")
+                << " [t" << record.threadIndex << "] ";
+            if (parser.isSet(rawOption)) {
+                QStringList args;
+                for (const QVariant& arg : record.args) {
+                    args << arg.toString();
+                }
+                out << (name.isEmpty() ? QString::number(record.eventId) : name)
+                    << '(' << args.join(", ") << ')';
+            } else {
+                out << BinaryLog::render(record);
+            }
+            out << '\n';
+        }
+
+        // 프로세스가 쓰는 도중 멈췄으면 마지막 기록이 잘려 있을 수 있음
+        if (!reader.errorString().isEmpty()) {
+            qWarning().noquote() << path << ":" << reader.errorString();
+        }
+    }
+    out.flush();
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,38 @@
+QT += core network testlib
+QT -= gui
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# release 빌드에서는 디버그 로그 문장을 컴파일하지 않음 (logging.h 참고)
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
+# 프레임 형식과 캡처 파일은 CentralServer의 소스를 그대로 사용 (RobotClient와 동일한 파일)
+INCLUDEPATH += ../CentralServer
+
+SOURCES += \
+    ../CentralServer/framecapture.cpp \
+    ../CentralServer/framescheduler.cpp \
+    ../CentralServer/logging.cpp \
+    ../CentralServer/metrics.cpp \
+    ../CentralServer/networkmanager.cpp \
+    ../CentralServer/sharedmemoryring.cpp \
+    ../CentralServer/tracer.cpp \
+    framereplayer.cpp \
+    main.cpp
+
+HEADERS += \
+    ../CentralServer/framecapture.h \
+    ../CentralServer/framescheduler.h \
+    ../CentralServer/logging.h \
+    ../CentralServer/message.h \
+    ../CentralServer/metrics.h \
+    ../CentralServer/networkmanager.h \
+    ../CentralServer/sharedmemoryring.h \
+    ../CentralServer/spscqueue.h \
+    ../CentralServer/tracer.h \
+    framereplayer.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,168 @@
+// framereplayer.cpp
+#include "framereplayer.h"
+#include "networkmanager.h"
+
+FrameReplayer::FrameReplayer(QObject *parent)
+    : QObject(parent)
+    , hasPending(false)
+    , direction(CapturedFrame::Direction::Incoming)
+    , speed(1.0)
+    , targetPort(0)
+    , server(nullptr)
+    , clientSocket(nullptr)
+    , firstTimestampUs(0)
+    , sent(0)
+    , finishing(false)
+{
+    timer.setSingleShot(true);
+    timer.setTimerType(Qt::PreciseTimer);
+    connect(&timer, &QTimer::timeout, this, &FrameReplayer::sendDueFrames);
+}
+
+bool FrameReplayer::open(const QString& path, QString& errorMessage)
+{
+    return reader.open(path, errorMessage);
+}
+
+void FrameReplayer::startToServer(const QString& host, quint16 port)
+{
+    targetHost = host;
+    targetPort = port;
+    begin();
+}
+
+bool FrameReplayer::listenForClient(quint16 port, QString& errorMessage)
+{
+    server = new QTcpServer(this);
+    if (!server->listen(QHostAddress::Any, port)) {
+        errorMessage = QString("재생 서버를 시작할 수 없습니다 (포트: %1) - %2").arg(port).arg(server->errorString());
+        delete server;
+        server = nullptr;
+        return false;
+    }
+
+    connect(server, &QTcpServer::newConnection, this, [this]() {
+        QTcpSocket* socket = server->nextPendingConnection();
+        if (!socket) {
+            return;
+        }
+        if (clientSocket) {
+            socket->abort();    // 로봇 한 대에만 재생
+            socket->deleteLater();
+            return;
+        }
+        clientSocket = socket;
+        discardIncoming(clientSocket);
+        emit logMessage("로봇이 연결되었습니다. 재생을 시작합니다.");
+        begin();
+    });
+    return true;
+}
+
+void FrameReplayer::begin()
+{
+    hasPending = readNextFrame();
+    firstTimestampUs = pending.timestampUs;
+    clock.start();
+    sendDueFrames();
+}
+
+bool FrameReplayer::readNextFrame()
+{
+    while (reader.next(pending)) {
+        if (pending.direction == direction) {
+            return true;
+        }
+    }
+    if (!reader.errorString().isEmpty()) {
+        emit logMessage(reader.errorString());
+    }
+    return false;
+}
+
+void FrameReplayer::sendDueFrames()
+{
+    int burst = 0;
+    while (hasPending) {
+        if (speed > 0.0) {
+            // 첫 프레임 기준 상대 시각을 배속으로 나눠 보낼 시각을 정함
+            const qint64 dueUs = static_cast<qint64>((pending.timestampUs - firstTimestampUs) / speed);
+            const qint64 elapsedUs = clock.nsecsElapsed() / 1000;
+            if (dueUs > elapsedUs) {
+                timer.start(static_cast<int>((dueUs - elapsedUs + 999) / 1000));
+                return;
+            }
+        } else if (burst++ >= FlatOutBurst) {
+            timer.start(0);     // 소켓이 실제로 보낼 수 있도록 이벤트 루프에 양보
+            return;
+        }
+
+        QTcpSocket* socket = socketFor(pending.connectionId);
+        if (socket) {
+            socket->write(NetworkManager::encodeFrame(pending.payload));
+            sent++;
+        }
+        hasPending = readNextFrame();
+    }
+    finish();
+}
+
+QTcpSocket* FrameReplayer::socketFor(int connectionId)
+{
+    if (server) {
+        return clientSocket;
+    }
+
+    QTcpSocket*& socket = sockets[connectionId];
+    if (!socket) {
+        // 연결 중에 쓴 데이터는 소켓이 보관했다가 연결되면 보냄
+        socket = new QTcpSocket(this);
+        discardIncoming(socket);
+        connect(socket, &QTcpSocket::errorOccurred, this, [this, socket, connectionId]() {
+            emit logMessage(QString("연결 %1 오류: %2").arg(connectionId).arg(socket->errorString()));
+        });
+        socket->connectToHost(targetHost, targetPort);
+    }
+    return socket;
+}
+
+void FrameReplayer::discardIncoming(QTcpSocket* socket)
+{
+    connect(socket, &QTcpSocket::readyRead, socket, [socket]() { socket->readAll(); });
+    connect(socket, &QTcpSocket::disconnected, this, &FrameReplayer::checkFinished);
+}
+
+void FrameReplayer::finish()
+{
+    finishing = true;
+    timer.stop();
+    emit logMessage(QString("재생 완료: 프레임 %1개").arg(sent));
+
+    // 남은 데이터를 모두 보낸 뒤 연결을 닫음
+    QList<QTcpSocket*> open = sockets.values();
+    if (clientSocket) {
+        open.append(clientSocket);
+    }
+    for (QTcpSocket* socket : open) {
+        if (socket->state() != QAbstractSocket::UnconnectedState) {
+            socket->disconnectFromHost();
+        }
+    }
+    checkFinished();
+}
+
+void FrameReplayer::checkFinished()
+{
+    if (!finishing) {
+        return;
+    }
+    for (QTcpSocket* socket : sockets) {
+        if (socket->state() != QAbstractSocket::UnconnectedState) return;
+    }
+    if (clientSocket && clientSocket->state() != QAbstractSocket::UnconnectedState) {
+        return;
+    }
+
+    finishing = false;
+    emit finished(sent);
+}
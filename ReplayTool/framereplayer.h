@@ -0,0 +1,77 @@
+// framereplayer.h
+#ifndef FRAMEREPLAYER_H
+#define FRAMEREPLAYER_H
+
+#include <QObject>
+#include <QMap>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "framecapture.h"
+
+// 캡처 파일의 프레임을 기록된 간격대로 대상 프로세스에 다시 보냄
+// - CentralServer 캡처: 서버가 받은 프레임을 기록된 연결 ID마다 로봇처럼 접속해 전송
+// - RobotClient 캡처: 로봇이 받은 프레임을 서버처럼 로봇의 접속을 기다렸다가 전송
+// 대상이 보내는 프레임은 읽어서 버리므로 재생 순서와 간격은 캡처 그대로입니다.
+class FrameReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int FlatOutBurst = 256;    // 최대 속도일 때 이벤트 루프에 양보하기 전 보낼 프레임 수
+
+    explicit FrameReplayer(QObject *parent = nullptr);
+
+    bool open(const QString& path, QString& errorMessage);
+
+    // 1.0: 원래 속도, 2.0: 두 배 빠르게, 0: 기다리지 않고 최대 속도
+    void setSpeed(double factor) { speed = qMax(0.0, factor); }
+    double playbackSpeed() const { return speed; }
+
+    // 재생할 프레임 방향 (기본: 캡처한 프로세스가 받은 프레임)
+    void setDirection(CapturedFrame::Direction value) { direction = value; }
+
+    // CentralServer로 재생: 연결 ID마다 host:port로 접속
+    void startToServer(const QString& host, quint16 port);
+    // RobotClient로 재생: port에서 로봇의 접속을 기다렸다가 시작
+    bool listenForClient(quint16 port, QString& errorMessage);
+    quint16 listeningPort() const { return server ? server->serverPort() : 0; }
+
+    qint64 framesSent() const { return sent; }
+
+signals:
+    void finished(qint64 framesSent);
+    void logMessage(const QString& message);
+
+private slots:
+    void sendDueFrames();
+
+private:
+    FrameCaptureReader reader;
+    CapturedFrame pending;
+    bool hasPending;
+    CapturedFrame::Direction direction;
+    double speed;
+
+    QString targetHost;
+    quint16 targetPort;
+    QTcpServer* server;             // RobotClient로 재생할 때
+    QTcpSocket* clientSocket;       // 접속한 로봇
+    QMap<int, QTcpSocket*> sockets; // CentralServer로 재생할 때 연결 ID별 접속
+
+    QTimer timer;
+    QElapsedTimer clock;
+    qint64 firstTimestampUs;
+    qint64 sent;
+    bool finishing;
+
+    void begin();
+    bool readNextFrame();
+    QTcpSocket* socketFor(int connectionId);
+    void discardIncoming(QTcpSocket* socket);
+    void finish();
+    void checkFinished();
+};
+
+#endif // FRAMEREPLAYER_H
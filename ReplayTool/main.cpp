@@ -0,0 +1,68 @@
+// main.cpp
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include "framereplayer.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CentralServer/RobotClient 캡처 파일 재생기");
+    parser.addHelpOption();
+    parser.addPositionalArgument("capture", "--capture로 기록한 캡처 파일");
+    QCommandLineOption connectOption("connect", "CentralServer로 재생 (host:port)", "host:port");
+    QCommandLineOption listenOption("listen", "RobotClient로 재생: 이 포트에서 로봇의 접속을 기다림", "port");
+    QCommandLineOption speedOption("speed", "재생 배속 (1: 원래 속도, 0: 최대 속도)", "factor", "1");
+    QCommandLineOption outgoingOption("outgoing", "캡처한 프로세스가 받은 프레임 대신 보낸 프레임을 재생");
+    parser.addOption(connectOption);
+    parser.addOption(listenOption);
+    parser.addOption(speedOption);
+    parser.addOption(outgoingOption);
+    parser.process(a);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 1 || parser.isSet(connectOption) == parser.isSet(listenOption)) {
+        parser.showHelp(1);
+    }
+
+    FrameReplayer replayer;
+    QObject::connect(&replayer, &FrameReplayer::logMessage,
+                     [](const QString& message) { qInfo().noquote() << message; });
+    QObject::connect(&replayer, &FrameReplayer::finished, &a, &QCoreApplication::quit);
+
+    QString error;
+    if (!replayer.open(arguments.first(), error)) {
+        qCritical().noquote() << error;
+        return 1;
+    }
+
+    bool speedOk = false;
+    const double speed = parser.value(speedOption).toDouble(&speedOk);
+    if (!speedOk || speed < 0.0) {
+        qCritical().noquote() << "잘못된 재생 배속입니다:" << parser.value(speedOption);
+        return 1;
+    }
+    replayer.setSpeed(speed);
+    if (parser.isSet(outgoingOption)) {
+        replayer.setDirection(CapturedFrame::Direction::Outgoing);
+    }
+
+    if (parser.isSet(listenOption)) {
+        const quint16 port = static_cast<quint16>(parser.value(listenOption).toUInt());
+        if (!replayer.listenForClient(port, error)) {
+            qCritical().noquote() << error;
+            return 1;
+        }
+        qInfo().noquote() << QString("포트 %1에서 로봇의 접속을 기다립니다.").arg(replayer.listeningPort());
+    } else {
+        const QString target = parser.value(connectOption);
+        const int colon = target.lastIndexOf(':');
+        const QString host = colon > 0 ? target.left(colon) : target;
+        const quint16 port = colon > 0 ? static_cast<quint16>(target.mid(colon + 1).toUInt()) : 1234;
+        replayer.startToServer(host, port);
+    }
+
+    return a.exec();
+}
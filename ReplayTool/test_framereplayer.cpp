@@ -0,0 +1,130 @@
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include "framereplayer.h"
+#include "networkmanager.h"
+
+class TestFrameReplayer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testReplayToServerPerConnection();
+    void testReplayKeepsRecordedPacing();
+    void testReplayToClient();
+
+private:
+    QTemporaryDir dir;
+    QString writeCapture(const QString& name, int frameCount, qint64 intervalUs, int connections);
+};
+
+QString TestFrameReplayer::writeCapture(const QString& name, int frameCount, qint64 intervalUs, int connections)
+{
+    const QString path = dir.filePath(name);
+    QString error;
+    FrameCaptureWriter writer;
+    if (!writer.open(path, error)) {
+        return QString();
+    }
+
+    for (int i = 0; i < frameCount; ++i) {
+        Message message;
+        message.type = MessageType::ROBOT_LOAD;
+        message.data["backlog"] = i;
+
+        CapturedFrame frame;
+        frame.timestampUs = i * intervalUs;
+        frame.direction = CapturedFrame::Direction::Incoming;
+        frame.connectionId = 1 + i % connections;
+        frame.payload = QJsonDocument(message.toJson()).toJson(QJsonDocument::Compact);
+        writer.write(frame);
+
+        // 보낸 프레임은 기본 재생 대상이 아님
+        frame.direction = CapturedFrame::Direction::Outgoing;
+        writer.write(frame);
+    }
+    return path;
+}
+
+void TestFrameReplayer::testReplayToServerPerConnection()
+{
+    const QString path = writeCapture("server.rcap", 100, 1000, 2);
+    QVERIFY(!path.isEmpty());
+
+    NetworkManager server(nullptr, true);
+    QVERIFY(server.startServer(12370));
+    QSignalSpy connectedSpy(&server, &NetworkManager::clientConnected);
+    QSignalSpy receivedSpy(&server, &NetworkManager::messageReceivedFrom);
+
+    FrameReplayer replayer;
+    QSignalSpy finishedSpy(&replayer, &FrameReplayer::finished);
+    QString error;
+    QVERIFY(replayer.open(path, error));
+    replayer.setSpeed(0);
+    replayer.startToServer("localhost", 12370);
+
+    // 기록된 연결 ID마다 별도 로봇으로 접속하고, 받은 프레임만 순서대로 전송
+    QTRY_COMPARE(receivedSpy.count(), 100);
+    QCOMPARE(connectedSpy.count(), 2);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(replayer.framesSent(), qint64(100));
+
+    QMap<int, int> lastBacklog;
+    for (const QList<QVariant>& arguments : receivedSpy) {
+        const int connectionId = arguments.at(0).toInt();
+        const Message message = qvariant_cast<Message>(arguments.at(1));
+        QCOMPARE(message.type, MessageType::ROBOT_LOAD);
+        const int backlog = message.data["backlog"].toInt();
+        QVERIFY(backlog > lastBacklog.value(connectionId, -1));
+        lastBacklog[connectionId] = backlog;
+    }
+}
+
+void TestFrameReplayer::testReplayKeepsRecordedPacing()
+{
+    // 10ms 간격 21프레임 = 200ms 구간, 2배속이면 약 100ms
+    const QString path = writeCapture("paced.rcap", 21, 10000, 1);
+
+    NetworkManager server(nullptr, true);
+    QVERIFY(server.startServer(12371));
+    QSignalSpy receivedSpy(&server, &NetworkManager::messageReceivedFrom);
+
+    FrameReplayer replayer;
+    QSignalSpy finishedSpy(&replayer, &FrameReplayer::finished);
+    QString error;
+    QVERIFY(replayer.open(path, error));
+    replayer.setSpeed(2.0);
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+    replayer.startToServer("localhost", 12371);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+
+    QVERIFY(elapsed.elapsed() >= 95);
+    QVERIFY(elapsed.elapsed() < 1000);
+    QTRY_COMPARE(receivedSpy.count(), 21);
+}
+
+void TestFrameReplayer::testReplayToClient()
+{
+    const QString path = writeCapture("robot.rcap", 10, 1000, 1);
+
+    FrameReplayer replayer;
+    QSignalSpy finishedSpy(&replayer, &FrameReplayer::finished);
+    QString error;
+    QVERIFY(replayer.open(path, error));
+    replayer.setSpeed(0);
+    QVERIFY2(replayer.listenForClient(0, error), qPrintable(error));
+    QVERIFY(replayer.listeningPort() != 0);
+
+    // 로봇이 접속하면 재생 시작
+    NetworkManager robot(nullptr, false);
+    QSignalSpy receivedSpy(&robot, &NetworkManager::messageReceived);
+    QVERIFY(robot.connectToServer("localhost", replayer.listeningPort()));
+    QTRY_COMPARE(receivedSpy.count(), 10);
+    QTRY_COMPARE(finishedSpy.count(), 1);
+}
+
+QTEST_MAIN(TestFrameReplayer)
+#include "test_framereplayer.moc"
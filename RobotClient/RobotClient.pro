@@ -2,27 +2,62 @@ QT += core gui network testlib
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 CONFIG += c++11
 
+# release 빌드에서는 디버그 로그 문장을 컴파일하지 않음 (logging.h 참고)
+CONFIG(release, debug|release): DEFINES += QT_NO_DEBUG_OUTPUT
+
 # You can make your code fail to compile if it uses deprecated APIs.
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    binarylog.cpp \
+    clock.cpp \
     device.cpp \
     devicemanager.cpp \
+    devicestatesync.cpp \
+    framecapture.cpp \
+    framescheduler.cpp \
+    logging.cpp \
     main.cpp \
+    metrics.cpp \
+    metricsserver.cpp \
     networkmanager.cpp \
-    robotcontrolgui.cpp
+    ordertable.cpp \
+    pipelinesimulator.cpp \
+    robotconfig.cpp \
+    robotcontrolgui.cpp \
+    schedulingpolicy.cpp \
+    sharedmemoryring.cpp \
+    tracer.cpp
 
 HEADERS += \
+    binarylog.h \
+    clock.h \
     device.h \
     devicemanager.h \
+    devicestatesync.h \
+    framecapture.h \
+    framescheduler.h \
+    logging.h \
     message.h \
+    metrics.h \
+    metricsserver.h \
     networkmanager.h \
-    robotcontrolgui.h
+    ordertable.h \
+    pipelinesimulator.h \
+    robotconfig.h \
+    robotcontrolgui.h \
+    schedulingpolicy.h \
+    sharedmemoryring.h \
+    spscqueue.h \
+    tracer.h
 
 FORMS += \
     robotcontrolgui.ui
 
+DISTFILES += \
+    robot_config.json
+
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
 else: unix:!android: target.path = /opt/$${TARGET}/bin
@@ -0,0 +1,192 @@
+// bench_devicemanager.cpp
+#include <QtTest/QtTest>
+#include <QDateTime>
+#include "devicemanager.h"
+#include "benchbaseline.h"
+
+// 링 경로의 완료 통지를 받아 세기만 함 (DeviceManager::drainCompletions와 같은 방식)
+class CompletionCounter : public QObject
+{
+public:
+    Device* device = nullptr;
+    int completed = 0;
+
+protected:
+    bool event(QEvent* event) override
+    {
+        if (event->type() != Device::completionEventType()) {
+            return QObject::event(event);
+        }
+        do {
+            DeviceCompletion completion;
+            while (device->takeCompletion(completion)) {
+                completed++;
+            }
+        } while (device->finishCompletions());
+        return true;
+    }
+};
+
+// 작업 배정 비용 (보관 중인 주문 수, 모듈당 장치 수별)
+// 장치를 모두 사용 중으로 표시해 두면 실제 작업은 시작되지 않고
+// 주문이 들어오거나 작업이 끝날 때마다 반복되는 대기 작업 수집/장치 탐색 비용만 남습니다.
+class BenchDeviceManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchAssignNextTask_data();
+    void benchAssignNextTask();
+    void benchFindAvailableDevice_data();
+    void benchFindAvailableDevice();
+    void benchDispatch_data();
+    void benchDispatch();
+
+private:
+    static const int LookupsPerIteration = 10000;
+    static const int TasksPerIteration = 100;
+
+    static void markAllBusy(DeviceManager& manager);
+};
+
+void BenchDeviceManager::markAllBusy(DeviceManager& manager)
+{
+    for (auto it = manager.deviceAvailability.begin(); it != manager.deviceAvailability.end(); ++it) {
+        it.value() = false;
+    }
+}
+
+void BenchDeviceManager::benchAssignNextTask_data()
+{
+    QTest::addColumn<int>("backlog");
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+}
+
+void BenchDeviceManager::benchAssignNextTask()
+{
+    QFETCH(int, backlog);
+
+    DeviceManager manager;
+    markAllBusy(manager);
+
+    // processNewOrder는 주문마다 배정을 다시 하므로 준비는 테이블에 직접 (단계는 고르게 분산)
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int steps = manager.moduleNames().size();
+    for (int i = 0; i < backlog; ++i) {
+        OrderMessage order;
+        order.orderId = i + 1;
+        order.bread = i % 2 ? "호밀빵" : "흰빵";
+        order.egg = "완숙";
+        order.jams << "딸기잼";
+        order.jamAmount = 50;
+        order.cheeses << "체다";
+        order.status = OrderStatus::WAITING;
+        const OrderHandle handle = manager.orders.insert(order, now);
+        manager.orders.setStep(handle, i % steps);
+    }
+
+    QBENCHMARK {
+        manager.assignNextTask();
+    }
+
+    int waiting = 0;
+    for (const QVector<SchedulingCandidate>& bucket : manager.readyTasks) {
+        waiting += bucket.size();
+    }
+    QCOMPARE(waiting, backlog);
+}
+
+void BenchDeviceManager::benchFindAvailableDevice_data()
+{
+    // 모든 장치가 사용 중일 때가 가장 오래 걸림 (끝까지 확인)
+    QTest::addColumn<int>("devices");
+    QTest::addColumn<bool>("allBusy");
+    QTest::newRow("2-free") << 2 << false;
+    QTest::newRow("2-busy") << 2 << true;
+    QTest::newRow("16-busy") << 16 << true;
+    QTest::newRow("64-busy") << 64 << true;
+}
+
+void BenchDeviceManager::benchFindAvailableDevice()
+{
+    QFETCH(int, devices);
+    QFETCH(bool, allBusy);
+
+    DeviceManager manager;
+    while (manager.deviceCount("Bread") < devices) {
+        QVERIFY(manager.addDevice("Bread") > 0);
+    }
+    if (allBusy) {
+        markAllBusy(manager);
+    }
+
+    const QString module = "Bread";
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 0; i < LookupsPerIteration; ++i) {
+            found += manager.findAvailableDevice(module) ? 1 : 0;
+        }
+    }
+    QCOMPARE(found > 0, !allBusy);
+}
+
+void BenchDeviceManager::benchDispatch_data()
+{
+    // 작업 하나를 장치 스레드에 배정하고 완료 통지를 받기까지 (ManualClock이라 처리 시간은 기다리지 않음)
+    // 시계의 완료 콜백 호출은 두 경로가 같으므로 차이는 배정/완료 전달 방식의 비용
+    QTest::addColumn<bool>("ring");
+    QTest::newRow("invokeMethod") << false;
+    QTest::newRow("ring") << true;
+}
+
+void BenchDeviceManager::benchDispatch()
+{
+    QFETCH(bool, ring);
+
+    ManualClock clock;
+    Device* device = new Device("Cheese", 1);
+    device->setClock(&clock);
+    CompletionCounter counter;
+    counter.device = device;
+    device->setCompletionTarget(&counter);
+    int signalled = 0;
+    connect(device, &Device::taskCompleted, this, [&signalled]() { signalled++; });
+
+    QThread thread;
+    device->moveToThread(&thread);
+    connect(&thread, &QThread::finished, device, &QObject::deleteLater);
+    thread.start();
+
+    const QString taskDetail = "치즈 추가: Cheddar";
+    const QString module = "Cheese";
+    int orderId = 0;
+    QBENCHMARK {
+        for (int i = 0; i < TasksPerIteration; ++i) {
+            orderId++;
+            if (ring) {
+                DeviceCommand command;
+                command.orderIds.append(orderId);
+                command.taskDetail = taskDetail;
+                command.module = module;
+                device->submit(std::move(command));
+            } else {
+                // 링 이전의 DeviceManager::startBatch 경로 (이름으로 찾는 호출 + 완료 시그널)
+                QMetaObject::invokeMethod(device, "processTask", Qt::BlockingQueuedConnection,
+                                          Q_ARG(int, orderId),
+                                          Q_ARG(QString, taskDetail),
+                                          Q_ARG(QString, module));
+            }
+            clock.advanceToNext();
+        }
+    }
+
+    thread.quit();
+    thread.wait();
+    QCOMPARE(ring ? counter.completed : signalled, orderId);
+}
+
+BENCH_MAIN(BenchDeviceManager)
+#include "bench_devicemanager.moc"
@@ -0,0 +1,94 @@
+// bench_scheduling.cpp
+#include <QtTest/QtTest>
+#include <QScopedPointer>
+#include "pipelinesimulator.h"
+#include "schedulingpolicy.h"
+#include "benchbaseline.h"
+
+// 스케줄링 정책별 마감 초과 건수 비교 시뮬레이션
+class BenchScheduling : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void benchDeadlineMisses_data();
+    void benchDeadlineMisses();
+    void benchBatching_data();
+    void benchBatching();
+};
+
+void BenchScheduling::benchDeadlineMisses_data()
+{
+    QTest::addColumn<QString>("policyName");
+    QTest::addColumn<double>("ordersPerMinute");
+
+    // 빵 단계(장치 2대 x 10초)의 단독 처리 한계는 분당 12건 (같은 재료 2건 배치 시 최대 24건)
+    const QList<double> loads = QList<double>() << 8.0 << 11.0 << 13.0;
+    for (double load : loads) {
+        for (const QString& policy : SchedulingPolicy::availablePolicies()) {
+            QTest::newRow(qPrintable(QString("%1@%2/min").arg(policy).arg(load)))
+                << policy << load;
+        }
+    }
+}
+
+void BenchScheduling::benchDeadlineMisses()
+{
+    QFETCH(QString, policyName);
+    QFETCH(double, ordersPerMinute);
+
+    const int orderCount = 2000;
+    const qint64 deliveryWindowMs = 4 * 60 * 1000;  // 배달 픽업까지 4분
+    const QVector<SimulatedOrder> workload =
+        PipelineSimulator::generateWorkload(orderCount, ordersPerMinute, deliveryWindowMs, 2024);
+
+    PipelineSimulator simulator;
+    SimulationResult result;
+    QBENCHMARK_ONCE {
+        QScopedPointer<SchedulingPolicy> policy(SchedulingPolicy::create(policyName));
+        QVERIFY(policy);
+        result = simulator.run(workload, policy.data());
+    }
+
+    QCOMPARE(result.completedOrders, orderCount);
+    qInfo().noquote() << QString("[%1/min] %2").arg(ordersPerMinute).arg(result.summary());
+}
+
+void BenchScheduling::benchBatching_data()
+{
+    QTest::addColumn<int>("capacity");
+    QTest::addColumn<qint64>("batchWindowMs");
+
+    QTest::newRow("단독") << 1 << qint64(0);
+    QTest::newRow("2건") << 2 << qint64(0);
+    QTest::newRow("2건+대기2초") << 2 << qint64(2000);
+    QTest::newRow("4건") << 4 << qint64(0);
+}
+
+void BenchScheduling::benchBatching()
+{
+    QFETCH(int, capacity);
+    QFETCH(qint64, batchWindowMs);
+
+    // 단독 처리 한계를 넘는 분당 14건에서 빵/계란 장치 용량별 처리량 비교
+    const int orderCount = 2000;
+    const QVector<SimulatedOrder> workload =
+        PipelineSimulator::generateWorkload(orderCount, 14.0, 4 * 60 * 1000, 2024);
+
+    PipelineSimulator simulator;
+    simulator.setDeviceCapacity(0, capacity);
+    simulator.setDeviceCapacity(2, capacity);
+    simulator.setBatchWindowMs(batchWindowMs);
+
+    SimulationResult result;
+    FifoPolicy policy;
+    QBENCHMARK_ONCE {
+        result = simulator.run(workload, &policy);
+    }
+
+    QCOMPARE(result.completedOrders, orderCount);
+    qInfo().noquote() << QString("[용량 %1] %2").arg(capacity).arg(result.summary());
+}
+
+BENCH_MAIN(BenchScheduling)
+#include "bench_scheduling.moc"
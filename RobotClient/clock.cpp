@@ -0,0 +1,155 @@
+// clock.cpp
+#include "clock.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QThread>
+#include <QTimer>
+#include "metrics.h"
+
+Clock* Clock::system()
+{
+    static SystemClock clock;
+    return &clock;
+}
+
+qint64 SystemClock::nowMs() const
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+qint64 SystemClock::nowUs() const
+{
+    return MetricsRegistry::nowUs();
+}
+
+quint64 SystemClock::callAfter(qint64 delayMs, QObject* context, std::function<void()> callback)
+{
+    const quint64 id = nextId.fetch_add(1);
+    {
+        QMutexLocker locker(&mutex);
+        pending.insert(id);
+    }
+
+    // 타이머는 context의 스레드에서 만기되므로 다른 스레드에서 예약해도 됨
+    QTimer::singleShot(static_cast<int>(qMax<qint64>(0, delayMs)), Qt::PreciseTimer, context,
+                       [this, id, callback]() {
+        {
+            QMutexLocker locker(&mutex);
+            if (!pending.remove(id)) {
+                return;     // 취소됨
+            }
+        }
+        callback();
+    });
+    return id;
+}
+
+void SystemClock::cancel(quint64 timerId)
+{
+    QMutexLocker locker(&mutex);
+    pending.remove(timerId);
+}
+
+ManualClock::ManualClock(qint64 startMs)
+    : startMs(startMs)
+    , elapsedUs(0)
+    , nextId(1)
+{
+}
+
+qint64 ManualClock::nowMs() const
+{
+    QMutexLocker locker(&mutex);
+    return startMs + elapsedUs / 1000;
+}
+
+qint64 ManualClock::nowUs() const
+{
+    QMutexLocker locker(&mutex);
+    return elapsedUs;
+}
+
+quint64 ManualClock::callAfter(qint64 delayMs, QObject* context, std::function<void()> callback)
+{
+    QMutexLocker locker(&mutex);
+    Timer timer;
+    timer.id = nextId++;
+    timer.context = context;
+    timer.callback = callback;
+    timers.insert(qMakePair(elapsedUs + qMax<qint64>(0, delayMs) * 1000, timer.id), timer);
+    return timer.id;
+}
+
+void ManualClock::cancel(quint64 timerId)
+{
+    QMutexLocker locker(&mutex);
+    for (auto it = timers.begin(); it != timers.end(); ++it) {
+        if (it->id == timerId) {
+            timers.erase(it);
+            return;
+        }
+    }
+}
+
+void ManualClock::advance(qint64 ms)
+{
+    qint64 untilUs;
+    {
+        QMutexLocker locker(&mutex);
+        untilUs = elapsedUs + qMax<qint64>(0, ms) * 1000;
+    }
+    while (runNextDue(untilUs)) {
+    }
+
+    QMutexLocker locker(&mutex);
+    elapsedUs = untilUs;
+}
+
+bool ManualClock::advanceToNext()
+{
+    qint64 dueUs;
+    {
+        QMutexLocker locker(&mutex);
+        if (timers.isEmpty()) {
+            return false;
+        }
+        dueUs = timers.firstKey().first;
+    }
+    // 같은 시각의 콜백과 그 콜백이 지연 없이 예약한 것까지 실행
+    while (runNextDue(dueUs)) {
+    }
+    return true;
+}
+
+int ManualClock::pendingTimers() const
+{
+    QMutexLocker locker(&mutex);
+    return timers.size();
+}
+
+bool ManualClock::runNextDue(qint64 untilUs)
+{
+    Timer timer;
+    {
+        QMutexLocker locker(&mutex);
+        if (timers.isEmpty() || timers.firstKey().first > untilUs) {
+            return false;
+        }
+        elapsedUs = qMax(elapsedUs, timers.firstKey().first);
+        timer = timers.take(timers.firstKey());
+    }
+
+    // 콜백이 시계를 다시 쓸 수 있으므로 잠금 밖에서 실행
+    QObject* context = timer.context.data();
+    if (context) {
+        if (context->thread() == QThread::currentThread()) {
+            timer.callback();
+        } else {
+            QMetaObject::invokeMethod(context, timer.callback, Qt::BlockingQueuedConnection);
+        }
+    }
+
+    // 다른 스레드에서 보낸 신호(장치 완료 등)를 바로 처리해 다음 예약이 이 시각에 이루어지게 함
+    QCoreApplication::sendPostedEvents();
+    return true;
+}
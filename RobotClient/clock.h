@@ -0,0 +1,86 @@
+// clock.h
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <QObject>
+#include <QPointer>
+#include <QMap>
+#include <QPair>
+#include <QMutex>
+#include <QSet>
+#include <atomic>
+#include <functional>
+
+// 시간 원천
+// 장치 처리 시간과 배치 대기처럼 "얼마 뒤에 할 일"은 모두 이 시계로 재고 예약합니다.
+// 실행 중에는 Clock::system(), 테스트에서는 ManualClock으로 시간을 직접 진행해
+// 몇 초~몇 시간짜리 시나리오를 실제로 기다리지 않고 확인할 수 있습니다.
+class Clock
+{
+public:
+    virtual ~Clock() = default;
+
+    virtual qint64 nowMs() const = 0;   // 벽시계 (epoch ms, 주문 시각과 마감 비교용)
+    virtual qint64 nowUs() const = 0;   // 단조 시계 (us, 경과 시간 측정용)
+
+    // delayMs 뒤에 context의 스레드에서 callback 실행 (그 전에 context가 사라지면 실행하지 않음)
+    // 반환값은 cancel에 쓰는 ID (0은 쓰지 않음)
+    virtual quint64 callAfter(qint64 delayMs, QObject* context, std::function<void()> callback) = 0;
+    virtual void cancel(quint64 timerId) = 0;
+
+    // 프로세스 공용 실제 시계
+    static Clock* system();
+};
+
+// 실제 시계 (QTimer 단발 타이머)
+class SystemClock : public Clock
+{
+public:
+    qint64 nowMs() const override;
+    qint64 nowUs() const override;
+    quint64 callAfter(qint64 delayMs, QObject* context, std::function<void()> callback) override;
+    void cancel(quint64 timerId) override;
+
+private:
+    std::atomic<quint64> nextId{1};
+    QMutex mutex;
+    QSet<quint64> pending;      // 아직 실행되지 않았고 취소되지 않은 타이머
+};
+
+// 테스트용 시계: advance()를 호출해야만 시간이 흐름
+// 만기된 콜백은 시각 순으로 각자 context의 스레드에서 실행하고 (다른 스레드면 끝날 때까지 기다림)
+// 콜백마다 호출 스레드에 쌓인 이벤트를 처리하므로, 다른 스레드의 장치가 보낸 완료 신호와
+// 그에 따른 다음 작업 예약까지 같은 advance 안에서 이어집니다.
+class ManualClock : public Clock
+{
+public:
+    explicit ManualClock(qint64 startMs = 1700000000000LL);
+
+    qint64 nowMs() const override;
+    qint64 nowUs() const override;
+    quint64 callAfter(qint64 delayMs, QObject* context, std::function<void()> callback) override;
+    void cancel(quint64 timerId) override;
+
+    // ms만큼 시간을 진행 (그 사이에 만기되는 콜백 실행)
+    void advance(qint64 ms);
+    // 다음 타이머 시각까지 진행 (예약된 타이머가 없으면 false)
+    bool advanceToNext();
+    int pendingTimers() const;
+
+private:
+    struct Timer {
+        quint64 id;
+        QPointer<QObject> context;
+        std::function<void()> callback;
+    };
+
+    mutable QMutex mutex;
+    qint64 startMs;
+    qint64 elapsedUs;
+    quint64 nextId;
+    QMap<QPair<qint64, quint64>, Timer> timers;     // (만기 시각 us, ID) -> 타이머, 같은 시각은 예약 순
+
+    bool runNextDue(qint64 untilUs);
+};
+
+#endif // CLOCK_H
@@ -1,49 +1,229 @@
 // device.cpp
 
 #include "device.h"
-#include <QThread>
-#include <QDebug>
+#include "logging.h"
+#include <QCoreApplication>
 
 Device::Device(const QString &module, int index, QObject *parent)
     : QObject(parent),
     moduleType(module),
     deviceIndex(index),
-    isProcessing(false)
+    capacity(defaultCapacity(module)),
+    processingTime(processingTimeMs(module)),
+    isProcessing(false),
+    clock(Clock::system()),
+    commands(RingCapacity),
+    completions(RingCapacity),
+    completionTarget(nullptr),
+    createdUs(clock->nowUs()),
+    busyUs(0),
+    traceTrack(QString("%1 #%2").arg(module).arg(index).toUtf8())
 {
+    // 같은 장치 번호로 다시 만들어도 같은 지표를 이어서 사용
+    const QString labels = QString("module=\"%1\",device=\"%2\"").arg(module).arg(index);
+    MetricsRegistry& metrics = MetricsRegistry::instance();
+    serviceTime = metrics.histogram("device_service_us", "장치의 작업(배치) 처리 시간", labels);
+    busyTime = metrics.counter("device_busy_us_total", "장치가 작업한 누적 시간", labels);
+    utilization = metrics.gauge("device_utilization", "장치 생성 이후 가동률 (0~1)", labels);
 }
 
-void Device::processTask(int orderId, const QString &taskDetail)
+void Device::setClock(Clock* value)
 {
+    clock = value ? value : Clock::system();
+    createdUs = clock->nowUs();
+    busyUs = 0;
+}
+
+void Device::beginWork()
+{
+    isProcessing = true;
+    emit statusChanged(this, moduleType, deviceIndex, true);
+}
+
+qint64 Device::endWork(qint64 startedUs)
+{
+    const qint64 now = clock->nowUs();
+    const qint64 elapsedUs = now - startedUs;
+    serviceTime->record(static_cast<quint64>(elapsedUs));
+    busyTime->add(static_cast<quint64>(elapsedUs));
+    busyUs += elapsedUs;
+    utilization->set(now > createdUs ? static_cast<double>(busyUs) / (now - createdUs) : 0.0);
+
+    isProcessing = false;
+    emit statusChanged(this, moduleType, deviceIndex, false);
+    return elapsedUs;
+}
+
+void Device::traceWork(const QString& module, qint64 elapsedUs, int orderId, int count)
+{
+    // 배치는 첫 주문 ID와 배치 크기로 기록
+    // 추적 타임라인은 실제 시각 기준이므로 끝난 시점에서 처리 시간만큼 거슬러 올라감
+    if (Tracer::enabled()) {
+        const qint64 nowUs = MetricsRegistry::nowUs();
+        Tracer::instance().complete(module.toUtf8().constData(), traceTrack.constData(),
+                                    nowUs - elapsedUs, elapsedUs, orderId, count);
+    }
+}
+
+void Device::processTask(int orderId, const QString &taskDetail, const QString &module)
+{
+    const QString taskModule = module.isEmpty() ? moduleType : module;
+
     if (isProcessing) {
         emit errorOccurred(this, "Device is already processing a task");
         return;
     }
 
-    isProcessing = true;
-    emit statusChanged(this, moduleType, deviceIndex, true);
+    const qint64 startedUs = clock->nowUs();
+    beginWork();
 
-    qDebug() << moduleType << "Device" << deviceIndex
-             << "started processing order" << orderId << ":" << taskDetail;
+    qCDebug(lcDevice) << moduleType << "Device" << deviceIndex
+                      << "started processing order" << orderId << ":" << taskDetail;
 
-    // 작업 시간 시뮬레이션 (각 모듈별로 다른 처리 시간 설정)
-    int processingTime = 5; // 기본값 5초
-    if (moduleType == "Bread") {
-        processingTime = 10; // 빵은 10초
-    } else if (moduleType == "Egg") {
-        processingTime = 7;  // 계란은 7초
-    } else if (moduleType == "Cheese") {
-        processingTime = 3;  // 치즈는 3초
-    } else if (moduleType == "Jam") {
-        processingTime = 4;  // 잼은 4초
+    // 실제 로봇에서는 여기서 하드웨어에 작업을 지시하고 완료 통지를 기다릴 것입니다.
+    clock->callAfter(processingTimeFor(taskModule), this, [this, taskModule, orderId, startedUs]() {
+        const qint64 elapsedUs = endWork(startedUs);
+        traceWork(taskModule, elapsedUs, orderId, 1);
+        emit taskCompleted(this, taskModule, orderId);
+
+        qCDebug(lcDevice) << moduleType << "Device" << deviceIndex
+                          << "finished processing order" << orderId;
+    });
+}
+
+void Device::processBatch(const QList<int> &orderIds, const QString &taskDetail,
+                          const QString &module)
+{
+    const QString taskModule = module.isEmpty() ? moduleType : module;
+
+    if (isProcessing) {
+        emit errorOccurred(this, "Device is already processing a task");
+        return;
+    }
+    if (orderIds.size() > capacity) {
+        emit errorOccurred(this, "Batch exceeds device capacity");
+        return;
     }
 
-    // 실제 로봇에서는 여기에 하드웨어 제어 코드가 들어갈 것입니다.
-    QThread::sleep(processingTime);
+    const qint64 startedUs = clock->nowUs();
+    beginWork();
 
-    isProcessing = false;
-    emit statusChanged(this, moduleType, deviceIndex, false);
-    emit taskCompleted(this, moduleType, orderId);
+    qCDebug(lcDevice) << moduleType << "Device" << deviceIndex
+                      << "started processing batch" << orderIds << ":" << taskDetail;
+
+    // 같은 재료의 작업은 한 번의 사이클로 함께 처리
+    clock->callAfter(processingTimeFor(taskModule), this, [this, taskModule, orderIds, startedUs]() {
+        const qint64 elapsedUs = endWork(startedUs);
+        traceWork(taskModule, elapsedUs, orderIds.first(), orderIds.size());
+        emit batchCompleted(this, taskModule, orderIds);
+
+        qCDebug(lcDevice) << moduleType << "Device" << deviceIndex
+                          << "finished processing batch" << orderIds;
+    });
+}
 
-    qDebug() << moduleType << "Device" << deviceIndex
-             << "finished processing order" << orderId;
+bool Device::submit(DeviceCommand command)
+{
+    const QString taskModule = command.module.isEmpty() ? moduleType : command.module;
+    const qint64 durationMs = static_cast<qint64>(processingTimeFor(taskModule)) * command.units;
+    command.startedUs = clock->nowUs();
+    if (!commands.push(std::move(command))) {
+        return false;
+    }
+
+    // 처리 시간은 배정하는 쪽에서 바로 예약 (ManualClock으로 시간을 진행해도 방금 배정한 작업이 빠지지 않음)
+    // 콜백은 장치 스레드에서 실행되며, 깨우기 이벤트보다 먼저 오면 명령부터 꺼내 시작함
+    clock->callAfter(durationMs, this, [this]() { finishCommand(); });
+
+    if (commands.requestWake()) {
+        QCoreApplication::postEvent(this, new QEvent(commandEventType()));
+    }
+    return true;
+}
+
+bool Device::event(QEvent *event)
+{
+    if (event->type() == commandEventType()) {
+        startCommands();
+        return true;
+    }
+    return QObject::event(event);
+}
+
+void Device::startCommands()
+{
+    do {
+        DeviceCommand command;
+        while (commands.pop(command)) {
+            if (isProcessing) {
+                emit errorOccurred(this, "Device is already processing a task");
+                continue;
+            }
+            current = std::move(command);
+            beginWork();
+
+            qCDebug(lcDevice) << moduleType << "Device" << deviceIndex
+                              << "started processing" << current.orderIds.size() << "order(s) from"
+                              << current.orderIds.first() << ":" << current.taskDetail;
+        }
+    } while (commands.finishWake());
+}
+
+void Device::finishCommand()
+{
+    startCommands();
+    if (!isProcessing) {
+        return;
+    }
+
+    DeviceCompletion completion;
+    completion.orderIds = current.orderIds;
+    completion.module = current.module.isEmpty() ? moduleType : current.module;
+    const qint64 elapsedUs = endWork(current.startedUs);
+    traceWork(completion.module, elapsedUs, completion.orderIds.first(), completion.orderIds.size());
+    current = DeviceCommand();
+
+    // 명령 하나에 완료 하나이고 두 링의 크기가 같으므로 완료 링은 넘치지 않음
+    completions.push(std::move(completion));
+    if (completions.requestWake() && completionTarget) {
+        QCoreApplication::postEvent(completionTarget, new QEvent(completionEventType()));
+    }
+
+    qCDebug(lcDevice) << moduleType << "Device" << deviceIndex << "finished processing";
+}
+
+QEvent::Type Device::commandEventType()
+{
+    static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+    return type;
+}
+
+QEvent::Type Device::completionEventType()
+{
+    static const QEvent::Type type = static_cast<QEvent::Type>(QEvent::registerEventType());
+    return type;
+}
+
+int Device::processingTimeMs(const QString &module)
+{
+    // 작업 시간 시뮬레이션 (각 모듈별로 다른 처리 시간 설정)
+    if (module == "Bread") {
+        return 10000; // 빵은 10초
+    } else if (module == "Egg") {
+        return 7000;  // 계란은 7초
+    } else if (module == "Cheese") {
+        return 3000;  // 치즈는 3초
+    } else if (module == "Jam") {
+        return 4000;  // 잼은 4초
+    }
+    return 5000; // 기본값 5초
+}
+
+int Device::defaultCapacity(const QString &module)
+{
+    // 토스터는 빵 두 장, 그리들은 계란 두 개를 한 번에 처리
+    if (module == "Bread" || module == "Egg") {
+        return 2;
+    }
+    return 1;
 }
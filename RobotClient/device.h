@@ -3,7 +3,32 @@
 #define DEVICE_H
 
 #include <QObject>
+#include <QEvent>
 #include <QString>
+#include <QStringList>
+#include <QList>
+#include <QMap>
+#include <QVarLengthArray>
+#include "clock.h"
+#include "metrics.h"
+#include "spscqueue.h"
+#include "tracer.h"
+
+// DeviceManager가 장치 스레드로 보내는 작업 명령
+// 칸은 장치를 만들 때 미리 할당되고, 주문 ID는 배치 용량만큼 칸 안에 들어감 (문자열은 공유 복사)
+struct DeviceCommand {
+    QVarLengthArray<int, 4> orderIds;   // 1개면 단일 작업, 여러 개면 배치
+    QString taskDetail;
+    QString module;                     // 처리할 작업의 모듈 (비어 있으면 장치 자신의 모듈)
+    int units = 1;                      // 처리 시간 배수 (치즈 장 수, 잼 종류 수; 0이면 바로 끝남)
+    qint64 startedUs = 0;               // 배정 시각 (장치 시계)
+};
+
+// 장치 스레드가 DeviceManager로 돌려보내는 완료 통지
+struct DeviceCompletion {
+    QVarLengthArray<int, 4> orderIds;
+    QString module;
+};
 
 class Device : public QObject
 {
@@ -15,18 +40,90 @@ public:
     QString getModuleType() const { return moduleType; }
     int getDeviceIndex() const { return deviceIndex; }
 
+    // 한 번에 함께 처리할 수 있는 작업 수 (토스터 슬롯, 그리들 칸 등)
+    int getCapacity() const { return capacity; }
+    void setCapacity(int value) { capacity = qMax(1, value); }
+
+    // 이 장치의 작업 처리 시간 (ms, 기본값은 모듈별 처리 시간)
+    int getProcessingTimeMs() const { return processingTime; }
+    void setProcessingTimeMs(int value) { processingTime = qMax(1, value); }
+
+    // 다른 모듈의 작업도 처리할 수 있는 다기능 장치 (예: 치즈/잼 스프레더, 빵/계란 겸용 조리기)
+    // 모듈 이름 -> 그 작업의 처리 시간 (ms). 스레드로 옮기기 전에 설정합니다.
+    void setSkill(const QString &module, int timeMs) { skills[module] = qMax(1, timeMs); }
+    QStringList getSkills() const { return skills.keys(); }
+    bool canProcess(const QString &module) const { return module == moduleType || skills.contains(module); }
+    int processingTimeFor(const QString &module) const {
+        return module == moduleType ? processingTime : skills.value(module, processingTime);
+    }
+
+    // 처리 시간을 재는 시계 (기본은 실제 시계). 스레드로 옮기기 전에 설정합니다.
+    void setClock(Clock* value);
+
+    // 모듈별 기본 작업 처리 시간 (ms)
+    static int processingTimeMs(const QString &module);
+    static int defaultCapacity(const QString &module);
+
+    // DeviceManager 전용 작업 경로 (시그널/슬롯 대신 장치별 단일 생산자/단일 소비자 링)
+    // submit은 배정하는 스레드에서 호출: 명령을 링에 넣고 처리 시간을 시계에 예약한 뒤 바로 반환
+    // 장치 스레드는 깨우기 이벤트 하나로 쌓인 명령을 모두 꺼내 시작하고, 끝나면 완료 링에 넣음
+    // 작업 중인 장치에 다시 넣지 않는 것은 호출 측 책임 (명령 링이 가득 차면 false)
+    static const int RingCapacity = 4;
+    bool submit(DeviceCommand command);
+    // 완료 통지 이벤트(completionEventType)를 받을 객체. 스레드로 옮기기 전에 설정합니다.
+    void setCompletionTarget(QObject *target) { completionTarget = target; }
+    // 완료 링은 completionTarget의 스레드에서만 비움 (finishCompletions가 true면 이어서 비움)
+    bool takeCompletion(DeviceCompletion& completion) { return completions.pop(completion); }
+    bool finishCompletions() { return completions.finishWake(); }
+
+    static QEvent::Type commandEventType();
+    static QEvent::Type completionEventType();
+
+protected:
+    bool event(QEvent *event) override;
+
 signals:
     void taskCompleted(Device* device, const QString &module, int orderId);
+    void batchCompleted(Device* device, const QString &module, const QList<int> &orderIds);
     void statusChanged(Device* device, const QString &module, int deviceIndex, bool isOn);
     void errorOccurred(Device* device, const QString &errorMessage);
 
 public slots:
-    void processTask(int orderId, const QString &taskDetail);
+    // 작업을 시작하고 처리 시간이 지나면 완료 신호를 보냄 (호출은 바로 반환)
+    // module: 처리할 작업의 모듈 (비어 있으면 장치 자신의 모듈)
+    void processTask(int orderId, const QString &taskDetail, const QString &module = QString());
+    void processBatch(const QList<int> &orderIds, const QString &taskDetail,
+                      const QString &module = QString());
 
 private:
     QString moduleType;
     int deviceIndex;
+    int capacity;
+    int processingTime;
+    QMap<QString, int> skills;
     bool isProcessing;
+    Clock* clock;
+
+    // 작업 링 (명령: 배정 스레드 -> 장치 스레드, 완료: 장치 스레드 -> completionTarget 스레드)
+    SpscQueue<DeviceCommand> commands;
+    SpscQueue<DeviceCompletion> completions;
+    QObject* completionTarget;
+    DeviceCommand current;          // 링으로 받아 처리 중인 명령
+
+    // 장치 지표: 작업 처리 시간, 누적 가동 시간, 생성 이후 가동률
+    MetricHistogram* serviceTime;
+    MetricCounter* busyTime;
+    MetricGauge* utilization;
+    qint64 createdUs;
+    qint64 busyUs;
+    QByteArray traceTrack;          // 추적 타임라인에서 이 장치의 줄 이름
+
+    void traceWork(const QString& module, qint64 elapsedUs, int orderId, int count);
+
+    void beginWork();
+    qint64 endWork(qint64 startedUs);
+    void startCommands();
+    void finishCommand();
 };
 
 #endif // DEVICE_H
@@ -1,14 +1,50 @@
 // devicemanager.cpp
 #include "devicemanager.h"
+#include <QMetaMethod>
 
 DeviceManager::DeviceManager(QObject *parent)
+    : DeviceManager(RobotConfig::defaults(), parent)
+{
+}
+
+DeviceManager::DeviceManager(const RobotConfig& topology, QObject *parent)
+    : DeviceManager(topology, Clock::system(), parent)
+{
+}
+
+DeviceManager::DeviceManager(const RobotConfig& topology, Clock* timeSource, QObject *parent)
     : QObject(parent)
+    , config(topology.modules.isEmpty() ? RobotConfig::defaults() : topology)
+    , clock(timeSource ? timeSource : Clock::system())
+    , orderEventText(true)
+    , backlogLimit(0)
+    , schedulingPolicy(new FifoPolicy)
+    , batchWindow(0)
+    , batchTimerId(0)
+    , batchDueMs(0)
 {
+    qRegisterMetaType<QList<int>>("QList<int>");
+
+    readyTasks.resize(stepCount());
+
+    MetricsRegistry& metrics = MetricsRegistry::instance();
+    for (const ModuleConfig& module : config.modules) {
+        const QString labels = QString("module=\"%1\"").arg(module.name);
+        queueWait.append(metrics.histogram("robot_queue_wait_us", "단계 준비부터 장치 배정까지 대기 시간", labels));
+        queueDepth.append(metrics.gauge("robot_queue_depth", "장치를 기다리는 작업 수", labels));
+    }
+    orderLatency = metrics.histogram("robot_order_latency_us", "주문 수신부터 모든 단계 완료까지 걸린 시간");
+    ordersCompleted = metrics.counter("robot_orders_completed_total", "완료한 주문 수");
+    ordersRejected = metrics.counter("robot_orders_rejected_total", "보관 한도 초과나 중복으로 거절한 주문 수");
+    backlogGauge = metrics.gauge("robot_backlog", "로봇이 보관 중인 주문 수");
+
     initializeDevices();
+    updateBacklogLimit();
 }
 
 DeviceManager::~DeviceManager()
 {
+    clock->cancel(batchTimerId);
     for (auto thread : deviceThreads.values()) {
         thread->quit();
         thread->wait();
@@ -18,107 +54,491 @@ DeviceManager::~DeviceManager()
 
 void DeviceManager::initializeDevices()
 {
-    QStringList modules = { "Bread", "Cheese", "Egg", "Jam" };
+    for (const ModuleConfig& module : config.modules) {
+        for (int i = 0; i < module.devices; ++i) {
+            createDevice(module, i + 1, module.deviceTimeMs(i + 1));
+            emit logMessage(QString("%1 장치 %2 초기화 완료").arg(module.name).arg(i + 1));
+        }
+    }
+}
+
+Device* DeviceManager::createDevice(const ModuleConfig& moduleConfig, int deviceIndex, int processingTimeMs)
+{
+    const QString& module = moduleConfig.name;
+    Device* device = new Device(module, deviceIndex);
+    device->setClock(clock);
+    device->setProcessingTimeMs(processingTimeMs);
+    device->setCapacity(moduleConfig.capacity);
+    device->setCompletionTarget(this);
+    for (auto it = moduleConfig.skills.constBegin(); it != moduleConfig.skills.constEnd(); ++it) {
+        device->setSkill(it.key(), it.value());
+    }
+    QThread* thread = new QThread(this);
 
-    for (const QString &module : modules) {
-        for (int i = 0; i < 2; ++i) {
-            Device* device = new Device(module, i + 1);
-            QThread* thread = new QThread(this);
+    device->moveToThread(thread);
+    deviceThreads[device] = thread;
+    devices[module].append(device);
+    deviceAvailability[device] = true;
 
-            device->moveToThread(thread);
-            deviceThreads[device] = thread;
-            devices[module].append(device);
-            deviceAvailability[device] = true;
+    // 작업과 완료는 시그널 대신 장치의 명령/완료 링으로 주고받음 (Device::submit, drainCompletions)
+    connect(thread, &QThread::started, device, [](){ /* Device idle */ });
+    connect(thread, &QThread::finished, device, &QObject::deleteLater);
 
-            connect(thread, &QThread::started, device, [](){ /* Device idle */ });
-            connect(device, &Device::taskCompleted,
-                    this, &DeviceManager::handleDeviceTaskCompleted);
-            connect(thread, &QThread::finished, device, &QObject::deleteLater);
+    thread->start();
 
-            thread->start();
+    emit deviceStatusChanged(module, deviceIndex, DeviceStatus::OFF, "");
+    return device;
+}
 
-            emit deviceStatusChanged(module, i + 1, DeviceStatus::OFF, "");
-            emit logMessage(QString("%1 장치 %2 초기화 완료").arg(module).arg(i + 1));
+void DeviceManager::destroyDevice(Device* device)
+{
+    const QString module = device->getModuleType();
+    const int deviceIndex = device->getDeviceIndex();
+
+    devices[module].removeAll(device);
+    deviceAvailability.remove(device);
+    retiringDevices.remove(device);
+
+    // 장치 객체는 스레드 종료 시 deleteLater로 정리됨
+    QThread* thread = deviceThreads.take(device);
+    if (thread) {
+        thread->quit();
+        thread->wait();
+        delete thread;
+    }
+
+    emit deviceRemoved(module, deviceIndex);
+    emit logMessage(QString("%1 장치 %2 제거 완료").arg(module).arg(deviceIndex));
+}
+
+QStringList DeviceManager::moduleNames() const
+{
+    QStringList names;
+    for (const ModuleConfig& module : config.modules) {
+        names.append(module.name);
+    }
+    return names;
+}
+
+int DeviceManager::deviceCount(const QString& module) const
+{
+    return devices.value(module).size();
+}
+
+int DeviceManager::addDevice(const QString& module, int processingTimeMs)
+{
+    const int step = config.indexOf(module);
+    if (step < 0) {
+        emit logMessage(QString("알 수 없는 모듈입니다: %1").arg(module));
+        return 0;
+    }
+
+    // 제거 예정인 장치가 있으면 새로 만들지 않고 제거를 취소 (장치 번호를 연속으로 유지)
+    for (Device* device : devices.value(module)) {
+        if (retiringDevices.remove(device)) {
+            updateBacklogLimit();
+            emit logMessage(QString("%1 장치 %2 제거 취소").arg(module).arg(device->getDeviceIndex()));
+            assignNextTask();
+            return device->getDeviceIndex();
         }
     }
+
+    const int deviceIndex = devices.value(module).size() + 1;
+    if (deviceIndex > RobotConfig::MaxDevicesPerModule) {
+        emit logMessage(QString("%1 장치는 최대 %2대까지 추가할 수 있습니다")
+                            .arg(module).arg(RobotConfig::MaxDevicesPerModule));
+        return 0;
+    }
+
+    const ModuleConfig& moduleConfig = config.modules.at(step);
+    const int timeMs = processingTimeMs > 0 ? processingTimeMs : moduleConfig.deviceTimeMs(deviceIndex);
+    createDevice(moduleConfig, deviceIndex, timeMs);
+    updateBacklogLimit();
+
+    emit deviceAdded(module, deviceIndex);
+    emit logMessage(QString("%1 장치 %2 추가 (처리 시간 %3ms)").arg(module).arg(deviceIndex).arg(timeMs));
+
+    // 새 장치에 대기 작업 배정
+    assignNextTask();
+    return deviceIndex;
 }
 
-void DeviceManager::processNewOrder(const OrderMessage& order)
+bool DeviceManager::removeDevice(const QString& module)
 {
-    // 새로운 OrderTask 생성
-    OrderTask newTask;
-    newTask.orderId = order.orderId;
-    newTask.currentStep = 0;
-    newTask.isProcessing = false;
-    newTask.moduleType = "Bread";  // 초기 모듈은 항상 Bread
-    newTask.taskDetail = createTaskDetail("Bread", order);
+    const QList<Device*> moduleDevices = devices.value(module);
+    Device* target = nullptr;
+    int activeCount = 0;
+    for (Device* device : moduleDevices) {
+        if (!retiringDevices.contains(device)) {
+            activeCount++;
+            target = device;    // 번호가 가장 큰 장치
+        }
+    }
+
+    if (!target) {
+        emit logMessage(QString("알 수 없는 모듈입니다: %1").arg(module));
+        return false;
+    }
+    if (activeCount <= 1) {
+        emit logMessage(QString("%1 모듈의 마지막 장치는 제거할 수 없습니다").arg(module));
+        return false;
+    }
+
+    retiringDevices.insert(target);
+    updateBacklogLimit();
+    if (!deviceAvailability.value(target, true)) {
+        emit logMessage(QString("%1 장치 %2: 현재 작업이 끝나면 제거합니다")
+                            .arg(module).arg(target->getDeviceIndex()));
+    }
+
+    removeRetiredDevices(module);
+    emit loadChanged();
+    return true;
+}
+
+void DeviceManager::removeRetiredDevices(const QString& module)
+{
+    // 번호 순서를 유지하기 위해 뒤쪽부터 쉬고 있는 제거 예정 장치만 정리
+    while (!devices.value(module).isEmpty()) {
+        Device* last = devices.value(module).last();
+        if (!retiringDevices.contains(last) || !deviceAvailability.value(last, true)) {
+            break;
+        }
+        destroyDevice(last);
+    }
+}
+
+void DeviceManager::updateBacklogLimit()
+{
+    // 장치마다 처리 중 1건 + 대기 1건
+    const int activeDevices = deviceAvailability.size() - retiringDevices.size();
+    backlogLimit = qMax(1, activeDevices * 2);
+}
+
+template <typename... Args>
+void DeviceManager::logOrderEvent(LogEvent event, const Args&... args)
+{
+    BinaryLogger::instance().log(event, args...);
+    // 문장은 받는 쪽이 있을 때만 만듦
+    if (orderEventText && isSignalConnected(QMetaMethod::fromSignal(&DeviceManager::logMessage))) {
+        emit logMessage(BinaryLogger::format(event, args...));
+    }
+}
+
+void DeviceManager::handleServerMessage(const Message& message)
+{
+    if (message.type != MessageType::ORDER_NEW) {
+        return;
+    }
+    const OrderMessage order = OrderMessage::fromJson(message.data);
+    emit orderReceived(order.orderId, processNewOrder(order));
+}
 
-    // 주문 큐에 추가
-    orderQueue.enqueue(newTask);
-    activeOrders[order.orderId] = order;
+bool DeviceManager::processNewOrder(const OrderMessage& order)
+{
+    if (orders.size() >= backlogLimit) {
+        ordersRejected->add();
+        logOrderEvent(LogEvent::OrderRejectedBacklog, order.orderId, backlogLimit);
+        return false;
+    }
 
-    emit logMessage(QString("새 주문 수신 (ID: %1)").arg(order.orderId));
+    // 주문 테이블에 추가 (초기 단계는 항상 Bread)
+    OrderHandle handle = orders.insert(order, clock->nowMs());
+    if (handle.isNull()) {
+        ordersRejected->add();
+        emit logMessage(QString("이미 수신된 주문입니다 (ID: %1)").arg(order.orderId));
+        return false;
+    }
+
+    orders.setStatus(handle, OrderStatus::WAITING);
+
+    logOrderEvent(LogEvent::RobotOrderReceived, order.orderId);
+    Tracer::instance().instant("order received", "orders", order.orderId);
 
     // 작업 할당 시도
     assignNextTask();
+    return true;
+}
+
+void DeviceManager::setMaxBacklog(int limit)
+{
+    backlogLimit = qMax(1, limit);
+}
+
+RobotLoadMessage DeviceManager::loadReport() const
+{
+    RobotLoadMessage report;
+    report.backlog = orders.size();
+
+    for (const ModuleConfig& module : config.modules) {
+        ModuleLoad load;
+        load.module = module.name;
+        qint64 totalTimeMs = 0;
+        for (Device* device : devices.value(module.name)) {
+            load.devices++;
+            totalTimeMs += device->getProcessingTimeMs();
+            if (!deviceAvailability.value(device, true)) {
+                load.busy++;
+            }
+        }
+        // 장치별 처리 시간이 다르면 평균으로 보고
+        load.durationMs = load.devices > 0 ? totalTimeMs / load.devices : module.processingTimeMs;
+        report.modules.append(load);
+    }
+
+    orders.forEach([&](OrderHandle handle) {
+        const int step = orders.step(handle);
+        if (step >= 0 && step < stepCount() && !orders.isProcessing(handle)) {
+            report.modules[step].waiting++;
+        }
+    });
+    return report;
+}
+
+void DeviceManager::setBatchWindowMs(int windowMs)
+{
+    batchWindow = qMax(0, windowMs);
+    assignNextTask();
+}
+
+void DeviceManager::setDeviceCapacity(const QString& module, int capacity)
+{
+    const int step = config.indexOf(module);
+    if (step >= 0) {
+        config.modules[step].capacity = qMax(1, capacity);   // 이후 추가되는 장치에도 적용
+    }
+
+    // 장치는 다른 스레드에 있지만 용량은 이 스레드에서만 읽음
+    for (Device* device : devices.value(module)) {
+        device->setCapacity(capacity);
+    }
+    emit logMessage(QString("%1 장치 용량 변경: %2").arg(module).arg(qMax(1, capacity)));
+    assignNextTask();
+}
+
+void DeviceManager::setSchedulingPolicy(SchedulingPolicy* policy)
+{
+    schedulingPolicy.reset(policy ? policy : new FifoPolicy);
+    emit logMessage(QString("스케줄링 정책 변경: %1").arg(schedulingPolicy->name()));
+    assignNextTask();
+}
+
+QString DeviceManager::schedulingPolicyName() const
+{
+    return schedulingPolicy->name();
 }
 
 void DeviceManager::assignNextTask()
 {
-    // 현재 처리 중인 주문들 확인
-    for (auto it = processingOrders.begin(); it != processingOrders.end(); ++it) {
-        if (it.value().isProcessing) {
-            continue;  // 이미 처리 중인 주문은 건너뛰기
-        }
-
-        // 다음 단계로 진행
-        OrderTask& task = it.value();
-        QString nextModule = getNextModule(task.currentStep);
-        if (!nextModule.isEmpty()) {
-            Device* device = findAvailableDevice(nextModule);
-            if (device) {
-                // 장치 할당 및 작업 시작
-                deviceAvailability[device] = false;
-                task.isProcessing = true;
-                task.moduleType = nextModule;
-                task.taskDetail = createTaskDetail(nextModule, activeOrders[task.orderId]);
-
-                emit deviceStatusChanged(nextModule, device->getDeviceIndex(), DeviceStatus::ON, task.taskDetail);
-                emit logMessage(QString("주문 %1: %2 시작").arg(task.orderId).arg(task.taskDetail));
-
-                QMetaObject::invokeMethod(device, "processTask", Qt::QueuedConnection,
-                                          Q_ARG(int, task.orderId),
-                                          Q_ARG(QString, task.taskDetail));
+    const qint64 now = clock->nowMs();
+
+    // 장치를 기다리는 작업을 단계별로 수집
+    for (QVector<SchedulingCandidate>& bucket : readyTasks) {
+        bucket.clear();
+    }
+    orders.forEach([&](OrderHandle handle) {
+        if (orders.isProcessing(handle)) {
+            return;  // 장치에서 처리 중인 주문은 건너뛰기
+        }
+        const int step = orders.step(handle);
+        if (step < 0 || step >= stepCount()) {
+            return;
+        }
+
+        SchedulingCandidate candidate;
+        candidate.handle = handle;
+        candidate.orderId = orders.orderId(handle);
+        candidate.step = step;
+        candidate.arrivalMs = orders.createdAt(handle);
+        candidate.deadlineMs = orders.deadline(handle);
+        candidate.priority = orders.priority(handle);
+        candidate.channel = orders.channel(handle);
+        candidate.remainingWorkMs = remainingWorkMs(step, orders.details(handle));
+        candidate.readyMs = orders.updatedAt(handle);
+        candidate.batchKey = createTaskDetail(getNextModule(step), orders.details(handle));
+        readyTasks[step].append(candidate);
+    });
+
+    for (int step = 0; step < stepCount(); ++step) {
+        queueDepth[step]->set(readyTasks[step].size());
+    }
+    backlogGauge->set(orders.size());
+
+    // 단계별로 빈 장치가 있는 동안 정책이 고른 작업을 배정
+    QVector<bool> waitingForBatch(stepCount(), false);
+    for (int step = 0; step < stepCount(); ++step) {
+        QVector<SchedulingCandidate>& bucket = readyTasks[step];
+        const QString module = getNextModule(step);
+
+        while (!bucket.isEmpty()) {
+            Device* device = findAvailableDevice(module);
+            if (!device) {
+                break;  // 사용 가능한 장치가 없으면 대기
+            }
+
+            const int capacity = device->getCapacity();
+            const QVector<SchedulingCandidate> batch = schedulingPolicy->takeBatch(bucket, now, capacity);
+
+            // 배치가 덜 찼으면 대기 시간 안에서 같은 재료의 작업을 더 기다림
+            const qint64 waitedMs = now - batch.first().readyMs;
+            if (batch.size() < capacity && waitedMs < batchWindow) {
+                const int remainingMs = static_cast<int>(batchWindow - waitedMs);
+                if (!batchTimerId || batchDueMs > now + remainingMs) {
+                    clock->cancel(batchTimerId);
+                    batchDueMs = now + remainingMs;
+                    batchTimerId = clock->callAfter(remainingMs, this, [this]() {
+                        batchTimerId = 0;
+                        assignNextTask();
+                    });
+                }
+                waitingForBatch[step] = true;
+                continue;
             }
+
+            startBatch(device, batch, module);
         }
     }
 
-    // 대기 중인 새 주문 처리
-    while (!orderQueue.isEmpty()) {
-        OrderTask task = orderQueue.dequeue();
+    stealWork(now, waitingForBatch);
+
+    emit loadChanged();
+}
+
+void DeviceManager::stealWork(qint64 now, const QVector<bool>& waitingForBatch)
+{
+    // 자기 모듈의 대기 작업이 없어 쉬는 다기능 장치는
+    // 처리할 수 있는 다른 모듈 중 대기열이 가장 긴 곳의 작업을 가져감
+    // (남은 대기열은 그 모듈 장치가 모두 바빠서 밀린 작업)
+    for (const QList<Device*>& moduleDevices : devices) {
+        for (Device* device : moduleDevices) {
+            if (device->getSkills().isEmpty() || !deviceAvailability.value(device, true) ||
+                retiringDevices.contains(device)) {
+                continue;
+            }
+            const int homeStep = config.indexOf(device->getModuleType());
+            if (homeStep >= 0 && waitingForBatch.at(homeStep)) {
+                continue;   // 자기 모듈의 배치를 기다리는 중
+            }
+
+            int longestStep = -1;
+            for (int step = 0; step < stepCount(); ++step) {
+                const QString module = getNextModule(step);
+                if (module == device->getModuleType() || !device->canProcess(module)) {
+                    continue;
+                }
+                if (!readyTasks[step].isEmpty() &&
+                    (longestStep < 0 || readyTasks[step].size() > readyTasks[longestStep].size())) {
+                    longestStep = step;
+                }
+            }
+            if (longestStep < 0) {
+                continue;
+            }
 
-        // 이미 처리 중인 주문인지 확인
-        if (processingOrders.contains(task.orderId)) {
-            continue;
+            const QString module = getNextModule(longestStep);
+            const QVector<SchedulingCandidate> batch =
+                schedulingPolicy->takeBatch(readyTasks[longestStep], now, device->getCapacity());
+            emit logMessage(QString("%1 장치 %2: %3 작업 지원 (대기 %4건)")
+                                .arg(device->getModuleType()).arg(device->getDeviceIndex())
+                                .arg(module).arg(readyTasks[longestStep].size() + batch.size()));
+            startBatch(device, batch, module);
         }
+    }
+}
 
-        Device* device = findAvailableDevice("Bread");
-        if (device) {
-            // 장치 할당 및 작업 시작
-            deviceAvailability[device] = false;
-            task.isProcessing = true;
-            processingOrders[task.orderId] = task;
+void DeviceManager::startBatch(Device* device, const QVector<SchedulingCandidate>& batch,
+                               const QString& module)
+{
+    // 장치 할당 및 작업 시작
+    deviceAvailability[device] = false;
 
-            emit deviceStatusChanged("Bread", device->getDeviceIndex(), DeviceStatus::ON, task.taskDetail);
-            emit logMessage(QString("주문 %1: %2 시작").arg(task.orderId).arg(task.taskDetail));
+    const qint64 now = clock->nowMs();
+    // 한 배치는 같은 재료이므로 처리 시간 배수도 같음
+    const int units = taskUnits(module, orders.details(batch.first().handle));
+    const int processingTimeMs = device->processingTimeFor(module) * units;
+    MetricHistogram* waitHistogram = queueWait.value(config.indexOf(module), nullptr);
+    const bool tracing = Tracer::enabled();
+    const QByteArray traceModule = tracing ? module.toUtf8() : QByteArray();
+    const qint64 nowUs = tracing ? MetricsRegistry::nowUs() : 0;
+    DeviceCommand command;
+    QVarLengthArray<int, 4>& orderIds = command.orderIds;
+    for (const SchedulingCandidate& candidate : batch) {
+        const qint64 waitedMs = qMax<qint64>(0, now - candidate.readyMs);
+        if (waitHistogram) {
+            waitHistogram->record(static_cast<quint64>(waitedMs) * 1000);
+        }
+        if (tracing) {
+            Tracer::instance().asyncSpan("queued", traceModule.constData(), candidate.orderId,
+                                         nowUs - waitedMs * 1000, nowUs);
+        }
+        if (orders.status(candidate.handle) == OrderStatus::WAITING) {
+            orders.setStatus(candidate.handle, OrderStatus::PROCESSING);
+        }
+        schedulingPolicy->taskDispatched(candidate, processingTimeMs);
+        orders.setProcessing(candidate.handle, true);
+        orders.touch(candidate.handle, now);
+        orderIds.append(candidate.orderId);
+    }
+
+    // 한 배치는 같은 재료이므로 작업 내용도 같음
+    const QString taskDetail = batch.first().batchKey;
+    QString statusDetail = taskDetail;
+    if (orderIds.size() > 1) {
+        statusDetail += QString(" x%1").arg(orderIds.size());
+    }
+
+    // 상태 표시는 장치 자신의 모듈 기준, 서버가 주문별 단계를 갱신하도록 주문마다 알림
+    for (int orderId : orderIds) {
+        emit deviceStatusChanged(device->getModuleType(), device->getDeviceIndex(), DeviceStatus::ON,
+                                 statusDetail, orderId);
+        logOrderEvent(LogEvent::TaskStarted, orderId, taskDetail);
+    }
+
+    // 장치 스레드를 기다리지 않고 명령 링에 넣기만 함 (처리 시간 예약은 submit 안에서 끝남)
+    command.taskDetail = taskDetail;
+    command.module = module;
+    command.units = units;
+    if (!device->submit(std::move(command))) {
+        emit logMessage(QString("%1 장치 %2의 명령 대기열이 가득 찼습니다")
+                            .arg(device->getModuleType()).arg(device->getDeviceIndex()));
+    }
+}
+
+bool DeviceManager::event(QEvent* event)
+{
+    if (event->type() == Device::completionEventType()) {
+        drainCompletions();
+        return true;
+    }
+    return QObject::event(event);
+}
+
+void DeviceManager::drainCompletions()
+{
+    // 완료 처리 중에 장치가 제거될 수 있으므로 모든 장치의 완료를 먼저 꺼낸 뒤 처리
+    // (완료를 기다리는 장치는 사용 중으로 남아 있어 제거되지 않음)
+    finishedWork.clear();
+    for (auto it = devices.constBegin(); it != devices.constEnd(); ++it) {
+        for (Device* device : it.value()) {
+            do {
+                DeviceCompletion completion;
+                while (device->takeCompletion(completion)) {
+                    finishedWork.append(qMakePair(device, completion));
+                }
+            } while (device->finishCompletions());
+        }
+    }
 
-            QMetaObject::invokeMethod(device, "processTask", Qt::QueuedConnection,
-                                      Q_ARG(int, task.orderId),
-                                      Q_ARG(QString, task.taskDetail));
+    for (const QPair<Device*, DeviceCompletion>& work : finishedWork) {
+        const DeviceCompletion& completion = work.second;
+        if (completion.orderIds.size() == 1) {
+            handleDeviceTaskCompleted(work.first, completion.module, completion.orderIds.first());
         } else {
-            // 사용 가능한 장치가 없으면 다시 큐에 추가
-            orderQueue.enqueue(task);
-            break;
+            QList<int> orderIds;
+            for (int orderId : completion.orderIds) {
+                orderIds.append(orderId);
+            }
+            handleDeviceBatchCompleted(work.first, completion.module, orderIds);
         }
     }
 }
@@ -126,26 +546,59 @@ void DeviceManager::assignNextTask()
 void DeviceManager::handleDeviceTaskCompleted(Device* device, const QString& module, int orderId)
 {
     // 장치 상태 업데이트
+    // module은 방금 끝난 작업의 모듈 (다기능 장치는 자기 모듈과 다를 수 있음)
+    Q_UNUSED(module);
+    deviceAvailability[device] = true;
+    emit deviceStatusChanged(device->getModuleType(), device->getDeviceIndex(), DeviceStatus::OFF, "", orderId);
+
+    advanceOrder(orderId);
+    removeRetiredDevices(device->getModuleType());
+
+    // 다음 작업 할당 시도
+    assignNextTask();
+}
+
+void DeviceManager::handleDeviceBatchCompleted(Device* device, const QString& module,
+                                               const QList<int>& orderIds)
+{
+    Q_UNUSED(module);
     deviceAvailability[device] = true;
-    emit deviceStatusChanged(module, device->getDeviceIndex(), DeviceStatus::OFF, "");
 
-    if (!processingOrders.contains(orderId)) {
+    for (int orderId : orderIds) {
+        emit deviceStatusChanged(device->getModuleType(), device->getDeviceIndex(), DeviceStatus::OFF, "", orderId);
+        advanceOrder(orderId);
+    }
+    removeRetiredDevices(device->getModuleType());
+
+    assignNextTask();
+}
+
+void DeviceManager::advanceOrder(int orderId)
+{
+    OrderHandle handle = orders.find(orderId);
+    if (handle.isNull()) {
         return;
     }
 
-    OrderTask& task = processingOrders[orderId];
-    task.isProcessing = false;
-    task.currentStep++;
+    const qint64 now = clock->nowMs();
+    const int nextStep = orders.step(handle) + 1;
+    orders.setProcessing(handle, false);
+    orders.setStep(handle, nextStep);
+    orders.touch(handle, now);
 
-    if (task.currentStep >= 4) {
+    if (nextStep >= stepCount()) {
         // 모든 단계 완료
-        emit logMessage(QString("주문 %1 완료").arg(orderId));
-        activeOrders.remove(orderId);
-        processingOrders.remove(orderId);
+        logOrderEvent(LogEvent::RobotOrderCompleted, orderId);
+        ordersCompleted->add();
+        const qint64 latencyMs = qMax<qint64>(0, now - orders.createdAt(handle));
+        orderLatency->record(static_cast<quint64>(latencyMs) * 1000);
+        if (Tracer::enabled()) {
+            const qint64 nowUs = MetricsRegistry::nowUs();
+            Tracer::instance().asyncSpan("order", "orders", orderId, nowUs - latencyMs * 1000, nowUs);
+        }
+        orders.remove(handle);
+        emit orderFinished(orderId);
     }
-
-    // 다음 작업 할당 시도
-    assignNextTask();
 }
 
 Device* DeviceManager::findAvailableDevice(const QString& module)
@@ -153,25 +606,42 @@ Device* DeviceManager::findAvailableDevice(const QString& module)
     if (!devices.contains(module)) return nullptr;
 
     for (Device* device : devices[module]) {
-        if (deviceAvailability.value(device, true)) {
+        if (deviceAvailability.value(device, true) && !retiringDevices.contains(device)) {
             return device;
         }
     }
     return nullptr;
 }
 
-QString DeviceManager::getNextModule(int currentStep)
+QString DeviceManager::getNextModule(int currentStep) const
+{
+    if (currentStep < 0 || currentStep >= stepCount()) {
+        return "";
+    }
+    return config.modules.at(currentStep).name;
+}
+
+int DeviceManager::taskUnits(const QString& module, const OrderDetails& order)
+{
+    // 치즈는 장마다, 잼은 종류마다 처리 시간이 늘고 없으면 장치를 거치기만 함
+    if (module == "Cheese")
+        return order.cheeses.size();
+    else if (module == "Jam")
+        return order.jams.size();
+    return 1;
+}
+
+qint64 DeviceManager::remainingWorkMs(int currentStep, const OrderDetails& order) const
 {
-    switch (currentStep) {
-    case 0: return "Bread";
-    case 1: return "Cheese";
-    case 2: return "Egg";
-    case 3: return "Jam";
-    default: return "";
+    qint64 total = 0;
+    for (int step = qMax(0, currentStep); step < stepCount(); ++step) {
+        const ModuleConfig& module = config.modules.at(step);
+        total += static_cast<qint64>(module.processingTimeMs) * taskUnits(module.name, order);
     }
+    return total;
 }
 
-QString DeviceManager::createTaskDetail(const QString& module, const OrderMessage& order)
+QString DeviceManager::createTaskDetail(const QString& module, const OrderDetails& order)
 {
     if (module == "Bread")
         return QString("빵 굽기: %1").arg(order.bread);
@@ -5,10 +5,19 @@
 #include <QObject>
 #include <QMap>
 #include <QQueue>
+#include <QScopedPointer>
+#include <QSet>
 #include <QThread>
 #include <QDebug>
+#include "binarylog.h"
+#include "clock.h"
 #include "device.h"
 #include "message.h"
+#include "metrics.h"
+#include "ordertable.h"
+#include "robotconfig.h"
+#include "schedulingpolicy.h"
+#include "tracer.h"
 
 class DeviceManager : public QObject
 {
@@ -16,43 +25,119 @@ class DeviceManager : public QObject
 
 public:
     explicit DeviceManager(QObject *parent = nullptr);
+    explicit DeviceManager(const RobotConfig& config, QObject *parent = nullptr);
+    // 장치 처리 시간과 배치 대기를 clock으로 재고 예약 (테스트에서는 ManualClock)
+    DeviceManager(const RobotConfig& config, Clock* clock, QObject *parent = nullptr);
     ~DeviceManager() override;
 
-    void processNewOrder(const OrderMessage& order);
+    // 장치 구성 (모듈 순서 = 조리 단계 순서)
+    QStringList moduleNames() const;
+    int deviceCount(const QString& module) const;
+
+    // 실행 중 장치 추가/제거 (보관 한도는 장치 수에 맞춰 다시 계산)
+    // 추가: 새 장치 번호 반환, 알 수 없는 모듈이면 0
+    // 제거: 번호가 가장 큰 장치부터, 작업 중이면 끝난 뒤 제거 (모듈의 마지막 장치는 제거 불가)
+    int addDevice(const QString& module, int processingTimeMs = 0);
+    bool removeDevice(const QString& module);
+
+    // 새 주문 수신 (보관 한도를 넘거나 중복이면 거절하고 false 반환)
+    bool processNewOrder(const OrderMessage& order);
+
+    // 흐름 제어: 로봇이 동시에 보관하는 주문 수 한도
+    int backlog() const { return orders.size(); }
+    int maxBacklog() const { return backlogLimit; }
+    void setMaxBacklog(int limit);
+
+    // 서버의 로봇 분배용 모듈별 부하 (received는 호출 측에서 채움)
+    RobotLoadMessage loadReport() const;
+
+    // 배치 대기 시간: 장치 용량보다 적게 모였을 때 같은 재료의 작업을 더 기다리는 최대 시간
+    // 0이면 기다리지 않고 그때 모인 만큼만 함께 처리
+    void setBatchWindowMs(int windowMs);
+    int batchWindowMs() const { return batchWindow; }
+    void setDeviceCapacity(const QString& module, int capacity);
+
+    // 스케줄링 정책 교체 (소유권 이전, nullptr이면 FIFO)
+    void setSchedulingPolicy(SchedulingPolicy* policy);
+    QString schedulingPolicyName() const;
+
+    // 주문마다 일어나는 이벤트(수신, 작업 시작, 완료)를 logMessage 문장으로도 보낼지 (기본 켬)
+    // 이진 로그에는 항상 기록하므로, 로그 창처럼 이진 로그에서 읽어 보여 주는 쪽은 꺼서 문장을 만들지 않게 함
+    void setOrderEventText(bool enabled) { orderEventText = enabled; }
+
+public slots:
+    // 서버에서 온 메시지 (NetworkManager::messageReceived에 직접 연결, 주문 외의 메시지는 무시)
+    // 화면을 거치지 않고 I/O 스레드가 넘긴 주문을 바로 배정
+    void handleServerMessage(const Message& message);
 
 signals:
+    // 서버에서 받은 주문마다 (accepted가 false면 보관 한도 초과나 중복으로 거절)
+    void orderReceived(int orderId, bool accepted);
     void deviceStatusChanged(const QString& module, int deviceIndex,
-                             DeviceStatus status, const QString& currentTask);
+                             DeviceStatus status, const QString& currentTask,
+                             int orderId = 0);
     void processingFinished(const QString& module, int deviceIndex, int orderId);
+    void orderFinished(int orderId);
+    void deviceAdded(const QString& module, int deviceIndex);
+    void deviceRemoved(const QString& module, int deviceIndex);
+    void loadChanged();     // 작업 배정이 끝날 때마다 (loadReport 갱신 시점)
     void logMessage(const QString& message);
 
-private slots:
-    void handleDeviceTaskCompleted(Device* device, const QString& module, int orderId);
+protected:
+    // 장치 완료 링의 깨우기 이벤트
+    bool event(QEvent* event) override;
 
 private:
-    struct OrderTask {
-        int orderId;
-        QString moduleType;
-        QString taskDetail;
-        bool isProcessing;
-        int currentStep;  // 0: Bread, 1: Cheese, 2: Egg, 3: Jam
-    };
-
     // 장치 관리
     QMap<QString, QList<Device*>> devices;
     QMap<Device*, QThread*> deviceThreads;
     QMap<Device*, bool> deviceAvailability;
+    QSet<Device*> retiringDevices;  // 작업이 끝나면 제거할 장치
+    RobotConfig config;
+    Clock* clock;
+    QVector<QPair<Device*, DeviceCompletion>> finishedWork;    // drainCompletions에서 재사용
+    bool orderEventText;
 
     // 작업 관리
-    QQueue<OrderTask> orderQueue;  // 이름 변경: taskQueue -> orderQueue
-    QMap<int, OrderMessage> activeOrders;
-    QMap<int, OrderTask> processingOrders;  // 현재 처리 중인 주문 추적
+    // 주문의 현재 단계(config.modules 순서)와 처리 여부는 테이블에 저장
+    // 아직 첫 단계를 시작하지 않은 주문은 WAITING 상태로 남아 있음
+    OrderTable orders;
+    int backlogLimit;
+    QScopedPointer<SchedulingPolicy> schedulingPolicy;
+    QVector<QVector<SchedulingCandidate>> readyTasks;   // 단계별 대기 작업 (assignNextTask에서 재사용)
+    int batchWindow;
+    quint64 batchTimerId;   // 배치 대기 시간이 끝나면 작업 배정을 다시 시도 (0이면 예약 없음)
+    qint64 batchDueMs;
+
+    // 지표 (시간은 마이크로초, 단계 순서)
+    QVector<MetricHistogram*> queueWait;    // 단계 준비 -> 장치 시작
+    QVector<MetricGauge*> queueDepth;       // 장치를 기다리는 작업 수
+    MetricHistogram* orderLatency;          // 주문 수신 -> 모든 단계 완료
+    MetricCounter* ordersCompleted;
+    MetricCounter* ordersRejected;
+    MetricGauge* backlogGauge;
 
     void initializeDevices();
+    Device* createDevice(const ModuleConfig& moduleConfig, int deviceIndex, int processingTimeMs);
+    void destroyDevice(Device* device);
+    void updateBacklogLimit();
     void assignNextTask();
     Device* findAvailableDevice(const QString& module);
-    QString getNextModule(int currentStep);
-    QString createTaskDetail(const QString& module, const OrderMessage& order);
+    void stealWork(qint64 now, const QVector<bool>& waitingForBatch);
+    void startBatch(Device* device, const QVector<SchedulingCandidate>& batch, const QString& module);
+    void drainCompletions();
+    void handleDeviceTaskCompleted(Device* device, const QString& module, int orderId);
+    void handleDeviceBatchCompleted(Device* device, const QString& module, const QList<int>& orderIds);
+    void advanceOrder(int orderId);
+    template <typename... Args>
+    void logOrderEvent(LogEvent event, const Args&... args);
+    void removeRetiredDevices(const QString& module);
+    int stepCount() const { return config.modules.size(); }
+    QString getNextModule(int currentStep) const;
+    // 주문의 재료에 따른 단계 처리 시간 배수와 남은 처리 시간 합 (SRPT용)
+    static int taskUnits(const QString& module, const OrderDetails& order);
+    qint64 remainingWorkMs(int currentStep, const OrderDetails& order) const;
+    QString createTaskDetail(const QString& module, const OrderDetails& order);
 };
 
 #endif //DEVICEMANAGER_H
@@ -0,0 +1,403 @@
+// devicestatesync.cpp
+#include "devicestatesync.h"
+
+namespace {
+
+enum FieldBits : quint8 {
+    StatusField = 1,
+    TaskField = 2,
+    OrderField = 4,
+    AllFields = StatusField | TaskField | OrderField
+};
+
+const int FieldMaskBits = 3;
+const int StatusBits = 2;
+
+// 0..count-1을 담는 데 필요한 비트 수 (하나뿐이면 0비트)
+int bitsFor(int count)
+{
+    int bits = 0;
+    while ((1 << bits) < count) {
+        bits++;
+    }
+    return bits;
+}
+
+quint64 zigzag(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+qint64 unzigzag(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+class BitWriter
+{
+public:
+    void write(quint32 value, int bits)
+    {
+        if (bits == 0) {
+            return;
+        }
+        accumulator |= (static_cast<quint64>(value) & ((Q_UINT64_C(1) << bits) - 1)) << filled;
+        filled += bits;
+        while (filled >= 8) {
+            bytes.append(static_cast<char>(accumulator & 0xff));
+            accumulator >>= 8;
+            filled -= 8;
+        }
+    }
+
+    void writeVarint(quint64 value)
+    {
+        while (value >= 0x80) {
+            write(static_cast<quint32>((value & 0x7f) | 0x80), 8);
+            value >>= 7;
+        }
+        write(static_cast<quint32>(value), 8);
+    }
+
+    QByteArray finish()
+    {
+        if (filled > 0) {
+            bytes.append(static_cast<char>(accumulator & 0xff));
+            accumulator = 0;
+            filled = 0;
+        }
+        return bytes;
+    }
+
+private:
+    QByteArray bytes;
+    quint64 accumulator = 0;
+    int filled = 0;
+};
+
+class BitReader
+{
+public:
+    explicit BitReader(const QByteArray& bytes) : bytes(bytes) {}
+
+    bool read(int bits, quint32& value)
+    {
+        if (position + bits > bytes.size() * 8) {
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < bits; ++i, ++position) {
+            const quint32 bit = (static_cast<quint8>(bytes.at(position >> 3)) >> (position & 7)) & 1;
+            value |= bit << i;
+        }
+        return true;
+    }
+
+    bool readVarint(quint64& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            quint32 group = 0;
+            if (!read(8, group)) {
+                return false;
+            }
+            value |= static_cast<quint64>(group & 0x7f) << shift;
+            if ((group & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    const QByteArray& bytes;
+    int position = 0;
+};
+
+QString deviceName(const QString& module, int deviceIndex)
+{
+    return module + QLatin1Char('/') + QString::number(deviceIndex);
+}
+
+} // namespace
+
+DeviceStateEncoder::DeviceStateEncoder(int keyframeInterval)
+    : keyframeInterval(keyframeInterval)
+    , sequence(0)
+    , messagesSinceKeyframe(0)
+    , keyframeRequested(true)
+    , sentDevices(0)
+    , sentTasks(0)
+{
+}
+
+void DeviceStateEncoder::update(const DeviceStatusMessage& status)
+{
+    const QString name = deviceName(status.moduleType, status.deviceIndex);
+    int device = deviceIds.value(name, -1);
+    if (device < 0) {
+        device = deviceNames.size();
+        deviceIds.insert(name, device);
+        deviceNames.append(name);
+        sentStates.append(State());
+        latestStates.append(State());
+    }
+
+    State& latest = latestStates[device];
+    Change change;
+    change.device = device;
+    change.fields = 0;
+    if (status.status != latest.status) {
+        change.fields |= StatusField;
+    }
+    if (status.currentTask != latest.task) {
+        change.fields |= TaskField;
+    }
+    if (status.orderId != latest.orderId) {
+        change.fields |= OrderField;
+    }
+    latest.status = status.status;
+    latest.task = status.currentTask;
+    latest.orderId = status.orderId;
+    change.state = latest;
+    pending.append(change);
+}
+
+int DeviceStateEncoder::internTask(const QString& task)
+{
+    auto it = taskIds.constFind(task);
+    if (it != taskIds.constEnd()) {
+        return it.value();
+    }
+    const int id = taskNames.size();
+    taskIds.insert(task, id);
+    taskNames.append(task);
+    return id;
+}
+
+DeviceStateSyncMessage DeviceStateEncoder::takeMessage()
+{
+    DeviceStateSyncMessage message;
+    message.sequence = ++sequence;
+    message.keyframe = keyframeRequested || messagesSinceKeyframe >= keyframeInterval ||
+                       taskNames.size() > MaxTaskNames;
+
+    if (message.keyframe) {
+        // 작업 표는 지금 쓰는 것만으로 다시 만들어 크기를 제한함
+        taskIds.clear();
+        taskNames.clear();
+        internTask(QString());
+        sentTasks = 1;
+        sentDevices = 0;
+        for (const State& state : sentStates) {
+            internTask(state.task);
+        }
+    }
+    for (const Change& change : pending) {
+        internTask(change.state.task);
+    }
+    message.devices = deviceNames.mid(sentDevices);
+    message.tasks = taskNames.mid(sentTasks);
+    message.count = pending.size();
+
+    const int deviceBits = bitsFor(deviceNames.size());
+    const int taskBits = bitsFor(taskNames.size());
+    BitWriter writer;
+    qint64 previousOrderId = 0;
+    auto writeState = [&](const State& state, quint8 fields) {
+        if (fields & StatusField) {
+            writer.write(static_cast<quint32>(state.status), StatusBits);
+        }
+        if (fields & TaskField) {
+            writer.write(static_cast<quint32>(taskIds.value(state.task)), taskBits);
+        }
+        if (fields & OrderField) {
+            writer.writeVarint(zigzag(state.orderId - previousOrderId));
+            previousOrderId = state.orderId;
+        }
+    };
+
+    if (message.keyframe) {
+        for (const State& state : sentStates) {
+            writeState(state, AllFields);
+        }
+    }
+    for (const Change& change : pending) {
+        writer.write(static_cast<quint32>(change.device), deviceBits);
+        writer.write(change.fields, FieldMaskBits);
+        writeState(change.state, change.fields);
+    }
+    message.records = writer.finish();
+
+    sentDevices = deviceNames.size();
+    sentTasks = taskNames.size();
+    sentStates = latestStates;
+    pending.clear();
+    messagesSinceKeyframe = message.keyframe ? 0 : messagesSinceKeyframe + 1;
+    keyframeRequested = false;
+    return message;
+}
+
+void DeviceStateEncoder::reset()
+{
+    // 이전 연결에 보내려던 변경은 버리고 현재 상태를 키프레임으로 알림
+    pending.clear();
+    sentStates = latestStates;
+    sequence = 0;
+    messagesSinceKeyframe = 0;
+    keyframeRequested = true;
+}
+
+void DeviceStateEncoder::collapsePending()
+{
+    // 주문이 없는 변경은 키프레임 상태로 접고, 주문이 붙은 변경부터는 순서대로 남김
+    // 키프레임은 장치마다 남긴 첫 변경 바로 앞 상태를 실어 받는 쪽이 같은 전환을 두 번 보지 않게 함
+    QVector<State> before = sentStates;
+    QVector<State> baseline = latestStates;
+    QVector<bool> kept(deviceNames.size(), false);
+    QVector<Change> orderChanges;
+    for (Change change : pending) {
+        const int device = change.device;
+        if (!kept.at(device) && change.state.orderId != 0) {
+            kept[device] = true;
+            baseline[device] = before.at(device);
+        }
+        if (kept.at(device)) {
+            // 앞의 변경을 버렸으므로 필드는 모두 실음
+            change.fields = AllFields;
+            orderChanges.append(change);
+        }
+        before[device] = change.state;
+    }
+    pending.swap(orderChanges);
+    sentStates = baseline;
+    keyframeRequested = true;
+}
+
+DeviceStateDecoder::DeviceStateDecoder()
+    : synchronized(false)
+    , lastSequence(0)
+{
+}
+
+bool DeviceStateDecoder::decode(const DeviceStateSyncMessage& message, QVector<DeviceStatusMessage>& changes,
+                                QString& errorMessage)
+{
+    if (!message.keyframe) {
+        if (!synchronized) {
+            errorMessage = QString("키프레임 전의 장치 상태 변경분을 버립니다 (메시지 %1)").arg(message.sequence);
+            return false;
+        }
+        if (message.sequence != lastSequence + 1) {
+            synchronized = false;
+            errorMessage = QString("장치 상태 메시지 %1이(가) 빠졌습니다. 다음 키프레임까지 변경분을 버립니다")
+                               .arg(lastSequence + 1);
+            return false;
+        }
+    }
+
+    // 키프레임은 이름 표를 새로 받음 (이전 상태는 달라진 장치를 찾는 데만 씀)
+    QHash<QString, int> previousIds;
+    QVector<DeviceStatusMessage> previous;
+    if (message.keyframe) {
+        previous.swap(devices);
+        for (int i = 0; i < previous.size(); ++i) {
+            previousIds.insert(deviceName(previous.at(i).moduleType, previous.at(i).deviceIndex), i);
+        }
+        taskNames = QStringList() << QString();
+    }
+
+    auto fail = [&](const QString& reason) {
+        synchronized = false;
+        errorMessage = QString("장치 상태 메시지 %1을(를) 풀 수 없습니다: %2").arg(message.sequence).arg(reason);
+        return false;
+    };
+
+    for (const QString& name : message.devices) {
+        const int separator = name.lastIndexOf(QLatin1Char('/'));
+        bool ok = false;
+        DeviceStatusMessage device;
+        device.moduleType = name.left(separator);
+        device.deviceIndex = separator > 0 ? name.mid(separator + 1).toInt(&ok) : 0;
+        if (!ok) {
+            return fail(QString("장치 이름 '%1'").arg(name));
+        }
+        device.status = DeviceStatus::OFF;
+        device.orderId = 0;
+        devices.append(device);
+    }
+    taskNames += message.tasks;
+
+    const int deviceBits = bitsFor(devices.size());
+    const int taskBits = bitsFor(taskNames.size());
+    BitReader reader(message.records);
+    qint64 previousOrderId = 0;
+    auto readState = [&](DeviceStatusMessage& state, quint32 fields) {
+        quint32 value = 0;
+        if (fields & StatusField) {
+            if (!reader.read(StatusBits, value) || value > static_cast<quint32>(DeviceStatus::ERROR)) {
+                return false;
+            }
+            state.status = static_cast<DeviceStatus>(value);
+        }
+        if (fields & TaskField) {
+            if (!reader.read(taskBits, value) || value >= static_cast<quint32>(taskNames.size())) {
+                return false;
+            }
+            state.currentTask = taskNames.at(static_cast<int>(value));
+        }
+        if (fields & OrderField) {
+            quint64 encoded = 0;
+            if (!reader.readVarint(encoded)) {
+                return false;
+            }
+            previousOrderId += unzigzag(encoded);
+            state.orderId = static_cast<int>(previousOrderId);
+        }
+        return true;
+    };
+
+    const int firstChange = changes.size();
+    if (message.keyframe) {
+        for (DeviceStatusMessage& device : devices) {
+            if (!readState(device, AllFields)) {
+                changes.resize(firstChange);
+                return fail("키프레임 상태가 잘립니다");
+            }
+            // 재동기화: 알던 장치 중 놓친 변경이 있는 것만 알림
+            auto it = previousIds.constFind(deviceName(device.moduleType, device.deviceIndex));
+            if (it != previousIds.constEnd()) {
+                const DeviceStatusMessage& before = previous.at(it.value());
+                if (before.status != device.status || before.currentTask != device.currentTask ||
+                    before.orderId != device.orderId) {
+                    changes.append(device);
+                }
+            }
+        }
+    }
+
+    for (int i = 0; i < message.count; ++i) {
+        quint32 device = 0;
+        quint32 fields = 0;
+        if (!reader.read(deviceBits, device) || device >= static_cast<quint32>(devices.size()) ||
+            !reader.read(FieldMaskBits, fields)) {
+            changes.resize(firstChange);
+            return fail(QString("변경 기록 %1").arg(i));
+        }
+        DeviceStatusMessage& state = devices[static_cast<int>(device)];
+        if (!readState(state, fields)) {
+            changes.resize(firstChange);
+            return fail(QString("변경 기록 %1").arg(i));
+        }
+        changes.append(state);
+    }
+
+    synchronized = true;
+    lastSequence = message.sequence;
+    return true;
+}
+
+QVector<DeviceStatusMessage> DeviceStateDecoder::snapshot() const
+{
+    return devices;
+}
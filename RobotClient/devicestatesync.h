@@ -0,0 +1,103 @@
+// devicestatesync.h
+#ifndef DEVICESTATESYNC_H
+#define DEVICESTATESYNC_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "message.h"
+
+// 장치 상태 동기화 (DEVICE_STATE_SYNC)
+// DeviceStatusMessage는 바뀔 때마다 모듈 이름, 번호, 상태, 작업 문장을 모두 보내므로 장치가 많으면 대부분 중복입니다.
+// 보내는 쪽은 장치/작업 이름을 표에 한 번만 올리고, 이후에는 바뀐 필드만 비트 단위로 붙여 보냅니다.
+//
+// 기록 형식 (LSB부터 채움, 폭은 메시지의 표 크기로 정해짐):
+//   키프레임 상태: 장치 ID 순서대로 [상태 2비트][작업 ID][주문 ID 변화량] (장치 ID는 생략)
+//   변경 기록:     [장치 ID][바뀐 필드 3비트][상태 2비트][작업 ID][주문 ID 변화량] (바뀐 필드만)
+// 주문 ID 변화량은 메시지 안에서 바로 앞에 쓴 주문 ID와의 차이를 zigzag 후 7비트 단위 varint로 씁니다.
+// 작업 ID 0은 빈 작업("")이며 표에 싣지 않습니다.
+
+// 로봇 쪽: 장치 상태 변경을 모아 동기화 메시지로 만듦
+// 변경은 같은 장치라도 합치지 않고 순서대로 모두 보냅니다 (서버는 변경마다 주문 단계를 갱신).
+class DeviceStateEncoder
+{
+public:
+    static const int DefaultKeyframeInterval = 100;     // 변경분 메시지 이만큼마다 키프레임
+    static const int MaxTaskNames = 256;                // 작업 표가 이보다 커지면 키프레임에서 다시 만듦
+
+    explicit DeviceStateEncoder(int keyframeInterval = DefaultKeyframeInterval);
+
+    void update(const DeviceStatusMessage& status);
+    bool hasPending() const { return !pending.isEmpty() || keyframeRequested; }
+    int pendingCount() const { return pending.size(); }
+
+    // 모은 변경을 메시지 하나로 만듦 (첫 메시지, 요청했을 때, keyframeInterval마다 키프레임)
+    DeviceStateSyncMessage takeMessage();
+    // 다음 메시지를 키프레임으로 (받는 쪽의 재동기화용)
+    void requestKeyframe() { keyframeRequested = true; }
+    // 새 연결: 이름 표와 번호를 처음부터 다시 보냄 (장치 상태는 유지)
+    void reset();
+    // 주문이 없는 변경을 버리고 다음 메시지를 키프레임으로 (전송이 오래 밀렸을 때 메모리 제한)
+    // 주문이 붙은 변경은 서버가 주문 단계를 옮기는 데 쓰므로 버리지 않고 순서대로 남김
+    void collapsePending();
+
+private:
+    struct State {
+        DeviceStatus status = DeviceStatus::OFF;
+        QString task;
+        int orderId = 0;
+    };
+    struct Change {
+        int device;
+        quint8 fields;
+        State state;
+    };
+
+    int keyframeInterval;
+    int sequence;
+    int messagesSinceKeyframe;
+    bool keyframeRequested;
+
+    // 장치 표 (한 번 정한 ID는 연결이 끊길 때까지 유지)
+    QHash<QString, int> deviceIds;
+    QStringList deviceNames;
+    int sentDevices;                // 받는 쪽이 아는 장치 수
+    QVector<State> sentStates;      // 받는 쪽이 마지막 메시지까지 적용한 상태
+    QVector<State> latestStates;    // pending까지 적용한 상태
+
+    // 작업 표 (0번은 빈 작업)
+    QHash<QString, int> taskIds;
+    QStringList taskNames;
+    int sentTasks;
+
+    QVector<Change> pending;
+
+    int internTask(const QString& task);
+};
+
+// 서버 쪽: 연결 하나의 동기화 메시지를 풀어 장치 상태 변경으로 되돌림
+class DeviceStateDecoder
+{
+public:
+    DeviceStateDecoder();
+
+    // 메시지의 변경 기록을 순서대로 changes에 추가
+    // 키프레임은 이미 알던 장치 중 상태가 달라진 것만 변경으로 내보냄 (처음 보는 장치는 기록만)
+    // 키프레임 전이거나 번호가 빠진 변경분은 다음 키프레임까지 버리고 false
+    bool decode(const DeviceStateSyncMessage& message, QVector<DeviceStatusMessage>& changes,
+                QString& errorMessage);
+
+    bool isSynchronized() const { return synchronized; }
+    int deviceCount() const { return devices.size(); }
+    // 알고 있는 모든 장치의 현재 상태 (장치 ID 순)
+    QVector<DeviceStatusMessage> snapshot() const;
+
+private:
+    bool synchronized;
+    int lastSequence;
+    QVector<DeviceStatusMessage> devices;   // 장치 ID별 현재 상태
+    QStringList taskNames;                  // 0번은 빈 작업
+};
+
+#endif // DEVICESTATESYNC_H
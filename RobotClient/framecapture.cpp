@@ -0,0 +1,195 @@
+// framecapture.cpp
+#include "framecapture.h"
+#include "metrics.h"
+#include <QDateTime>
+#include <cstring>
+
+namespace {
+
+const char CaptureMagic[4] = { 'R', 'C', 'A', 'P' };
+
+} // namespace
+
+FrameCaptureWriter::FrameCaptureWriter()
+    : frames(0)
+{
+}
+
+FrameCaptureWriter::~FrameCaptureWriter()
+{
+    close();
+}
+
+bool FrameCaptureWriter::open(const QString& path, QString& errorMessage)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QString("캡처 파일을 열 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+
+    stream.setDevice(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setByteOrder(QDataStream::BigEndian);
+    stream.writeRawData(CaptureMagic, sizeof(CaptureMagic));
+    stream << FormatVersion << QDateTime::currentMSecsSinceEpoch();
+    frames = 0;
+
+    if (stream.status() != QDataStream::Ok) {
+        errorMessage = QString("캡처 파일에 쓸 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        close();
+        return false;
+    }
+    return true;
+}
+
+void FrameCaptureWriter::close()
+{
+    if (!file.isOpen()) {
+        return;
+    }
+    stream.setDevice(nullptr);
+    file.close();
+}
+
+bool FrameCaptureWriter::write(const CapturedFrame& frame)
+{
+    if (!file.isOpen()) {
+        return false;
+    }
+
+    stream << frame.timestampUs
+           << static_cast<quint8>(frame.direction)
+           << static_cast<quint32>(frame.connectionId)
+           << static_cast<quint32>(frame.payload.size());
+    stream.writeRawData(frame.payload.constData(), frame.payload.size());
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+    frames++;
+    return true;
+}
+
+FrameCaptureReader::FrameCaptureReader()
+    : startedAt(0)
+{
+}
+
+bool FrameCaptureReader::open(const QString& path, QString& errorMessage)
+{
+    close();
+
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("캡처 파일을 열 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+
+    stream.setDevice(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream.setByteOrder(QDataStream::BigEndian);
+
+    char magic[sizeof(CaptureMagic)];
+    quint16 version = 0;
+    if (stream.readRawData(magic, sizeof(magic)) != static_cast<int>(sizeof(magic)) ||
+        std::memcmp(magic, CaptureMagic, sizeof(magic)) != 0) {
+        errorMessage = QString("캡처 파일 형식이 아닙니다: %1").arg(path);
+        close();
+        return false;
+    }
+    stream >> version >> startedAt;
+    if (stream.status() != QDataStream::Ok || version != FrameCaptureWriter::FormatVersion) {
+        errorMessage = QString("지원하지 않는 캡처 파일 버전입니다: %1 (버전 %2)").arg(path).arg(version);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void FrameCaptureReader::close()
+{
+    if (file.isOpen()) {
+        stream.setDevice(nullptr);
+        file.close();
+    }
+    error.clear();
+}
+
+bool FrameCaptureReader::next(CapturedFrame& frame)
+{
+    if (!file.isOpen() || stream.atEnd()) {
+        return false;
+    }
+
+    quint8 direction = 0;
+    quint32 connectionId = 0;
+    quint32 size = 0;
+    stream >> frame.timestampUs >> direction >> connectionId >> size;
+    if (stream.status() != QDataStream::Ok || size > MaxPayloadBytes) {
+        error = QString("캡처 파일의 프레임 머리말이 잘렸거나 손상되었습니다 (위치 %1)").arg(file.pos());
+        return false;
+    }
+
+    frame.direction = direction == static_cast<quint8>(CapturedFrame::Direction::Outgoing)
+                          ? CapturedFrame::Direction::Outgoing
+                          : CapturedFrame::Direction::Incoming;
+    frame.connectionId = static_cast<int>(connectionId);
+    frame.payload.resize(static_cast<int>(size));
+    if (stream.readRawData(frame.payload.data(), static_cast<int>(size)) != static_cast<int>(size)) {
+        error = QString("캡처 파일의 프레임 본문이 잘렸습니다 (위치 %1)").arg(file.pos());
+        return false;
+    }
+    return true;
+}
+
+FrameRecorder& FrameRecorder::instance()
+{
+    static FrameRecorder recorder;
+    return recorder;
+}
+
+FrameRecorder::FrameRecorder()
+    : recording(false)
+    , startedUs(0)
+{
+}
+
+bool FrameRecorder::start(const QString& path, QString& errorMessage)
+{
+    QMutexLocker locker(&mutex);
+    if (!writer.open(path, errorMessage)) {
+        recording.store(false, std::memory_order_relaxed);
+        return false;
+    }
+    startedUs = MetricsRegistry::nowUs();
+    recording.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void FrameRecorder::stop()
+{
+    QMutexLocker locker(&mutex);
+    recording.store(false, std::memory_order_relaxed);
+    writer.close();
+}
+
+void FrameRecorder::record(CapturedFrame::Direction direction, int connectionId, const QByteArray& payload)
+{
+    if (!isRecording()) {
+        return;
+    }
+
+    CapturedFrame frame;
+    frame.direction = direction;
+    frame.connectionId = connectionId;
+    frame.payload = payload;    // 암시적 공유라 복사 비용 없음
+
+    QMutexLocker locker(&mutex);
+    if (!writer.isOpen()) {
+        return;
+    }
+    frame.timestampUs = MetricsRegistry::nowUs() - startedUs;
+    writer.write(frame);
+}
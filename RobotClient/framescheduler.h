@@ -0,0 +1,47 @@
+// framescheduler.h
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <QByteArray>
+#include <QQueue>
+#include "message.h"
+
+// 연결 하나의 보내기 대기열을 레인별로 나눠 두고 다음에 보낼 본문을 고르는 스케줄러
+// 제어 레인은 항상 먼저 나갑니다. 나머지 레인도 앞쪽이 먼저지만, 기다리는 뒤쪽 레인이
+// 앞 레인에 MaxPassedOver번 밀리면 한 번 먼저 보내서 대량 전송도 멈추지 않습니다.
+// NetworkWorker는 소켓(또는 공유 메모리 링)에 SendWindowBytes까지만 넘기고 나머지는 여기 두므로,
+// 나중에 들어온 제어 메시지가 앞서 쌓인 대량 전송 뒤에서 기다리는 양은 그 창 크기로 제한됩니다.
+class FrameScheduler
+{
+public:
+    static const int LaneCount = 4;
+
+    struct Frame {
+        QByteArray payload;
+        MessageLane lane = MessageLane::ORDERS;
+        qint64 queuedUs = 0;        // 레인에 들어온 시각 (대기 시간 지표)
+    };
+
+    FrameScheduler();
+
+    void push(MessageLane lane, const QByteArray& payload, qint64 nowUs);
+    // 다음에 보낼 본문 (비어 있으면 false)
+    bool pop(Frame& frame);
+    void clear();
+
+    bool isEmpty() const { return frames == 0; }
+    int queuedFrames() const { return frames; }
+    int queuedFrames(MessageLane lane) const;
+    qint64 queuedBytes() const { return bytes; }
+
+private:
+    // 기다리는 레인이 앞 레인에 밀려도 되는 횟수 (제어 레인이 비어 있을 때만 적용)
+    static const int MaxPassedOver[LaneCount];
+
+    QQueue<Frame> lanes[LaneCount];
+    int passedOver[LaneCount];
+    int frames;
+    qint64 bytes;
+};
+
+#endif // FRAMESCHEDULER_H
@@ -1,10 +1,102 @@
 #include "robotcontrolgui.h"
+#include "binarylog.h"
+#include "framecapture.h"
+#include "logging.h"
+#include "metricsserver.h"
+#include "networkmanager.h"
+#include "tracer.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFileInfo>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    RobotControlGUI w;
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption configOption("config", "장치 구성 파일 (JSON)", "path",
+                                    QApplication::applicationDirPath() + "/robot_config.json");
+    parser.addOption(configOption);
+    QCommandLineOption metricsPortOption("metrics-port", "지표(Prometheus) HTTP 포트, 0이면 사용 안 함", "port", "0");
+    parser.addOption(metricsPortOption);
+    QCommandLineOption traceOption("trace", "종료 시 주문/장치 타임라인을 Chrome trace JSON으로 저장", "path");
+    parser.addOption(traceOption);
+    QCommandLineOption captureOption("capture", "송수신 프레임을 캡처 파일로 기록 (ReplayTool로 재생)", "path");
+    parser.addOption(captureOption);
+    QCommandLineOption logLevelOption("log-level", "로그 수준: debug|info|warning|critical|off, 분류별로는 network=debug,device=warning", "level", "info");
+    parser.addOption(logLevelOption);
+    QCommandLineOption binaryLogOption("binary-log", "주문/장치 이벤트를 이진 로그로 기록할 폴더 (LogDecoder로 읽음)", "dir");
+    parser.addOption(binaryLogOption);
+    QCommandLineOption tcpOnlyOption("tcp-only", "같은 호스트 연결도 공유 메모리 대신 TCP로 통신");
+    parser.addOption(tcpOnlyOption);
+    QCommandLineOption fullStatusOption("full-status", "장치 상태를 변경분 압축 없이 변경마다 전체로 전송 (이전 서버와 호환)");
+    parser.addOption(fullStatusOption);
+    parser.process(a);
+
+    Logging::install();
+    if (parser.isSet(tcpOnlyOption)) {
+        NetworkManager::setLocalTransportEnabled(false);
+    }
+    QString logError;
+    if (!Logging::applyLevelSpec(parser.value(logLevelOption), logError)) {
+        qWarning().noquote() << logError;
+    }
+
+    // 설정 파일이 없거나 잘못되면 기본 구성(모듈당 장치 2대)으로 시작
+    RobotConfig config = RobotConfig::defaults();
+    const QString configPath = parser.value(configOption);
+    if (parser.isSet(configOption) || QFileInfo::exists(configPath)) {
+        QString error;
+        if (!RobotConfig::loadFile(configPath, config, error)) {
+            qWarning().noquote() << error << "- 기본 장치 구성을 사용합니다";
+        }
+    }
+
+    // 추적은 켜 둔 동안 스레드별 버퍼에 모았다가 종료할 때 한 번에 기록
+    const QString tracePath = parser.value(traceOption);
+    if (!tracePath.isEmpty()) {
+        Tracer::instance().setEnabled(true);
+        QObject::connect(&a, &QCoreApplication::aboutToQuit, [tracePath]() {
+            QString error;
+            if (!Tracer::instance().writeChromeTrace(tracePath, error)) {
+                qWarning().noquote() << error;
+            }
+        });
+    }
+
+    // 이진 로그는 전용 스레드가 순환 파일에 씀 (폴더를 주지 않으면 로그 창용으로만 동작)
+    BinaryLogSettings binaryLogSettings;
+    binaryLogSettings.directory = parser.value(binaryLogOption);
+    binaryLogSettings.baseName = "robot";
+    QString binaryLogError;
+    if (!BinaryLogger::instance().start(binaryLogSettings, binaryLogError)) {
+        qWarning().noquote() << binaryLogError;
+    }
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, []() { BinaryLogger::instance().stop(); });
+
+    const QString capturePath = parser.value(captureOption);
+    if (!capturePath.isEmpty()) {
+        QString error;
+        if (FrameRecorder::instance().start(capturePath, error)) {
+            QObject::connect(&a, &QCoreApplication::aboutToQuit, []() { FrameRecorder::instance().stop(); });
+        } else {
+            qWarning().noquote() << error;
+        }
+    }
+
+    // 지표 수신기는 전용 스레드에서 동작하므로 장치 처리와 독립적
+    MetricsServer metricsServer;
+    QObject::connect(&metricsServer, &MetricsServer::logMessage,
+                     [](const QString& message) { qInfo().noquote() << message; });
+    const quint16 metricsPort = static_cast<quint16>(parser.value(metricsPortOption).toUInt());
+    if (metricsPort != 0) {
+        metricsServer.start(metricsPort);
+    }
+
+    RobotControlGUI w(config);
+    w.setDeviceStateSync(!parser.isSet(fullStatusOption));
     w.show();
     return a.exec();
 }
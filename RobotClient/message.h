@@ -5,15 +5,40 @@
 #include <QString>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QVector>
 
 // 메시지 타입 정의
 enum class MessageType {
     ORDER_NEW,              // 새로운 주문
     ORDER_STATUS_UPDATE,    // 주문 상태 업데이트
     DEVICE_STATUS_UPDATE,   // 장치 상태 업데이트
-    ERROR_REPORT           // 에러 보고
+    ERROR_REPORT,          // 에러 보고
+    FLOW_CONTROL,          // 로봇 수용 가능 주문 수 (크레딧) 통지
+    ROBOT_LOAD,            // 로봇 모듈별 부하 보고
+    TRANSPORT_SWITCH,      // 같은 호스트 연결의 공유 메모리 전송 전환 (NetworkManager 내부용)
+    SUBSCRIBE,             // 읽기 전용 화면의 주제 구독 요청
+    PUBLISH,               // 구독한 주제의 상태 발행
+    DEVICE_STATE_SYNC      // 장치 상태 동기화 (키프레임 + 비트 압축 변경분)
 };
 
+// 로그/추적에 쓰는 메시지 종류 이름
+inline const char* messageTypeName(MessageType type)
+{
+    switch (type) {
+    case MessageType::ORDER_NEW: return "ORDER_NEW";
+    case MessageType::ORDER_STATUS_UPDATE: return "ORDER_STATUS_UPDATE";
+    case MessageType::DEVICE_STATUS_UPDATE: return "DEVICE_STATUS_UPDATE";
+    case MessageType::ERROR_REPORT: return "ERROR_REPORT";
+    case MessageType::FLOW_CONTROL: return "FLOW_CONTROL";
+    case MessageType::ROBOT_LOAD: return "ROBOT_LOAD";
+    case MessageType::TRANSPORT_SWITCH: return "TRANSPORT_SWITCH";
+    case MessageType::SUBSCRIBE: return "SUBSCRIBE";
+    case MessageType::PUBLISH: return "PUBLISH";
+    case MessageType::DEVICE_STATE_SYNC: return "DEVICE_STATE_SYNC";
+    }
+    return "UNKNOWN";
+}
+
 // 주문 상태 정의
 enum class OrderStatus {
     WAITING,        // 대기 중
@@ -22,6 +47,20 @@ enum class OrderStatus {
     ERROR          // 에러
 };
 
+// 주문 우선순위 등급
+enum class OrderPriority {
+    LOW,            // 낮음
+    NORMAL,         // 보통
+    HIGH            // 급함
+};
+
+// 주문 채널
+enum class OrderChannel {
+    DINE_IN,        // 매장
+    TAKEOUT,        // 포장
+    DELIVERY        // 배달
+};
+
 // 장치 상태 정의
 enum class DeviceStatus {
     OFF,           // 꺼짐
@@ -49,6 +88,49 @@ struct Message {
     }
 };
 
+// 연결 하나를 나눠 쓰는 보내기 레인 (앞쪽일수록 먼저 보냄, FrameScheduler 참고)
+// 같은 레인 안에서는 보낸 순서가 유지되지만 레인끼리는 순서가 바뀔 수 있습니다.
+enum class MessageLane {
+    CONTROL,        // 흐름 제어, 거절/에러 보고, 전송 전환, 구독 요청, 급한 주문
+    ORDERS,         // 주문 전송과 주문 상태
+    STATUS,         // 장치/부하 상태와 구독 발행
+    BULK            // 기록 묶음처럼 크고 급하지 않은 본문 (종류로는 정하지 않고 보내는 쪽이 지정)
+};
+
+inline const char* messageLaneName(MessageLane lane)
+{
+    switch (lane) {
+    case MessageLane::CONTROL: return "control";
+    case MessageLane::ORDERS: return "orders";
+    case MessageLane::STATUS: return "status";
+    case MessageLane::BULK: return "bulk";
+    }
+    return "unknown";
+}
+
+// 메시지 종류로 정하는 기본 레인
+inline MessageLane messageLane(const Message& message)
+{
+    switch (message.type) {
+    case MessageType::FLOW_CONTROL:
+    case MessageType::ERROR_REPORT:
+    case MessageType::TRANSPORT_SWITCH:
+    case MessageType::SUBSCRIBE:
+        return MessageLane::CONTROL;
+    case MessageType::ORDER_NEW:
+        return message.data.value("priority").toInt() == static_cast<int>(OrderPriority::HIGH)
+                   ? MessageLane::CONTROL : MessageLane::ORDERS;
+    case MessageType::ORDER_STATUS_UPDATE:
+        return MessageLane::ORDERS;
+    case MessageType::DEVICE_STATUS_UPDATE:
+    case MessageType::DEVICE_STATE_SYNC:    // 키프레임과 변경분은 번호 순서를 지켜야 하므로 같은 레인
+    case MessageType::ROBOT_LOAD:
+    case MessageType::PUBLISH:
+        return MessageLane::STATUS;
+    }
+    return MessageLane::ORDERS;
+}
+
 // 주문 메시지 구조체
 struct OrderMessage {
     int orderId;
@@ -58,6 +140,9 @@ struct OrderMessage {
     int jamAmount;
     QStringList cheeses;
     OrderStatus status;
+    OrderPriority priority = OrderPriority::NORMAL;
+    OrderChannel channel = OrderChannel::DINE_IN;
+    qint64 deadline = 0;    // 약속 시각 (epoch ms, 0이면 지정 없음)
 
     QJsonObject toJson() const {
         QJsonObject json;
@@ -68,6 +153,9 @@ struct OrderMessage {
         json["jamAmount"] = jamAmount;
         json["cheeses"] = QJsonArray::fromStringList(cheeses);
         json["status"] = static_cast<int>(status);
+        json["priority"] = static_cast<int>(priority);
+        json["channel"] = static_cast<int>(channel);
+        json["deadline"] = deadline;
         return json;
     }
 
@@ -86,6 +174,11 @@ struct OrderMessage {
             order.cheeses.append(cheese.toString());
         }
         order.status = static_cast<OrderStatus>(json["status"].toInt());
+        order.priority = static_cast<OrderPriority>(
+            json["priority"].toInt(static_cast<int>(OrderPriority::NORMAL)));
+        order.channel = static_cast<OrderChannel>(
+            json["channel"].toInt(static_cast<int>(OrderChannel::DINE_IN)));
+        order.deadline = static_cast<qint64>(json["deadline"].toDouble(0));
         return order;
     }
 };
@@ -96,6 +189,7 @@ struct DeviceStatusMessage {
     int deviceIndex;
     DeviceStatus status;
     QString currentTask;
+    int orderId = 0;        // 처리 중인 주문 ID (0이면 없음)
 
     QJsonObject toJson() const {
         QJsonObject json;
@@ -103,6 +197,7 @@ struct DeviceStatusMessage {
         json["deviceIndex"] = deviceIndex;
         json["status"] = static_cast<int>(status);
         json["currentTask"] = currentTask;
+        json["orderId"] = orderId;
         return json;
     }
 
@@ -112,8 +207,187 @@ struct DeviceStatusMessage {
         deviceStatus.deviceIndex = json["deviceIndex"].toInt();
         deviceStatus.status = static_cast<DeviceStatus>(json["status"].toInt());
         deviceStatus.currentTask = json["currentTask"].toString();
+        deviceStatus.orderId = json["orderId"].toInt();
         return deviceStatus;
     }
 };
 
+// 흐름 제어 메시지 구조체 (로봇 -> 서버)
+// 서버는 이번 연결에서 보낸 주문 수가 limit보다 작을 때만 새 주문을 보낼 수 있습니다.
+// 누적 상한을 쓰기 때문에 전송 중인 주문과 통지가 엇갈려도 크레딧이 중복 계산되지 않습니다.
+struct FlowControlMessage {
+    int window;     // 로봇이 동시에 보관할 수 있는 최대 주문 수
+    int backlog;    // 현재 로봇이 보관 중인 주문 수
+    int received;   // 이번 연결에서 받은 주문 수
+    int limit;      // 받을 수 있는 누적 주문 수 상한 (received + 빈 자리)
+
+    QJsonObject toJson() const {
+        QJsonObject json;
+        json["window"] = window;
+        json["backlog"] = backlog;
+        json["received"] = received;
+        json["limit"] = limit;
+        return json;
+    }
+
+    static FlowControlMessage fromJson(const QJsonObject& json) {
+        FlowControlMessage flow;
+        flow.window = json["window"].toInt();
+        flow.backlog = json["backlog"].toInt();
+        flow.received = json["received"].toInt();
+        flow.limit = json["limit"].toInt();
+        return flow;
+    }
+};
+
+// 모듈 한 단계의 부하
+struct ModuleLoad {
+    QString module;
+    int devices = 0;        // 장치 수
+    int busy = 0;           // 작업 중인 장치 수
+    int waiting = 0;        // 이 단계를 기다리는 주문 수
+    qint64 durationMs = 0;  // 한 작업의 처리 시간
+
+    QJsonObject toJson() const {
+        QJsonObject json;
+        json["module"] = module;
+        json["devices"] = devices;
+        json["busy"] = busy;
+        json["waiting"] = waiting;
+        json["durationMs"] = durationMs;
+        return json;
+    }
+
+    static ModuleLoad fromJson(const QJsonObject& json) {
+        ModuleLoad load;
+        load.module = json["module"].toString();
+        load.devices = json["devices"].toInt();
+        load.busy = json["busy"].toInt();
+        load.waiting = json["waiting"].toInt();
+        load.durationMs = static_cast<qint64>(json["durationMs"].toDouble());
+        return load;
+    }
+};
+
+// 로봇 부하 보고 메시지 구조체 (로봇 -> 서버)
+// modules는 파이프라인 순서 (Bread -> Cheese -> Egg -> Jam)
+struct RobotLoadMessage {
+    int backlog = 0;        // 현재 보관 중인 주문 수
+    int received = 0;       // 이번 연결에서 받은 주문 수
+    QVector<ModuleLoad> modules;
+
+    QJsonObject toJson() const {
+        QJsonObject json;
+        json["backlog"] = backlog;
+        json["received"] = received;
+        QJsonArray moduleArray;
+        for (const ModuleLoad& load : modules) {
+            moduleArray.append(load.toJson());
+        }
+        json["modules"] = moduleArray;
+        return json;
+    }
+
+    static RobotLoadMessage fromJson(const QJsonObject& json) {
+        RobotLoadMessage load;
+        load.backlog = json["backlog"].toInt();
+        load.received = json["received"].toInt();
+        const QJsonArray moduleArray = json["modules"].toArray();
+        for (const QJsonValue& value : moduleArray) {
+            load.modules.append(ModuleLoad::fromJson(value.toObject()));
+        }
+        return load;
+    }
+};
+
+// 구독 요청 (주제: orders, devices, robot/<연결 ID>, 모든 로봇은 robot/*)
+// 이 메시지를 보낸 연결은 로봇이 아닌 읽기 전용 구독자로 취급되어 주문을 받지 않습니다.
+struct SubscribeMessage {
+    QStringList topics;
+
+    QJsonObject toJson() const {
+        QJsonObject json;
+        json["topics"] = QJsonArray::fromStringList(topics);
+        return json;
+    }
+
+    static SubscribeMessage fromJson(const QJsonObject& json) {
+        SubscribeMessage subscribe;
+        const QJsonArray topicArray = json["topics"].toArray();
+        for (const QJsonValue& value : topicArray) {
+            subscribe.topics.append(value.toString());
+        }
+        return subscribe;
+    }
+};
+
+// 발행 이벤트 (같은 topic과 key의 이벤트는 나중 것이 앞의 것을 대체하는 최신 상태)
+struct PublishMessage {
+    QString topic;
+    QString key;
+    QJsonObject event;
+
+    QJsonObject toJson() const {
+        QJsonObject json;
+        json["topic"] = topic;
+        json["key"] = key;
+        json["event"] = event;
+        return json;
+    }
+
+    static PublishMessage fromJson(const QJsonObject& json) {
+        PublishMessage publish;
+        publish.topic = json["topic"].toString();
+        publish.key = json["key"].toString();
+        publish.event = json["event"].toObject();
+        return publish;
+    }
+};
+
+// 장치 상태 동기화 메시지 (로봇 -> 서버, DeviceStateEncoder가 만들고 DeviceStateDecoder가 풂)
+// 장치와 작업 이름은 처음 한 번만 보내고 이후에는 표의 순번(작은 정수)으로 가리킵니다.
+// 키프레임은 이름 표 전체와 모든 장치의 상태를 담고, 그 밖에는 새로 생긴 이름과 바뀐 필드만 담습니다.
+struct DeviceStateSyncMessage {
+    int sequence = 0;           // 메시지 번호 (빠진 메시지가 있으면 다음 키프레임까지 변경분을 버림)
+    bool keyframe = false;
+    QStringList devices;        // 새 장치 이름 "모듈/번호" (키프레임이면 전체), 표의 순번이 장치 ID
+    QStringList tasks;          // 새 작업 이름 (키프레임이면 전체), 표의 순번이 작업 ID
+    int count = 0;              // 변경 기록 수
+    QByteArray records;         // 비트 단위로 붙인 키프레임 상태와 변경 기록 (JSON에서는 base64)
+
+    QJsonObject toJson() const {
+        QJsonObject json;
+        json["seq"] = sequence;
+        if (keyframe) {
+            json["key"] = true;
+        }
+        if (!devices.isEmpty()) {
+            json["dev"] = QJsonArray::fromStringList(devices);
+        }
+        if (!tasks.isEmpty()) {
+            json["task"] = QJsonArray::fromStringList(tasks);
+        }
+        json["n"] = count;
+        json["bits"] = QString::fromLatin1(records.toBase64());
+        return json;
+    }
+
+    static DeviceStateSyncMessage fromJson(const QJsonObject& json) {
+        DeviceStateSyncMessage sync;
+        sync.sequence = json["seq"].toInt();
+        sync.keyframe = json["key"].toBool();
+        const QJsonArray deviceArray = json["dev"].toArray();
+        for (const QJsonValue& value : deviceArray) {
+            sync.devices.append(value.toString());
+        }
+        const QJsonArray taskArray = json["task"].toArray();
+        for (const QJsonValue& value : taskArray) {
+            sync.tasks.append(value.toString());
+        }
+        sync.count = json["n"].toInt();
+        sync.records = QByteArray::fromBase64(json["bits"].toString().toLatin1());
+        return sync;
+    }
+};
+
 #endif // MESSAGE_H
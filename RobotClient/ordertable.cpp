@@ -0,0 +1,317 @@
+// ordertable.cpp
+#include "ordertable.h"
+
+namespace {
+const quint32 EmptySlot = 0xffffffffu;
+const quint32 DeletedSlot = 0xfffffffeu;
+const int MinIndexCapacity = 16;
+const int MaxInternedValues = 1024;  // 재료 이름/조합 수는 적으므로 넘으면 공유하지 않고 그대로 보관
+}
+
+OrderTable::OrderTable()
+    : staleArrivals(0)
+    , liveCount(0)
+    , idIndexUsed(0)
+{
+}
+
+void OrderTable::reserve(int count)
+{
+    generations.reserve(count);
+    orderIds.reserve(count);
+    statuses.reserve(count);
+    steps.reserve(count);
+    processingFlags.reserve(count);
+    createdTimes.reserve(count);
+    updatedTimes.reserve(count);
+    deadlines.reserve(count);
+    priorities.reserve(count);
+    channels.reserve(count);
+    coldDetails.reserve(count);
+    arrivalOrder.reserve(count);
+
+    int capacity = MinIndexCapacity;
+    while (capacity * 3 < count * 4) {
+        capacity *= 2;
+    }
+    if (capacity > idIndex.size()) {
+        rebuildIndex(capacity);
+    }
+}
+
+OrderHandle OrderTable::insert(const OrderMessage& order, qint64 timestampMs)
+{
+    if (!find(order.orderId).isNull()) {
+        return OrderHandle();
+    }
+
+    // 재료 목록은 여기서 한 번만 만들고 이후로는 바꾸지 않음
+    QSharedPointer<OrderDetails> details = QSharedPointer<OrderDetails>::create();
+    details->bread = internName(order.bread);
+    details->egg = internName(order.egg);
+    details->jams = internList(order.jams);
+    details->jamAmount = order.jamAmount;
+    details->cheeses = internList(order.cheeses);
+
+    OrderHandle handle = allocateSlot(order.orderId, timestampMs);
+    statuses[handle.index] = order.status;
+    deadlines[handle.index] = order.deadline;
+    priorities[handle.index] = static_cast<qint8>(order.priority);
+    channels[handle.index] = static_cast<qint8>(order.channel);
+    coldDetails[handle.index] = details;
+    return handle;
+}
+
+OrderHandle OrderTable::insertShared(const OrderTable& source, OrderHandle sourceHandle, qint64 timestampMs)
+{
+    if (!source.contains(sourceHandle) || !find(source.orderId(sourceHandle)).isNull()) {
+        return OrderHandle();
+    }
+
+    OrderHandle handle = allocateSlot(source.orderId(sourceHandle), timestampMs);
+    statuses[handle.index] = source.statuses.at(sourceHandle.index);
+    deadlines[handle.index] = source.deadlines.at(sourceHandle.index);
+    priorities[handle.index] = source.priorities.at(sourceHandle.index);
+    channels[handle.index] = source.channels.at(sourceHandle.index);
+    coldDetails[handle.index] = source.coldDetails.at(sourceHandle.index);
+    return handle;
+}
+
+OrderHandle OrderTable::allocateSlot(int orderId, qint64 timestampMs)
+{
+    // 삭제 표시를 포함해 적재율 3/4를 넘지 않도록 유지
+    if ((idIndexUsed + 1) * 4 > idIndex.size() * 3) {
+        int capacity = qMax(MinIndexCapacity, idIndex.size());
+        while ((liveCount + 1) * 2 > capacity) {
+            capacity *= 2;
+        }
+        rebuildIndex(capacity);
+    }
+
+    quint32 slot;
+    if (!freeSlots.isEmpty()) {
+        slot = freeSlots.takeLast();
+        generations[slot] += 1;
+    } else {
+        slot = static_cast<quint32>(generations.size());
+        generations.append(1);
+        orderIds.append(0);
+        statuses.append(OrderStatus::WAITING);
+        steps.append(0);
+        processingFlags.append(false);
+        createdTimes.append(0);
+        updatedTimes.append(0);
+        deadlines.append(0);
+        priorities.append(0);
+        channels.append(0);
+        coldDetails.append(SharedOrderDetails());
+    }
+
+    orderIds[slot] = orderId;
+    steps[slot] = 0;
+    processingFlags[slot] = false;
+    createdTimes[slot] = timestampMs;
+    updatedTimes[slot] = timestampMs;
+
+    const quint32 mask = static_cast<quint32>(idIndex.size() - 1);
+    for (quint32 pos = hashOrderId(orderId) & mask; ; pos = (pos + 1) & mask) {
+        quint32& entry = idIndex[pos];
+        if (entry == EmptySlot || entry == DeletedSlot) {
+            if (entry == EmptySlot) {
+                ++idIndexUsed;
+            }
+            entry = slot;
+            break;
+        }
+    }
+
+    if (staleArrivals > 32 && staleArrivals * 2 > arrivalOrder.size()) {
+        compactArrivals();
+    }
+
+    OrderHandle handle(slot, generations.at(slot));
+    arrivalOrder.append(handle);
+    ++liveCount;
+    return handle;
+}
+
+QString OrderTable::internName(const QString& name)
+{
+    QSet<QString>::const_iterator it = namePool.constFind(name);
+    if (it != namePool.constEnd()) {
+        return *it;
+    }
+    if (namePool.size() < MaxInternedValues) {
+        namePool.insert(name);
+    }
+    return name;
+}
+
+QStringList OrderTable::internList(const QStringList& names)
+{
+    if (names.isEmpty()) {
+        return QStringList();
+    }
+    QSet<QStringList>::const_iterator it = listPool.constFind(names);
+    if (it != listPool.constEnd()) {
+        return *it;
+    }
+
+    QStringList interned;
+    interned.reserve(names.size());
+    for (const QString& name : names) {
+        interned.append(internName(name));
+    }
+    if (listPool.size() < MaxInternedValues) {
+        listPool.insert(interned);
+    }
+    return interned;
+}
+
+bool OrderTable::remove(OrderHandle handle)
+{
+    if (!contains(handle)) {
+        return false;
+    }
+
+    const int orderId = orderIds.at(handle.index);
+    const quint32 mask = static_cast<quint32>(idIndex.size() - 1);
+    for (quint32 pos = hashOrderId(orderId) & mask; ; pos = (pos + 1) & mask) {
+        quint32& entry = idIndex[pos];
+        if (entry == EmptySlot) {
+            break;
+        }
+        if (entry == handle.index) {
+            entry = DeletedSlot;
+            break;
+        }
+    }
+
+    generations[handle.index] += 1;
+    coldDetails[handle.index].reset();
+    freeSlots.append(handle.index);
+    ++staleArrivals;
+    --liveCount;
+    return true;
+}
+
+void OrderTable::clear()
+{
+    generations.clear();
+    orderIds.clear();
+    statuses.clear();
+    steps.clear();
+    processingFlags.clear();
+    createdTimes.clear();
+    updatedTimes.clear();
+    deadlines.clear();
+    priorities.clear();
+    channels.clear();
+    coldDetails.clear();
+    namePool.clear();
+    listPool.clear();
+    freeSlots.clear();
+    arrivalOrder.clear();
+    idIndex.clear();
+    staleArrivals = 0;
+    liveCount = 0;
+    idIndexUsed = 0;
+}
+
+OrderHandle OrderTable::find(int orderId) const
+{
+    if (idIndex.isEmpty()) {
+        return OrderHandle();
+    }
+
+    const quint32* entries = idIndex.constData();
+    const quint32 mask = static_cast<quint32>(idIndex.size() - 1);
+    for (quint32 pos = hashOrderId(orderId) & mask; ; pos = (pos + 1) & mask) {
+        const quint32 slot = entries[pos];
+        if (slot == EmptySlot) {
+            return OrderHandle();
+        }
+        if (slot != DeletedSlot && orderIds.at(slot) == orderId) {
+            return OrderHandle(slot, generations.at(slot));
+        }
+    }
+}
+
+OrderMessage OrderTable::order(OrderHandle handle) const
+{
+    const OrderDetails& details = *coldDetails.at(handle.index);
+
+    OrderMessage order;
+    order.orderId = orderIds.at(handle.index);
+    order.bread = details.bread;
+    order.egg = details.egg;
+    order.jams = details.jams;
+    order.jamAmount = details.jamAmount;
+    order.cheeses = details.cheeses;
+    order.status = statuses.at(handle.index);
+    order.priority = static_cast<OrderPriority>(priorities.at(handle.index));
+    order.channel = static_cast<OrderChannel>(channels.at(handle.index));
+    order.deadline = deadlines.at(handle.index);
+    return order;
+}
+
+QJsonObject OrderTable::toJson(OrderHandle handle) const
+{
+    const OrderDetails& details = *coldDetails.at(handle.index);
+
+    // OrderMessage::toJson과 같은 형식
+    QJsonObject json;
+    json["orderId"] = orderIds.at(handle.index);
+    json["bread"] = details.bread;
+    json["egg"] = details.egg;
+    json["jams"] = QJsonArray::fromStringList(details.jams);
+    json["jamAmount"] = details.jamAmount;
+    json["cheeses"] = QJsonArray::fromStringList(details.cheeses);
+    json["status"] = static_cast<int>(statuses.at(handle.index));
+    json["priority"] = static_cast<int>(priorities.at(handle.index));
+    json["channel"] = static_cast<int>(channels.at(handle.index));
+    json["deadline"] = deadlines.at(handle.index);
+    return json;
+}
+
+QList<OrderMessage> OrderTable::orders() const
+{
+    QList<OrderMessage> result;
+    result.reserve(liveCount);
+    forEach([&](OrderHandle handle) {
+        result.append(order(handle));
+    });
+    return result;
+}
+
+void OrderTable::rebuildIndex(int capacity)
+{
+    idIndex.fill(EmptySlot, capacity);
+    idIndexUsed = 0;
+
+    const quint32 mask = static_cast<quint32>(capacity - 1);
+    for (int slot = 0; slot < generations.size(); ++slot) {
+        if (!(generations.at(slot) & 1u)) {
+            continue;
+        }
+        quint32 pos = hashOrderId(orderIds.at(slot)) & mask;
+        while (idIndex.at(pos) != EmptySlot) {
+            pos = (pos + 1) & mask;
+        }
+        idIndex[pos] = static_cast<quint32>(slot);
+        ++idIndexUsed;
+    }
+}
+
+void OrderTable::compactArrivals()
+{
+    QVector<OrderHandle> live;
+    live.reserve(liveCount + 1);
+    for (int i = 0; i < arrivalOrder.size(); ++i) {
+        if (contains(arrivalOrder.at(i))) {
+            live.append(arrivalOrder.at(i));
+        }
+    }
+    arrivalOrder.swap(live);
+    staleArrivals = 0;
+}
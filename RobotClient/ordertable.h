@@ -0,0 +1,185 @@
+// ordertable.h
+#ifndef ORDERTABLE_H
+#define ORDERTABLE_H
+
+#include <QVector>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QSharedPointer>
+#include <QJsonObject>
+#include <QMetaType>
+#include "message.h"
+
+// 주문 핸들 (슬롯 인덱스 + 세대 번호)
+// 슬롯이 재사용되면 세대 번호가 바뀌므로 오래된 핸들은 자동으로 무효가 됩니다.
+struct OrderHandle {
+    quint32 index;
+    quint32 generation;
+
+    OrderHandle() : index(0), generation(0) {}
+    OrderHandle(quint32 index, quint32 generation) : index(index), generation(generation) {}
+
+    bool isNull() const { return generation == 0; }
+    bool operator==(const OrderHandle& other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const OrderHandle& other) const { return !(*this == other); }
+};
+
+Q_DECLARE_METATYPE(OrderHandle)
+
+// 자주 접근하지 않는 주문 정보 (재료 목록)
+// 주문을 넣을 때 한 번 만들고 바꾸지 않으므로 여러 테이블이 같은 레코드를 참조 카운트로 공유합니다.
+struct OrderDetails {
+    QString bread;
+    QString egg;
+    QStringList jams;
+    int jamAmount;
+    QStringList cheeses;
+
+    OrderDetails() : jamAmount(0) {}
+};
+
+typedef QSharedPointer<const OrderDetails> SharedOrderDetails;
+
+// 슬롯 맵 기반 주문 테이블
+// 상태/단계/타임스탬프 같은 자주 쓰는 필드는 필드별 배열(SoA)에 연속으로 두고,
+// 재료 목록은 별도 배열에 두어 상태 갱신 시 캐시를 오염시키지 않습니다.
+// 주문 ID -> 슬롯 조회는 개방 주소법 해시 인덱스로 처리합니다.
+// 재료 이름과 조합은 테이블 안에서 하나만 두고 공유하므로 주문마다 문자열을 새로 할당하지 않습니다.
+class OrderTable
+{
+public:
+    OrderTable();
+
+    // 주문 추가 (이미 같은 ID가 있으면 null 핸들 반환)
+    OrderHandle insert(const OrderMessage& order, qint64 timestampMs = 0);
+    // 다른 테이블의 주문을 추가 (재료 목록은 복사하지 않고 같은 레코드를 공유)
+    OrderHandle insertShared(const OrderTable& source, OrderHandle sourceHandle, qint64 timestampMs = 0);
+    bool remove(OrderHandle handle);
+    void clear();
+    void reserve(int count);
+
+    OrderHandle find(int orderId) const;
+    bool contains(OrderHandle handle) const {
+        return handle.index < static_cast<quint32>(generations.size()) &&
+               generations.at(handle.index) == handle.generation &&
+               (handle.generation & 1u);
+    }
+
+    int size() const { return liveCount; }
+    bool isEmpty() const { return liveCount == 0; }
+
+    // 자주 쓰는 필드
+    int orderId(OrderHandle handle) const { return orderIds.at(handle.index); }
+    OrderStatus status(OrderHandle handle) const { return statuses.at(handle.index); }
+    int step(OrderHandle handle) const { return steps.at(handle.index); }
+    bool isProcessing(OrderHandle handle) const { return processingFlags.at(handle.index); }
+    qint64 createdAt(OrderHandle handle) const { return createdTimes.at(handle.index); }
+    qint64 updatedAt(OrderHandle handle) const { return updatedTimes.at(handle.index); }
+    qint64 deadline(OrderHandle handle) const { return deadlines.at(handle.index); }
+    OrderPriority priority(OrderHandle handle) const {
+        return static_cast<OrderPriority>(priorities.at(handle.index));
+    }
+    OrderChannel channel(OrderHandle handle) const {
+        return static_cast<OrderChannel>(channels.at(handle.index));
+    }
+
+    void setStatus(OrderHandle handle, OrderStatus status) {
+        Q_ASSERT(contains(handle));
+        statuses[handle.index] = status;
+    }
+    void setStep(OrderHandle handle, int step) {
+        Q_ASSERT(contains(handle));
+        steps[handle.index] = static_cast<qint8>(step);
+    }
+    void setProcessing(OrderHandle handle, bool processing) {
+        Q_ASSERT(contains(handle));
+        processingFlags[handle.index] = processing;
+    }
+    void setPriority(OrderHandle handle, OrderPriority priority) {
+        Q_ASSERT(contains(handle));
+        priorities[handle.index] = static_cast<qint8>(priority);
+    }
+    void touch(OrderHandle handle, qint64 timestampMs) {
+        Q_ASSERT(contains(handle));
+        updatedTimes[handle.index] = timestampMs;
+    }
+
+    // 재료 목록
+    const OrderDetails& details(OrderHandle handle) const { return *coldDetails.at(handle.index); }
+    SharedOrderDetails sharedDetails(OrderHandle handle) const { return coldDetails.at(handle.index); }
+
+    // OrderMessage 형태로 복원
+    OrderMessage order(OrderHandle handle) const;
+    // OrderMessage::toJson과 같은 형식 (OrderMessage를 거치지 않고 바로 만듦)
+    QJsonObject toJson(OrderHandle handle) const;
+    QList<OrderMessage> orders() const;
+
+    // 도착 순서대로 순회. 순회 중 필드 변경과 remove()는 허용되지만 insert()는 안 됩니다.
+    template <typename Function>
+    void forEach(Function fn) const {
+        for (int i = 0; i < arrivalOrder.size(); ++i) {
+            const OrderHandle handle = arrivalOrder.at(i);
+            if (contains(handle)) {
+                fn(handle);
+            }
+        }
+    }
+
+    // 도착 순서상 조건을 만족하는 첫 번째 주문
+    template <typename Predicate>
+    OrderHandle findFirst(Predicate pred) const {
+        for (int i = 0; i < arrivalOrder.size(); ++i) {
+            const OrderHandle handle = arrivalOrder.at(i);
+            if (contains(handle) && pred(handle)) {
+                return handle;
+            }
+        }
+        return OrderHandle();
+    }
+
+private:
+    // 자주 쓰는 필드 (SoA)
+    QVector<quint32> generations;   // 홀수: 사용 중, 짝수: 비어 있음
+    QVector<int> orderIds;
+    QVector<OrderStatus> statuses;
+    QVector<qint8> steps;
+    QVector<bool> processingFlags;
+    QVector<qint64> createdTimes;
+    QVector<qint64> updatedTimes;
+    QVector<qint64> deadlines;
+    QVector<qint8> priorities;
+    QVector<qint8> channels;
+
+    // 자주 쓰지 않는 필드 (빈 슬롯은 null)
+    QVector<SharedOrderDetails> coldDetails;
+
+    // 재료 이름/조합 공유 (insert에서만 사용)
+    QSet<QString> namePool;
+    QSet<QStringList> listPool;
+
+    QVector<quint32> freeSlots;
+    QVector<OrderHandle> arrivalOrder;
+    int staleArrivals;
+    int liveCount;
+
+    // 주문 ID -> 슬롯 인덱스 (선형 탐사)
+    QVector<quint32> idIndex;
+    int idIndexUsed;    // 사용 중 + 삭제 표시 항목 수
+
+    static quint32 hashOrderId(int orderId) {
+        quint32 h = static_cast<quint32>(orderId) * 2654435761u;
+        return h ^ (h >> 16);
+    }
+
+    OrderHandle allocateSlot(int orderId, qint64 timestampMs);
+    QString internName(const QString& name);
+    QStringList internList(const QStringList& names);
+    void rebuildIndex(int capacity);
+    void compactArrivals();
+};
+
+#endif // ORDERTABLE_H
@@ -0,0 +1,363 @@
+// pipelinesimulator.cpp
+#include "pipelinesimulator.h"
+#include <QRandomGenerator>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+SimulationResult::SimulationResult()
+    : completedOrders(0)
+    , deadlineMisses(0)
+    , makespanMs(0)
+    , meanLatencyMs(0.0)
+    , p95LatencyMs(0)
+    , maxLatencyMs(0)
+    , maxLatenessMs(0)
+{
+    for (int i = 0; i < 3; ++i) {
+        missesByChannel[i] = 0;
+    }
+}
+
+QString SimulationResult::summary() const
+{
+    return QString("%1: 완료 %2건, 마감 초과 %3건 (매장 %4 / 포장 %5 / 배달 %6), "
+                   "평균 %7초, p95 %8초, 최대 %9초, 최대 초과 %10초")
+        .arg(policyName, -4)
+        .arg(completedOrders)
+        .arg(deadlineMisses)
+        .arg(missesByChannel[static_cast<int>(OrderChannel::DINE_IN)])
+        .arg(missesByChannel[static_cast<int>(OrderChannel::TAKEOUT)])
+        .arg(missesByChannel[static_cast<int>(OrderChannel::DELIVERY)])
+        .arg(meanLatencyMs / 1000.0, 0, 'f', 1)
+        .arg(p95LatencyMs / 1000.0, 0, 'f', 1)
+        .arg(maxLatencyMs / 1000.0, 0, 'f', 1)
+        .arg(maxLatenessMs / 1000.0, 0, 'f', 1);
+}
+
+PipelineSimulator::PipelineSimulator()
+    : batchWindowMs(0)
+{
+    for (int step = 0; step < StepCount; ++step) {
+        for (int other = 0; other < StepCount; ++other) {
+            skillTimes[step][other] = 0;
+        }
+    }
+    applyConfig(RobotConfig::defaults());
+}
+
+void PipelineSimulator::applyConfig(const RobotConfig& config)
+{
+    // 시뮬레이션 주문은 빵/치즈/계란/잼 4단계이므로 앞의 4개 모듈만 반영
+    for (int step = 0; step < StepCount && step < config.modules.size(); ++step) {
+        const ModuleConfig& module = config.modules.at(step);
+        qint64 totalTimeMs = 0;
+        for (int i = 1; i <= module.devices; ++i) {
+            totalTimeMs += module.deviceTimeMs(i);
+        }
+        deviceCounts[step] = module.devices;
+        processingTimes[step] = totalTimeMs / module.devices;
+        deviceCapacities[step] = module.capacity;
+        for (int other = 0; other < StepCount; ++other) {
+            skillTimes[step][other] = other < config.modules.size()
+                ? module.skills.value(config.modules.at(other).name, 0) : 0;
+        }
+    }
+}
+
+void PipelineSimulator::setDeviceCount(int step, int count)
+{
+    if (step >= 0 && step < StepCount && count > 0) {
+        deviceCounts[step] = count;
+    }
+}
+
+int PipelineSimulator::deviceCount(int step) const
+{
+    return (step >= 0 && step < StepCount) ? deviceCounts[step] : 0;
+}
+
+void PipelineSimulator::setProcessingTime(int step, qint64 durationMs)
+{
+    if (step >= 0 && step < StepCount && durationMs > 0) {
+        processingTimes[step] = durationMs;
+    }
+}
+
+qint64 PipelineSimulator::processingTime(int step) const
+{
+    return (step >= 0 && step < StepCount) ? processingTimes[step] : 0;
+}
+
+void PipelineSimulator::setDeviceCapacity(int step, int capacity)
+{
+    if (step >= 0 && step < StepCount && capacity > 0) {
+        deviceCapacities[step] = capacity;
+    }
+}
+
+void PipelineSimulator::setDeviceSkill(int step, int otherStep, qint64 durationMs)
+{
+    if (step >= 0 && step < StepCount && otherStep >= 0 && otherStep < StepCount && step != otherStep) {
+        skillTimes[step][otherStep] = qMax<qint64>(0, durationMs);
+    }
+}
+
+int PipelineSimulator::deviceCapacity(int step) const
+{
+    return (step >= 0 && step < StepCount) ? deviceCapacities[step] : 0;
+}
+
+SimulationResult PipelineSimulator::run(const QVector<SimulatedOrder>& input,
+                                        SchedulingPolicy* policy) const
+{
+    SimulationResult result;
+    result.policyName = policy->name();
+
+    QVector<SimulatedOrder> orders = input;
+    std::stable_sort(orders.begin(), orders.end(),
+                     [](const SimulatedOrder& a, const SimulatedOrder& b) {
+                         return a.arrivalMs < b.arrivalMs;
+                     });
+
+    const int orderCount = orders.size();
+    QVector<int> steps(orderCount, 0);
+    QVector<qint64> readyTimes(orderCount, 0);     // 현재 단계를 기다리기 시작한 시각
+    QVector<qint64> latencies;
+    latencies.reserve(orderCount);
+
+    // 주문의 재료에 따른 남은 처리 시간 (SRPT용)
+    auto remainingWork = [&](const SimulatedOrder& order, int fromStep) {
+        qint64 total = 0;
+        for (int step = fromStep; step < StepCount; ++step) {
+            total += processingTimes[step] * order.units[step];
+        }
+        return total;
+    };
+
+    auto makeCandidate = [&](int index) -> SchedulingCandidate {
+        const SimulatedOrder& order = orders.at(index);
+        SchedulingCandidate candidate;
+        candidate.handle = OrderHandle(static_cast<quint32>(index), 1);
+        candidate.orderId = order.orderId;
+        candidate.step = steps.at(index);
+        candidate.arrivalMs = order.arrivalMs;
+        candidate.deadlineMs = order.deadlineMs;
+        candidate.priority = order.priority;
+        candidate.channel = order.channel;
+        candidate.remainingWorkMs = remainingWork(order, candidate.step);
+        candidate.readyMs = readyTimes.at(index);
+        if (candidate.step < StepCount) {
+            candidate.batchKey = QString::number(order.variants[candidate.step]);
+        }
+        return candidate;
+    };
+
+    // 장치별 진행 중인 배치 (비어 있으면 유휴)와 완료 시각
+    QVector<QVector<int>> runningBatches[StepCount];
+    QVector<qint64> finishTimes[StepCount];
+    QVector<SchedulingCandidate> readyTasks[StepCount];
+    for (int step = 0; step < StepCount; ++step) {
+        runningBatches[step].resize(deviceCounts[step]);
+        finishTimes[step].fill(0, deviceCounts[step]);
+    }
+
+    int nextArrival = 0;
+    qint64 latencySum = 0;
+    qint64 batchWakeup = std::numeric_limits<qint64>::max();   // 배치 대기가 끝나는 가장 이른 시각
+    while (result.completedOrders < orderCount) {
+        // 다음 사건 시각 (도착, 장치 작업 완료 또는 배치 대기 종료)
+        qint64 now = batchWakeup;
+        batchWakeup = std::numeric_limits<qint64>::max();
+        if (nextArrival < orderCount) {
+            now = qMin(now, orders.at(nextArrival).arrivalMs);
+        }
+        for (int step = 0; step < StepCount; ++step) {
+            for (int d = 0; d < deviceCounts[step]; ++d) {
+                if (!runningBatches[step].at(d).isEmpty()) {
+                    now = qMin(now, finishTimes[step].at(d));
+                }
+            }
+        }
+        if (now == std::numeric_limits<qint64>::max()) {
+            break;
+        }
+
+        // 작업 완료 처리
+        for (int step = 0; step < StepCount; ++step) {
+            for (int d = 0; d < deviceCounts[step]; ++d) {
+                if (runningBatches[step].at(d).isEmpty() || finishTimes[step].at(d) > now) {
+                    continue;
+                }
+                const QVector<int> batch = runningBatches[step].at(d);
+                runningBatches[step][d].clear();
+
+                for (int index : batch) {
+                    steps[index] += 1;
+                    readyTimes[index] = now;
+
+                    if (steps.at(index) < StepCount) {
+                        readyTasks[steps.at(index)].append(makeCandidate(index));
+                        continue;
+                    }
+
+                    const SimulatedOrder& order = orders.at(index);
+                    const qint64 latency = now - order.arrivalMs;
+                    latencies.append(latency);
+                    latencySum += latency;
+                    result.completedOrders++;
+                    result.makespanMs = now;
+                    result.maxLatencyMs = qMax(result.maxLatencyMs, latency);
+
+                    SchedulingCandidate finished = makeCandidate(index);
+                    const qint64 lateness = now - SchedulingPolicy::effectiveDeadline(finished);
+                    if (lateness > 0) {
+                        result.deadlineMisses++;
+                        const int channel = static_cast<int>(order.channel);
+                        if (channel >= 0 && channel < 3) {
+                            result.missesByChannel[channel]++;
+                        }
+                        result.maxLatenessMs = qMax(result.maxLatenessMs, lateness);
+                    }
+                }
+            }
+        }
+
+        // 새 주문 도착
+        while (nextArrival < orderCount && orders.at(nextArrival).arrivalMs <= now) {
+            readyTimes[nextArrival] = orders.at(nextArrival).arrivalMs;
+            readyTasks[0].append(makeCandidate(nextArrival));
+            ++nextArrival;
+        }
+
+        // 빈 장치에 정책이 고른 작업을 배치로 배정
+        QVector<SchedulingCandidate> deferred[StepCount];
+        for (int step = 0; step < StepCount; ++step) {
+            QVector<SchedulingCandidate>& bucket = readyTasks[step];
+            for (int d = 0; d < deviceCounts[step] && !bucket.isEmpty(); ++d) {
+                if (!runningBatches[step].at(d).isEmpty()) {
+                    continue;
+                }
+                const QVector<SchedulingCandidate> batch =
+                    policy->takeBatch(bucket, now, deviceCapacities[step]);
+
+                // 배치가 덜 찼으면 대기 시간이 끝날 때까지 같은 재료의 작업을 기다림
+                const qint64 batchDeadline = batch.first().readyMs + batchWindowMs;
+                if (batch.size() < deviceCapacities[step] && now < batchDeadline) {
+                    batchWakeup = qMin(batchWakeup, batchDeadline);
+                    deferred[step] += batch;
+                    --d;    // 같은 장치에 다른 작업을 다시 시도
+                    continue;
+                }
+
+                // 한 배치는 같은 재료 조합이므로 처리 시간 배수도 같음
+                const int units = orders.at(static_cast<int>(batch.first().handle.index)).units[step];
+                const qint64 durationMs = processingTimes[step] * units;
+                for (const SchedulingCandidate& candidate : batch) {
+                    runningBatches[step][d].append(static_cast<int>(candidate.handle.index));
+                    policy->taskDispatched(candidate, durationMs);
+                }
+                finishTimes[step][d] = now + durationMs;
+            }
+        }
+
+        // 쉬는 다기능 장치는 처리할 수 있는 다른 단계 중 대기열이 가장 긴 곳의 작업을 가져감
+        for (int step = 0; step < StepCount; ++step) {
+            if (!deferred[step].isEmpty()) {
+                continue;   // 자기 단계의 배치를 기다리는 중
+            }
+            for (int d = 0; d < deviceCounts[step]; ++d) {
+                if (!runningBatches[step].at(d).isEmpty()) {
+                    continue;
+                }
+                int longest = -1;
+                for (int other = 0; other < StepCount; ++other) {
+                    if (skillTimes[step][other] <= 0 || readyTasks[other].isEmpty()) {
+                        continue;
+                    }
+                    if (longest < 0 || readyTasks[other].size() > readyTasks[longest].size()) {
+                        longest = other;
+                    }
+                }
+                if (longest < 0) {
+                    break;
+                }
+
+                const QVector<SchedulingCandidate> batch =
+                    policy->takeBatch(readyTasks[longest], now, deviceCapacities[step]);
+                const int units = orders.at(static_cast<int>(batch.first().handle.index)).units[longest];
+                const qint64 durationMs = skillTimes[step][longest] * units;
+                for (const SchedulingCandidate& candidate : batch) {
+                    runningBatches[step][d].append(static_cast<int>(candidate.handle.index));
+                    policy->taskDispatched(candidate, durationMs);
+                }
+                finishTimes[step][d] = now + durationMs;
+            }
+        }
+
+        for (int step = 0; step < StepCount; ++step) {
+            readyTasks[step] += deferred[step];
+        }
+    }
+
+    if (!latencies.isEmpty()) {
+        std::sort(latencies.begin(), latencies.end());
+        result.meanLatencyMs = static_cast<double>(latencySum) / latencies.size();
+        const int p95Index = qMin(latencies.size() - 1,
+                                  static_cast<int>(qCeil(latencies.size() * 0.95)) - 1);
+        result.p95LatencyMs = latencies.at(qMax(0, p95Index));
+    }
+    return result;
+}
+
+QVector<SimulatedOrder> PipelineSimulator::generateWorkload(int orderCount, double ordersPerMinute,
+                                                            qint64 deliveryWindowMs, quint32 seed)
+{
+    QVector<SimulatedOrder> orders;
+    orders.reserve(orderCount);
+
+    QRandomGenerator rng(seed);
+    const double meanGapMs = 60000.0 / ordersPerMinute;
+    double now = 0.0;
+
+    for (int i = 0; i < orderCount; ++i) {
+        // 지수 분포 도착 간격
+        now += -meanGapMs * qLn(1.0 - rng.generateDouble());
+
+        SimulatedOrder order;
+        order.orderId = i + 1;
+        order.arrivalMs = static_cast<qint64>(now);
+        order.deadlineMs = 0;
+
+        const double channelRoll = rng.generateDouble();
+        if (channelRoll < 0.5) {
+            order.channel = OrderChannel::DINE_IN;
+        } else if (channelRoll < 0.75) {
+            order.channel = OrderChannel::TAKEOUT;
+        } else {
+            order.channel = OrderChannel::DELIVERY;
+            order.deadlineMs = order.arrivalMs + deliveryWindowMs;
+        }
+
+        const double priorityRoll = rng.generateDouble();
+        if (priorityRoll < 0.1) {
+            order.priority = OrderPriority::HIGH;
+        } else if (priorityRoll < 0.9) {
+            order.priority = OrderPriority::NORMAL;
+        } else {
+            order.priority = OrderPriority::LOW;
+        }
+
+        // 빵 2종, 치즈 조합 4종, 계란 2종, 잼 조합 4종
+        // 치즈/잼 조합은 없음, 한 가지 2종, 두 가지 (평균 처리 시간은 한 가지와 같음)
+        const int variantCounts[4] = { 2, 4, 2, 4 };
+        const int comboUnits[4] = { 0, 1, 1, 2 };
+        for (int step = 0; step < 4; ++step) {
+            order.variants[step] = static_cast<int>(rng.bounded(variantCounts[step]));
+            order.units[step] = variantCounts[step] == 4 ? comboUnits[order.variants[step]] : 1;
+        }
+
+        orders.append(order);
+    }
+    return orders;
+}
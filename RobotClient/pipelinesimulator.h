@@ -0,0 +1,76 @@
+// pipelinesimulator.h
+#ifndef PIPELINESIMULATOR_H
+#define PIPELINESIMULATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "message.h"
+#include "robotconfig.h"
+#include "schedulingpolicy.h"
+
+// 시뮬레이션 입력 주문
+struct SimulatedOrder {
+    int orderId;
+    qint64 arrivalMs;
+    qint64 deadlineMs;      // 0이면 우선순위별 SLA 적용
+    OrderPriority priority;
+    OrderChannel channel;
+    int variants[4];        // 단계별 재료 조합 (값이 같으면 한 장치에서 함께 처리 가능)
+    int units[4];           // 단계별 처리 시간 배수 (치즈 장 수, 잼 종류 수; 0이면 바로 통과)
+};
+
+// 정책별 시뮬레이션 결과
+struct SimulationResult {
+    QString policyName;
+    int completedOrders;
+    int deadlineMisses;
+    int missesByChannel[3];
+    qint64 makespanMs;          // 마지막 주문 완료 시각
+    double meanLatencyMs;
+    qint64 p95LatencyMs;
+    qint64 maxLatencyMs;
+    qint64 maxLatenessMs;       // 마감 시각을 가장 많이 넘긴 시간
+
+    SimulationResult();
+    QString summary() const;
+};
+
+// 로봇 파이프라인 (Bread -> Cheese -> Egg -> Jam) 이산 사건 시뮬레이터
+// DeviceManager와 같은 방식으로 단계별 대기 작업을 SchedulingPolicy에 맡겨 배정합니다.
+// 실제 시간을 쓰지 않으므로 수천 건의 주문도 즉시 시뮬레이션됩니다.
+class PipelineSimulator
+{
+public:
+    PipelineSimulator();
+
+    // 로봇 설정 파일의 장치 구성으로 시뮬레이션 (장치별 처리 시간은 평균)
+    void applyConfig(const RobotConfig& config);
+
+    void setDeviceCount(int step, int count);
+    int deviceCount(int step) const;
+    void setProcessingTime(int step, qint64 durationMs);
+    qint64 processingTime(int step) const;
+    void setDeviceCapacity(int step, int capacity);
+    int deviceCapacity(int step) const;
+    void setBatchWindowMs(qint64 windowMs) { batchWindowMs = qMax<qint64>(0, windowMs); }
+    // step 단계 장치가 쉴 때 otherStep 단계 작업을 durationMs에 처리 (0이면 해제)
+    void setDeviceSkill(int step, int otherStep, qint64 durationMs);
+
+    SimulationResult run(const QVector<SimulatedOrder>& orders, SchedulingPolicy* policy) const;
+
+    // 포아송 도착 + 채널/우선순위/재료 혼합 부하 생성
+    // 배달 주문은 도착 후 deliveryWindowMs 안에 픽업된다고 가정
+    static QVector<SimulatedOrder> generateWorkload(int orderCount, double ordersPerMinute,
+                                                    qint64 deliveryWindowMs, quint32 seed);
+
+private:
+    static const int StepCount = 4;
+    int deviceCounts[StepCount];
+    qint64 processingTimes[StepCount];
+    int deviceCapacities[StepCount];
+    qint64 skillTimes[StepCount][StepCount];
+    qint64 batchWindowMs;
+};
+
+#endif // PIPELINESIMULATOR_H
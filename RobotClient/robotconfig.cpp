@@ -0,0 +1,175 @@
+// robotconfig.cpp
+#include "robotconfig.h"
+#include "device.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+
+QStringList RobotConfig::pipelineModules()
+{
+    return { "Bread", "Cheese", "Egg", "Jam" };
+}
+
+RobotConfig RobotConfig::defaults()
+{
+    RobotConfig config;
+    for (const QString& name : pipelineModules()) {
+        ModuleConfig module;
+        module.name = name;
+        module.devices = 2;
+        module.processingTimeMs = Device::processingTimeMs(name);
+        module.capacity = Device::defaultCapacity(name);
+        config.modules.append(module);
+    }
+    return config;
+}
+
+bool RobotConfig::fromJson(const QJsonObject& json, RobotConfig& config, QString& errorMessage)
+{
+    const QJsonArray moduleArray = json["modules"].toArray();
+    if (moduleArray.isEmpty()) {
+        errorMessage = "모듈 목록(modules)이 비어 있습니다";
+        return false;
+    }
+
+    RobotConfig parsed;
+    QSet<QString> names;
+    for (const QJsonValue& value : moduleArray) {
+        const QJsonObject object = value.toObject();
+        ModuleConfig module;
+        module.name = object["name"].toString();
+        if (module.name.isEmpty() || names.contains(module.name)) {
+            errorMessage = QString("모듈 이름이 없거나 중복되었습니다: '%1'").arg(module.name);
+            return false;
+        }
+        names.insert(module.name);
+
+        module.devices = object["devices"].toInt(1);
+        module.processingTimeMs = object["processingTimeMs"].toInt(Device::processingTimeMs(module.name));
+        module.capacity = object["capacity"].toInt(Device::defaultCapacity(module.name));
+        if (module.devices < 1 || module.devices > MaxDevicesPerModule) {
+            errorMessage = QString("%1: 장치 수는 1~%2대여야 합니다 (%3)")
+                               .arg(module.name).arg(MaxDevicesPerModule).arg(module.devices);
+            return false;
+        }
+        if (module.processingTimeMs <= 0 || module.capacity < 1) {
+            errorMessage = QString("%1: 처리 시간과 용량은 양수여야 합니다").arg(module.name);
+            return false;
+        }
+
+        for (const QJsonValue& time : object["deviceTimesMs"].toArray()) {
+            if (time.toInt() <= 0) {
+                errorMessage = QString("%1: 장치별 처리 시간은 양수여야 합니다").arg(module.name);
+                return false;
+            }
+            module.deviceTimesMs.append(time.toInt());
+        }
+        if (module.deviceTimesMs.size() > module.devices) {
+            errorMessage = QString("%1: 장치별 처리 시간이 장치 수보다 많습니다").arg(module.name);
+            return false;
+        }
+
+        const QJsonObject skillObject = object["skills"].toObject();
+        for (auto it = skillObject.begin(); it != skillObject.end(); ++it) {
+            if (it.key() == module.name || it.value().toInt() <= 0) {
+                errorMessage = QString("%1: 잘못된 추가 기능 '%2'").arg(module.name, it.key());
+                return false;
+            }
+            module.skills.insert(it.key(), it.value().toInt());
+        }
+
+        parsed.modules.append(module);
+    }
+
+    // 서버는 단계 번호로 주문을 진행하므로 모듈 이름과 순서를 바꿀 수 없음
+    QStringList order;
+    for (const ModuleConfig& module : parsed.modules) {
+        order << module.name;
+    }
+    if (order != pipelineModules()) {
+        errorMessage = QString("모듈은 %1 순서로 모두 있어야 합니다 (설정: %2)")
+                           .arg(pipelineModules().join(", "), order.join(", "));
+        return false;
+    }
+
+    // 추가 기능은 구성에 있는 모듈의 작업만 가능
+    for (const ModuleConfig& module : parsed.modules) {
+        for (const QString& skill : module.skills.keys()) {
+            if (!names.contains(skill)) {
+                errorMessage = QString("%1: 알 수 없는 모듈의 기능 '%2'").arg(module.name, skill);
+                return false;
+            }
+        }
+    }
+
+    config = parsed;
+    return true;
+}
+
+bool RobotConfig::loadFile(const QString& path, RobotConfig& config, QString& errorMessage)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorMessage = QString("설정 파일을 열 수 없습니다: %1").arg(path);
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        errorMessage = QString("설정 파일 형식 오류 (%1): %2").arg(path, parseError.errorString());
+        return false;
+    }
+    return fromJson(document.object(), config, errorMessage);
+}
+
+QJsonObject RobotConfig::toJson() const
+{
+    QJsonArray moduleArray;
+    for (const ModuleConfig& module : modules) {
+        QJsonObject object;
+        object["name"] = module.name;
+        object["devices"] = module.devices;
+        object["processingTimeMs"] = module.processingTimeMs;
+        object["capacity"] = module.capacity;
+        if (!module.deviceTimesMs.isEmpty()) {
+            QJsonArray times;
+            for (int time : module.deviceTimesMs) {
+                times.append(time);
+            }
+            object["deviceTimesMs"] = times;
+        }
+        if (!module.skills.isEmpty()) {
+            QJsonObject skillObject;
+            for (auto it = module.skills.constBegin(); it != module.skills.constEnd(); ++it) {
+                skillObject[it.key()] = it.value();
+            }
+            object["skills"] = skillObject;
+        }
+        moduleArray.append(object);
+    }
+
+    QJsonObject json;
+    json["modules"] = moduleArray;
+    return json;
+}
+
+int RobotConfig::indexOf(const QString& module) const
+{
+    for (int i = 0; i < modules.size(); ++i) {
+        if (modules.at(i).name == module) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int RobotConfig::totalDevices() const
+{
+    int total = 0;
+    for (const ModuleConfig& module : modules) {
+        total += module.devices;
+    }
+    return total;
+}
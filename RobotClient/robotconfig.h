@@ -0,0 +1,57 @@
+// robotconfig.h
+#ifndef ROBOTCONFIG_H
+#define ROBOTCONFIG_H
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QJsonObject>
+
+// 파이프라인 한 단계(모듈)의 장치 구성
+struct ModuleConfig {
+    QString name;               // "Bread", "Cheese" ... (서버와 주고받는 모듈 이름)
+    int devices;
+    int processingTimeMs;       // 모듈 기본 처리 시간
+    int capacity;               // 장치당 동시 처리 작업 수
+    QVector<int> deviceTimesMs; // 장치별 처리 시간 (앞쪽 장치부터, 없으면 모듈 기본값)
+    QMap<QString, int> skills;  // 이 모듈 장치가 함께 처리할 수 있는 다른 모듈 -> 처리 시간
+
+    ModuleConfig() : devices(1), processingTimeMs(0), capacity(1) {}
+
+    // deviceIndex는 1부터
+    int deviceTimeMs(int deviceIndex) const {
+        const int i = deviceIndex - 1;
+        return (i >= 0 && i < deviceTimesMs.size()) ? deviceTimesMs.at(i) : processingTimeMs;
+    }
+};
+
+// 로봇 장치 구성 (모듈 순서 = 조리 단계 순서)
+// 설정 파일 예:
+// { "modules": [ { "name": "Bread", "devices": 3, "processingTimeMs": 10000, "capacity": 2,
+//                  "deviceTimesMs": [10000, 10000, 12000] },
+//                { "name": "Cheese", "devices": 2, "skills": { "Jam": 5000 } }, ... ] }
+// processingTimeMs, capacity를 생략하면 모듈 이름에 따른 기본값을 사용합니다.
+// 모듈 목록은 서버가 주문 단계를 세는 순서(Bread, Cheese, Egg, Jam)와 같아야 하고,
+// 장치 수, 처리 시간, 용량, 추가 기능만 바꿀 수 있습니다.
+struct RobotConfig {
+    static const int MaxDevicesPerModule = 16;
+
+    QVector<ModuleConfig> modules;
+
+    // 서버의 주문 단계 순서대로의 모듈 이름
+    static QStringList pipelineModules();
+
+    // 기존 구성: 4개 모듈, 모듈당 장치 2대
+    static RobotConfig defaults();
+
+    // 잘못된 항목이 있으면 false와 함께 errorMessage에 이유를 채움 (config는 바뀌지 않음)
+    static bool fromJson(const QJsonObject& json, RobotConfig& config, QString& errorMessage);
+    static bool loadFile(const QString& path, RobotConfig& config, QString& errorMessage);
+    QJsonObject toJson() const;
+
+    int indexOf(const QString& module) const;
+    int totalDevices() const;
+};
+
+#endif // ROBOTCONFIG_H
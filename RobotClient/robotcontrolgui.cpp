@@ -1,10 +1,22 @@
 // robotcontrolgui.cpp
 #include "robotcontrolgui.h"
+#include "logging.h"
+#include <QDateTime>
 #include <QDebug>
 #include <QIntValidator>
 
 RobotControlGUI::RobotControlGUI(QWidget *parent)
+    : RobotControlGUI(RobotConfig::defaults(), parent)
+{
+}
+
+RobotControlGUI::RobotControlGUI(const RobotConfig& config, QWidget *parent)
     : QMainWindow(parent)
+    , ordersReceived(0)
+    , deviceStateSync(true)
+    , deviceStateSendPending(false)
+    , heldDeviceChangeLimit(MaxHeldDeviceChanges)
+    , deviceDisplayPending(false)
 {
     // GUI 초기화
     centralWidget = new QWidget(this);
@@ -14,34 +26,63 @@ RobotControlGUI::RobotControlGUI(QWidget *parent)
 
     // 매니저 객체 초기화
     networkManager = new NetworkManager(this, false);  // 클라이언트 모드
-    deviceManager = new DeviceManager(this);
+    deviceManager = new DeviceManager(config, this);
 
     // GUI 설정
     initializeGUI();
 
-    // 네트워크 이벤트 연결
+    // 네트워크 이벤트 연결 (서버가 보낸 주문은 화면을 거치지 않고 장치 매니저로 바로 감)
     connect(networkManager, &NetworkManager::messageReceived,
-            this, &RobotControlGUI::handleNetworkMessage);
+            deviceManager, &DeviceManager::handleServerMessage);
+    connect(deviceManager, &DeviceManager::orderReceived,
+            this, &RobotControlGUI::handleOrderReceived);
     connect(networkManager, &NetworkManager::errorOccurred,
             this, &RobotControlGUI::handleNetworkError);
     connect(networkManager, &NetworkManager::connected,
             this, &RobotControlGUI::handleNetworkConnection);
     connect(networkManager, &NetworkManager::disconnected,
             this, &RobotControlGUI::handleNetworkDisconnection);
+    connect(networkManager, &NetworkManager::sendBackpressure,
+            this, &RobotControlGUI::handleSendBackpressure);
 
     // 장치 매니저 이벤트 연결
     connect(deviceManager, &DeviceManager::deviceStatusChanged,
             this, &RobotControlGUI::handleDeviceStatusUpdate);
     connect(deviceManager, &DeviceManager::processingFinished,
             this, &RobotControlGUI::handleProcessingFinished);
+    connect(deviceManager, &DeviceManager::orderFinished,
+            this, &RobotControlGUI::handleOrderFinished);
+    connect(deviceManager, &DeviceManager::loadChanged,
+            this, &RobotControlGUI::sendLoadReport);
+    connect(deviceManager, &DeviceManager::deviceAdded,
+            this, &RobotControlGUI::handleDeviceAdded);
+    connect(deviceManager, &DeviceManager::deviceRemoved,
+            this, &RobotControlGUI::handleDeviceRemoved);
     connect(deviceManager, &DeviceManager::logMessage,
             this, &RobotControlGUI::appendLog);
 
+    // 주문 처리 중에는 이진 로그에 기록만 하고, 문장은 로그 창을 갱신할 때 만듦
+    // (main에서 --binary-log로 시작하지 않았으면 파일 없이 화면용으로만 시작)
+    deviceManager->setOrderEventText(false);
+    BinaryLogger& binaryLog = BinaryLogger::instance();
+    if (!binaryLog.isRunning()) {
+        QString error;
+        binaryLog.start(BinaryLogSettings(), error);
+    }
+    binaryLog.setTailEnabled(true);
+    logTailTimer = new QTimer(this);
+    connect(logTailTimer, &QTimer::timeout, this, &RobotControlGUI::showLoggedEvents);
+    logTailTimer->start(LogTailIntervalMs);
+
+    keyframeTimer = new QTimer(this);
+    connect(keyframeTimer, &QTimer::timeout, this, &RobotControlGUI::sendDeviceKeyframe);
+
     setWindowTitle("샌드위치 제조 로봇 제어 시스템");
 }
 
 RobotControlGUI::~RobotControlGUI()
 {
+    BinaryLogger::instance().setTailEnabled(false);
     delete networkManager;
     delete deviceManager;
 }
@@ -80,8 +121,49 @@ void RobotControlGUI::setupNetworkControl()
 
     mainLayout->addLayout(networkLayout);
 
+    // 스케줄링 정책 선택
+    QHBoxLayout *policyLayout = new QHBoxLayout;
+    QLabel *policyLabel = new QLabel("스케줄링 정책:", this);
+    policyComboBox = new QComboBox(this);
+    policyComboBox->addItems(SchedulingPolicy::availablePolicies());
+    policyComboBox->setCurrentText(deviceManager->schedulingPolicyName());
+
+    // 배치 대기 시간 (같은 재료의 주문을 모아 한 번에 처리)
+    QLabel *batchWindowLabel = new QLabel("배치 대기(초):", this);
+    batchWindowSpinBox = new QSpinBox(this);
+    batchWindowSpinBox->setRange(0, 30);
+    batchWindowSpinBox->setSpecialValueText("대기 안 함");
+    batchWindowSpinBox->setValue(deviceManager->batchWindowMs() / 1000);
+
+    policyLayout->addWidget(policyLabel);
+    policyLayout->addWidget(policyComboBox);
+    policyLayout->addWidget(batchWindowLabel);
+    policyLayout->addWidget(batchWindowSpinBox);
+    policyLayout->addStretch();
+    mainLayout->addLayout(policyLayout);
+
     connect(connectButton, &QPushButton::clicked,
             this, &RobotControlGUI::onConnectButtonClicked);
+    connect(policyComboBox, &QComboBox::currentTextChanged,
+            this, &RobotControlGUI::onSchedulingPolicyChanged);
+    connect(batchWindowSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &RobotControlGUI::onBatchWindowChanged);
+}
+
+void RobotControlGUI::onSchedulingPolicyChanged(const QString& policyName)
+{
+    SchedulingPolicy* policy = SchedulingPolicy::create(policyName);
+    if (!policy) {
+        appendLog(QString("알 수 없는 스케줄링 정책: %1").arg(policyName));
+        return;
+    }
+    deviceManager->setSchedulingPolicy(policy);
+}
+
+void RobotControlGUI::onBatchWindowChanged(int seconds)
+{
+    deviceManager->setBatchWindowMs(seconds * 1000);
+    appendLog(QString("배치 대기 시간 변경: %1초").arg(seconds));
 }
 
 void RobotControlGUI::setupDeviceStatus()
@@ -89,22 +171,35 @@ void RobotControlGUI::setupDeviceStatus()
     deviceStatusLabel = new QLabel("장치 상태:", this);
     mainLayout->addWidget(deviceStatusLabel);
 
+    // 장치 추가/제거 (로봇을 다시 시작하지 않고 병목 단계에 장치를 늘림)
+    QHBoxLayout *topologyLayout = new QHBoxLayout;
+    deviceModuleComboBox = new QComboBox(this);
+    deviceModuleComboBox->addItems(deviceManager->moduleNames());
+    addDeviceButton = new QPushButton("장치 추가", this);
+    removeDeviceButton = new QPushButton("장치 제거", this);
+    topologyLayout->addWidget(new QLabel("모듈:", this));
+    topologyLayout->addWidget(deviceModuleComboBox);
+    topologyLayout->addWidget(addDeviceButton);
+    topologyLayout->addWidget(removeDeviceButton);
+    topologyLayout->addStretch();
+    mainLayout->addLayout(topologyLayout);
+
+    connect(addDeviceButton, &QPushButton::clicked,
+            this, &RobotControlGUI::onAddDeviceClicked);
+    connect(removeDeviceButton, &QPushButton::clicked,
+            this, &RobotControlGUI::onRemoveDeviceClicked);
+
+    // 모듈마다 한 열, 장치마다 한 행 (설정 파일의 장치 구성에 맞춤)
     deviceGridLayout = new QGridLayout;
-    QStringList modules = {"Bread", "Cheese", "Egg", "Jam"};
-    QStringList translations = {"Bread", "Cheese", "Egg", "Jam"};
+    const QStringList modules = deviceManager->moduleNames();
 
     for (int i = 0; i < modules.size(); ++i) {
-        QLabel *moduleLabel = new QLabel(translations[i], this);
+        QLabel *moduleLabel = new QLabel(modules[i], this);
         deviceGridLayout->addWidget(moduleLabel, 0, i);
 
         QList<QLabel*> deviceLabels;
-        for (int j = 0; j < 2; ++j) {
-            QLabel *deviceLabel = new QLabel(QString("%1 %2: 대기 중")
-                                                 .arg(translations[i])
-                                                 .arg(j + 1), this);
-            deviceLabel->setStyleSheet(
-                "QLabel { background-color: gray; color: white; "
-                "padding: 5px; border-radius: 5px; }");
+        for (int j = 0; j < deviceManager->deviceCount(modules[i]); ++j) {
+            QLabel *deviceLabel = createDeviceLabel(modules[i], j + 1);
             deviceGridLayout->addWidget(deviceLabel, j + 1, i);
             deviceLabels.append(deviceLabel);
         }
@@ -114,6 +209,53 @@ void RobotControlGUI::setupDeviceStatus()
     mainLayout->addLayout(deviceGridLayout);
 }
 
+QLabel* RobotControlGUI::createDeviceLabel(const QString& module, int deviceIndex)
+{
+    QLabel *deviceLabel = new QLabel(QString("%1 %2: 대기 중").arg(module).arg(deviceIndex), this);
+    deviceLabel->setStyleSheet(
+        "QLabel { background-color: gray; color: white; "
+        "padding: 5px; border-radius: 5px; }");
+    return deviceLabel;
+}
+
+void RobotControlGUI::onAddDeviceClicked()
+{
+    if (deviceManager->addDevice(deviceModuleComboBox->currentText()) > 0 &&
+        networkManager->isConnectedToServer()) {
+        sendFlowControl();  // 보관 한도가 바뀌었으므로 서버에 알림
+    }
+}
+
+void RobotControlGUI::onRemoveDeviceClicked()
+{
+    if (deviceManager->removeDevice(deviceModuleComboBox->currentText()) &&
+        networkManager->isConnectedToServer()) {
+        sendFlowControl();
+    }
+}
+
+void RobotControlGUI::handleDeviceAdded(const QString& module, int deviceIndex)
+{
+    const int column = deviceManager->moduleNames().indexOf(module);
+    if (column < 0) {
+        return;
+    }
+
+    QLabel *deviceLabel = createDeviceLabel(module, deviceIndex);
+    deviceGridLayout->addWidget(deviceLabel, deviceIndex, column);
+    deviceLabelMap[module].append(deviceLabel);
+}
+
+void RobotControlGUI::handleDeviceRemoved(const QString& module, int deviceIndex)
+{
+    QList<QLabel*>& deviceLabels = deviceLabelMap[module];
+    if (deviceIndex - 1 < deviceLabels.size()) {
+        QLabel *deviceLabel = deviceLabels.takeAt(deviceIndex - 1);
+        deviceGridLayout->removeWidget(deviceLabel);
+        deviceLabel->deleteLater();
+    }
+}
+
 void RobotControlGUI::setupLogArea()
 {
     logLabel = new QLabel("작업 로그:", this);
@@ -127,9 +269,9 @@ void RobotControlGUI::setupLogArea()
 
 void RobotControlGUI::onConnectButtonClicked()
 {
-    if (networkManager->isServerRunning()) {
+    if (networkManager->isConnectedToServer()) {
         // 연결 해제
-        networkManager->stopServer();  // stopServer가 연결 해제도 처리
+        networkManager->disconnectFromServer();
         connectButton->setText("연결");
         serverAddressEdit->setEnabled(true);
         serverPortEdit->setEnabled(true);
@@ -151,27 +293,29 @@ void RobotControlGUI::onConnectButtonClicked()
             return;
         }
 
-        if (networkManager->connectToServer(serverAddressEdit->text(), port)) {
-            connectButton->setText("연결 해제");
-            updateNetworkStatus("서버에 연결됨", "green");
-        }
-        connectButton->setEnabled(true);
+        // 결과는 기다리지 않고 connected/errorOccurred를 받아 화면을 바꿈
+        networkManager->connectToServer(serverAddressEdit->text(), port);
     }
 }
 
-void RobotControlGUI::handleNetworkMessage(const Message& message)
+void RobotControlGUI::handleOrderReceived(int orderId, bool accepted)
 {
-    switch (message.type) {
-    case MessageType::ORDER_NEW: {
-        OrderMessage order = OrderMessage::fromJson(message.data);
-        appendLog(QString("새 주문 수신 (ID: %1)").arg(order.orderId));
-        deviceManager->processNewOrder(order);
-        break;
-    }
-    default:
-        qDebug() << "Unknown message type received";
-        break;
+    ordersReceived++;
+    if (accepted) {
+        return;
     }
+
+    // 거절한 주문은 서버 대기열로 돌려보냄
+    Message reject;
+    reject.type = MessageType::ERROR_REPORT;
+    QJsonObject data;
+    data["orderId"] = orderId;
+    data["reason"] = QString("로봇 보관 한도 초과 (%1/%2)")
+                         .arg(deviceManager->backlog())
+                         .arg(deviceManager->maxBacklog());
+    reject.data = data;
+    networkManager->sendMessage(reject);
+    sendFlowControl();
 }
 
 void RobotControlGUI::handleNetworkError(const QString& error)
@@ -186,6 +330,56 @@ void RobotControlGUI::handleNetworkError(const QString& error)
 void RobotControlGUI::handleNetworkConnection()
 {
     updateNetworkStatus("서버에 연결됨", "green");
+    connectButton->setText("연결 해제");
+    connectButton->setEnabled(true);
+
+    // 새 연결마다 받은 주문 수를 다시 세고 현재 여유를 알림
+    ordersReceived = 0;
+    sendLoadReport();
+    sendFlowControl();
+
+    // 새 연결은 장치/작업 표부터 다시 받으므로 현재 상태를 키프레임으로 보냄
+    if (deviceStateSync) {
+        deviceStateEncoder.reset();
+        sendDeviceState();
+        keyframeTimer->start(KeyframeIntervalMs);
+    }
+}
+
+void RobotControlGUI::sendFlowControl()
+{
+    FlowControlMessage flow;
+    flow.window = deviceManager->maxBacklog();
+    flow.backlog = deviceManager->backlog();
+    flow.received = ordersReceived;
+    flow.limit = ordersReceived + qMax(0, flow.window - flow.backlog);
+
+    Message message;
+    message.type = MessageType::FLOW_CONTROL;
+    message.data = flow.toJson();
+    networkManager->sendMessage(message);
+}
+
+void RobotControlGUI::sendLoadReport()
+{
+    // 밀려 있는 동안은 보내지 않고 풀릴 때 최신 부하를 한 번 보냄
+    if (!networkManager->isConnectedToServer() || networkManager->isSendCongested()) {
+        return;
+    }
+
+    RobotLoadMessage load = deviceManager->loadReport();
+    load.received = ordersReceived;
+
+    Message message;
+    message.type = MessageType::ROBOT_LOAD;
+    message.data = load.toJson();
+    networkManager->sendMessage(message);
+}
+
+void RobotControlGUI::handleOrderFinished(int orderId)
+{
+    Q_UNUSED(orderId);
+    sendFlowControl();
 }
 
 void RobotControlGUI::handleNetworkDisconnection()
@@ -194,6 +388,23 @@ void RobotControlGUI::handleNetworkDisconnection()
     connectButton->setText("연결");
     serverAddressEdit->setEnabled(true);
     serverPortEdit->setEnabled(true);
+    keyframeTimer->stop();
+}
+
+void RobotControlGUI::handleSendBackpressure(int connectionId, bool congested)
+{
+    Q_UNUSED(connectionId);
+    if (congested) {
+        appendLog("서버가 데이터를 늦게 읽어 상태 보고를 모아 둡니다");
+        return;
+    }
+
+    // 밀린 동안 모은 장치 상태 변경과 최신 부하를 이어서 보냄
+    appendLog("서버 전송이 풀려 상태 보고를 다시 보냅니다");
+    sendLoadReport();
+    if (deviceStateSync) {
+        sendDeviceState();
+    }
 }
 
 void RobotControlGUI::updateNetworkStatus(const QString& status, const QString& color)
@@ -204,16 +415,37 @@ void RobotControlGUI::updateNetworkStatus(const QString& status, const QString&
 }
 
 void RobotControlGUI::handleDeviceStatusUpdate(const QString& module, int deviceIndex,
-                                               DeviceStatus status, const QString& currentTask)
+                                               DeviceStatus status, const QString& currentTask,
+                                               int orderId)
 {
-    updateDeviceStatusDisplay(module, deviceIndex, status, currentTask);
-
     // 상태 업데이트를 서버에 전송
     DeviceStatusMessage statusMsg;
     statusMsg.moduleType = module;
     statusMsg.deviceIndex = deviceIndex;
     statusMsg.status = status;
     statusMsg.currentTask = currentTask;
+    statusMsg.orderId = orderId;
+
+    dirtyDevices.insert(qMakePair(module, deviceIndex), statusMsg);
+    if (!deviceDisplayPending) {
+        deviceDisplayPending = true;
+        QTimer::singleShot(0, this, &RobotControlGUI::refreshDeviceDisplay);
+    }
+
+    if (deviceStateSync) {
+        // 바뀐 필드만 기록해 두고 이번 이벤트 처리가 끝나면 한 메시지로 보냄
+        deviceStateEncoder.update(statusMsg);
+        if (deviceStateEncoder.pendingCount() > heldDeviceChangeLimit && networkManager->isSendCongested()) {
+            // 주문 단계 전환은 남지만 받은 주문 수만큼만 늘어남 (흐름 제어로 제한됨)
+            deviceStateEncoder.collapsePending();
+            heldDeviceChangeLimit = deviceStateEncoder.pendingCount() + MaxHeldDeviceChanges;
+        }
+        if (!deviceStateSendPending) {
+            deviceStateSendPending = true;
+            QTimer::singleShot(0, this, &RobotControlGUI::sendDeviceState);
+        }
+        return;
+    }
 
     Message message;
     message.type = MessageType::DEVICE_STATUS_UPDATE;
@@ -221,6 +453,42 @@ void RobotControlGUI::handleDeviceStatusUpdate(const QString& module, int device
     networkManager->sendMessage(message);
 }
 
+void RobotControlGUI::sendDeviceState()
+{
+    deviceStateSendPending = false;
+    if (!networkManager->isConnectedToServer()) {
+        // 연결하면 현재 상태를 키프레임으로 보내므로 쌓아 둘 필요 없음
+        deviceStateEncoder.reset();
+        heldDeviceChangeLimit = MaxHeldDeviceChanges;
+        return;
+    }
+    // 밀려 있는 동안은 변경을 인코더에 모아 두었다가 풀리면 한 메시지로 보냄
+    if (!deviceStateEncoder.hasPending() || networkManager->isSendCongested()) {
+        return;
+    }
+
+    Message message;
+    message.type = MessageType::DEVICE_STATE_SYNC;
+    message.data = deviceStateEncoder.takeMessage().toJson();
+    networkManager->sendMessage(message);
+    heldDeviceChangeLimit = MaxHeldDeviceChanges;
+}
+
+void RobotControlGUI::sendDeviceKeyframe()
+{
+    deviceStateEncoder.requestKeyframe();
+    sendDeviceState();
+}
+
+void RobotControlGUI::refreshDeviceDisplay()
+{
+    deviceDisplayPending = false;
+    for (const DeviceStatusMessage& status : dirtyDevices) {
+        updateDeviceStatusDisplay(status.moduleType, status.deviceIndex, status.status, status.currentTask);
+    }
+    dirtyDevices.clear();
+}
+
 void RobotControlGUI::updateDeviceStatusDisplay(const QString& module, int deviceIndex,
                                                 DeviceStatus status, const QString& currentTask)
 {
@@ -246,8 +514,7 @@ void RobotControlGUI::updateDeviceStatusDisplay(const QString& module, int devic
 
 void RobotControlGUI::handleProcessingFinished(const QString& module, int deviceIndex, int orderId)
 {
-    appendLog(QString("작업 완료 - 모듈: %1, 장치: %2, 주문 ID: %3")
-                  .arg(module).arg(deviceIndex).arg(orderId));
+    BinaryLogger::instance().log(LogEvent::TaskFinished, module, deviceIndex, orderId);
 
     // 작업 완료 메시지를 서버에 전송
     Message message;
@@ -262,9 +529,31 @@ void RobotControlGUI::handleProcessingFinished(const QString& module, int device
     networkManager->sendMessage(message);
 }
 
+void RobotControlGUI::showLoggedEvents()
+{
+    // 로봇 프로세스의 이진 로그에는 로봇 이벤트만 있으므로 모두 표시
+    const QVector<LogRecord> records = BinaryLogger::instance().takeTail();
+
+    // 한꺼번에 많이 쌓였으면 최근 것만 표시 (전체 기록은 --binary-log 파일에 있음)
+    int first = 0;
+    if (records.size() > MaxLoggedEventsPerUpdate) {
+        first = records.size() - MaxLoggedEventsPerUpdate;
+        appendLog(QString("주문 기록 %1건 생략").arg(first));
+    }
+    for (int i = first; i < records.size(); ++i) {
+        appendLogAt(BinaryLog::render(records.at(i)),
+                    QDateTime::fromMSecsSinceEpoch(records.at(i).wallMs).time());
+    }
+}
+
 void RobotControlGUI::appendLog(const QString& message)
 {
-    QString timestamp = QTime::currentTime().toString("hh:mm:ss");
+    appendLogAt(message, QTime::currentTime());
+}
+
+void RobotControlGUI::appendLogAt(const QString& message, const QTime& time)
+{
+    QString timestamp = time.toString("hh:mm:ss");
     logTextEdit->append(QString("[%1] %2").arg(timestamp).arg(message));
 }
 
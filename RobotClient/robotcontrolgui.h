@@ -9,8 +9,13 @@
 #include <QVBoxLayout>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QComboBox>
+#include <QSpinBox>
+#include <QTimer>
+#include "binarylog.h"
 #include "networkmanager.h"
 #include "devicemanager.h"
+#include "devicestatesync.h"
 
 class RobotControlGUI : public QMainWindow
 {
@@ -18,18 +23,36 @@ class RobotControlGUI : public QMainWindow
 
 public:
     explicit RobotControlGUI(QWidget *parent = nullptr);
+    explicit RobotControlGUI(const RobotConfig& config, QWidget *parent = nullptr);
     ~RobotControlGUI() override;
 
+    // 장치 상태를 키프레임 + 변경분(DEVICE_STATE_SYNC)으로 보낼지 (기본 켜짐)
+    // 끄면 예전처럼 변경마다 DEVICE_STATUS_UPDATE 전체를 보냄
+    void setDeviceStateSync(bool enabled) { deviceStateSync = enabled; }
+
 private slots:
     void onConnectButtonClicked();
-    void handleNetworkMessage(const Message& message);
+    void onSchedulingPolicyChanged(const QString& policyName);
+    void onBatchWindowChanged(int seconds);
+    void onAddDeviceClicked();
+    void onRemoveDeviceClicked();
+    void handleDeviceAdded(const QString& module, int deviceIndex);
+    void handleDeviceRemoved(const QString& module, int deviceIndex);
+    void handleOrderReceived(int orderId, bool accepted);
     void handleNetworkError(const QString& error);
     void handleNetworkConnection();
     void handleNetworkDisconnection();
+    void handleSendBackpressure(int connectionId, bool congested);
     void handleDeviceStatusUpdate(const QString& module, int deviceIndex,
-                                  DeviceStatus status, const QString& currentTask);
+                                  DeviceStatus status, const QString& currentTask,
+                                  int orderId = 0);
     void handleProcessingFinished(const QString& module, int deviceIndex, int orderId);
+    void handleOrderFinished(int orderId);
     void appendLog(const QString& message);
+    void showLoggedEvents();
+    void sendDeviceState();
+    void sendDeviceKeyframe();
+    void refreshDeviceDisplay();
 
 private:
     // GUI 요소
@@ -42,27 +65,58 @@ private:
     QPushButton *connectButton;
     QLabel *networkStatusLabel;
 
+    // 스케줄링 정책 선택
+    QComboBox *policyComboBox;
+    QSpinBox *batchWindowSpinBox;
+
     // 장치 상태 표시
     QLabel *deviceStatusLabel;
     QGridLayout *deviceGridLayout;
     QMap<QString, QList<QLabel*>> deviceLabelMap;
+    // 한 번 깨어날 때 바뀐 장치는 마지막 상태만 모아 라벨을 한 번씩 다시 그림
+    QMap<QPair<QString, int>, DeviceStatusMessage> dirtyDevices;
+    bool deviceDisplayPending;
+    QComboBox *deviceModuleComboBox;
+    QPushButton *addDeviceButton;
+    QPushButton *removeDeviceButton;
 
     // 로그 표시
     QLabel *logLabel;
     QTextEdit *logTextEdit;
+    QTimer *logTailTimer;       // 주문마다 남는 기록은 이진 로그에서 모아 주기적으로 표시
+
+    // 로그 창 갱신 주기와 한 번에 표시하는 주문 기록 수 (넘으면 최근 것만)
+    static const int LogTailIntervalMs = 250;
+    static const int MaxLoggedEventsPerUpdate = 200;
 
     // 매니저 객체
     NetworkManager *networkManager;
     DeviceManager *deviceManager;
 
+    // 흐름 제어 (이번 연결에서 받은 주문 수)
+    int ordersReceived;
+
+    // 장치 상태 동기화 (한 번 깨어날 때 생긴 변경을 메시지 하나로 모아 보냄)
+    DeviceStateEncoder deviceStateEncoder;
+    bool deviceStateSync;
+    bool deviceStateSendPending;
+    QTimer *keyframeTimer;      // 서버가 놓친 상태를 바로잡도록 주기적으로 키프레임 전송
+    static const int KeyframeIntervalMs = 10000;
+    static const int MaxHeldDeviceChanges = 4096;   // 전송이 밀린 동안 모아 두는 변경 수 (넘으면 주문 없는 변경을 키프레임으로 접음)
+    int heldDeviceChangeLimit;  // 접고도 남은 주문 변경 위로 다시 MaxHeldDeviceChanges만큼 쌓이면 다시 접음
+
     // GUI 초기화 함수
     void initializeGUI();
     void setupNetworkControl();
     void setupDeviceStatus();
     void setupLogArea();
+    QLabel* createDeviceLabel(const QString& module, int deviceIndex);
     void updateDeviceStatusDisplay(const QString& module, int deviceIndex,
                                    DeviceStatus status, const QString& currentTask = "");
     void updateNetworkStatus(const QString& status, const QString& color);
+    void appendLogAt(const QString& message, const QTime& time);
+    void sendFlowControl();
+    void sendLoadReport();
 };
 
 #endif // ROBOTCONTROLGUI_H
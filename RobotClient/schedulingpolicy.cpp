@@ -0,0 +1,192 @@
+// schedulingpolicy.cpp
+#include "schedulingpolicy.h"
+
+namespace {
+// 동점일 때는 먼저 들어온 주문 우선
+bool arrivedEarlier(const SchedulingCandidate& a, const SchedulingCandidate& b)
+{
+    if (a.arrivalMs != b.arrivalMs) {
+        return a.arrivalMs < b.arrivalMs;
+    }
+    return a.orderId < b.orderId;
+}
+
+// 순서를 유지하지 않는 제거 (마지막 원소를 빈자리로 이동)
+SchedulingCandidate takeAt(QVector<SchedulingCandidate>& candidates, int index)
+{
+    const SchedulingCandidate candidate = candidates.at(index);
+    candidates[index] = candidates.last();
+    candidates.removeLast();
+    return candidate;
+}
+}
+
+void SchedulingPolicy::taskDispatched(const SchedulingCandidate& candidate, qint64 serviceMs)
+{
+    Q_UNUSED(candidate);
+    Q_UNUSED(serviceMs);
+}
+
+QVector<SchedulingCandidate> SchedulingPolicy::takeBatch(QVector<SchedulingCandidate>& candidates,
+                                                         qint64 nowMs, int capacity)
+{
+    QVector<SchedulingCandidate> batch;
+    batch.append(takeAt(candidates, selectNext(candidates, nowMs)));
+
+    const QString key = batch.first().batchKey;
+    if (capacity <= 1 || key.isEmpty()) {
+        return batch;
+    }
+
+    // 같은 재료의 작업만 모아 정책에 다시 묻기
+    QVector<SchedulingCandidate> compatible;
+    for (int i = candidates.size() - 1; i >= 0; --i) {
+        if (candidates.at(i).batchKey == key) {
+            compatible.append(takeAt(candidates, i));
+        }
+    }
+    while (batch.size() < capacity && !compatible.isEmpty()) {
+        batch.append(takeAt(compatible, selectNext(compatible, nowMs)));
+    }
+
+    // 이번 배치에 들지 못한 작업은 되돌려 놓음
+    candidates += compatible;
+    return batch;
+}
+
+qint64 SchedulingPolicy::slaMs(OrderPriority priority)
+{
+    switch (priority) {
+    case OrderPriority::HIGH: return 3 * 60 * 1000;     // 3분
+    case OrderPriority::NORMAL: return 10 * 60 * 1000;  // 10분
+    case OrderPriority::LOW: return 20 * 60 * 1000;     // 20분
+    }
+    return 10 * 60 * 1000;
+}
+
+qint64 SchedulingPolicy::effectiveDeadline(const SchedulingCandidate& candidate)
+{
+    if (candidate.deadlineMs > 0) {
+        return candidate.deadlineMs;
+    }
+    return candidate.arrivalMs + slaMs(candidate.priority);
+}
+
+SchedulingPolicy* SchedulingPolicy::create(const QString& name)
+{
+    const QString key = name.toUpper();
+    if (key == "FIFO") return new FifoPolicy;
+    if (key == "EDF") return new EdfPolicy;
+    if (key == "SRPT") return new SrptPolicy;
+    if (key == "WFQ") return new WeightedFairPolicy;
+    return nullptr;
+}
+
+QStringList SchedulingPolicy::availablePolicies()
+{
+    return QStringList() << "FIFO" << "EDF" << "SRPT" << "WFQ";
+}
+
+int FifoPolicy::selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs)
+{
+    Q_UNUSED(nowMs);
+
+    int best = 0;
+    for (int i = 1; i < candidates.size(); ++i) {
+        if (arrivedEarlier(candidates.at(i), candidates.at(best))) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+int EdfPolicy::selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs)
+{
+    Q_UNUSED(nowMs);
+
+    int best = 0;
+    qint64 bestDeadline = effectiveDeadline(candidates.at(0));
+    for (int i = 1; i < candidates.size(); ++i) {
+        const qint64 deadline = effectiveDeadline(candidates.at(i));
+        if (deadline < bestDeadline ||
+            (deadline == bestDeadline && arrivedEarlier(candidates.at(i), candidates.at(best)))) {
+            best = i;
+            bestDeadline = deadline;
+        }
+    }
+    return best;
+}
+
+int SrptPolicy::selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs)
+{
+    Q_UNUSED(nowMs);
+
+    int best = 0;
+    for (int i = 1; i < candidates.size(); ++i) {
+        const SchedulingCandidate& c = candidates.at(i);
+        const SchedulingCandidate& b = candidates.at(best);
+        if (c.remainingWorkMs < b.remainingWorkMs ||
+            (c.remainingWorkMs == b.remainingWorkMs && arrivedEarlier(c, b))) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+WeightedFairPolicy::WeightedFairPolicy()
+    : virtualTime(0.0)
+{
+    for (int i = 0; i < ChannelCount; ++i) {
+        weights[i] = 1.0;
+        virtualService[i] = 0.0;
+    }
+    // 배달 주문은 픽업 시간이 정해져 있어 더 많은 몫을 받음
+    weights[static_cast<int>(OrderChannel::DELIVERY)] = 2.0;
+}
+
+void WeightedFairPolicy::setWeight(OrderChannel channel, double weight)
+{
+    const int index = static_cast<int>(channel);
+    if (index >= 0 && index < ChannelCount && weight > 0.0) {
+        weights[index] = weight;
+    }
+}
+
+double WeightedFairPolicy::weight(OrderChannel channel) const
+{
+    const int index = static_cast<int>(channel);
+    return (index >= 0 && index < ChannelCount) ? weights[index] : 1.0;
+}
+
+int WeightedFairPolicy::channelIndex(OrderChannel channel)
+{
+    const int index = static_cast<int>(channel);
+    return (index >= 0 && index < ChannelCount) ? index : 0;
+}
+
+int WeightedFairPolicy::selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs)
+{
+    Q_UNUSED(nowMs);
+
+    int best = -1;
+    double bestService = 0.0;
+    for (int i = 0; i < candidates.size(); ++i) {
+        const int channel = channelIndex(candidates.at(i).channel);
+        // 한동안 대기 작업이 없던 채널은 현재 가상 시간부터 다시 경쟁
+        const double service = qMax(virtualService[channel], virtualTime);
+        if (best < 0 || service < bestService ||
+            (service == bestService && arrivedEarlier(candidates.at(i), candidates.at(best)))) {
+            best = i;
+            bestService = service;
+        }
+    }
+    return best;
+}
+
+void WeightedFairPolicy::taskDispatched(const SchedulingCandidate& candidate, qint64 serviceMs)
+{
+    const int channel = channelIndex(candidate.channel);
+    const double start = qMax(virtualService[channel], virtualTime);
+    virtualTime = start;
+    virtualService[channel] = start + static_cast<double>(serviceMs) / weights[channel];
+}
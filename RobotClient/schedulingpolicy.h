@@ -0,0 +1,100 @@
+// schedulingpolicy.h
+#ifndef SCHEDULINGPOLICY_H
+#define SCHEDULINGPOLICY_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "message.h"
+#include "ordertable.h"
+
+// 특정 모듈 단계를 기다리는 작업 (스케줄링 후보)
+struct SchedulingCandidate {
+    OrderHandle handle;
+    int orderId;
+    int step;
+    qint64 arrivalMs;       // 주문 수신 시각
+    qint64 deadlineMs;      // 약속 시각 (0이면 지정 없음)
+    OrderPriority priority;
+    OrderChannel channel;
+    qint64 remainingWorkMs; // 남은 단계 처리 시간 합
+    qint64 readyMs;         // 현재 단계를 기다리기 시작한 시각
+    QString batchKey;       // 값이 같으면 한 장치에서 함께 처리 가능 (비어 있으면 단독 처리)
+};
+
+// 스케줄링 정책 인터페이스
+// 장치가 비었을 때 해당 모듈의 대기 작업 중 무엇을 먼저 처리할지 결정합니다.
+class SchedulingPolicy
+{
+public:
+    virtual ~SchedulingPolicy() {}
+
+    virtual QString name() const = 0;
+
+    // candidates 중 다음에 장치를 배정할 후보의 인덱스 반환 (candidates는 비어 있지 않음)
+    virtual int selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs) = 0;
+
+    // 작업이 장치에 배정되었음을 통지 (serviceMs: 해당 단계 처리 시간)
+    virtual void taskDispatched(const SchedulingCandidate& candidate, qint64 serviceMs);
+
+    // selectNext로 고른 작업과 batchKey가 같은 작업을 정책 순서대로 최대 capacity개 꺼냄
+    // 반환 목록의 첫 번째가 정책이 고른 작업이며, 꺼낸 작업은 candidates에서 제거됨
+    QVector<SchedulingCandidate> takeBatch(QVector<SchedulingCandidate>& candidates,
+                                           qint64 nowMs, int capacity);
+
+    // 약속 시각이 없는 주문은 우선순위별 SLA로 마감 시각을 정함
+    static qint64 slaMs(OrderPriority priority);
+    static qint64 effectiveDeadline(const SchedulingCandidate& candidate);
+
+    // 이름으로 정책 생성 ("FIFO", "EDF", "SRPT", "WFQ"), 알 수 없으면 nullptr
+    static SchedulingPolicy* create(const QString& name);
+    static QStringList availablePolicies();
+};
+
+// 도착 순서 (기존 동작)
+class FifoPolicy : public SchedulingPolicy
+{
+public:
+    QString name() const override { return "FIFO"; }
+    int selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs) override;
+};
+
+// 마감 시각이 가장 이른 작업 우선
+class EdfPolicy : public SchedulingPolicy
+{
+public:
+    QString name() const override { return "EDF"; }
+    int selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs) override;
+};
+
+// 남은 처리 시간이 가장 짧은 작업 우선
+class SrptPolicy : public SchedulingPolicy
+{
+public:
+    QString name() const override { return "SRPT"; }
+    int selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs) override;
+};
+
+// 채널별 가중치에 따라 처리 시간을 나누는 공정 분배 (채널 내부는 도착 순서)
+class WeightedFairPolicy : public SchedulingPolicy
+{
+public:
+    WeightedFairPolicy();
+
+    QString name() const override { return "WFQ"; }
+    int selectNext(const QVector<SchedulingCandidate>& candidates, qint64 nowMs) override;
+    void taskDispatched(const SchedulingCandidate& candidate, qint64 serviceMs) override;
+
+    void setWeight(OrderChannel channel, double weight);
+    double weight(OrderChannel channel) const;
+
+private:
+    static const int ChannelCount = 3;
+    double weights[ChannelCount];
+    double virtualService[ChannelCount];    // 가중치로 나눈 누적 처리 시간
+    double virtualTime;                     // 마지막으로 선택된 채널의 가상 시간
+
+    static int channelIndex(OrderChannel channel);
+};
+
+#endif // SCHEDULINGPOLICY_H
@@ -0,0 +1,74 @@
+// sharedmemoryring.h
+#ifndef SHAREDMEMORYRING_H
+#define SHAREDMEMORYRING_H
+
+#include <QByteArray>
+#include <atomic>
+
+// 공유 메모리 위에 놓는 가변 길이 메시지 링 (단일 생산자/단일 소비자, 잠금 없음)
+// 같은 호스트의 두 프로세스가 같은 영역을 각자 bind해서 한쪽은 write, 다른 쪽은 read만 합니다.
+// 기록 하나는 quint32 길이 + 본문이고 링 끝에서는 앞으로 이어서 씁니다 (같은 호스트라 바이트 순서는 그대로).
+// 링에 한 번에 들어가지 않는 본문은 생산자가 조각으로 나눠 쓰고(길이의 최상위 비트 = 뒤에 조각이 더 있음),
+// 소비자의 read는 마지막 조각까지 읽었을 때 이어 붙인 본문 하나를 돌려줍니다.
+//
+// 깨우기 규칙은 SpscQueue와 같습니다:
+//   생산자: write 후 requestWake()가 true면 소비자에게 한 번 알림
+//   소비자: 다 읽은 뒤 finishWake()가 true면 이어서 읽음
+// 링이 가득 차서 못 쓴 생산자는 markWriterWaiting()으로 표시하고, 소비자는 읽은 뒤
+// takeWriterWaiting()이 true면 생산자에게 자리가 났다고 알립니다.
+class SharedMemoryRing
+{
+public:
+    static const int HeaderSize = 256;
+
+    // capacity 바이트(2의 거듭제곱) 링에 필요한 공유 메모리 크기
+    static int bytesFor(int capacity) { return HeaderSize + capacity; }
+
+    SharedMemoryRing();
+
+    // memory는 bytesFor(capacity) 바이트 이상이어야 함
+    void bind(void* memory, int capacity);
+    // 영역을 만든 쪽에서 상대가 bind하기 전에 한 번 호출
+    void initialize();
+    bool isBound() const { return header != nullptr; }
+    int capacity() const { return static_cast<int>(mask + 1); }
+
+    // 생산자: 자리가 없으면 false (capacity() - 4바이트보다 큰 본문은 조각으로 나눠 써야 함)
+    bool write(const QByteArray& payload);
+    // 생산자: 본문의 한 조각을 씀, more가 true면 같은 본문의 조각이 뒤에 이어짐
+    bool write(const char* source, int size, bool more);
+    // 소비자: 비어 있거나 아직 마지막 조각이 오지 않았으면 false (읽은 조각은 다음 호출까지 보관)
+    bool read(QByteArray& payload);
+    bool isEmpty() const;
+    // 생산자: 상대가 아직 읽지 않은 바이트 (길이 접두어 포함)
+    int usedBytes() const;
+
+    bool requestWake();
+    bool finishWake();
+
+    void markWriterWaiting();
+    bool takeWriterWaiting();
+
+private:
+    // 다른 프로세스와 공유하는 머리말 (원자 변수는 주소와 무관하게 잠금 없이 동작해야 함)
+    struct Header {
+        std::atomic<quint32> head;      // 다음에 쓸 위치 (생산자만 증가)
+        char padding0[60];
+        std::atomic<quint32> tail;      // 다음에 읽을 위치 (소비자만 증가)
+        char padding1[60];
+        std::atomic<quint32> wakePending;
+        std::atomic<quint32> writerWaiting;
+    };
+
+    static const quint32 MoreFragments = 0x80000000u;
+
+    void copyIn(quint32 position, const char* source, int size);
+    void copyOut(quint32 position, char* target, int size) const;
+
+    Header* header;
+    char* data;
+    quint32 mask;
+    QByteArray partial;     // 소비자: 이어 붙이는 중인 조각 (이 프로세스에만 있음)
+};
+
+#endif // SHAREDMEMORYRING_H
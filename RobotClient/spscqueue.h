@@ -0,0 +1,103 @@
+// spscqueue.h
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// 고정 크기 단일 생산자/단일 소비자 대기열 (잠금 없음)
+// 칸은 생성할 때 한 번만 할당하고, push/pop은 값 이동과 원자 변수 읽기/쓰기 몇 번으로 끝납니다.
+// push는 생산자 스레드 하나, pop은 소비자 스레드 하나에서만 호출해야 합니다.
+//
+// 소비자 깨우기는 호출 측에서 wakePending 같은 플래그로 묶어서 보냅니다:
+//   생산자: push 후 requestWake()가 true면 소비자에게 한 번 알림
+//   소비자: finishWake() 후 다시 비어 있지 않으면 이어서 처리 (알림 사이에 들어온 항목을 놓치지 않음)
+template <typename T>
+class SpscQueue
+{
+public:
+    // capacity는 2의 거듭제곱으로 올림
+    explicit SpscQueue(int capacity)
+        : head(0)
+        , tail(0)
+        , wakePending(false)
+    {
+        int size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        slots.resize(size);
+        mask = static_cast<quint32>(size - 1);
+    }
+
+    int capacity() const { return static_cast<int>(slots.size()); }
+
+    // 생산자: 가득 차면 false (value는 그대로)
+    bool push(T&& value)
+    {
+        const quint32 position = head.load(std::memory_order_relaxed);
+        if (position - tail.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        slots[position & mask] = std::move(value);
+        // 깨우기 플래그와 순서를 맞추려고 seq_cst (finishWake 참고)
+        head.store(position + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    bool push(const T& value)
+    {
+        T copy(value);
+        return push(std::move(copy));
+    }
+
+    // 소비자: 비어 있으면 false
+    bool pop(T& value)
+    {
+        const quint32 position = tail.load(std::memory_order_relaxed);
+        if (position == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        T& slot = slots[position & mask];
+        value = std::move(slot);
+        slot = T();     // 공유 데이터(QByteArray 등)의 참조를 바로 놓음
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return tail.load(std::memory_order_relaxed) == head.load(std::memory_order_seq_cst);
+    }
+
+    int size() const
+    {
+        return static_cast<int>(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire));
+    }
+
+    // 생산자: 소비자가 이미 깨어날 예정이 아니면 true (이때만 알림을 보냄)
+    bool requestWake() { return !wakePending.exchange(true, std::memory_order_seq_cst); }
+
+    // 소비자: 처리를 마쳤을 때. 그 사이에 들어온 항목이 있어 계속 처리해야 하면 true
+    bool finishWake()
+    {
+        wakePending.store(false, std::memory_order_seq_cst);
+        return !isEmpty() && requestWake();
+    }
+
+private:
+    std::vector<T> slots;
+    quint32 mask;
+    // 생산자와 소비자가 각자 쓰는 위치는 다른 캐시 줄에 둠
+    // (alignas는 C++17 전에는 힙 할당에서 보장되지 않으므로 채움 바이트 사용)
+    char padding0[64];
+    std::atomic<quint32> head;      // 다음에 쓸 위치 (생산자만 증가)
+    char padding1[64];
+    std::atomic<quint32> tail;      // 다음에 읽을 위치 (소비자만 증가)
+    char padding2[64];
+    std::atomic<bool> wakePending;
+};
+
+#endif // SPSCQUEUE_H
@@ -1,6 +1,7 @@
 // test_device.cpp
 #include <QtTest/QtTest>
 #include "device.h"
+#include "clock.h"
 
 class TestDevice : public QObject {
     Q_OBJECT
@@ -10,6 +11,8 @@ private slots:
     void testProcessTask();
     void testProcessTaskWhileBusy();
     void testSignalEmissions();
+    void testProcessSkillTask();
+    void testSubmitThroughRings();
 };
 
 void TestDevice::testInitialization() {
@@ -20,19 +23,27 @@ void TestDevice::testInitialization() {
 }
 
 void TestDevice::testProcessTask() {
+    ManualClock clock;
     Device device("Cheese", 2, nullptr);
+    device.setClock(&clock);
     QSignalSpy statusSpy(&device, &Device::statusChanged);
     QSignalSpy taskSpy(&device, &Device::taskCompleted);
 
     device.processTask(101, "Make Cheese Sandwich");
+    QCOMPARE(statusSpy.count(), 1);
 
-    QVERIFY(statusSpy.wait());
+    // 치즈는 3초: 그 전에는 끝나지 않음
+    clock.advance(2999);
+    QCOMPARE(taskSpy.count(), 0);
+    clock.advance(1);
     QCOMPARE(statusSpy.count(), 2);
     QCOMPARE(taskSpy.count(), 1);
 }
 
 void TestDevice::testProcessTaskWhileBusy() {
+    ManualClock clock;
     Device device("Egg", 3, nullptr);
+    device.setClock(&clock);
     QSignalSpy errorSpy(&device, &Device::errorOccurred);
 
     device.processTask(102, "Cook Eggs");
@@ -42,13 +53,15 @@ void TestDevice::testProcessTaskWhileBusy() {
 }
 
 void TestDevice::testSignalEmissions() {
+    ManualClock clock;
     Device device("Jam", 4, nullptr);
+    device.setClock(&clock);
     QSignalSpy statusSpy(&device, &Device::statusChanged);
     QSignalSpy taskSpy(&device, &Device::taskCompleted);
 
     device.processTask(104, "Spread Jam");
 
-    QVERIFY(statusSpy.wait());
+    QVERIFY(clock.advanceToNext());
     QCOMPARE(statusSpy.count(), 2);
     QCOMPARE(taskSpy.count(), 1);
 
@@ -67,5 +80,59 @@ void TestDevice::testSignalEmissions() {
     QCOMPARE(taskArgs.at(2).toInt(), 104);
 }
 
+void TestDevice::testProcessSkillTask() {
+    ManualClock clock;
+    Device device("Cheese", 1, nullptr);
+    device.setClock(&clock);
+    device.setSkill("Jam", 50);
+    QVERIFY(device.canProcess("Jam"));
+    QVERIFY(!device.canProcess("Bread"));
+    QCOMPARE(device.processingTimeFor("Jam"), 50);
+    QCOMPARE(device.processingTimeFor("Cheese"), 3000);
+
+    // 다른 모듈의 작업은 그 모듈 이름으로 완료를 알림
+    QSignalSpy taskSpy(&device, &Device::taskCompleted);
+    device.processTask(105, "Spread Jam", "Jam");
+    clock.advance(50);
+    QCOMPARE(taskSpy.count(), 1);
+    QCOMPARE(taskSpy.takeFirst().at(1).toString(), QString("Jam"));
+}
+
+void TestDevice::testSubmitThroughRings() {
+    ManualClock clock;
+    Device device("Bread", 1, nullptr);
+    device.setClock(&clock);
+    QSignalSpy statusSpy(&device, &Device::statusChanged);
+    QSignalSpy batchSpy(&device, &Device::batchCompleted);
+
+    DeviceCommand command;
+    command.orderIds.append(201);
+    command.orderIds.append(202);
+    command.taskDetail = "빵 굽기: Whole Wheat";
+    QVERIFY(device.submit(command));
+
+    // 명령은 깨우기 이벤트를 처리할 때 시작
+    QCOMPARE(statusSpy.count(), 0);
+    QCoreApplication::sendPostedEvents(&device, Device::commandEventType());
+    QCOMPARE(statusSpy.count(), 1);
+    QVERIFY(device.isProcessing);
+
+    // 처리 시간은 submit에서 예약됨 (빵은 10초)
+    DeviceCompletion completion;
+    clock.advance(9999);
+    QVERIFY(!device.takeCompletion(completion));
+    clock.advance(1);
+    QVERIFY(device.takeCompletion(completion));
+    QCOMPARE(completion.orderIds.size(), 2);
+    QCOMPARE(completion.orderIds.at(0), 201);
+    QCOMPARE(completion.orderIds.at(1), 202);
+    QCOMPARE(completion.module, QString("Bread"));
+    QVERIFY(!device.takeCompletion(completion));
+    QCOMPARE(statusSpy.count(), 2);
+
+    // 링으로 받은 작업의 완료는 시그널로 보내지 않음
+    QCOMPARE(batchSpy.count(), 0);
+}
+
 QTEST_MAIN(TestDevice)
 #include "test_device.moc"
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <QtTest/QtTest>
 #include "devicemanager.h"
 #include "device.h"
+#include "clock.h"
+#include <QElapsedTimer>
 
 class TestDeviceManager : public QObject {
     Q_OBJECT
@@ -10,10 +12,45 @@ private slots:
     void testHandleDeviceTaskCompleted();
     void testHandleDeviceTaskCompletedWithNonExistentOrder();
     void testHandleDeviceTaskCompletedWithAllStepsCompleted();
+    void testOrderEventsWithoutText();
+    void testTopologyFromConfig();
+    void testAddAndRemoveDevice();
+    void testPipelineTimingWithManualClock();
+    void testBatchWindowWithManualClock();
+    void testSrptUsesOrderRecipe();
+    void testThousandsOfOrdersWithManualClock();
+
+private:
+    static OrderMessage makeOrder(int orderId);
+    static int countStarted(const QSignalSpy& statusSpy);
+    static int nextBreadOrder(SchedulingPolicy* policy);
 };
 
+OrderMessage TestDeviceManager::makeOrder(int orderId) {
+    OrderMessage order;
+    order.orderId = orderId;
+    order.bread = "Whole Wheat";
+    order.cheeses = {"Cheddar"};
+    order.egg = "Sunny Side Up";
+    order.jams = {"Strawberry"};
+    order.jamAmount = 50;
+    order.status = OrderStatus::WAITING;
+    return order;
+}
+
+int TestDeviceManager::countStarted(const QSignalSpy& statusSpy) {
+    int started = 0;
+    for (const QList<QVariant>& args : statusSpy) {
+        if (args.at(2).toInt() == DeviceStatus::ON) {
+            started++;
+        }
+    }
+    return started;
+}
+
 void TestDeviceManager::testHandleDeviceTaskCompleted() {
-    DeviceManager manager;
+    ManualClock clock;
+    DeviceManager manager(RobotConfig::defaults(), &clock);
     OrderMessage order;
     order.orderId = 1;
     order.bread = "Whole Wheat";
@@ -61,7 +98,8 @@ void TestDeviceManager::testHandleDeviceTaskCompletedWithNonExistentOrder() {
 }
 
 void TestDeviceManager::testHandleDeviceTaskCompletedWithAllStepsCompleted() {
-    DeviceManager manager;
+    ManualClock clock;
+    DeviceManager manager(RobotConfig::defaults(), &clock);
     OrderMessage order;
     order.orderId = 2;
     order.bread = "Whole Wheat";
@@ -87,5 +125,183 @@ void TestDeviceManager::testHandleDeviceTaskCompletedWithAllStepsCompleted() {
     QCOMPARE(logArgs.at(0).toString(), QString("주문 2 완료"));
 }
 
+void TestDeviceManager::testOrderEventsWithoutText() {
+    // 로그 창처럼 이진 로그에서 읽어 보여 주는 쪽: 문장 없이 이진 로그에만 남음
+    BinaryLogger& binaryLog = BinaryLogger::instance();
+    QString error;
+    QVERIFY2(binaryLog.start(BinaryLogSettings(), error), qPrintable(error));
+    binaryLog.setTailEnabled(true);
+
+    ManualClock clock;
+    DeviceManager manager(RobotConfig::defaults(), &clock);
+    manager.setOrderEventText(false);
+    QSignalSpy logSpy(&manager, &DeviceManager::logMessage);
+
+    manager.processNewOrder(makeOrder(3));
+    while (clock.advanceToNext()) {
+    }
+    QCOMPARE(logSpy.count(), 0);
+
+    binaryLog.flush();
+    QStringList lines;
+    for (const LogRecord& record : binaryLog.takeTail()) {
+        lines << BinaryLog::render(record);
+    }
+    binaryLog.setTailEnabled(false);
+    binaryLog.stop();
+
+    QCOMPARE(lines.first(), QString("새 주문 수신 (ID: 3)"));
+    QVERIFY(lines.contains("주문 3: 치즈 추가: Cheddar 시작"));
+    QCOMPARE(lines.last(), QString("주문 3 완료"));
+}
+
+void TestDeviceManager::testTopologyFromConfig() {
+    RobotConfig config = RobotConfig::defaults();
+    config.modules[0].devices = 3;
+    config.modules[0].deviceTimesMs = {10000, 10000, 12000};
+    config.modules[1].devices = 1;
+
+    DeviceManager manager(config);
+    QCOMPARE(manager.moduleNames(), QStringList({"Bread", "Cheese", "Egg", "Jam"}));
+    QCOMPARE(manager.deviceCount("Bread"), 3);
+    QCOMPARE(manager.deviceCount("Cheese"), 1);
+    QCOMPARE(manager.maxBacklog(), (3 + 1 + 2 + 2) * 2);
+
+    RobotLoadMessage load = manager.loadReport();
+    QCOMPARE(load.modules.size(), 4);
+    QCOMPARE(load.modules.at(0).devices, 3);
+    QCOMPARE(load.modules.at(0).durationMs, qint64(32000 / 3));
+    // 남은 처리 시간은 주문의 재료로 계산 (치즈 2장, 잼 없음)
+    OrderDetails details;
+    details.cheeses = QStringList() << "Cheddar" << "Swiss";
+    QCOMPARE(manager.remainingWorkMs(1, details), qint64(2 * 3000 + 7000));
+    details.jams = QStringList() << "Strawberry";
+    QCOMPARE(manager.remainingWorkMs(0, details), qint64(10000 + 2 * 3000 + 7000 + 4000));
+}
+
+void TestDeviceManager::testAddAndRemoveDevice() {
+    DeviceManager manager;
+    QSignalSpy addedSpy(&manager, &DeviceManager::deviceAdded);
+    QSignalSpy removedSpy(&manager, &DeviceManager::deviceRemoved);
+
+    QCOMPARE(manager.addDevice("Bread", 9000), 3);
+    QCOMPARE(manager.deviceCount("Bread"), 3);
+    QCOMPARE(manager.maxBacklog(), 18);
+    QCOMPARE(addedSpy.count(), 1);
+    QCOMPARE(manager.addDevice("Toast"), 0);
+
+    // 쉬고 있는 장치는 번호가 큰 것부터 바로 제거
+    QVERIFY(manager.removeDevice("Bread"));
+    QVERIFY(manager.removeDevice("Bread"));
+    QCOMPARE(manager.deviceCount("Bread"), 1);
+    QCOMPARE(removedSpy.count(), 2);
+    QCOMPARE(removedSpy.at(0).at(1).toInt(), 3);
+    QCOMPARE(removedSpy.at(1).at(1).toInt(), 2);
+
+    // 마지막 장치는 남겨 둠
+    QVERIFY(!manager.removeDevice("Bread"));
+    QCOMPARE(manager.deviceCount("Bread"), 1);
+    QCOMPARE(manager.maxBacklog(), 14);
+}
+
+void TestDeviceManager::testPipelineTimingWithManualClock() {
+    ManualClock clock;
+    DeviceManager manager(RobotConfig::defaults(), &clock);
+    QSignalSpy finishedSpy(&manager, &DeviceManager::orderFinished);
+
+    QVERIFY(manager.processNewOrder(makeOrder(1)));
+
+    // 빵 10초 + 치즈 3초 + 계란 7초 + 잼 4초
+    clock.advance(23999);
+    QCOMPARE(finishedSpy.count(), 0);
+    clock.advance(1);
+    QCOMPARE(finishedSpy.count(), 1);
+    QCOMPARE(finishedSpy.takeFirst().at(0).toInt(), 1);
+    QCOMPARE(manager.backlog(), 0);
+    QCOMPARE(clock.pendingTimers(), 0);
+}
+
+void TestDeviceManager::testBatchWindowWithManualClock() {
+    ManualClock clock;
+    DeviceManager manager(RobotConfig::defaults(), &clock);
+    manager.setBatchWindowMs(2000);
+    QSignalSpy statusSpy(&manager, &DeviceManager::deviceStatusChanged);
+
+    // 토스터는 2장을 함께 구우므로 대기 시간 동안 같은 빵을 기다림
+    QVERIFY(manager.processNewOrder(makeOrder(1)));
+    clock.advance(1999);
+    QCOMPARE(countStarted(statusSpy), 0);
+    clock.advance(1);
+    QCOMPARE(countStarted(statusSpy), 1);
+
+    // 대기 중에 같은 빵이 오면 용량이 차는 즉시 함께 시작
+    statusSpy.clear();
+    clock.advance(10000);
+    QVERIFY(manager.processNewOrder(makeOrder(2)));
+    clock.advance(500);
+    QVERIFY(manager.processNewOrder(makeOrder(3)));
+    QCOMPARE(countStarted(statusSpy), 3);   // 주문 1의 치즈 단계 + 주문 2, 3의 빵 배치
+}
+
+int TestDeviceManager::nextBreadOrder(SchedulingPolicy* policy) {
+    // 빵 장치 1대가 주문 1을 굽는 동안 재료가 많은 주문 2, 적은 주문 3이 차례로 대기
+    RobotConfig config = RobotConfig::defaults();
+    config.modules[0].devices = 1;
+    config.modules[0].capacity = 1;
+    ManualClock clock;
+    DeviceManager manager(config, &clock);
+    manager.setSchedulingPolicy(policy);
+
+    OrderMessage longOrder = makeOrder(2);
+    longOrder.cheeses = {"Cheddar", "Swiss", "Mozzarella"};
+    longOrder.jams = {"Strawberry", "Blueberry"};
+    OrderMessage shortOrder = makeOrder(3);
+    shortOrder.jams.clear();
+    if (!manager.processNewOrder(makeOrder(1)) || !manager.processNewOrder(longOrder) ||
+        !manager.processNewOrder(shortOrder)) {
+        return -1;
+    }
+
+    QSignalSpy statusSpy(&manager, &DeviceManager::deviceStatusChanged);
+    clock.advance(10000);
+    for (const QList<QVariant>& args : statusSpy) {
+        if (args.at(0).toString() == "Bread" && args.at(2).toInt() == DeviceStatus::ON) {
+            return args.at(4).toInt();
+        }
+    }
+    return 0;
+}
+
+void TestDeviceManager::testSrptUsesOrderRecipe() {
+    // 같은 단계에서 기다려도 남은 처리 시간은 주문마다 다름 (주문 2: 34초, 주문 3: 20초)
+    QCOMPARE(nextBreadOrder(new FifoPolicy), 2);
+    QCOMPARE(nextBreadOrder(new SrptPolicy), 3);
+}
+
+void TestDeviceManager::testThousandsOfOrdersWithManualClock() {
+    const int total = 1000;
+    ManualClock clock;
+    DeviceManager manager(RobotConfig::defaults(), &clock);
+    QSignalSpy finishedSpy(&manager, &DeviceManager::orderFinished);
+
+    // 보관 한도가 허락하는 만큼 계속 넣고 다음 타이머까지 시간을 진행
+    QElapsedTimer wallClock;
+    wallClock.start();
+    int submitted = 0;
+    while (finishedSpy.count() < total) {
+        while (submitted < total && manager.backlog() < manager.maxBacklog()) {
+            QVERIFY(manager.processNewOrder(makeOrder(++submitted)));
+        }
+        QVERIFY(clock.advanceToNext());     // 대기 작업이 남았는데 예약이 없으면 멈춘 것
+    }
+
+    QCOMPARE(manager.backlog(), 0);
+    // 병목인 빵 단계: 장치 2대 x 2장 / 10초
+    const qint64 simulatedMs = clock.nowUs() / 1000;
+    QVERIFY(simulatedMs >= qint64(total) * 10000 / 4);
+    qInfo().noquote() << QString("주문 %1건: 시뮬레이션 %2초, 실제 %3ms")
+                         .arg(total).arg(simulatedMs / 1000).arg(wallClock.elapsed());
+}
+
 QTEST_MAIN(TestDeviceManager)
 #include "test_devicemanager.moc"
\ No newline at end of file
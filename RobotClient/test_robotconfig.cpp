@@ -0,0 +1,120 @@
+// test_robotconfig.cpp
+#include <QtTest/QtTest>
+#include <QJsonDocument>
+#include "robotconfig.h"
+
+class TestRobotConfig : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testDefaults();
+    void testParseWithModuleDefaults();
+    void testRejectInvalidConfig();
+    void testJsonRoundTrip();
+    void testSkills();
+
+private:
+    static QJsonObject parse(const QByteArray& text);
+};
+
+QJsonObject TestRobotConfig::parse(const QByteArray& text) {
+    return QJsonDocument::fromJson(text).object();
+}
+
+void TestRobotConfig::testDefaults() {
+    RobotConfig config = RobotConfig::defaults();
+    QCOMPARE(config.modules.size(), 4);
+    QCOMPARE(config.totalDevices(), 8);
+    QCOMPARE(config.indexOf("Egg"), 2);
+    QCOMPARE(config.indexOf("Toast"), -1);
+    QCOMPARE(config.modules.at(0).processingTimeMs, 10000);
+}
+
+void TestRobotConfig::testParseWithModuleDefaults() {
+    RobotConfig config;
+    QString error;
+    QVERIFY(RobotConfig::fromJson(parse(R"({"modules": [
+        {"name": "Bread", "devices": 3, "deviceTimesMs": [9000, 12000]},
+        {"name": "Cheese"},
+        {"name": "Egg"},
+        {"name": "Jam"}
+    ]})"), config, error));
+
+    QCOMPARE(config.modules.size(), 4);
+    const ModuleConfig& bread = config.modules.at(0);
+    QCOMPARE(bread.devices, 3);
+    QCOMPARE(bread.capacity, 2);                // 생략하면 모듈 기본값
+    QCOMPARE(bread.deviceTimeMs(1), 9000);
+    QCOMPARE(bread.deviceTimeMs(2), 12000);
+    QCOMPARE(bread.deviceTimeMs(3), 10000);     // 장치별 시간이 없으면 모듈 처리 시간
+    QCOMPARE(config.modules.at(3).devices, 1);
+    QCOMPARE(config.modules.at(3).processingTimeMs, 4000);
+}
+
+void TestRobotConfig::testRejectInvalidConfig() {
+    RobotConfig config = RobotConfig::defaults();
+    QString error;
+
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": []})"), config, error));
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": [{"name": "Bread"}, {"name": "Bread"}]})"),
+                                   config, error));
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": [{"name": "Bread", "devices": 0}]})"),
+                                   config, error));
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": [{"name": "Egg", "devices": 1,
+                                             "deviceTimesMs": [7000, 7000]}]})"), config, error));
+    QVERIFY(error.contains("Egg"));
+
+    // 서버의 주문 단계와 다른 모듈 구성 (빠짐, 순서 바뀜, 모르는 모듈)
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": [{"name": "Bread"}, {"name": "Cheese"},
+                                             {"name": "Egg"}]})"), config, error));
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": [{"name": "Bread"}, {"name": "Egg"},
+                                             {"name": "Cheese"}, {"name": "Jam"}]})"), config, error));
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": [{"name": "Bread"}, {"name": "Cheese"},
+                                             {"name": "Egg"}, {"name": "Jam"}, {"name": "Toast"}]})"),
+                                   config, error));
+    QVERIFY(error.contains("Toast"));
+
+    // 실패해도 기존 구성은 그대로
+    QCOMPARE(config.totalDevices(), 8);
+    QVERIFY(!RobotConfig::loadFile("no_such_robot_config.json", config, error));
+}
+
+void TestRobotConfig::testJsonRoundTrip() {
+    RobotConfig config = RobotConfig::defaults();
+    config.modules[0].devices = 3;
+    config.modules[0].deviceTimesMs = {10000, 10000, 12000};
+
+    RobotConfig restored;
+    QString error;
+    QVERIFY(RobotConfig::fromJson(config.toJson(), restored, error));
+    QCOMPARE(restored.toJson(), config.toJson());
+    QCOMPARE(restored.modules.at(0).deviceTimeMs(3), 12000);
+}
+
+void TestRobotConfig::testSkills() {
+    RobotConfig config;
+    QString error;
+    QVERIFY(RobotConfig::fromJson(parse(R"({"modules": [
+        {"name": "Bread"},
+        {"name": "Cheese", "devices": 2, "skills": {"Jam": 5000}},
+        {"name": "Egg"},
+        {"name": "Jam"}
+    ]})"), config, error));
+    QCOMPARE(config.modules.at(1).skills.value("Jam"), 5000);
+
+    RobotConfig restored;
+    QVERIFY(RobotConfig::fromJson(config.toJson(), restored, error));
+    QCOMPARE(restored.modules.at(1).skills, config.modules.at(1).skills);
+
+    // 구성에 없는 모듈이나 자기 모듈은 추가 기능이 될 수 없음
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": [{"name": "Bread"},
+                                             {"name": "Cheese", "skills": {"Toast": 5000}},
+                                             {"name": "Egg"}, {"name": "Jam"}]})"), config, error));
+    QVERIFY(error.contains("Toast"));
+    QVERIFY(!RobotConfig::fromJson(parse(R"({"modules": [{"name": "Bread"},
+                                             {"name": "Cheese", "skills": {"Cheese": 1000}},
+                                             {"name": "Egg"}, {"name": "Jam"}]})"), config, error));
+}
+
+QTEST_MAIN(TestRobotConfig)
+#include "test_robotconfig.moc"
@@ -10,6 +10,7 @@ class TestRobotControlGUI : public QObject {
 private slots:
     void testInitializeGUI();
     void testNetworkConnection();
+    void testNetworkConnectionRefused();
     void testDeviceStatusUpdate();
     void testLogAppending();
 };
@@ -27,20 +28,45 @@ void TestRobotControlGUI::testInitializeGUI() {
 }
 
 void TestRobotControlGUI::testNetworkConnection() {
+    NetworkManager server;
+    QVERIFY(server.startServer(12390));
+
     RobotControlGUI gui;
     QSignalSpy connectSpy(gui.networkManager, &NetworkManager::connected);
     QSignalSpy disconnectSpy(gui.networkManager, &NetworkManager::disconnected);
 
-    gui.serverAddressEdit->setText("localhost");
-    gui.serverPortEdit->setText("1234");
+    gui.serverAddressEdit->setText("127.0.0.1");
+    gui.serverPortEdit->setText("12390");
     gui.onConnectButtonClicked();
 
-    QCOMPARE(connectSpy.count(), 1);
+    // 연결을 기다리지 않고 돌아오며, 결과는 connected 신호로 화면에 반영
+    QCOMPARE(gui.networkStatusLabel->text(), QString("연결 시도 중..."));
+    QVERIFY(!gui.connectButton->isEnabled());
+    QTRY_COMPARE(connectSpy.count(), 1);
     QCOMPARE(gui.networkStatusLabel->text(), QString("서버에 연결됨"));
+    QCOMPARE(gui.connectButton->text(), QString("연결 해제"));
+    QVERIFY(gui.connectButton->isEnabled());
 
     gui.onConnectButtonClicked();
     QCOMPARE(disconnectSpy.count(), 1);
     QCOMPARE(gui.networkStatusLabel->text(), QString("연결이 해제되었습니다"));
+    QCOMPARE(gui.connectButton->text(), QString("연결"));
+}
+
+void TestRobotControlGUI::testNetworkConnectionRefused() {
+    RobotControlGUI gui;
+    QSignalSpy errorSpy(gui.networkManager, &NetworkManager::errorOccurred);
+
+    // 아무도 듣지 않는 포트: 실패는 errorOccurred로 알려 입력을 다시 열어 줌
+    gui.serverAddressEdit->setText("127.0.0.1");
+    gui.serverPortEdit->setText("12391");
+    gui.onConnectButtonClicked();
+    QTRY_VERIFY(gui.connectButton->isEnabled());
+    QVERIFY(errorSpy.count() >= 1);
+    QVERIFY(gui.networkStatusLabel->text().startsWith("오류: "));
+    QCOMPARE(gui.connectButton->text(), QString("연결"));
+    QVERIFY(gui.serverAddressEdit->isEnabled());
+    QVERIFY(!gui.networkManager->isConnectedToServer());
 }
 
 void TestRobotControlGUI::testDeviceStatusUpdate() {
@@ -50,8 +76,9 @@ void TestRobotControlGUI::testDeviceStatusUpdate() {
     gui.handleDeviceStatusUpdate("Bread", 1, DeviceStatus::ON, "Baking");
     QCOMPARE(statusSpy.count(), 1);
 
+    // 라벨은 이번 이벤트 처리가 끝난 뒤 모아서 한 번 다시 그림
     QLabel *deviceLabel = gui.deviceLabelMap["Bread"].at(0);
-    QCOMPARE(deviceLabel->text(), QString("Bread 1: 작동 중 (Baking)"));
+    QTRY_COMPARE(deviceLabel->text(), QString("Bread 1: 작동 중 (Baking)"));
     QCOMPARE(deviceLabel->styleSheet(), QString("QLabel { background-color: green; color: white; padding: 5px; border-radius: 5px; }"));
 }
 
@@ -0,0 +1,198 @@
+// test_schedulingpolicy.cpp
+#include <QtTest/QtTest>
+#include "schedulingpolicy.h"
+#include "pipelinesimulator.h"
+
+class TestSchedulingPolicy : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testFifoPicksEarliestArrival();
+    void testEdfPicksEarliestDeadline();
+    void testEdfUsesSlaWithoutDeadline();
+    void testSrptPicksShortestRemainingWork();
+    void testWeightedFairSharesBetweenChannels();
+    void testCreateByName();
+    void testSimulatorCompletesAllOrders();
+    void testTakeBatchGroupsCompatibleTasks();
+    void testBatchingRaisesThroughput();
+    void testWorkStealingRelievesBottleneck();
+
+private:
+    static SchedulingCandidate candidate(int orderId, qint64 arrivalMs, qint64 deadlineMs = 0,
+                                         OrderChannel channel = OrderChannel::DINE_IN,
+                                         qint64 remainingWorkMs = 24000);
+};
+
+SchedulingCandidate TestSchedulingPolicy::candidate(int orderId, qint64 arrivalMs, qint64 deadlineMs,
+                                                    OrderChannel channel, qint64 remainingWorkMs)
+{
+    SchedulingCandidate c;
+    c.handle = OrderHandle(static_cast<quint32>(orderId), 1);
+    c.orderId = orderId;
+    c.step = 0;
+    c.arrivalMs = arrivalMs;
+    c.deadlineMs = deadlineMs;
+    c.priority = OrderPriority::NORMAL;
+    c.channel = channel;
+    c.remainingWorkMs = remainingWorkMs;
+    c.readyMs = arrivalMs;
+    return c;
+}
+
+void TestSchedulingPolicy::testFifoPicksEarliestArrival() {
+    FifoPolicy policy;
+    QVector<SchedulingCandidate> candidates;
+    candidates << candidate(3, 300) << candidate(1, 100) << candidate(2, 200);
+    QCOMPARE(policy.selectNext(candidates, 0), 1);
+}
+
+void TestSchedulingPolicy::testEdfPicksEarliestDeadline() {
+    EdfPolicy policy;
+    QVector<SchedulingCandidate> candidates;
+    candidates << candidate(1, 100, 90000) << candidate(2, 200, 60000) << candidate(3, 300, 120000);
+    QCOMPARE(policy.selectNext(candidates, 0), 1);
+}
+
+void TestSchedulingPolicy::testEdfUsesSlaWithoutDeadline() {
+    EdfPolicy policy;
+    QVector<SchedulingCandidate> candidates;
+    SchedulingCandidate normal = candidate(1, 0);
+    SchedulingCandidate urgent = candidate(2, 1000);
+    urgent.priority = OrderPriority::HIGH;
+    candidates << normal << urgent;
+
+    // 늦게 들어왔어도 급한 주문의 SLA 마감이 더 이름
+    QCOMPARE(policy.selectNext(candidates, 0), 1);
+}
+
+void TestSchedulingPolicy::testSrptPicksShortestRemainingWork() {
+    SrptPolicy policy;
+    QVector<SchedulingCandidate> candidates;
+    candidates << candidate(1, 100, 0, OrderChannel::DINE_IN, 24000)
+               << candidate(2, 200, 0, OrderChannel::DINE_IN, 4000)
+               << candidate(3, 300, 0, OrderChannel::DINE_IN, 11000);
+    QCOMPARE(policy.selectNext(candidates, 0), 1);
+}
+
+void TestSchedulingPolicy::testWeightedFairSharesBetweenChannels() {
+    WeightedFairPolicy policy;
+    policy.setWeight(OrderChannel::DELIVERY, 1.0);
+
+    // 매장 주문이 먼저 잔뜩 쌓여 있어도 배달 주문이 번갈아 배정되어야 함
+    QVector<SchedulingCandidate> candidates;
+    for (int i = 0; i < 4; ++i) {
+        candidates << candidate(i + 1, i, 0, OrderChannel::DINE_IN);
+    }
+    for (int i = 0; i < 4; ++i) {
+        candidates << candidate(i + 11, 100 + i, 0, OrderChannel::DELIVERY);
+    }
+
+    QList<OrderChannel> picked;
+    for (int round = 0; round < 4; ++round) {
+        const int index = policy.selectNext(candidates, 0);
+        picked << candidates.at(index).channel;
+        policy.taskDispatched(candidates.at(index), 10000);
+        candidates.remove(index);
+    }
+
+    QCOMPARE(picked.count(OrderChannel::DINE_IN), 2);
+    QCOMPARE(picked.count(OrderChannel::DELIVERY), 2);
+}
+
+void TestSchedulingPolicy::testCreateByName() {
+    for (const QString& name : SchedulingPolicy::availablePolicies()) {
+        QScopedPointer<SchedulingPolicy> policy(SchedulingPolicy::create(name));
+        QVERIFY(policy);
+        QCOMPARE(policy->name(), name);
+    }
+    QVERIFY(SchedulingPolicy::create("unknown") == nullptr);
+}
+
+void TestSchedulingPolicy::testSimulatorCompletesAllOrders() {
+    PipelineSimulator simulator;
+    QVector<SimulatedOrder> workload = PipelineSimulator::generateWorkload(200, 10.0, 240000, 7);
+
+    EdfPolicy policy;
+    SimulationResult result = simulator.run(workload, &policy);
+    QCOMPARE(result.completedOrders, 200);
+    QVERIFY(result.makespanMs >= workload.last().arrivalMs);
+    QVERIFY(result.p95LatencyMs >= 24000);  // 주문 절반 이상은 재료만으로 4단계 처리 시간 합이 24초 이상
+}
+
+void TestSchedulingPolicy::testTakeBatchGroupsCompatibleTasks() {
+    FifoPolicy policy;
+    QVector<SchedulingCandidate> candidates;
+    const QStringList keys = QStringList() << "호밀빵" << "흰빵" << "호밀빵" << "호밀빵" << "흰빵";
+    for (int i = 0; i < keys.size(); ++i) {
+        SchedulingCandidate c = candidate(i + 1, i * 100);
+        c.batchKey = keys.at(i);
+        candidates << c;
+    }
+
+    // 가장 먼저 온 호밀빵 주문과 같은 재료만 도착 순서대로 용량만큼
+    QVector<SchedulingCandidate> batch = policy.takeBatch(candidates, 0, 2);
+    QCOMPARE(batch.size(), 2);
+    QCOMPARE(batch.at(0).orderId, 1);
+    QCOMPARE(batch.at(1).orderId, 3);
+    QCOMPARE(candidates.size(), 3);
+
+    batch = policy.takeBatch(candidates, 0, 4);
+    QCOMPARE(batch.size(), 2);
+    QCOMPARE(batch.at(0).orderId, 2);
+    QCOMPARE(batch.at(1).orderId, 5);
+    QCOMPARE(candidates.size(), 1);
+    QCOMPARE(candidates.first().orderId, 4);
+
+    // 배치 키가 없으면 단독 처리
+    candidates.first().batchKey.clear();
+    candidates << candidate(9, 900);
+    QCOMPARE(policy.takeBatch(candidates, 0, 4).size(), 1);
+}
+
+void TestSchedulingPolicy::testBatchingRaisesThroughput() {
+    // 빵 장치 2대 x 10초의 단독 처리 한계(분당 12건)를 넘는 부하
+    QVector<SimulatedOrder> workload = PipelineSimulator::generateWorkload(300, 16.0, 240000, 11);
+    FifoPolicy policy;
+
+    PipelineSimulator single;
+    for (int step = 0; step < 4; ++step) {
+        single.setDeviceCapacity(step, 1);
+    }
+    SimulationResult singleResult = single.run(workload, &policy);
+
+    PipelineSimulator batched;
+    batched.setDeviceCapacity(0, 4);
+    batched.setDeviceCapacity(2, 2);
+    SimulationResult batchedResult = batched.run(workload, &policy);
+
+    QCOMPARE(singleResult.completedOrders, 300);
+    QCOMPARE(batchedResult.completedOrders, 300);
+    QVERIFY(batchedResult.makespanMs < singleResult.makespanMs);
+    QVERIFY(batchedResult.p95LatencyMs < singleResult.p95LatencyMs);
+}
+
+void TestSchedulingPolicy::testWorkStealingRelievesBottleneck() {
+    // 잼 장치 1대(분당 15건)가 병목이고 치즈 장치 2대는 대부분 쉬는 구성에 분당 18건
+    QVector<SimulatedOrder> workload = PipelineSimulator::generateWorkload(300, 18.0, 240000, 5);
+    FifoPolicy policy;
+
+    PipelineSimulator dedicated;
+    dedicated.setDeviceCount(0, 4);
+    dedicated.setDeviceCount(2, 3);
+    dedicated.setDeviceCount(3, 1);
+    SimulationResult dedicatedResult = dedicated.run(workload, &policy);
+
+    // 치즈 스프레더가 잼도 바를 수 있으면 쉬는 동안 잼 대기열을 나눠 처리
+    PipelineSimulator spreaders = dedicated;
+    spreaders.setDeviceSkill(1, 3, 4000);
+    SimulationResult stealingResult = spreaders.run(workload, &policy);
+
+    QCOMPARE(dedicatedResult.completedOrders, 300);
+    QCOMPARE(stealingResult.completedOrders, 300);
+    QVERIFY(stealingResult.p95LatencyMs < dedicatedResult.p95LatencyMs);
+    QVERIFY(stealingResult.makespanMs <= dedicatedResult.makespanMs);
+}
+
+QTEST_MAIN(TestSchedulingPolicy)
+#include "test_schedulingpolicy.moc"
@@ -0,0 +1,245 @@
+// tracer.cpp
+#include "tracer.h"
+#include "metrics.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+namespace {
+
+void copyText(char* target, const char* text)
+{
+    qstrncpy(target, text ? text : "", TraceEvent::TextSize);
+}
+
+} // namespace
+
+Tracer& Tracer::instance()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer()
+    : active(false)
+    , generation(0)
+    , dropped(0)
+{
+}
+
+Tracer::~Tracer()
+{
+    qDeleteAll(buffers);
+}
+
+Tracer::ThreadBuffer* Tracer::localBuffer()
+{
+    // 스레드가 끝나도 버퍼는 남겨 두어야 덤프할 수 있으므로 추적기가 소유
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        buffer = new ThreadBuffer;
+        buffer->size.store(0, std::memory_order_relaxed);
+        buffer->generation.store(generation.load(std::memory_order_acquire), std::memory_order_release);
+        QMutexLocker locker(&mutex);
+        buffers.append(buffer);
+    }
+    return buffer;
+}
+
+void Tracer::record(const TraceEvent& event)
+{
+    ThreadBuffer* buffer = localBuffer();
+
+    // clear() 이후 처음 기록하는 스레드가 자기 버퍼를 비움 (작성자는 항상 한 스레드)
+    // 세대를 먼저 바꾸고 울타리를 둔 뒤 덮어쓰므로, 덮어쓴 칸을 읽은 events()는 바뀐 세대를 보고 버림
+    const quint64 current = generation.load(std::memory_order_acquire);
+    if (buffer->generation.load(std::memory_order_relaxed) != current) {
+        buffer->size.store(0, std::memory_order_relaxed);
+        buffer->generation.store(current, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    const int index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= BufferCapacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    buffer->events[index] = event;
+    // 이벤트를 다 쓴 뒤에 크기를 늘려 읽는 쪽이 완성된 이벤트만 보도록 함
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::complete(const char* name, const char* track, qint64 startUs, qint64 durationUs,
+                      int orderId, int count)
+{
+    if (!enabled()) return;
+
+    TraceEvent event;
+    event.phase = 'X';
+    copyText(event.name, name);
+    copyText(event.track, track);
+    event.timestampUs = startUs;
+    event.durationUs = qMax<qint64>(0, durationUs);
+    event.orderId = orderId;
+    event.count = count;
+    record(event);
+}
+
+void Tracer::instant(const char* name, const char* track, int orderId)
+{
+    if (!enabled()) return;
+
+    TraceEvent event;
+    event.phase = 'i';
+    copyText(event.name, name);
+    copyText(event.track, track);
+    event.timestampUs = MetricsRegistry::nowUs();
+    event.durationUs = 0;
+    event.orderId = orderId;
+    event.count = 0;
+    record(event);
+}
+
+void Tracer::asyncSpan(const char* name, const char* category, int orderId, qint64 startUs, qint64 endUs)
+{
+    if (!enabled()) return;
+
+    TraceEvent event;
+    event.phase = 'b';
+    copyText(event.name, name);
+    copyText(event.track, category);
+    event.timestampUs = startUs;
+    event.durationUs = 0;
+    event.orderId = orderId;
+    event.count = 0;
+    record(event);
+
+    event.phase = 'e';
+    event.timestampUs = qMax(startUs, endUs);
+    record(event);
+}
+
+void Tracer::clear()
+{
+    generation.fetch_add(1, std::memory_order_acq_rel);
+    dropped.store(0, std::memory_order_relaxed);
+}
+
+QList<TraceEvent> Tracer::events() const
+{
+    QList<ThreadBuffer*> snapshot;
+    {
+        QMutexLocker locker(&mutex);
+        snapshot = buffers;
+    }
+
+    const quint64 current = generation.load(std::memory_order_acquire);
+    QList<TraceEvent> result;
+    for (ThreadBuffer* buffer : snapshot) {
+        if (buffer->generation.load(std::memory_order_acquire) != current) {
+            continue;   // clear() 이후 아직 기록하지 않은 스레드
+        }
+        const int size = buffer->size.load(std::memory_order_acquire);
+        const int first = result.size();
+        for (int i = 0; i < size; ++i) {
+            result.append(buffer->events[i]);
+        }
+        // 복사하는 동안 clear() 뒤 첫 기록이 버퍼를 다시 쓰기 시작했으면 섞인 복사본을 버림
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (buffer->generation.load(std::memory_order_relaxed) != current) {
+            result.erase(result.begin() + first, result.end());
+        }
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const TraceEvent& a, const TraceEvent& b) {
+        return a.timestampUs < b.timestampUs;
+    });
+    return result;
+}
+
+QByteArray Tracer::toChromeJson() const
+{
+    const qint64 pid = QCoreApplication::applicationPid();
+    const QList<TraceEvent> recorded = events();
+
+    // 트랙(장치, 모듈 등)마다 Gantt 한 줄: tid를 발급하고 이름을 메타데이터로 붙임
+    QJsonArray traceEvents;
+    QJsonObject processName;
+    processName["ph"] = "M";
+    processName["name"] = "process_name";
+    processName["pid"] = pid;
+    processName["tid"] = 0;
+    processName["args"] = QJsonObject{ { "name", QCoreApplication::applicationName() } };
+    traceEvents.append(processName);
+
+    QHash<QByteArray, int> trackIds;
+    for (const TraceEvent& event : recorded) {
+        const QByteArray track(event.track);
+        const bool async = event.phase == 'b' || event.phase == 'e';
+
+        QJsonObject json;
+        json["name"] = QString::fromUtf8(event.name);
+        json["ph"] = QString(QChar::fromLatin1(event.phase));
+        json["ts"] = event.timestampUs;
+        json["pid"] = pid;
+
+        QJsonObject args;
+        if (event.orderId >= 0) args["orderId"] = event.orderId;
+        if (event.count > 0) args["count"] = event.count;
+        if (!args.isEmpty()) json["args"] = args;
+
+        if (async) {
+            // 비동기 구간은 분류 + 주문 ID로 짝을 맞춤
+            json["cat"] = QString::fromUtf8(track);
+            json["id"] = event.orderId;
+            json["tid"] = 0;
+            traceEvents.append(json);
+            continue;
+        }
+
+        int tid = trackIds.value(track, 0);
+        if (tid == 0) {
+            tid = trackIds.size() + 1;
+            trackIds.insert(track, tid);
+
+            QJsonObject threadName;
+            threadName["ph"] = "M";
+            threadName["name"] = "thread_name";
+            threadName["pid"] = pid;
+            threadName["tid"] = tid;
+            threadName["args"] = QJsonObject{ { "name", QString::fromUtf8(track) } };
+            traceEvents.append(threadName);
+        }
+        json["cat"] = "timeline";
+        json["tid"] = tid;
+        if (event.phase == 'X') {
+            json["dur"] = event.durationUs;
+        } else {
+            json["s"] = "t";
+        }
+        traceEvents.append(json);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Tracer::writeChromeTrace(const QString& path, QString& errorMessage) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = QString("추적 파일을 열 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+    if (file.write(toChromeJson()) < 0) {
+        errorMessage = QString("추적 파일을 쓸 수 없습니다: %1 (%2)").arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
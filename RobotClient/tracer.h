@@ -0,0 +1,78 @@
+// tracer.h
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QList>
+#include <QByteArray>
+#include <QMutex>
+#include <atomic>
+
+// 추적 이벤트 한 건 (Chrome trace 형식의 한 항목)
+// 이름과 트랙은 기록 시 고정 크기 버퍼로 복사하므로 기록 중 메모리 할당이 없습니다.
+struct TraceEvent {
+    static const int TextSize = 32;
+
+    char phase;                 // 'X': 구간, 'i': 순간, 'b'/'e': 주문별 비동기 구간 시작/끝
+    char name[TextSize];
+    char track[TextSize];       // 장치/모듈 이름 등 Gantt 한 줄 (비동기 구간은 분류)
+    qint64 timestampUs;
+    qint64 durationUs;
+    int orderId;                // 없으면 -1
+    int count;                  // 배치 크기 등 (없으면 0)
+};
+
+// 주문과 장치 타임라인 추적기 (기본 꺼짐)
+// 스레드마다 고정 크기 버퍼에 기록하고 (단일 작성자, 잠금 없음)
+// toChromeJson()으로 Chrome trace JSON을 만들어 Perfetto/chrome://tracing에서 봅니다.
+// 시각은 MetricsRegistry::nowUs()와 같은 단조 시계라 같은 기기의 서버/로봇 추적을 합쳐 볼 수 있습니다.
+class Tracer
+{
+public:
+    static const int BufferCapacity = 1 << 15;     // 스레드당 이벤트 수, 넘치면 버림
+
+    static Tracer& instance();
+
+    // 꺼져 있으면 기록 함수는 원자 변수 하나만 읽고 돌아옴
+    static bool enabled() { return instance().active.load(std::memory_order_relaxed); }
+    void setEnabled(bool enable) { active.store(enable, std::memory_order_relaxed); }
+
+    // startUs부터 durationUs 동안의 구간 (장치 작업, 프레임 전송 등)
+    void complete(const char* name, const char* track, qint64 startUs, qint64 durationUs,
+                  int orderId = -1, int count = 0);
+    // 현재 시각의 순간 이벤트
+    void instant(const char* name, const char* track, int orderId = -1);
+    // 주문 하나의 비동기 구간 (대기열에서 기다린 시간, 주문 전체 처리 시간 등)
+    void asyncSpan(const char* name, const char* category, int orderId, qint64 startUs, qint64 endUs);
+
+    // 모든 스레드의 기록을 비움 (기록 중인 스레드는 다음 기록 때 자기 버퍼를 비움)
+    void clear();
+    quint64 droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+
+    // 지금까지의 기록 (시각 순, clear()와 겹친 스레드 버퍼는 빠질 수 있음)
+    QList<TraceEvent> events() const;
+
+    QByteArray toChromeJson() const;
+    bool writeChromeTrace(const QString& path, QString& errorMessage) const;
+
+private:
+    struct ThreadBuffer {
+        std::atomic<int> size;
+        std::atomic<quint64> generation;
+        TraceEvent events[BufferCapacity];
+    };
+
+    Tracer();
+    ~Tracer();
+    ThreadBuffer* localBuffer();
+    void record(const TraceEvent& event);
+
+    std::atomic<bool> active;
+    std::atomic<quint64> generation;    // clear()마다 증가
+    std::atomic<quint64> dropped;
+
+    mutable QMutex mutex;               // 스레드 버퍼 목록 (스레드마다 처음 한 번만 잠금)
+    QList<ThreadBuffer*> buffers;
+};
+
+#endif // TRACER_H